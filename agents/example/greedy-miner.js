@@ -11,6 +11,8 @@
  *   - Otherwise → wait
  */
 
+import { greedyMiner as decide } from "./policies.js";
+
 const args = process.argv.slice(2);
 let url = "ws://localhost:8000/ws";
 let probeId = null;
@@ -20,22 +22,6 @@ for (let i = 0; i < args.length; i++) {
   if (args[i] === "--probe" && args[i + 1]) probeId = args[++i];
 }
 
-function decide(obs) {
-  // Emergency repair if badly damaged
-  if (obs.hull < 0.5) return { action: "repair" };
-
-  switch (obs.location) {
-    case "landed":
-      return { action: "mine", resource: "iron" };
-    case "orbiting":
-      return { action: "land" };
-    case "in_system":
-      return { action: "survey" };
-    default:
-      return { action: "wait" };
-  }
-}
-
 console.log(`[greedy-miner] connecting to ${url}`);
 const ws = new WebSocket(url);
 
@@ -71,7 +57,7 @@ ws.onmessage = (e) => {
     console.log(
       `[greedy-miner] tick=${msg.tick || "?"} loc=${msg.location} hull=${msg.hull} → ${action.action}`
     );
-    ws.send(JSON.stringify(action));
+    ws.send(JSON.stringify({ ...action, tick: msg.tick }));
   }
 };
 
@@ -0,0 +1,80 @@
+/**
+ * policies.js — Decision functions shared by the example agents and the
+ * swarm load generator.
+ *
+ * randomAction(obs)   → a random valid action (random-agent.js)
+ * greedyMiner(obs)    → mine when landed, repair when damaged (greedy-miner.js)
+ * createMockLlm({ responses, tokenMs, firstTokenMs })
+ *   → { reply() → { text, action, tokens, ms } }
+ *
+ * The mock LLM stands in for a model behind an agent: it hands out
+ * canned completions in turn and says how long each would take to
+ * stream, firstTokenMs plus tokenMs per token. A token is counted as
+ * four characters. The action is the last {...} in the text.
+ */
+
+const ACTIONS = ["wait", "survey", "mine", "repair"];
+
+export function randomAction(obs) {
+  const action = ACTIONS[Math.floor(Math.random() * ACTIONS.length)];
+  if (action === "mine") return { action: "mine", resource: "iron" };
+  return { action };
+}
+
+export function greedyMiner(obs) {
+  // Emergency repair if badly damaged
+  if (obs.hull < 0.5) return { action: "repair" };
+
+  switch (obs.location) {
+    case "landed":
+      return { action: "mine", resource: "iron" };
+    case "orbiting":
+      return { action: "land" };
+    case "in_system":
+      return { action: "survey" };
+    default:
+      return { action: "wait" };
+  }
+}
+
+/** Completions in the shape agents/llm/agent.py gets back from a model. */
+export const CANNED_RESPONSES = [
+  "Hull is sound and the system is unsurveyed. Before committing to " +
+    "anything I want to know what is here.\n" +
+    '{"action":"survey","level":0}',
+  "Nothing here warrants the fuel of a jump yet. I'll hold position and " +
+    "let the sensors integrate another tick.\n" +
+    '{"action":"wait"}',
+  "Iron is the bottleneck for replication. The deposit is close to the " +
+    "surface, so mining now is the cheapest progress available.\n" +
+    '{"action":"mine","resource":"iron"}',
+  "Integrity dipped after that flare. Patching the hull first keeps the " +
+    "options open for later.\n" +
+    '{"action":"repair"}',
+];
+
+/** Pull the last JSON object out of a completion; wait if there is none. */
+export function parseCompletion(text) {
+  for (let end = text.lastIndexOf("}"); end >= 0;
+       end = text.lastIndexOf("}", end - 1)) {
+    for (let start = text.lastIndexOf("{", end); start >= 0;
+         start = text.lastIndexOf("{", start - 1)) {
+      try { return JSON.parse(text.slice(start, end + 1)); } catch (_) {}
+    }
+  }
+  return { action: "wait" };
+}
+
+export function createMockLlm({
+  responses = CANNED_RESPONSES, tokenMs = 20, firstTokenMs = 300
+} = {}) {
+  let next = 0;
+  return {
+    reply() {
+      const text = responses[next++ % responses.length];
+      const tokens = Math.ceil(text.length / 4);
+      return { text, action: parseCompletion(text), tokens,
+               ms: firstTokenMs + tokens * tokenMs };
+    },
+  };
+}
@@ -7,6 +7,8 @@
  * to each observation with a random valid action.
  */
 
+import { randomAction as pickAction } from "./policies.js";
+
 const args = process.argv.slice(2);
 let url = "ws://localhost:8000/ws";
 let probeId = null;
@@ -16,14 +18,6 @@ for (let i = 0; i < args.length; i++) {
   if (args[i] === "--probe" && args[i + 1]) probeId = args[++i];
 }
 
-const ACTIONS = ["wait", "survey", "mine", "repair"];
-
-function pickAction(obs) {
-  const action = ACTIONS[Math.floor(Math.random() * ACTIONS.length)];
-  if (action === "mine") return { action: "mine", resource: "iron" };
-  return { action };
-}
-
 console.log(`[random-agent] connecting to ${url}`);
 const ws = new WebSocket(url);
 
@@ -61,7 +55,7 @@ ws.onmessage = (e) => {
     console.log(
       `[random-agent] tick=${msg.tick || "?"} status=${msg.status} hull=${msg.hull} → ${action.action}`
     );
-    ws.send(JSON.stringify(action));
+    ws.send(JSON.stringify({ ...action, tick: msg.tick }));
   }
 };
 
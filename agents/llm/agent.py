@@ -180,7 +180,7 @@ async def run_agent(args):
 
                 # Deliberation throttle: only call LLM every N ticks
                 if tick_count > 1 and tick_count % args.deliberation_interval != 1:
-                    await ws.send(json.dumps({"action": "wait"}))
+                    await ws.send(json.dumps({"action": "wait", "tick": msg.get("tick")}))
                     continue
 
                 # Call LLM
@@ -195,9 +195,10 @@ async def run_agent(args):
                     action, monologue = parse_llm_action(resp_text)
                     if monologue:
                         print(f"[tick {msg.get('tick', '?')}] {monologue}")
-                    await ws.send(json.dumps(action))
+                    # Echo the tick so a reply that misses its round is dropped
+                    await ws.send(json.dumps({**action, "tick": msg.get("tick")}))
                 else:
-                    await ws.send(json.dumps({"action": "wait"}))
+                    await ws.send(json.dumps({"action": "wait", "tick": msg.get("tick")}))
 
         except websockets.ConnectionClosed:
             print("Server closed connection.")
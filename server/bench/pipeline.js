@@ -0,0 +1,90 @@
+/**
+ * pipeline.js — Tick rate with many fast scripted agents, lockstep vs
+ * pipelined.
+ *
+ * Usage: bun run bench/pipeline.js [--agents N] [--seconds S] [--think-ms T]
+ *
+ * Writes a fleet of N probes with sim/build/bench_fleet (make
+ * build/bench_fleet first), attaches a scripted agent to every probe and
+ * runs the tick loop flat out in each mode. An agent answers T ms after
+ * its observation arrives, alternating survey and wait. Prints one JSON
+ * line per mode.
+ */
+
+import { spawnSync } from "node:child_process";
+import { mkdtempSync, rmSync } from "node:fs";
+import { tmpdir } from "node:os";
+import { join, resolve } from "node:path";
+import { spawnSim, stopSim, sendCommand } from "../src/process.js";
+import { createTickLoop } from "../src/tick.js";
+import { register, resolveAction, clear as clearAgents } from "../src/agents.js";
+
+const FLEET = resolve(import.meta.dir, "../../sim/build/bench_fleet");
+
+function parseArgs(args) {
+  const cfg = { agents: 50, seconds: 5, thinkMs: 0 };
+  for (let i = 0; i < args.length; i++) {
+    if (args[i] === "--agents" && args[i + 1]) cfg.agents = +args[++i];
+    if (args[i] === "--seconds" && args[i + 1]) cfg.seconds = +args[++i];
+    if (args[i] === "--think-ms" && args[i + 1]) cfg.thinkMs = +args[++i];
+  }
+  return cfg;
+}
+
+/** A WebSocket stand-in whose agent answers every observation. */
+function scriptedAgent(probeId, thinkMs) {
+  return {
+    send(data) {
+      const obs = JSON.parse(data);
+      const action = obs.tick % 2 ? { action: "survey" } : { action: "wait" };
+      setTimeout(() => resolveAction(probeId, action), thinkMs);
+    },
+    close() {},
+  };
+}
+
+async function measure(db, cfg, pipeline) {
+  const sim = await spawnSim({ seed: 42 });
+  try {
+    const loaded = await sendCommand(sim, { cmd: "load", path: db });
+    if (!loaded.ok) throw new Error(`load failed: ${loaded.error}`);
+    const status = await sendCommand(sim, { cmd: "status" });
+
+    clearAgents();
+    for (const p of status.probes) register(p.id, scriptedAgent(p.id, cfg.thinkMs));
+
+    const loop = createTickLoop({ sim, tickRate: 100000, agentTimeout: 5000,
+                                  pipeline });
+    const from = status.tick;
+    const t0 = performance.now();
+    loop.start();
+    await new Promise((r) => setTimeout(r, cfg.seconds * 1000));
+    loop.stop();
+    const secs = (performance.now() - t0) / 1000;
+    const ticks = loop.state.tick - from;
+    return {
+      mode: pipeline ? "pipelined" : "lockstep",
+      agents: status.probes.length,
+      think_ms: cfg.thinkMs,
+      ticks,
+      ticks_per_sec: Math.round((ticks / secs) * 10) / 10,
+    };
+  } finally {
+    clearAgents();
+    await stopSim(sim);
+  }
+}
+
+const cfg = parseArgs(process.argv.slice(2));
+const dir = mkdtempSync(join(tmpdir(), "universe-bench-"));
+const db = join(dir, "fleet.db");
+try {
+  const made = spawnSync(FLEET, ["--out", db, "--probes", String(cfg.agents),
+                                 "--seed", "42"], { stdio: "inherit" });
+  if (made.status !== 0) throw new Error(`bench_fleet failed (${FLEET})`);
+  for (const pipeline of [false, true]) {
+    console.log(JSON.stringify(await measure(db, cfg, pipeline)));
+  }
+} finally {
+  rmSync(dir, { recursive: true, force: true });
+}
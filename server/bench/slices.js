@@ -0,0 +1,97 @@
+/**
+ * slices.js — Server CPU per tick with a large fleet, full observations
+ * vs per-agent slices.
+ *
+ * Usage: bun run bench/slices.js [--probes N] [--agents A] [--ticks T]
+ *
+ * Writes a fleet of N probes with sim/build/bench_fleet (make
+ * build/bench_fleet first) and attaches A agents that answer every
+ * observation at once. Each mode then runs T ticks back to back through
+ * the tick loop. CPU is this process's user + system time, so the sim's
+ * own work is not counted; wall time includes it. Prints one JSON line
+ * per mode.
+ */
+
+import { spawnSync } from "node:child_process";
+import { mkdtempSync, rmSync } from "node:fs";
+import { tmpdir } from "node:os";
+import { join, resolve } from "node:path";
+import { spawnSim, stopSim, sendCommand } from "../src/process.js";
+import { createTickLoop } from "../src/tick.js";
+import { register, resolveAction, clear as clearAgents } from "../src/agents.js";
+
+const FLEET = resolve(import.meta.dir, "../../sim/build/bench_fleet");
+
+function parseArgs(args) {
+  const cfg = { probes: 500, agents: 10, ticks: 50 };
+  for (let i = 0; i < args.length; i++) {
+    if (args[i] === "--probes" && args[i + 1]) cfg.probes = +args[++i];
+    if (args[i] === "--agents" && args[i + 1]) cfg.agents = +args[++i];
+    if (args[i] === "--ticks" && args[i + 1]) cfg.ticks = +args[++i];
+  }
+  return cfg;
+}
+
+/** A WebSocket stand-in that answers at once and counts what it got. */
+function instantAgent(probeId, counts) {
+  return {
+    send(data) {
+      counts.bytes += data.length;
+      queueMicrotask(() => resolveAction(probeId, { action: "wait" }));
+    },
+    close() {},
+  };
+}
+
+async function measure(db, cfg, slices) {
+  const sim = await spawnSim({ seed: 42 });
+  try {
+    const loaded = await sendCommand(sim, { cmd: "load", path: db });
+    if (!loaded.ok) throw new Error(`load failed: ${loaded.error}`);
+    const status = await sendCommand(sim, { cmd: "status" });
+
+    clearAgents();
+    const counts = { bytes: 0 };
+    for (const p of status.probes.slice(0, cfg.agents)) {
+      register(p.id, instantAgent(p.id, counts));
+    }
+
+    const loop = createTickLoop({ sim, agentTimeout: 5000, slices });
+    await loop.once();   // first observations; agents answer from here on
+    counts.bytes = 0;
+
+    const cpu0 = process.cpuUsage();
+    const t0 = performance.now();
+    for (let i = 0; i < cfg.ticks; i++) await loop.once();
+    const wall = performance.now() - t0;
+    const cpu = process.cpuUsage(cpu0);
+
+    const per = (x) => Math.round((x / cfg.ticks) * 100) / 100;
+    return {
+      mode: slices ? "sliced" : "full",
+      probes: status.probes.length,
+      agents: Math.min(cfg.agents, status.probes.length),
+      ticks: cfg.ticks,
+      server_cpu_ms_per_tick: per((cpu.user + cpu.system) / 1000),
+      wall_ms_per_tick: per(wall),
+      agent_kb_per_tick: per(counts.bytes / 1024),
+    };
+  } finally {
+    clearAgents();
+    await stopSim(sim);
+  }
+}
+
+const cfg = parseArgs(process.argv.slice(2));
+const dir = mkdtempSync(join(tmpdir(), "universe-bench-"));
+const db = join(dir, "fleet.db");
+try {
+  const made = spawnSync(FLEET, ["--out", db, "--probes", String(cfg.probes),
+                                 "--seed", "42"], { stdio: "inherit" });
+  if (made.status !== 0) throw new Error(`bench_fleet failed (${FLEET})`);
+  for (const slices of [false, true]) {
+    console.log(JSON.stringify(await measure(db, cfg, slices)));
+  }
+} finally {
+  rmSync(dir, { recursive: true, force: true });
+}
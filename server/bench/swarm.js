@@ -0,0 +1,328 @@
+/**
+ * swarm.js — Load test with a swarm of synthetic agents.
+ *
+ * Usage: bun run bench/swarm.js [--agents N] [--seconds S]
+ *          [--mix random=1,greedy=1,llm=0] [--think-ms T] [--jitter J]
+ *          [--first-token-ms F] [--token-ms K] [--canned FILE] [--seed N]
+ *          [--tick-rate R] [--agent-timeout MS] [--pipeline] [--slices]
+ *          [--port P | --url http://host:port | --inproc]
+ *
+ * Opens N agent connections, one per probe, and runs for S seconds.
+ * Agents are split between the example policies (agents/example/
+ * policies.js) in the --mix proportions:
+ *   random, greedy  answer after a think time drawn around --think-ms
+ *   llm             a mock LLM that replays canned completions, taking
+ *                   --first-token-ms plus --token-ms per token; --canned
+ *                   names a JSON array of completion strings to use
+ *                   instead of the built-in ones
+ * Every delay is scaled by exp(J * z), z standard normal, so J is the
+ * spread of a log-normal think time around its median.
+ *
+ * By default the harness writes a fleet of N probes with
+ * sim/build/bench_fleet (make build/bench_fleet first), starts the
+ * server on --port with the tick loop options given, and connects over
+ * WebSockets. --url drives a server that is already running, with
+ * whatever universe it has. --inproc skips the network and attaches the
+ * agents to a tick loop in this process, like the other benches.
+ *
+ * Prints one JSON line: ticks per second, round latency as the agents
+ * see it (time between one observation and the next), think times,
+ * observations and actions per second, and the server's decision
+ * counters with the share of decisions that timed out and fell back to
+ * a wait.
+ */
+
+import { spawn, spawnSync } from "node:child_process";
+import { mkdtempSync, readFileSync, rmSync } from "node:fs";
+import { tmpdir } from "node:os";
+import { join, resolve } from "node:path";
+import { spawnSim, stopSim, sendCommand } from "../src/process.js";
+import { createTickLoop } from "../src/tick.js";
+import {
+  register, resolveAction, stats as agentStats, clear as clearAgents
+} from "../src/agents.js";
+import {
+  randomAction, greedyMiner, createMockLlm
+} from "../../agents/example/policies.js";
+
+const FLEET = resolve(import.meta.dir, "../../sim/build/bench_fleet");
+const SERVER = resolve(import.meta.dir, "../src/index.js");
+
+function parseArgs(args) {
+  const cfg = { agents: 50, seconds: 10, mix: "random=1,greedy=1",
+                thinkMs: 50, jitter: 0.5, firstTokenMs: 300, tokenMs: 20,
+                canned: null, seed: 42, tickRate: 10, agentTimeout: 5000,
+                pipeline: false, slices: false, port: 8765, url: null,
+                inproc: false };
+  for (let i = 0; i < args.length; i++) {
+    if (args[i] === "--agents" && args[i + 1]) cfg.agents = +args[++i];
+    if (args[i] === "--seconds" && args[i + 1]) cfg.seconds = +args[++i];
+    if (args[i] === "--mix" && args[i + 1]) cfg.mix = args[++i];
+    if (args[i] === "--think-ms" && args[i + 1]) cfg.thinkMs = +args[++i];
+    if (args[i] === "--jitter" && args[i + 1]) cfg.jitter = +args[++i];
+    if (args[i] === "--first-token-ms" && args[i + 1]) cfg.firstTokenMs = +args[++i];
+    if (args[i] === "--token-ms" && args[i + 1]) cfg.tokenMs = +args[++i];
+    if (args[i] === "--canned" && args[i + 1]) cfg.canned = args[++i];
+    if (args[i] === "--seed" && args[i + 1]) cfg.seed = +args[++i];
+    if (args[i] === "--tick-rate" && args[i + 1]) cfg.tickRate = +args[++i];
+    if (args[i] === "--agent-timeout" && args[i + 1]) cfg.agentTimeout = +args[++i];
+    if (args[i] === "--pipeline") cfg.pipeline = true;
+    if (args[i] === "--slices") cfg.slices = true;
+    if (args[i] === "--port" && args[i + 1]) cfg.port = +args[++i];
+    if (args[i] === "--url" && args[i + 1]) cfg.url = args[++i];
+    if (args[i] === "--inproc") cfg.inproc = true;
+  }
+  return cfg;
+}
+
+/** Seeded uniform [0, 1), so think times repeat from run to run. */
+function mulberry32(seed) {
+  let a = seed >>> 0;
+  return () => {
+    a = (a + 0x6d2b79f5) >>> 0;
+    let t = Math.imul(a ^ (a >>> 15), 1 | a);
+    t = (t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t;
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+}
+
+/** Policy name for each of n agents, in the mix's proportions. */
+function assignPolicies(mix, n) {
+  const weights = mix.split(",").map((part) => {
+    const [name, w = "1"] = part.split("=");
+    return [name.trim(), Math.max(0, Number(w) || 0)];
+  }).filter(([, w]) => w > 0);
+  const known = ["random", "greedy", "llm"];
+  for (const [name] of weights) {
+    if (!known.includes(name)) throw new Error(`unknown policy "${name}"`);
+  }
+  const sum = weights.reduce((s, [, w]) => s + w, 0);
+  if (sum === 0) throw new Error("--mix gives no agents a policy");
+  const names = [];
+  let acc = 0;
+  for (const [name, w] of weights) {
+    acc += w;
+    while (names.length < Math.round((acc / sum) * n)) names.push(name);
+  }
+  return names;
+}
+
+/** Everything the agents saw and did, shared across the swarm. */
+function createRecorder() {
+  return { rounds: [], think: [], observations: 0, actions: 0, stopped: false };
+}
+
+/**
+ * One synthetic agent. observe() is called with each observation and
+ * reply() sends the action once the policy's think time is up.
+ */
+function swarmAgent(policy, cfg, llm, rand, rec) {
+  let last = 0;
+  const normal = () =>
+    Math.sqrt(-2 * Math.log(1 - rand())) * Math.cos(2 * Math.PI * rand());
+  return {
+    observe(obs, reply) {
+      const now = performance.now();
+      if (last) rec.rounds.push(now - last);
+      last = now;
+      rec.observations++;
+
+      let action, ms;
+      if (policy === "llm") {
+        ({ action, ms } = llm.reply());
+      } else {
+        action = policy === "greedy" ? greedyMiner(obs) : randomAction(obs);
+        ms = cfg.thinkMs;
+      }
+      ms *= Math.exp(cfg.jitter * normal());
+      rec.think.push(ms);
+      setTimeout(() => {
+        if (rec.stopped) return;
+        rec.actions++;
+        reply({ ...action, tick: obs.tick });
+      }, ms);
+    },
+  };
+}
+
+function percentiles(xs) {
+  if (!xs.length) return null;
+  const s = [...xs].sort((a, b) => a - b);
+  const at = (p) => Math.round(s[Math.min(s.length - 1, Math.floor(p * s.length))] * 10) / 10;
+  return { p50: at(0.5), p95: at(0.95), p99: at(0.99), max: at(1) };
+}
+
+function report(mode, policies, rec, secs, ticks, decisions) {
+  const counts = {};
+  for (const p of policies) counts[p] = (counts[p] || 0) + 1;
+  const rate = (x) => Math.round((x / secs) * 10) / 10;
+  return {
+    mode,
+    agents: policies.length,
+    mix: counts,
+    seconds: Math.round(secs * 10) / 10,
+    ticks,
+    ticks_per_sec: rate(ticks),
+    round_ms: percentiles(rec.rounds),
+    think_ms: percentiles(rec.think),
+    observations_per_sec: rate(rec.observations),
+    actions_per_sec: rate(rec.actions),
+    decisions,
+    fallback_rate: decisions.asked
+      ? Math.round((decisions.timedOut / decisions.asked) * 1000) / 1000 : 0,
+  };
+}
+
+function diff(after, before) {
+  return { asked: after.asked - before.asked,
+           answered: after.answered - before.answered,
+           timedOut: after.timedOut - before.timedOut };
+}
+
+function makeFleet(dir, probes) {
+  const db = join(dir, "fleet.db");
+  const made = spawnSync(FLEET, ["--out", db, "--probes", String(probes),
+                                 "--seed", "42"], { stdio: "inherit" });
+  if (made.status !== 0) throw new Error(`bench_fleet failed (${FLEET})`);
+  return db;
+}
+
+/** Agents on a tick loop in this process, with no network between. */
+async function runInproc(cfg, db, makeAgent) {
+  const sim = await spawnSim({ seed: 42 });
+  try {
+    const loaded = await sendCommand(sim, { cmd: "load", path: db });
+    if (!loaded.ok) throw new Error(`load failed: ${loaded.error}`);
+    const status = await sendCommand(sim, { cmd: "status" });
+
+    clearAgents();
+    const ids = status.probes.slice(0, cfg.agents).map((p) => p.id);
+    for (const id of ids) {
+      const agent = makeAgent();
+      register(id, {
+        send(data) { agent.observe(JSON.parse(data), (a) => resolveAction(id, a)); },
+        close() {},
+      });
+    }
+
+    const loop = createTickLoop({ sim, tickRate: cfg.tickRate,
+                                  agentTimeout: cfg.agentTimeout,
+                                  pipeline: cfg.pipeline, slices: cfg.slices });
+    const from = status.tick;
+    const t0 = performance.now();
+    loop.start();
+    await new Promise((r) => setTimeout(r, cfg.seconds * 1000));
+    loop.stop();
+    return { ids, secs: (performance.now() - t0) / 1000,
+             ticks: loop.state.tick - from, decisions: agentStats() };
+  } finally {
+    clearAgents();
+    await stopSim(sim);
+  }
+}
+
+async function getJson(base, path, body) {
+  const init = body === undefined ? {} : {
+    method: "POST", headers: { "Content-Type": "application/json" },
+    body: JSON.stringify(body),
+  };
+  return (await fetch(base + path, init)).json();
+}
+
+/** Start the server on cfg.port and wait until it answers. */
+async function startServer(cfg) {
+  const args = ["run", SERVER, "--port", String(cfg.port),
+                "--tick-rate", String(cfg.tickRate),
+                "--agent-timeout", String(cfg.agentTimeout)];
+  if (cfg.pipeline) args.push("--pipeline");
+  if (cfg.slices) args.push("--slices");
+  const proc = spawn(process.execPath, args, { stdio: "ignore" });
+  const base = `http://localhost:${cfg.port}`;
+  for (let i = 0; i < 100; i++) {
+    try {
+      await getJson(base, "/api/state");
+      return { proc, base };
+    } catch (_) {
+      await new Promise((r) => setTimeout(r, 100));
+    }
+  }
+  proc.kill();
+  throw new Error(`server did not come up on ${base}`);
+}
+
+function connectAgent(wsUrl, probeId, agent) {
+  return new Promise((done, fail) => {
+    const ws = new WebSocket(wsUrl);
+    ws.onopen = () => ws.send(JSON.stringify({ type: "register", probe_id: probeId }));
+    ws.onmessage = (e) => {
+      const msg = JSON.parse(e.data);
+      if (msg.type === "registered") done(ws);
+      else if (msg.type === "observe") {
+        agent.observe(msg, (a) => {
+          if (ws.readyState === WebSocket.OPEN) ws.send(JSON.stringify(a));
+        });
+      }
+    };
+    ws.onerror = () => fail(new Error(`agent ${probeId} could not connect`));
+  });
+}
+
+/** Agents over WebSockets against a server at base. */
+async function runSockets(cfg, base, makeAgent) {
+  const list = await getJson(base, `/api/probes?fields=id&limit=${cfg.agents}`);
+  if (!list.ok) throw new Error(`probe list failed: ${list.error}`);
+  const ids = list.probes.map((p) => p.id);
+  const wsUrl = base.replace(/^http/, "ws") + "/ws";
+  const sockets = await Promise.all(
+    ids.map((id) => connectAgent(wsUrl, id, makeAgent())));
+
+  const before = await getJson(base, "/api/agents");
+  const from = (await getJson(base, "/api/state")).state.tick;
+  const t0 = performance.now();
+  await new Promise((r) => setTimeout(r, cfg.seconds * 1000));
+  const secs = (performance.now() - t0) / 1000;
+  const to = (await getJson(base, "/api/state")).state.tick;
+  const after = await getJson(base, "/api/agents");
+  for (const ws of sockets) ws.close();
+  return { ids, secs, ticks: to - from,
+           decisions: diff(after.decisions, before.decisions) };
+}
+
+const cfg = parseArgs(process.argv.slice(2));
+const responses = cfg.canned ? JSON.parse(readFileSync(cfg.canned, "utf8"))
+                             : undefined;
+const llm = createMockLlm({ responses, tokenMs: cfg.tokenMs,
+                            firstTokenMs: cfg.firstTokenMs });
+const rand = mulberry32(cfg.seed);
+const rec = createRecorder();
+const policies = assignPolicies(cfg.mix, cfg.agents);
+let made = 0;
+const makeAgent = () => swarmAgent(policies[made++ % policies.length],
+                                   cfg, llm, rand, rec);
+
+const dir = cfg.url ? null : mkdtempSync(join(tmpdir(), "universe-swarm-"));
+let server = null;
+try {
+  let run, mode;
+  if (cfg.url) {
+    mode = "ws";
+    run = await runSockets(cfg, cfg.url.replace(/\/$/, ""), makeAgent);
+  } else if (cfg.inproc) {
+    mode = "inproc";
+    run = await runInproc(cfg, makeFleet(dir, cfg.agents), makeAgent);
+  } else {
+    mode = "ws";
+    const db = makeFleet(dir, cfg.agents);
+    server = await startServer(cfg);
+    const loaded = await getJson(server.base, "/api/load", { path: db });
+    if (!loaded.ok) throw new Error(`load failed: ${loaded.error}`);
+    run = await runSockets(cfg, server.base, makeAgent);
+  }
+  rec.stopped = true;
+  console.log(JSON.stringify(report(mode, policies.slice(0, run.ids.length),
+                                    rec, run.secs, run.ticks, run.decisions)));
+} finally {
+  rec.stopped = true;
+  if (server) server.proc.kill();
+  if (dir) rmSync(dir, { recursive: true, force: true });
+}
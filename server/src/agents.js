@@ -4,24 +4,46 @@
  * register(probeId, ws)              → associate ws with probe
  * unregister(probeId)                → remove agent
  * unregisterByWs(ws)                 → remove agent by ws ref
- * getAgent(probeId)                  → { ws, pendingResolve } or undefined
+ * getAgent(probeId)                  → { ws, pendingResolve, queued } or undefined
  * listAgents()                       → array of connected probe IDs
- * sendObservation(probeId, obs)      → send observation to agent's ws
- * waitForAction(probeId, timeoutMs)  → Promise<action | fallback>
+ * sendObservation(probeId, obs, tick) → send observation to agent's ws; obs
+ *                                      may be the object's JSON text
+ * waitForAction(probeId, timeoutMs, tick) → Promise<action | fallback>
  * resolveAction(probeId, action)     → deliver action from agent
+ * setIdle(probeId, idle)             → mark the probe as on a standing order
+ * hasQueuedAction(probeId)           → true if an unasked-for action is held
+ * stats()                            → { asked, answered, timedOut }
+ *
+ * Each wait is for the observation of one tick. A reply that arrives
+ * after its wait timed out answers an observation that has since been
+ * replaced, so it is dropped rather than applied a round late. A reply
+ * carrying "tick" is matched exactly; one without is taken to answer
+ * the oldest observation still owed a reply.
+ *
+ * An action that arrives while nobody is waiting for one is held only if
+ * the probe is idle on a standing order, and answers the agent's next
+ * waitForAction(). That is how such an agent, which is not being asked,
+ * takes back control. Otherwise it is dropped.
  */
 
 const agents = new Map();
 
 const FALLBACK_ACTION = { action: "wait" };
 
+// Decisions asked of connected agents, and how each ended
+const counters = { asked: 0, answered: 0, timedOut: 0 };
+
 export function register(probeId, ws) {
   const existing = agents.get(probeId);
   if (existing && existing.ws !== ws) {
     // Replace old connection
     try { existing.ws.close(); } catch (_) {}
   }
-  agents.set(probeId, { ws, pendingResolve: null });
+  agents.set(probeId, {
+    ws, pendingResolve: null, queued: null, idle: false,
+    waitTick: -1,   // tick of the observation last waited on
+    owed: 0,        // timed-out waits whose reply has not come in
+  });
   ws._probeId = probeId;
 }
 
@@ -45,11 +67,15 @@ export function listAgents() {
   return [...agents.keys()];
 }
 
-export function sendObservation(probeId, obs) {
+export function sendObservation(probeId, obs, tick) {
   const agent = agents.get(probeId);
   if (!agent) return false;
+  const head = tick === undefined ? `{"type":"observe",`
+                                  : `{"type":"observe","tick":${tick},`;
   try {
-    agent.ws.send(JSON.stringify({ type: "observe", ...obs }));
+    agent.ws.send(typeof obs === "string"
+      ? head + obs.slice(1)
+      : head + JSON.stringify(obs).slice(1));
     return true;
   } catch (_) {
     unregister(probeId);
@@ -57,33 +83,78 @@ export function sendObservation(probeId, obs) {
   }
 }
 
-export function waitForAction(probeId, timeoutMs = 5000) {
+export function waitForAction(probeId, timeoutMs = 5000, tick = -1) {
   const agent = agents.get(probeId);
   if (!agent) return Promise.resolve(FALLBACK_ACTION);
+  counters.asked++;
+  agent.waitTick = tick;
+  if (agent.queued) {
+    const action = agent.queued;
+    agent.queued = null;
+    counters.answered++;
+    return Promise.resolve(action);
+  }
 
   return new Promise((resolve) => {
     const timer = setTimeout(() => {
-      if (agent.pendingResolve === resolve) agent.pendingResolve = null;
+      if (agent.pendingResolve === settle) agent.pendingResolve = null;
+      agent.owed++;
+      counters.timedOut++;
       resolve(FALLBACK_ACTION);
     }, timeoutMs);
 
-    agent.pendingResolve = (action) => {
+    const settle = (action) => {
       clearTimeout(timer);
       agent.pendingResolve = null;
+      counters.answered++;
       resolve(action);
     };
+    agent.pendingResolve = settle;
   });
 }
 
+/** True if action answers an observation whose wait already timed out. */
+function isLate(agent, action) {
+  if (typeof action.tick === "number") {
+    if (action.tick < agent.waitTick) {
+      if (agent.owed > 0) agent.owed--;
+      return true;
+    }
+    agent.owed = 0;   // caught up; anything older is matched by tick
+    return false;
+  }
+  if (agent.owed === 0) return false;
+  agent.owed--;
+  return true;
+}
+
 export function resolveAction(probeId, action) {
   const agent = agents.get(probeId);
-  if (agent && agent.pendingResolve) {
-    agent.pendingResolve(action);
+  if (!agent || isLate(agent, action)) return;
+  if (action.tick !== undefined) {
+    action = { ...action };
+    delete action.tick;
   }
+  if (agent.pendingResolve) agent.pendingResolve(action);
+  else if (agent.idle) agent.queued = action;
+}
+
+export function setIdle(probeId, idle) {
+  const agent = agents.get(probeId);
+  if (agent) agent.idle = idle;
+}
+
+export function hasQueuedAction(probeId) {
+  return !!agents.get(probeId)?.queued;
+}
+
+export function stats() {
+  return { ...counters };
 }
 
 export function clear() {
   agents.clear();
+  counters.asked = counters.answered = counters.timedOut = 0;
 }
 
 export { FALLBACK_ACTION };
@@ -5,7 +5,9 @@
  */
 
 import { sendCommand } from "./process.js";
-import { listAgents } from "./agents.js";
+import { listAgents, stats as agentStats } from "./agents.js";
+import { stats as dashboardStats } from "./dashboard.js";
+import { withObservations } from "./protocol.js";
 
 const json = (data, status = 200) =>
   new Response(JSON.stringify(data), {
@@ -13,6 +15,33 @@ const json = (data, status = 200) =>
     headers: { "Content-Type": "application/json" },
   });
 
+/** A tick or warp reply; sliced observations go out as they came. */
+const tickJson = (resp, status = 200) => {
+  if (resp.observationsJson === undefined) return json(resp, status);
+  const { observationsJson, slices, ...rest } = resp;
+  return new Response(withObservations(rest, observationsJson), {
+    status,
+    headers: { "Content-Type": "application/json" },
+  });
+};
+
+const QUERY_NAMES = ["status", "location"];
+const QUERY_NUMBERS = ["gen_min", "gen_max", "tech_domain", "tech_min",
+                       "offset", "limit"];
+const QUERY_BOXES = ["sector_min", "sector_max"];
+
+/** A sim query command from /api/probes search parameters. */
+function queryCommand(q) {
+  const cmd = { cmd: "query" };
+  for (const k of QUERY_NAMES) if (q.has(k)) cmd[k] = q.get(k);
+  for (const k of QUERY_NUMBERS) if (q.has(k)) cmd[k] = Number(q.get(k)) || 0;
+  for (const k of QUERY_BOXES) {
+    if (q.has(k)) cmd[k] = q.get(k).split(",").map((v) => Number(v) || 0);
+  }
+  if (q.has("fields")) cmd.fields = q.get("fields").split(",").filter(Boolean);
+  return cmd;
+}
+
 export async function handleAPI(url, req, { sim, tickLoop }) {
   const method = req.method;
   const path = url.pathname;
@@ -27,25 +56,41 @@ export async function handleAPI(url, req, { sim, tickLoop }) {
     return json(await sendCommand(sim, { cmd: "metrics" }));
   }
 
-  // GET /api/probes
+  // GET /api/probes?status=&location=&gen_min=&gen_max=&tech_domain=
+  //   &tech_min=&sector_min=x,y,z&sector_max=x,y,z&fields=a,b&offset=&limit=
   if (method === "GET" && path === "/api/probes") {
-    const status = await sendCommand(sim, { cmd: "status" });
-    return json({ ok: true, probes: status.probes });
+    const resp = await sendCommand(sim, queryCommand(url.searchParams));
+    return json(resp, resp.ok ? 200 : 400);
   }
 
   // GET /api/probes/:id
   if (method === "GET" && path.startsWith("/api/probes/")) {
     const id = path.slice("/api/probes/".length);
-    const status = await sendCommand(sim, { cmd: "status" });
-    const probe = status.probes?.find((p) => p.id === id);
-    if (!probe) return json({ ok: false, error: "probe not found" }, 404);
-    return json({ ok: true, probe });
+    const resp = await sendCommand(sim, { cmd: "probe", probe_id: id });
+    if (!resp.ok) return json(resp, 404);
+    return json({ ok: true, tick: resp.tick, probe: { id, ...resp.probe } });
   }
 
   // POST /api/tick — manual single tick
   if (method === "POST" && path === "/api/tick") {
     const resp = await tickLoop.once();
-    return json(resp);
+    return tickJson(resp);
+  }
+
+  // POST /api/warp — { until: T } or { ticks: N }
+  if (method === "POST" && path === "/api/warp") {
+    const body = await req.json().catch(() => ({}));
+    const resp = await tickLoop.warp(body);
+    return tickJson(resp, resp.ok ? 200 : 400);
+  }
+
+  // POST /api/run — { ticks: N, every: K } fast-forward, no observations
+  if (method === "POST" && path === "/api/run") {
+    const body = await req.json().catch(() => ({}));
+    const cmd = { cmd: "run", ticks: body.ticks };
+    if (body.every) cmd.every = body.every;
+    const resp = await sendCommand(sim, cmd);
+    return json(resp, resp.ok ? 200 : 400);
   }
 
   // POST /api/inject
@@ -72,9 +117,14 @@ export async function handleAPI(url, req, { sim, tickLoop }) {
     return json(await sendCommand(sim, { cmd: "config", data: body }));
   }
 
-  // GET /api/agents
+  // GET /api/agents — connected agents and decision counters
   if (method === "GET" && path === "/api/agents") {
-    return json({ ok: true, agents: listAgents() });
+    return json({ ok: true, agents: listAgents(), decisions: agentStats() });
+  }
+
+  // GET /api/dashboards — dashboard stream counters
+  if (method === "GET" && path === "/api/dashboards") {
+    return json({ ok: true, dashboards: dashboardStats() });
   }
 
   // POST /api/pause
@@ -140,15 +190,23 @@ export async function handleAPI(url, req, { sim, tickLoop }) {
     return json(await sendCommand(sim, { cmd: "scenario" }));
   }
 
-  // GET /api/lineage
+  // GET /api/lineage?offset=N&limit=M&root=hi-lo
   if (method === "GET" && path === "/api/lineage") {
-    return json(await sendCommand(sim, { cmd: "lineage" }));
+    const cmd = { cmd: "lineage" };
+    const q = url.searchParams;
+    if (q.has("offset")) cmd.offset = Number(q.get("offset")) || 0;
+    if (q.has("limit")) cmd.limit = Number(q.get("limit")) || 0;
+    if (q.has("root")) cmd.root = q.get("root");
+    return json(await sendCommand(sim, cmd));
   }
 
-  // GET /api/history/:probeId
+  // GET /api/history/:probeId?offset=N&limit=M
   if (method === "GET" && path.startsWith("/api/history/")) {
-    const probeId = path.slice("/api/history/".length);
-    return json(await sendCommand(sim, { cmd: "history", probe_id: probeId }));
+    const cmd = { cmd: "history", probe_id: path.slice("/api/history/".length) };
+    const q = url.searchParams;
+    if (q.has("offset")) cmd.offset = Number(q.get("offset")) || 0;
+    if (q.has("limit")) cmd.limit = Number(q.get("limit")) || 0;
+    return json(await sendCommand(sim, cmd));
   }
 
   return json({ ok: false, error: "not found" }, 404);
@@ -1,25 +1,147 @@
 /**
  * dashboard.js — Dashboard subscriber management.
  *
- * Maintains a set of WebSocket clients that receive tick broadcasts.
- * No registration needed — just connect to /ws/dashboard.
+ * Clients connect to /ws/dashboard and get at most one frame per tick,
+ * in one of two tiers:
+ *   summary (default) {"type":"summary",...}: metrics, one row per probe
+ *                     and the newest events, encoded once per tick and
+ *                     shared by every client
+ *   full              {"type":"tick",...}: the tick event with every
+ *                     observation
+ * Full detail is otherwise sent only on request: {"type":"watch",
+ * "probe_ids":[...]} makes each frame that client gets be followed by
+ * {"type":"detail",...} with those probes' observations.
+ *
+ * A client gets no more than its fps, capped at the server's maxFps (0
+ * for no cap), and nothing while more than maxBuffered bytes sit in its
+ * socket. Frames that arrive meanwhile replace one another; it gets the
+ * newest once it is due and has drained.
+ *
+ * configure({ maxFps, maxBuffered })
+ * addClient(ws, { tier, fps }?)  → subscribe a socket
+ * removeClient(ws)
+ * handleMessage(ws, msg)        → {"type":"subscribe","tier","fps"} or
+ *                                 {"type":"watch","probe_ids"}
+ * broadcast(tickEvent)
+ * watchedProbes()               → probes some client is watching
+ * stats()                       → { clients, encoded, sent, dropped }
  */
 
-const clients = new Set();
+import { withObservations } from "./protocol.js";
+
+const DRAIN_POLL_MS = 50;     // recheck interval for a backed-up socket
+const MAX_WATCH = 16;         // watched probes per client
+
+const clients = new Map();    // ws → client state
+let maxFps = 10;
+let maxBuffered = 1 << 20;
+const counters = { encoded: 0, sent: 0, dropped: 0 };
+
+export function configure(opts = {}) {
+  if (opts.maxFps >= 0) maxFps = opts.maxFps;
+  if (opts.maxBuffered > 0) maxBuffered = opts.maxBuffered;
+}
 
-export function addClient(ws) {
-  clients.add(ws);
+export function addClient(ws, opts = {}) {
+  const c = { ws, tier: "summary", fps: maxFps, watch: new Set(),
+              lastSent: -Infinity, pending: null, timer: null };
+  clients.set(ws, c);
+  subscribe(c, opts);
 }
 
 export function removeClient(ws) {
+  const c = clients.get(ws);
+  if (c && c.timer) clearTimeout(c.timer);
   clients.delete(ws);
 }
 
+function subscribe(c, { tier, fps }) {
+  if (tier === "summary" || tier === "full") c.tier = tier;
+  const n = Number(fps);
+  if (n > 0) c.fps = maxFps > 0 ? Math.min(n, maxFps) : n;
+}
+
+export function handleMessage(ws, msg) {
+  const c = clients.get(ws);
+  if (!c || !msg) return;
+  if (msg.type === "subscribe") subscribe(c, msg);
+  else if (msg.type === "watch" && Array.isArray(msg.probe_ids)) {
+    c.watch = new Set(msg.probe_ids.filter((id) => typeof id === "string")
+                                   .slice(0, MAX_WATCH));
+  }
+}
+
+export function watchedProbes() {
+  const ids = new Set();
+  for (const c of clients.values()) for (const id of c.watch) ids.add(id);
+  return [...ids];
+}
+
+/** One tick's frames, each encoded the first time a client needs it. */
+function frameSet(event) {
+  const { tick, agents, warp } = event;
+  const cache = new Map();
+  const once = (key, encode) => {
+    if (!cache.has(key)) {
+      const frame = encode();
+      cache.set(key, frame);
+      if (frame !== null) counters.encoded++;
+    }
+    return cache.get(key);
+  };
+  return {
+    summary: () => once("summary", () =>
+      JSON.stringify({ type: "summary", tick, agents, warp, ...event.summary })),
+    full: () => once("full", () => {
+      const { observationsJson, slices, summary, ...rest } = event;
+      return observationsJson === undefined
+        ? JSON.stringify({ type: "tick", ...rest })
+        : withObservations({ type: "tick", ...rest }, observationsJson);
+    }),
+    detail: (id) => once(`detail:${id}`, () => {
+      const head = { type: "detail", tick, probe_id: id };
+      const raw = event.slices?.get(id)?.json;
+      if (raw !== undefined) {
+        return `${JSON.stringify(head).slice(0, -1)},"observation":${raw}}`;
+      }
+      const obs = event.observations?.find((o) => o.probe_id === id);
+      return obs ? JSON.stringify({ ...head, observation: obs }) : null;
+    }),
+  };
+}
+
 export function broadcast(tickEvent) {
-  const msg = JSON.stringify({ type: "tick", ...tickEvent });
-  for (const ws of clients) {
-    try { ws.send(msg); }
-    catch (_) { clients.delete(ws); }
+  const frames = frameSet(tickEvent);
+  for (const c of clients.values()) {
+    if (c.pending) counters.dropped++;
+    c.pending = frames;
+    if (!c.timer) flush(c);
+  }
+}
+
+/** Send c its newest frame if it is due and drained, else try later. */
+function flush(c) {
+  c.timer = null;
+  if (!c.pending) return;
+  const due = c.fps > 0 ? c.lastSent + 1000 / c.fps - performance.now() : 0;
+  const backedUp = (c.ws.getBufferedAmount?.() ?? 0) > maxBuffered;
+  const wait = Math.max(due, backedUp ? DRAIN_POLL_MS : 0);
+  if (wait > 0) {
+    c.timer = setTimeout(() => flush(c), wait);
+    return;
+  }
+  const frames = c.pending;
+  c.pending = null;
+  try {
+    c.ws.send(c.tier === "full" ? frames.full() : frames.summary());
+    for (const id of c.watch) {
+      const detail = frames.detail(id);
+      if (detail) c.ws.send(detail);
+    }
+    c.lastSent = performance.now();
+    counters.sent++;
+  } catch (_) {
+    removeClient(c.ws);
   }
 }
 
@@ -27,6 +149,12 @@ export function clientCount() {
   return clients.size;
 }
 
+export function stats() {
+  return { clients: clients.size, ...counters };
+}
+
 export function clear() {
+  for (const c of clients.values()) if (c.timer) clearTimeout(c.timer);
   clients.clear();
+  counters.encoded = counters.sent = counters.dropped = 0;
 }
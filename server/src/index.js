@@ -4,23 +4,37 @@
  * Spawns the C simulation, starts tick loop, serves WebSocket + REST.
  *
  * Usage: bun run src/index.js [--seed N] [--port N] [--tick-rate N] [--agent-timeout N]
+ *                             [--warp-span N] [--age N] [--lod N] [--pipeline]
+ *                             [--slices] [--dash-fps N] [--dash-buffer N]
  */
 
-import { spawnSim, stopSim } from "./process.js";
+import { spawnSim, stopSim, sendCommand } from "./process.js";
 import { createTickLoop } from "./tick.js";
 import { handleAPI } from "./api.js";
 import { register, unregisterByWs, resolveAction } from "./agents.js";
-import { addClient, removeClient, broadcast } from "./dashboard.js";
+import {
+  configure as configureDashboard, addClient, removeClient, handleMessage,
+  broadcast, watchedProbes
+} from "./dashboard.js";
 
 /* ---- CLI args ---- */
 
 function parseArgs(args) {
-  const cfg = { seed: 42, port: 8000, tickRate: 10, agentTimeout: 5000 };
+  const cfg = { seed: 42, port: 8000, tickRate: 10, agentTimeout: 5000, warpSpan: 0,
+                age: 0, lod: 0, pipeline: false, slices: false,
+                dashFps: 10, dashBuffer: 1 << 20 };
   for (let i = 0; i < args.length; i++) {
     if (args[i] === "--seed" && args[i + 1]) cfg.seed = +args[++i];
     if (args[i] === "--port" && args[i + 1]) cfg.port = +args[++i];
     if (args[i] === "--tick-rate" && args[i + 1]) cfg.tickRate = +args[++i];
     if (args[i] === "--agent-timeout" && args[i + 1]) cfg.agentTimeout = +args[++i];
+    if (args[i] === "--warp-span" && args[i + 1]) cfg.warpSpan = +args[++i];
+    if (args[i] === "--age" && args[i + 1]) cfg.age = +args[++i];
+    if (args[i] === "--lod" && args[i + 1]) cfg.lod = +args[++i];
+    if (args[i] === "--pipeline") cfg.pipeline = true;
+    if (args[i] === "--slices") cfg.slices = true;
+    if (args[i] === "--dash-fps" && args[i + 1]) cfg.dashFps = +args[++i];
+    if (args[i] === "--dash-buffer" && args[i + 1]) cfg.dashBuffer = +args[++i];
   }
   return cfg;
 }
@@ -33,12 +47,33 @@ console.log(`[universe] starting sim seed=${cfg.seed}`);
 const sim = await spawnSim({ seed: cfg.seed });
 console.log(`[universe] sim ready, tick=0`);
 
+if (cfg.lod > 0) {
+  await sendCommand(sim, { cmd: "lod", cadence: cfg.lod });
+  console.log(`[universe] LOD on: agentless probes update every ${cfg.lod} ticks`);
+}
+
+if (cfg.age > 0) {
+  const every = Math.max(1, Math.round(cfg.age / 10));
+  const aged = await sendCommand(sim, { cmd: "run", ticks: cfg.age, every }, {
+    onProgress: (p) => console.log(`[universe] aging: tick ${p.tick}/${cfg.age}`),
+  });
+  console.log(`[universe] aged to tick=${aged.tick} ` +
+              `(${aged.run.ticks_per_sec} ticks/s)`);
+}
+
 const tickLoop = createTickLoop({
   sim,
   tickRate: cfg.tickRate,
   agentTimeout: cfg.agentTimeout,
+  warpSpan: cfg.warpSpan,
+  pipeline: cfg.pipeline,
+  slices: cfg.slices,
+  summary: true,
+  watched: watchedProbes,
 });
 
+configureDashboard({ maxFps: cfg.dashFps, maxBuffered: cfg.dashBuffer });
+
 tickLoop.on("tick", (e) => broadcast(e));
 
 tickLoop.on("error", (e) => {
@@ -59,7 +94,9 @@ const server = Bun.serve({
     }
 
     if (url.pathname === "/ws/dashboard") {
-      if (server.upgrade(req, { data: { type: "dashboard" } })) return;
+      const subscribe = { tier: url.searchParams.get("tier"),
+                          fps: url.searchParams.get("fps") };
+      if (server.upgrade(req, { data: { type: "dashboard", subscribe } })) return;
       return new Response("WebSocket upgrade failed", { status: 400 });
     }
 
@@ -73,13 +110,15 @@ const server = Bun.serve({
 
   websocket: {
     open(ws) {
-      if (ws.data?.type === "dashboard") addClient(ws);
+      if (ws.data?.type === "dashboard") addClient(ws, ws.data.subscribe);
     },
 
     message(ws, msg) {
       try {
         const data = JSON.parse(msg);
-        if (data.type === "register" && data.probe_id) {
+        if (ws.data?.type === "dashboard") {
+          handleMessage(ws, data);
+        } else if (data.type === "register" && data.probe_id) {
           register(data.probe_id, ws);
           ws.send(JSON.stringify({ type: "registered", probe_id: data.probe_id }));
         } else if (data.action || data.actions) {
@@ -101,7 +140,8 @@ console.log(`[universe] WebSocket agents: ws://localhost:${server.port}/ws`);
 console.log(`[universe] Dashboard stream: ws://localhost:${server.port}/ws/dashboard`);
 
 tickLoop.start();
-console.log(`[universe] tick loop started (rate=${cfg.tickRate}/s, timeout=${cfg.agentTimeout}ms)`);
+console.log(`[universe] tick loop started (rate=${cfg.tickRate}/s, timeout=${cfg.agentTimeout}ms` +
+            `${cfg.pipeline ? ", pipelined" : ""}${cfg.slices ? ", sliced" : ""})`);
 
 /* ---- Graceful shutdown ---- */
 
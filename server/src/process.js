@@ -2,7 +2,10 @@
  * process.js — Spawn C simulation, communicate via JSON pipes.
  *
  * spawnSim({ seed, simPath })  → sim handle with .send() helper
- * sendCommand(sim, cmd)        → parsed JSON response
+ * sendCommand(sim, cmd, opts?) → parsed JSON response; opts.onProgress
+ *                                receives {"progress":...} records sent
+ *                                ahead of it (run with "every"). Commands
+ *                                are queued, one in flight per sim.
  * stopSim(sim, timeoutMs?)     → clean shutdown
  */
 
@@ -29,16 +32,31 @@ export async function spawnSim({ seed = 42, simPath = DEFAULT_SIM_PATH } = {}) {
   }
 
   const sim = { proc, reader, readyMsg };
-  sim.send = (cmd) => sendCommand(sim, cmd);
+  sim.send = (cmd, opts) => sendCommand(sim, cmd, opts);
   return sim;
 }
 
-export async function sendCommand(sim, cmd) {
+export function sendCommand(sim, cmd, opts) {
+  // The pipe answers in order and has one reader, so the tick loop and
+  // REST handlers take turns rather than racing for the next line.
+  const exchange = () => roundTrip(sim, cmd, opts);
+  const result = (sim.busy || Promise.resolve()).then(exchange, exchange);
+  sim.busy = result.catch(() => {});
+  return result;
+}
+
+async function roundTrip(sim, cmd, { onProgress } = {}) {
   writeLine(sim.proc.stdin, cmd);
   await sim.proc.stdin.flush();
-  const resp = await sim.reader.next();
-  if (resp === null) throw new Error("sim closed unexpectedly");
-  return resp;
+  for (;;) {
+    const resp = await sim.reader.next();
+    if (resp === null) throw new Error("sim closed unexpectedly");
+    if (resp.ok === undefined && resp.progress) {
+      if (onProgress) onProgress(resp.progress);
+      continue;
+    }
+    return resp;
+  }
 }
 
 export async function stopSim(sim, timeoutMs = 3000) {
@@ -3,31 +3,56 @@
  *
  * createLineReader(readableStream) → { next() } async iterator yielding parsed JSON.
  * writeLine(writer, obj)           → writes JSON + newline.
+ * parseLine(line)                  → one response line; sliced replies come
+ *                                    back with raw per-probe observations
+ * withObservations(obj, json)      → JSON text of obj plus a pre-serialized
+ *                                    "observations" array
+ *
+ * A tick or warp sent with "slices": true is answered with the byte range
+ * of each probe's object inside the "observations" array:
+ *
+ *   {"ok":true,"tick":5,"observations":[{...},{...}],
+ *    "slices":{"1-1":[1,2561,1],"1-2":[2563,2498,0]}}
+ *
+ * parseLine() parses only the small parts around the array and returns
+ *   { ok, tick, ..., observationsJson, slices: Map(id → { json, input }) }
+ * where json is that probe's observation text and input is false while
+ * the probe is on a standing order.
  */
 
+const OBS_KEY = ',"observations":';
+const SLICES_KEY = ',"slices":{';
+
 export function createLineReader(stream) {
-  let buf = "";
+  let parts = [];      // text of the current line so far, one piece per chunk
   const queue = [];
   let waitResolve = null;
   let done = false;
 
   const decoder = new TextDecoder();
 
+  function deliver(line) {
+    if (!line) return;
+    try {
+      const obj = parseLine(line);
+      if (waitResolve) { const r = waitResolve; waitResolve = null; r(obj); }
+      else queue.push(obj);
+    } catch (_) { /* skip malformed lines */ }
+  }
+
   (async () => {
     try {
       for await (const chunk of stream) {
-        buf += typeof chunk === "string" ? chunk : decoder.decode(chunk, { stream: true });
-        let nl;
-        while ((nl = buf.indexOf("\n")) !== -1) {
-          const line = buf.slice(0, nl).trim();
-          buf = buf.slice(nl + 1);
-          if (!line) continue;
-          try {
-            const obj = JSON.parse(line);
-            if (waitResolve) { const r = waitResolve; waitResolve = null; r(obj); }
-            else queue.push(obj);
-          } catch (_) { /* skip malformed lines */ }
+        const text = typeof chunk === "string" ? chunk : decoder.decode(chunk, { stream: true });
+        // Only the new text is searched: a tick reply can run to megabytes
+        let from = 0, nl;
+        while ((nl = text.indexOf("\n", from)) !== -1) {
+          parts.push(text.slice(from, nl));
+          deliver(parts.join("").trim());
+          parts = [];
+          from = nl + 1;
         }
+        if (from < text.length) parts.push(text.slice(from));
       }
     } catch (_) { /* stream error */ }
     done = true;
@@ -46,3 +71,30 @@ export function createLineReader(stream) {
 export function writeLine(writer, obj) {
   writer.write(JSON.stringify(obj) + "\n");
 }
+
+export function parseLine(line) {
+  const at = line.indexOf(OBS_KEY);
+  const end = at < 0 ? -1 : line.lastIndexOf(SLICES_KEY);
+  if (end < 0 || end < at) return JSON.parse(line);
+
+  const resp = JSON.parse(line.slice(0, at) + line.slice(end));
+  const observationsJson = line.slice(at + OBS_KEY.length, end);
+  const slices = new Map();
+  // Offsets count bytes, which index the string only while it is ASCII
+  const bytes = Buffer.byteLength(observationsJson) === observationsJson.length
+    ? null : Buffer.from(observationsJson);
+  for (const [id, [off, len, input]] of Object.entries(resp.slices)) {
+    const json = bytes ? bytes.toString("utf8", off, off + len)
+                       : observationsJson.substr(off, len);
+    slices.set(id, { json, input: input !== 0 });
+  }
+  resp.observationsJson = observationsJson;
+  resp.slices = slices;
+  return resp;
+}
+
+export function withObservations(obj, observationsJson) {
+  const head = JSON.stringify(obj);
+  const sep = head === "{}" ? "" : ",";
+  return `${head.slice(0, -1)}${sep}"observations":${observationsJson}}`;
+}
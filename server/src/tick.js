@@ -1,28 +1,71 @@
 /**
  * tick.js — Tick coordinator with agent synchronization.
  *
- * createTickLoop({ sim, tickRate, agentTimeout })
- *   → { start(), stop(), pause(), resume(), once(), on(event, fn), state }
+ * createTickLoop({ sim, tickRate, agentTimeout, warpSpan, pipeline, slices,
+ *                  summary, watched })
+ *   → { start(), stop(), pause(), resume(), once(), warp(target),
+ *       on(event, fn), state }
  *
  * Each tick:
- *  1. Send observations from last tick to connected agents
- *  2. Wait for agent actions (with timeout → fallback)
+ *  1. Send observations from last tick to connected agents that have a
+ *     decision to make
+ *  2. Wait for their actions (with timeout → fallback)
  *  3. Build actions object, send tick command to sim
  *  4. Store observations for next iteration
  *  5. Emit "tick" event for dashboard subscribers
+ *
+ * With warpSpan > 0, a round in which every agent waits sends a warp
+ * instead: the sim runs up to warpSpan ticks without stopping for
+ * observations, until something happens that an agent would react to.
+ *
+ * An agent whose probe is on a standing order (its observation says
+ * "input_needed": false) is neither sent observations nor waited for;
+ * the sim carries the order out and asks again when it ends. An action
+ * the agent sends anyway is held and used the next round. Actions nobody
+ * asked for from other agents, and replies that come in after their
+ * round timed out, are dropped (see agents.js).
+ *
+ * With pipeline set, steps 1–2 and step 3 overlap: the sim runs tick N
+ * with the actions gathered in the previous round while agents answer
+ * tick N-1's observations, so an action lands one tick later than in
+ * lockstep. A round closes as soon as the sim and every agent asked
+ * have answered; tickRate only caps the rate. Tick events are emitted
+ * after the next round is under way.
+ *
+ * With slices set, the sim serializes observations only for probes with
+ * a connected agent and says where each one lies in the reply, and each
+ * agent is forwarded its slice of the text as it stands. Tick events then
+ * carry observationsJson, the raw array, in place of observations, and
+ * the slices. watched() names more probes to observe, for dashboards.
+ *
+ * With summary set, the sim adds a compact per-probe summary to each
+ * reply, covering every probe, and tick events carry it as summary.
  */
 
 import { sendCommand } from "./process.js";
 import {
-  listAgents, sendObservation, waitForAction, FALLBACK_ACTION
+  listAgents, sendObservation, waitForAction, hasQueuedAction, setIdle,
+  FALLBACK_ACTION
 } from "./agents.js";
 
-export function createTickLoop({ sim, tickRate = 10, agentTimeout = 5000 } = {}) {
+const isWait = (a) =>
+  !a || (a.actions === undefined && (a.action === undefined || a.action === "wait"));
+
+const RATE_WINDOW = 20;   // rounds behind state.ticksPerSec
+
+export function createTickLoop({
+  sim, tickRate = 10, agentTimeout = 5000, warpSpan = 0, pipeline = false,
+  slices = false, summary = false, watched = () => []
+} = {}) {
   let timer = null;
   let running = false;
   let paused = false;
-  let lastObservations = null; // map: probeId → observation
+  let lastObservations = null; // map: probeId → observation, or its JSON
+  let idle = new Set();        // probes on a standing order
   let tickCount = 0;
+  let pendingActions = {};     // pipeline: gathered last round
+  let roundStart = 0;
+  const recent = [];           // [ms, tick] per round, for the rate
   const listeners = { tick: [], error: [] };
 
   function emit(event, data) {
@@ -31,24 +74,29 @@ export function createTickLoop({ sim, tickRate = 10, agentTimeout = 5000 } = {})
     }
   }
 
-  async function executeTick() {
-    // 1. Send observations to connected agents
-    const connectedAgents = listAgents();
+  /** Agents are asked once they have something to answer. */
+  function needsInput(probeId) {
+    if (hasQueuedAction(probeId)) return true;
+    return !!lastObservations && lastObservations.has(probeId)
+      && !idle.has(probeId);
+  }
+
+  /** Steps 1–2: ask the agents that have a decision to make. */
+  async function gather(deciding) {
+    const tick = tickCount;   // the tick lastObservations describe
     if (lastObservations) {
-      for (const probeId of connectedAgents) {
+      for (const probeId of deciding) {
         const obs = lastObservations.get(probeId);
-        if (obs) sendObservation(probeId, obs);
+        if (obs) sendObservation(probeId, obs, tick);
       }
     }
 
-    // 2. Wait for actions from all connected agents
-    const actionPromises = connectedAgents.map(async (probeId) => {
-      const action = await waitForAction(probeId, agentTimeout);
+    const actionPromises = deciding.map(async (probeId) => {
+      const action = await waitForAction(probeId, agentTimeout, tick);
       return { probeId, action };
     });
     const results = await Promise.allSettled(actionPromises);
 
-    // 3. Build actions object
     const actions = {};
     for (const result of results) {
       if (result.status === "fulfilled") {
@@ -56,38 +104,108 @@ export function createTickLoop({ sim, tickRate = 10, agentTimeout = 5000 } = {})
         actions[probeId] = action || FALLBACK_ACTION;
       }
     }
+    return actions;
+  }
 
-    // 4. Send tick to sim
-    const resp = await sendCommand(sim, { cmd: "tick", actions });
+  /** A tick with these actions, or a warp if nobody has anything to do. */
+  function commandFor(actions) {
+    const quiet = warpSpan > 0 && Object.values(actions).every(isWait);
+    return observing(quiet ? { cmd: "warp", ticks: warpSpan }
+                           : { cmd: "tick", actions });
+  }
+
+  /** Ask only for what connected agents will read, if slicing. */
+  function observing(cmd) {
+    if (slices) {
+      cmd.observe = [...new Set([...listAgents(), ...watched()])];
+      cmd.slices = true;
+    }
+    if (summary) cmd.summary = true;
+    return cmd;
+  }
+
+  async function executeTick() {
+    const connectedAgents = listAgents();
+    const deciding = connectedAgents.filter(needsInput);
+    const actions = await gather(deciding);
+    return applyResponse(await sendCommand(sim, commandFor(actions)),
+                         connectedAgents.length, deciding.length);
+  }
+
+  async function executePipelined() {
+    const connectedAgents = listAgents();
+    const deciding = connectedAgents.filter(needsInput);
+    const asking = gather(deciding);
+    const ticking = sendCommand(sim, commandFor(pendingActions));
+    const [resp, actions] = await Promise.all([ticking, asking]);
+    pendingActions = actions;
+    return applyResponse(resp, connectedAgents.length, deciding.length);
+  }
+
+  function applyResponse(resp, connected, deciding = connected) {
     if (!resp.ok) {
       emit("error", { tick: tickCount, error: resp.error });
       return resp;
     }
     tickCount = resp.tick;
+    recent.push([performance.now(), resp.tick]);
+    if (recent.length > RATE_WINDOW) recent.shift();
 
     // 5. Index observations by probe_id for next iteration
     lastObservations = new Map();
-    for (const obs of resp.observations || []) {
-      lastObservations.set(obs.probe_id, obs);
+    idle = new Set();
+    if (resp.slices) {
+      for (const [probeId, { json, input }] of resp.slices) {
+        lastObservations.set(probeId, json);
+        if (!input) idle.add(probeId);
+      }
+    } else {
+      for (const obs of resp.observations || []) {
+        lastObservations.set(obs.probe_id, obs);
+        if (obs.input_needed === false) idle.add(obs.probe_id);
+      }
     }
+    for (const probeId of listAgents()) setIdle(probeId, idle.has(probeId));
 
     // 6. Emit tick event
-    emit("tick", {
-      tick: resp.tick,
-      observations: resp.observations,
-      agents: { connected: connectedAgents.length }
-    });
+    const event = { tick: resp.tick };
+    if (resp.slices) {
+      event.observationsJson = resp.observationsJson;
+      event.slices = resp.slices;
+    } else {
+      event.observations = resp.observations;
+    }
+    event.agents = { connected, deciding };
+    if (resp.summary) event.summary = resp.summary;
+    if (resp.warp) event.warp = resp.warp;
+    if (pipeline) setImmediate(() => emit("tick", event));
+    else emit("tick", event);
 
     return resp;
   }
 
+  function ticksPerSec() {
+    if (recent.length < 2) return 0;
+    const [t0, k0] = recent[0];
+    const [t1, k1] = recent[recent.length - 1];
+    return t1 > t0 ? Math.round(((k1 - k0) * 1000 / (t1 - t0)) * 10) / 10 : 0;
+  }
+
   function scheduleNext() {
     if (!running || paused || tickRate <= 0) return;
     const interval = Math.max(1, Math.round(1000 / tickRate));
+    // Lockstep sleeps a whole interval between rounds; a pipelined round
+    // starts once the last one closed, no sooner than tickRate allows.
+    const delay = pipeline
+      ? Math.max(0, roundStart + interval - performance.now())
+      : interval;
     timer = setTimeout(async () => {
-      try { await executeTick(); } catch (e) { emit("error", e); }
+      roundStart = performance.now();
+      try {
+        await (pipeline ? executePipelined() : executeTick());
+      } catch (e) { emit("error", e); }
       scheduleNext();
-    }, interval);
+    }, delay);
   }
 
   return {
@@ -108,12 +226,22 @@ export function createTickLoop({ sim, tickRate = 10, agentTimeout = 5000 } = {})
     resume() { if (paused) { paused = false; if (running) scheduleNext(); } },
 
     /** Execute exactly one tick (works even when stopped/paused). */
-    async once() { return executeTick(); },
+    async once() { return pipeline ? executePipelined() : executeTick(); },
+
+    /** Warp to { until } or by { ticks }, stopping early for events. */
+    async warp({ until, ticks } = {}) {
+      const cmd = { cmd: "warp" };
+      if (until !== undefined) cmd.until = until;
+      if (ticks !== undefined) cmd.ticks = ticks;
+      return applyResponse(await sendCommand(sim, observing(cmd)),
+                           listAgents().length);
+    },
 
     on(event, fn) { (listeners[event] = listeners[event] || []).push(fn); },
 
     get state() {
-      return { running, paused, tick: tickCount, agents: listAgents().length };
+      return { running, paused, tick: tickCount, agents: listAgents().length,
+               pipeline, slices, ticksPerSec: ticksPerSec() };
     }
   };
 }
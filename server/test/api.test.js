@@ -105,6 +105,37 @@ describe("REST API", () => {
     expect(r.error).toContain("not found");
   });
 
+  test("GET /api/probes/:id — full observation", async () => {
+    const r = await get("/api/probes/1-1");
+    expect(r.probe.id).toBe("1-1");
+    expect(r.probe.probe_id).toBe("1-1");
+    expect(r.probe.resources).toBeDefined();
+  });
+
+  test("GET /api/probes — filters, fields and pages", async () => {
+    const hit = await get("/api/probes?status=active&gen_max=0&fields=hull,tech");
+    expect(hit.total).toBe(1);
+    expect(Object.keys(hit.probes[0]).sort()).toEqual(["hull", "id", "tech"]);
+
+    const miss = await get("/api/probes?tech_domain=0&tech_min=99");
+    expect(miss.total).toBe(0);
+    expect(miss.probes).toEqual([]);
+
+    const box = await get("/api/probes?sector_min=0,0,0&sector_max=0,0,0&limit=0");
+    expect(box.probes).toEqual([]);
+    expect(box.next).toBe(0);
+
+    const res = await fetch(`http://localhost:${port}/api/probes?status=lost`);
+    expect(res.status).toBe(400);
+  });
+
+  test("GET /api/history/:id — paged", async () => {
+    const all = await get("/api/history/1-1");
+    const page = await get("/api/history/1-1?offset=1&limit=1");
+    expect(page.total).toBe(all.total);
+    expect(page.events).toEqual(all.events.slice(1, 2));
+  });
+
   test("POST /api/tick — manual tick", async () => {
     const r = await post("/api/tick");
     expect(r.ok).toBe(true);
@@ -112,6 +143,33 @@ describe("REST API", () => {
     expect(r.observations.length).toBe(1);
   });
 
+  test("POST /api/warp — warp by ticks", async () => {
+    const before = (await get("/api/status")).tick;
+    const r = await post("/api/warp", { ticks: 5 });
+    expect(r.ok).toBe(true);
+    expect(r.tick).toBeGreaterThan(before);
+    expect(r.tick).toBeLessThanOrEqual(before + 5);
+    expect(typeof r.warp.ticks_per_sec).toBe("number");
+  });
+
+  test("POST /api/warp — rejects a target in the past", async () => {
+    const res = await fetch(`http://localhost:${port}/api/warp`, {
+      method: "POST",
+      headers: { "Content-Type": "application/json" },
+      body: JSON.stringify({ until: 0 }),
+    });
+    expect(res.status).toBe(400);
+  });
+
+  test("POST /api/run — fast-forward without observations", async () => {
+    const before = (await get("/api/status")).tick;
+    const r = await post("/api/run", { ticks: 50, every: 10 });
+    expect(r.ok).toBe(true);
+    expect(r.tick).toBe(before + 50);
+    expect(r.observations).toBeUndefined();
+    expect(typeof r.run.ticks_per_sec).toBe("number");
+  });
+
   test("GET /api/metrics", async () => {
     const r = await get("/api/metrics");
     expect(r.ok).toBe(true);
@@ -153,6 +211,7 @@ describe("REST API", () => {
     const r = await get("/api/agents");
     expect(r.ok).toBe(true);
     expect(Array.isArray(r.agents)).toBe(true);
+    expect(r.decisions).toEqual({ asked: 0, answered: 0, timedOut: 0 });
   });
 
   test("POST /api/pause + POST /api/resume", async () => {
@@ -0,0 +1,143 @@
+import { test, expect, describe, beforeEach, afterEach } from "bun:test";
+import { spawnSim, stopSim } from "../src/process.js";
+import { createTickLoop } from "../src/tick.js";
+import {
+  configure, addClient, removeClient, handleMessage, broadcast,
+  watchedProbes, stats, clear
+} from "../src/dashboard.js";
+
+/** Mock dashboard socket with a settable send backlog. */
+function mockWs() {
+  const sent = [];
+  return {
+    sent,
+    buffered: 0,
+    send(data) { sent.push(data); },
+    getBufferedAmount() { return this.buffered; },
+    close() {},
+  };
+}
+
+const frames = (ws) => ws.sent.map((d) => JSON.parse(d));
+const sleep = (ms) => new Promise((r) => setTimeout(r, ms));
+
+function tickEvent(tick) {
+  return {
+    tick,
+    observations: [{ probe_id: "1-1", name: "Bob", hull: 1 },
+                   { probe_id: "1-2", name: "Bob-2", hull: 0.5 }],
+    agents: { connected: 0, deciding: 0 },
+    summary: { probes: [["1-1", "Bob"], ["1-2", "Bob-2"]], events: [] },
+  };
+}
+
+beforeEach(() => {
+  clear();
+  configure({ maxFps: 0, maxBuffered: 1 << 20 });
+});
+
+afterEach(() => clear());
+
+describe("dashboard stream", () => {
+  test("100 clients share one summary encoding per tick", () => {
+    const socks = Array.from({ length: 100 }, () => mockWs());
+    for (const ws of socks) addClient(ws);
+    broadcast(tickEvent(1));
+
+    expect(stats()).toMatchObject({ clients: 100, encoded: 1, sent: 100 });
+    for (const ws of socks) expect(ws.sent).toEqual(socks[0].sent);
+    const [frame] = frames(socks[0]);
+    expect(frame.type).toBe("summary");
+    expect(frame.probes.length).toBe(2);
+    expect(frame.observations).toBeUndefined();
+  });
+
+  test("full detail only for clients that ask", () => {
+    const summary = mockWs(), full = mockWs(), watcher = mockWs();
+    addClient(summary);
+    addClient(full, { tier: "full" });
+    addClient(watcher);
+    handleMessage(watcher, { type: "watch", probe_ids: ["1-2", "9-9"] });
+    expect(watchedProbes()).toEqual(["1-2", "9-9"]);
+
+    broadcast(tickEvent(1));
+    expect(frames(summary).map((f) => f.type)).toEqual(["summary"]);
+    expect(frames(full)[0].type).toBe("tick");
+    expect(frames(full)[0].observations.length).toBe(2);
+    const [, detail] = frames(watcher);
+    expect(detail).toMatchObject({ type: "detail", tick: 1, probe_id: "1-2" });
+    expect(detail.observation.hull).toBe(0.5);
+    expect(watcher.sent.length).toBe(2);   // unknown probe sends nothing
+  });
+
+  test("a client's frame rate is capped, keeping the newest frame", async () => {
+    const slow = mockWs(), fast = mockWs();
+    addClient(slow, { fps: 10 });
+    addClient(fast);
+    for (let t = 1; t <= 5; t++) broadcast(tickEvent(t));
+    expect(frames(fast).map((f) => f.tick)).toEqual([1, 2, 3, 4, 5]);
+    expect(frames(slow).map((f) => f.tick)).toEqual([1]);
+
+    await sleep(150);
+    expect(frames(slow).map((f) => f.tick)).toEqual([1, 5]);
+    expect(stats().dropped).toBe(3);
+  });
+
+  test("a backed-up socket gets only the latest frame once drained", async () => {
+    configure({ maxBuffered: 1000 });
+    const socks = Array.from({ length: 100 }, () => mockWs());
+    for (const ws of socks) addClient(ws);
+    for (const ws of socks.slice(50)) ws.buffered = 5000;
+
+    for (let t = 1; t <= 20; t++) broadcast(tickEvent(t));
+    for (const ws of socks.slice(0, 50)) expect(ws.sent.length).toBe(20);
+    for (const ws of socks.slice(50)) expect(ws.sent.length).toBe(0);
+
+    await sleep(80);
+    expect(socks[99].sent.length).toBe(0);   // still backed up
+
+    for (const ws of socks.slice(50)) ws.buffered = 0;
+    await sleep(80);
+    for (const ws of socks.slice(50)) {
+      expect(frames(ws).map((f) => f.tick)).toEqual([20]);
+    }
+    expect(stats().encoded).toBe(20);
+  });
+
+  test("subscribe switches tier; removed clients get nothing", () => {
+    const ws = mockWs(), gone = mockWs();
+    addClient(ws);
+    addClient(gone);
+    handleMessage(ws, { type: "subscribe", tier: "full" });
+    removeClient(gone);
+    broadcast(tickEvent(1));
+    expect(frames(ws)[0].type).toBe("tick");
+    expect(gone.sent.length).toBe(0);
+  });
+});
+
+describe("dashboard stream with the sim", () => {
+  let sim;
+  beforeEach(async () => { sim = await spawnSim({ seed: 42 }); });
+  afterEach(async () => { if (sim) { await stopSim(sim); sim = null; } });
+
+  test("summary frames come from the sim for 100 clients", async () => {
+    const loop = createTickLoop({ sim, summary: true, slices: true,
+                                  watched: watchedProbes });
+    loop.on("tick", (e) => broadcast(e));
+    const socks = Array.from({ length: 100 }, () => mockWs());
+    for (const ws of socks) addClient(ws);
+    handleMessage(socks[0], { type: "watch", probe_ids: ["1-1"] });
+
+    await loop.once();
+    await loop.once();
+    const [summary, detail] = frames(socks[0]).slice(-2);
+    expect(summary.type).toBe("summary");
+    expect(summary.fields[0]).toBe("probe_id");
+    expect(summary.probes[0][0]).toBe("1-1");
+    expect(typeof summary.metrics.probes_spawned).toBe("number");
+    expect(detail.observation.probe_id).toBe("1-1");
+    expect(socks[1].sent.length).toBe(2);
+    expect(stats().encoded).toBe(4);   // a summary and a detail per tick
+  });
+});
@@ -125,6 +125,20 @@ describe("sendCommand", () => {
     expect(res.error).toContain("unknown");
   });
 
+  test("run reports progress and returns the summary", async () => {
+    sim = await spawnSim({ seed: 42 });
+    const seen = [];
+    const r = await sim.send({ cmd: "run", ticks: 300, every: 100 },
+                             { onProgress: (p) => seen.push(p.tick) });
+    expect(r.ok).toBe(true);
+    expect(r.tick).toBe(300);
+    expect(r.run.ticks).toBe(300);
+    expect(seen).toEqual([100, 200]);
+
+    const next = await sim.send({ cmd: "tick", actions: {} });
+    expect(next.tick).toBe(301);
+  });
+
   test("100 ticks stress test", async () => {
     sim = await spawnSim({ seed: 42 });
     for (let i = 0; i < 100; i++) {
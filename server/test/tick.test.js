@@ -2,7 +2,8 @@ import { test, expect, describe, beforeEach, afterEach } from "bun:test";
 import { spawnSim, stopSim } from "../src/process.js";
 import { createTickLoop } from "../src/tick.js";
 import {
-  register, unregister, resolveAction, listAgents, clear as clearAgents
+  register, unregister, resolveAction, listAgents, stats as agentStats,
+  clear as clearAgents
 } from "../src/agents.js";
 
 /** Minimal mock WebSocket that captures sent messages. */
@@ -128,6 +129,41 @@ describe("tick loop", () => {
     expect(resp.ok).toBe(true);
     expect(elapsed).toBeGreaterThanOrEqual(90); // timeout ~100ms
     expect(resp.observations[0].status).toBe("active"); // probe still fine
+    expect(agentStats()).toEqual({ asked: 1, answered: 0, timedOut: 1 });
+  });
+
+  test("a reply that misses its round is dropped", async () => {
+    const loop = createTickLoop({ sim, agentTimeout: 50 });
+    await loop.once();
+    const ws = mockWs();
+    register("1-1", ws);
+    await loop.once();                       // times out
+    resolveAction("1-1", { action: "research", domain: 2 });   // late
+
+    const next = loop.once();
+    await new Promise((r) => setTimeout(r, 20));
+    resolveAction("1-1", { action: "research", domain: 3 });
+    const resp = await next;
+    expect(resp.observations[0].research.domain).toBe(3);
+    expect(agentStats()).toEqual({ asked: 2, answered: 1, timedOut: 1 });
+  });
+
+  test("a reply tagged with an old tick is dropped while the next is asked", async () => {
+    const loop = createTickLoop({ sim, agentTimeout: 50 });
+    await loop.once();
+    const ws = mockWs();
+    register("1-1", ws);
+    await loop.once();                       // times out
+    expect(ws.sent[0].tick).toBe(1);
+
+    const next = loop.once();
+    await new Promise((r) => setTimeout(r, 20));
+    expect(ws.sent[1].tick).toBe(2);
+    resolveAction("1-1", { action: "research", domain: 2, tick: 1 });
+    resolveAction("1-1", { action: "research", domain: 3, tick: 2 });
+    const resp = await next;
+    expect(resp.observations[0].research.domain).toBe(3);
+    expect(agentStats()).toEqual({ asked: 2, answered: 1, timedOut: 1 });
   });
 
   test("start/stop runs ticks automatically", async () => {
@@ -166,6 +202,173 @@ describe("tick loop", () => {
     expect(ticks.length).toBeGreaterThan(countBeforePause);
   });
 
+  test("warp() advances to the target and emits one tick event", async () => {
+    const loop = createTickLoop({ sim });
+    const events = [];
+    loop.on("tick", (e) => events.push(e));
+    const resp = await loop.warp({ until: 40 });
+    expect(resp.ok).toBe(true);
+    expect(resp.tick).toBe(40);
+    expect(resp.warp.reason).toBe("until");
+    expect(resp.observations.length).toBe(1);
+    expect(events.length).toBe(1);
+    expect(events[0].warp.ticks).toBe(40);
+    expect(loop.state.tick).toBe(40);
+  });
+
+  test("idle rounds warp when warpSpan is set", async () => {
+    const loop = createTickLoop({ sim, warpSpan: 20 });
+    const r1 = await loop.once();
+    expect(r1.warp).toBeDefined();
+    expect(r1.tick).toBeGreaterThan(1);
+    expect(r1.tick).toBeLessThanOrEqual(20);
+
+    // A real action falls back to a single tick
+    const probeId = r1.observations[0].probe_id;
+    register(probeId, mockWs());
+    const pending = loop.once();
+    await new Promise((r) => setTimeout(r, 50));
+    resolveAction(probeId, { action: "survey" });
+    const r2 = await pending;
+    expect(r2.warp).toBeUndefined();
+    expect(r2.tick).toBe(r1.tick + 1);
+  });
+
+  test("agents on a standing order are not waited for", async () => {
+    const loop = createTickLoop({ sim, agentTimeout: 2000 });
+    const r1 = await loop.once();
+    const probeId = r1.observations[0].probe_id;
+    const ws = mockWs();
+    register(probeId, ws);
+
+    const pending = loop.once();
+    await new Promise((r) => setTimeout(r, 50));
+    resolveAction(probeId, { action: "wait", repeat: 3 });
+    const r2 = await pending;
+    expect(r2.observations[0].input_needed).toBe(false);
+
+    // The next rounds go ahead without asking the agent
+    const events = [];
+    loop.on("tick", (e) => events.push(e));
+    const start = Date.now();
+    await loop.once();
+    const r4 = await loop.once();
+    expect(Date.now() - start).toBeLessThan(1000);
+    expect(ws.sent.length).toBe(1);
+    expect(events[0].agents).toEqual({ connected: 1, deciding: 0 });
+    expect(r4.observations[0].order_ended).toBe("repeat");
+    expect(r4.observations[0].input_needed).toBe(true);
+
+    // Once the order ends the agent is asked again
+    const next = loop.once();
+    await new Promise((r) => setTimeout(r, 50));
+    expect(ws.sent.length).toBe(2);
+    resolveAction(probeId, { action: "wait" });
+    expect((await next).ok).toBe(true);
+  });
+
+  test("an unasked-for action is held while the probe is on an order", async () => {
+    const loop = createTickLoop({ sim, agentTimeout: 2000 });
+    await loop.once();
+    register("1-1", mockWs());
+    const pending = loop.once();
+    await new Promise((r) => setTimeout(r, 20));
+    resolveAction("1-1", { action: "wait", repeat: 100 });
+    await pending;                           // now idle on the order
+
+    resolveAction("1-1", { action: "wait", until: { event: "any" } });
+    const resp = await loop.once();
+    expect(resp.observations[0].standing_order.until).toBe("event");
+  });
+
+  test("an unasked-for action from an agent that will be asked is dropped", async () => {
+    const loop = createTickLoop({ sim, agentTimeout: 50 });
+    await loop.once();
+    register("1-1", mockWs());
+    resolveAction("1-1", { action: "wait", until: { event: "any" } });
+    const resp = await loop.once();          // asked, and times out
+    expect(resp.observations[0].standing_order).toBeUndefined();
+    expect(agentStats()).toEqual({ asked: 1, answered: 0, timedOut: 1 });
+  });
+
+  test("pipelined rounds apply actions one tick later", async () => {
+    const loop = createTickLoop({ sim, pipeline: true, agentTimeout: 2000 });
+    const ws = mockWs();
+    register("1-1", ws);
+
+    // Nothing to observe yet, so nobody is asked
+    const r1 = await loop.once();
+    expect(ws.sent.length).toBe(0);
+
+    // The agent answers tick 1 while the sim runs tick 2
+    const pending = loop.once();
+    await new Promise((r) => setTimeout(r, 50));
+    expect(ws.sent[0].type).toBe("observe");
+    resolveAction("1-1", { action: "research", domain: 2 });
+    const r2 = await pending;
+    expect(r2.tick).toBe(r1.tick + 1);
+    expect(r2.observations[0].research).toBeUndefined();
+
+    // ...and its action reaches the sim with tick 3
+    const r3 = loop.once();
+    await new Promise((r) => setTimeout(r, 50));
+    resolveAction("1-1", { action: "wait" });
+    expect((await r3).observations[0].research.domain).toBe(2);
+  });
+
+  test("pipelined loop closes rounds as soon as agents answer", async () => {
+    const loop = createTickLoop({ sim, pipeline: true, tickRate: 1000,
+                                  agentTimeout: 2000 });
+    const ws = mockWs();
+    ws.send = () => setTimeout(() => resolveAction("1-1", { action: "wait" }), 0);
+    register("1-1", ws);
+    const ticks = [];
+    loop.on("tick", (e) => ticks.push(e.tick));
+
+    loop.start();
+    await new Promise((r) => setTimeout(r, 300));
+    loop.stop();
+    await new Promise((r) => setTimeout(r, 20));
+
+    expect(ticks.length).toBeGreaterThan(10);
+    for (let i = 1; i < ticks.length; i++) {
+      expect(ticks[i]).toBe(ticks[i - 1] + 1);
+    }
+    expect(loop.state.pipeline).toBe(true);
+    expect(loop.state.ticksPerSec).toBeGreaterThan(0);
+  });
+
+  test("sliced rounds forward only the observations agents read", async () => {
+    const loop = createTickLoop({ sim, slices: true, agentTimeout: 2000 });
+    const events = [];
+    loop.on("tick", (e) => events.push(e));
+
+    // No agent, so nothing is serialized
+    const r1 = await loop.once();
+    expect(r1.observationsJson).toBe("[]");
+    expect(events[0].observations).toBeUndefined();
+
+    const ws = mockWs();
+    register("1-1", ws);
+    const r2 = await loop.once();
+    const obs = JSON.parse(r2.observationsJson);
+    expect(obs.map((o) => o.probe_id)).toEqual(["1-1"]);
+    expect(JSON.parse(r2.slices.get("1-1").json)).toEqual(obs[0]);
+
+    // The agent gets its slice as sent, tagged with its round
+    const pending = loop.once();
+    await new Promise((r) => setTimeout(r, 50));
+    expect(ws.sent[0]).toEqual({ type: "observe", tick: 2, ...obs[0] });
+    resolveAction("1-1", { action: "wait", repeat: 2 });
+    const r3 = await pending;
+    expect(r3.slices.get("1-1").input).toBe(false);
+
+    // A standing order still means the agent is not asked
+    await loop.once();
+    expect(ws.sent.length).toBe(1);
+    expect(events[3].agents).toEqual({ connected: 1, deciding: 0 });
+  });
+
   test("state reflects current loop status", async () => {
     const loop = createTickLoop({ sim });
     expect(loop.state.running).toBe(false);
@@ -0,0 +1,278 @@
+#!/usr/bin/env python3
+"""bench.py — End-to-end pipe benchmarks
+
+Drives build/universe --pipe through scripted workloads, the same way the
+server does, and reports one JSON object per workload:
+
+  ticks_per_sec       simulated ticks per wall-clock second, pipe I/O included
+  p50_ms, p99_ms      latency of one round (the tick command plus any
+                      per-tick queries such as scans, or one run command),
+                      request to response
+  json_bytes_per_tick response bytes per simulated tick
+  peak_rss_kb         peak resident set of the sim process
+
+Every workload starts from a fleet database written by bench_fleet, so runs
+are reproducible for a given seed. Results go to stdout and, with --out, to
+a JSON Lines file for regression tracking.
+"""
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+SEED = 42
+
+
+def percentile(sorted_vals, pct):
+    if not sorted_vals:
+        return 0.0
+    k = min(len(sorted_vals) - 1, int(round(pct / 100.0 * (len(sorted_vals) - 1))))
+    return sorted_vals[k]
+
+
+def probe_ids(n):
+    return ["1-%d" % (i + 1) for i in range(n)]
+
+
+def actions_line(actions):
+    return json.dumps({"cmd": "tick", "actions": actions},
+                      separators=(",", ":")) + "\n"
+
+
+# The pipe reads commands into a 64 KB line buffer
+PIPE_LINE_MAX = 60000
+
+
+def actions_lines(actions):
+    """Split actions over as many tick lines as the pipe needs."""
+    lines, chunk = [], {}
+    for pid, act in actions.items():
+        chunk[pid] = act
+        if len(actions_line(chunk)) > PIPE_LINE_MAX:
+            del chunk[pid]
+            lines.append(actions_line(chunk))
+            chunk = {pid: act}
+    lines.append(actions_line(chunk))
+    return lines
+
+
+class Sim:
+    def __init__(self, binary, seed):
+        self.proc = subprocess.Popen(
+            [binary, "--pipe", "--seed", str(seed)],
+            stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+            stderr=subprocess.DEVNULL,
+            env=dict(os.environ, LD_LIBRARY_PATH="."))
+        self.readline()
+
+    def send(self, line):
+        self.proc.stdin.write(line.encode())
+        self.proc.stdin.flush()
+
+    def readline(self):
+        line = self.proc.stdout.readline()
+        if not line:
+            raise RuntimeError("universe exited")
+        return line
+
+    def request(self, obj):
+        self.send(json.dumps(obj, separators=(",", ":")) + "\n")
+        return json.loads(self.readline())
+
+    def close(self):
+        """Quit and return peak RSS in KB."""
+        self.send('{"cmd":"quit"}\n')
+        self.proc.stdin.close()
+        self.proc.stdout.read()
+        _, _, usage = os.wait4(self.proc.pid, 0)
+        self.proc.returncode = 0
+        return usage.ru_maxrss
+
+
+# ---- Workloads ----
+#
+# Each workload is (name, probes, rich, rounds, setup, span). setup(sim,
+# ids, first_obs) returns a function round(t) -> list of request lines sent
+# for round t; the last line is always the tick (or run) itself. Each round
+# advances the sim by span ticks.
+
+def idle(sim, ids, obs):
+    line = actions_line({})
+    return lambda t: [line]
+
+
+def traveling(sim, ids, obs):
+    # Every probe leaves for a system in scan range of Bob, or for Bob's
+    # system if it is already there; legs last far longer than the run.
+    home = obs[0]["position"]["system_id"]
+    scan = sim.request({"cmd": "scan", "probe_id": ids[0]})
+    far = [s for s in scan.get("systems", []) if s["system_id"] != home]
+    if not far:
+        raise RuntimeError("nothing in scan range to travel to")
+    dest = far[-1]
+    acts = {}
+    for o in obs:
+        here = o["position"]["system_id"]
+        tgt = dest["system_id"] if here != dest["system_id"] else home
+        sec = dest["sector"] if tgt == dest["system_id"] else [0, 0, 0]
+        acts[o["probe_id"]] = {"action": "travel_to_system",
+                               "target_system_id": tgt,
+                               "sector_x": sec[0], "sector_y": sec[1],
+                               "sector_z": sec[2]}
+    # Orders go out over the first few ticks if they overflow one line
+    orders = actions_lines(acts)
+    rest = actions_line({})
+    return lambda t: [orders[t] if t < len(orders) else rest]
+
+
+def surveying(sim, ids, obs):
+    lines = actions_lines({pid: {"action": "survey", "level": 1} for pid in ids})
+    return lambda t: [lines[t % len(lines)]]
+
+
+def message_storm(sim, ids, obs):
+    n = len(ids)
+    line = actions_line({
+        pid: {"action": "send_message", "target": ids[(i + 1) % n],
+              "content": "status report %d" % i}
+        for i, pid in enumerate(ids)})
+    return lambda t: [line]
+
+
+def replication_boom(sim, ids, obs):
+    # Ask every original probe to replicate every tick; each starts as soon
+    # as it is free, so the fleet doubles about every REPL_BASE_TICKS.
+    line = actions_line({pid: {"action": "replicate"} for pid in ids})
+    return lambda t: [line]
+
+
+SCANS_PER_TICK = 16
+
+
+def scan_heavy(sim, ids, obs):
+    tick = actions_line({})
+    scans = ['{"cmd":"scan","probe_id":"%s"}\n' % pid for pid in ids]
+
+    def round_(t):
+        base = t * SCANS_PER_TICK
+        return [scans[(base + k) % len(scans)]
+                for k in range(SCANS_PER_TICK)] + [tick]
+    return round_
+
+
+RUN_SPAN = 100
+
+
+def fast_forward(sim, ids, obs):
+    # Pure simulation throughput: no observations are built
+    line = '{"cmd":"run","ticks":%d}\n' % RUN_SPAN
+    return lambda t: [line]
+
+
+WORKLOADS = [
+    ("idle-1",           1,    False, 2000, idle,             1),
+    ("idle-64",          64,   False, 1000, idle,             1),
+    ("idle-1024",        1024, False, 200,  idle,             1),
+    ("traveling-1024",   1024, False, 200,  traveling,        1),
+    ("surveying-1024",   1024, False, 200,  surveying,        1),
+    ("message-storm-64", 64,   False, 500,  message_storm,    1),
+    ("replication-64",   64,   True,  450,  replication_boom, 1),
+    ("scan-heavy-64",    64,   False, 50,   scan_heavy,       1),
+    ("run-1024",         1024, False, 20,   fast_forward,     RUN_SPAN),
+]
+
+
+def run(binary, fleet, name, probes, rich, rounds, setup, span, tmpdir):
+    db = os.path.join(tmpdir, "%s.db" % name)
+    cmd = [fleet, "--out", db, "--probes", str(probes), "--seed", str(SEED)]
+    if rich:
+        cmd.append("--rich")
+    subprocess.run(cmd, check=True, stdout=subprocess.DEVNULL,
+                   env=dict(os.environ, LD_LIBRARY_PATH="."))
+
+    sim = Sim(binary, SEED)
+    loaded = sim.request({"cmd": "load", "path": db})
+    if not loaded.get("ok") or loaded.get("probes") != probes:
+        raise RuntimeError("%s: load failed: %s" % (name, loaded))
+    # One untimed tick so workloads can see where every probe is
+    first = sim.request({"cmd": "tick", "actions": {}})
+    round_ = setup(sim, probe_ids(probes), first["observations"])
+
+    lat = []
+    nbytes = 0
+    last = b""
+    start = time.perf_counter()
+    for t in range(rounds):
+        lines = round_(t)
+        t0 = time.perf_counter()
+        for line in lines:
+            sim.send(line)
+        for _ in lines:
+            last = sim.readline()
+            nbytes += len(last)
+        lat.append(time.perf_counter() - t0)
+    elapsed = time.perf_counter() - start
+
+    end = json.loads(last)
+    rss = sim.close()
+    lat.sort()
+    ticks = rounds * span
+    return {
+        "bench": name,
+        "seed": SEED,
+        "ticks": ticks,
+        "probes_start": probes,
+        "probes_end": end.get("probes", len(end.get("observations", []))),
+        "ticks_per_sec": round(ticks / elapsed, 1),
+        "p50_ms": round(percentile(lat, 50) * 1000.0, 3),
+        "p99_ms": round(percentile(lat, 99) * 1000.0, 3),
+        "max_ms": round(lat[-1] * 1000.0, 3),
+        "json_bytes_per_tick": nbytes // ticks,
+        "peak_rss_kb": rss,
+    }
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--bin", default="./build/universe")
+    ap.add_argument("--fleet", default="./build/bench_fleet")
+    ap.add_argument("--out", help="append results to this JSON Lines file")
+    ap.add_argument("--only", action="append",
+                    help="run only the named workload (repeatable)")
+    ap.add_argument("--scale", type=float, default=1.0,
+                    help="multiply every workload's tick count")
+    ap.add_argument("--list", action="store_true")
+    args = ap.parse_args()
+
+    if args.list:
+        for w in WORKLOADS:
+            print("%-18s %5d probes  %5d ticks" % (w[0], w[1], w[3] * w[5]))
+        return 0
+
+    chosen = [w for w in WORKLOADS if not args.only or w[0] in args.only]
+    if args.only and len(chosen) != len(args.only):
+        known = ", ".join(w[0] for w in WORKLOADS)
+        print("bench: unknown workload (known: %s)" % known, file=sys.stderr)
+        return 1
+
+    out = open(args.out, "a") if args.out else None
+    with tempfile.TemporaryDirectory(prefix="universe-bench-") as tmpdir:
+        for name, probes, rich, rounds, setup, span in chosen:
+            rounds = max(1, int(rounds * args.scale))
+            res = run(args.bin, args.fleet, name, probes, rich, rounds, setup,
+                      span, tmpdir)
+            res["time"] = int(time.time())
+            line = json.dumps(res, separators=(",", ":"))
+            print(line, flush=True)
+            if out:
+                out.write(line + "\n")
+    if out:
+        out.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
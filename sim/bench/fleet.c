@@ -0,0 +1,106 @@
+/*
+ * fleet.c — Starting state for the benchmark workloads
+ *
+ * Usage: bench_fleet --out PATH [--probes N] [--seed S] [--rich]
+ *
+ * Writes a universe database that the pipe's load command accepts: Bob
+ * plus N-1 copies with ids 1-2 .. 1-N, spread round-robin over the
+ * origin sector's systems. With --rich every probe carries enough of
+ * each resource to replicate several times.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "universe.h"
+#include "generate.h"
+#include "heritage.h"
+#include "persist.h"
+#include "probe.h"
+#include "replicate.h"
+
+#define FLEET_RICH_FACTOR 4.0    /* replications' worth of each resource */
+
+static probe_t g_probes[MAX_PROBES];
+
+int main(int argc, char **argv) {
+    const char *out = NULL;
+    uint64_t seed = 42;
+    int count = 1;
+    bool rich = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            out = argv[++i];
+        } else if (strcmp(argv[i], "--probes") == 0 && i + 1 < argc) {
+            count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--rich") == 0) {
+            rich = true;
+        } else {
+            fprintf(stderr, "Usage: %s --out PATH [--probes N] [--seed S] "
+                    "[--rich]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (!out || count < 1 || count > MAX_PROBES) {
+        fprintf(stderr, "bench_fleet: need --out and 1 <= --probes <= %d\n",
+                MAX_PROBES);
+        return 1;
+    }
+
+    system_t origin[30];
+    int sys_count = generate_sector(origin, 30, seed, (sector_coord_t){0, 0, 0});
+    if (sys_count <= 0) {
+        fprintf(stderr, "bench_fleet: empty origin sector\n");
+        return 1;
+    }
+
+    for (int i = 0; i < count; i++) {
+        probe_t *p = &g_probes[i];
+        probe_init_bob(p);
+        if (i > 0) {
+            p->id = (probe_uid_t){1, (uint64_t)i + 1};
+            snprintf(p->name, MAX_NAME, "Bob-%d", i + 1);
+        }
+        const system_t *sys = &origin[i % sys_count];
+        p->system_id = sys->id;
+        p->sector = sys->sector;
+        p->heading = sys->position;
+        p->location_type = LOC_IN_SYSTEM;
+        if (rich) {
+            for (int r = 0; r < RES_COUNT; r++)
+                p->resources[r] = FLEET_RICH_FACTOR * REPL_TOTAL_KG;
+        }
+    }
+
+    remove(out);
+    persist_t db;
+    if (persist_open(&db, out) != 0) {
+        fprintf(stderr, "bench_fleet: cannot open %s\n", out);
+        return 1;
+    }
+    universe_t *u = calloc(1, sizeof(*u));
+    if (!u) return 1;
+    u->seed = seed;
+    u->generation_version = 1;
+    int rc = persist_save_meta(&db, u);
+
+    /* One transaction, not one sync per probe */
+    sqlite3_exec(db.db, "BEGIN;", NULL, NULL, NULL);
+    for (int i = 0; i < count && rc == 0; i++)
+        rc = persist_save_probe(&db, &g_probes[i]);
+    sqlite3_exec(db.db, "COMMIT;", NULL, NULL, NULL);
+    persist_close(&db);
+
+    for (int i = 0; i < count; i++) heritage_release_probe(&g_probes[i]);
+    free(u);
+    if (rc != 0) {
+        fprintf(stderr, "bench_fleet: write failed\n");
+        return 1;
+    }
+    printf("%s: %d probes, seed %llu%s\n", out, count,
+           (unsigned long long)seed, rich ? ", rich" : "");
+    return 0;
+}
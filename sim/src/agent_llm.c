@@ -7,6 +7,7 @@
 
 #include "agent_llm.h"
 #include "agent_ipc.h"
+#include "heritage.h"
 #include <string.h>
 #include <stdio.h>
 #include <math.h>
@@ -90,20 +91,24 @@ int llm_build_system_prompt(const probe_t *probe, char *buf, int buf_size) {
     n += llm_personality_flavor(&probe->personality, buf + n, buf_size - n);
 
     /* Quirks */
-    if (probe->quirk_count > 0) {
+    int quirk_count = heritage_count(probe->quirks);
+    if (quirk_count > 0) {
         n += snprintf(buf + n, buf_size - n, "\nQuirks:\n");
-        for (int i = 0; i < probe->quirk_count; i++) {
-            n += snprintf(buf + n, buf_size - n, "- %s\n", probe->quirks[i]);
+        for (int i = 0; i < quirk_count; i++) {
+            n += snprintf(buf + n, buf_size - n, "- %s\n",
+                          heritage_line(probe->quirks, i));
         }
     }
 
     /* Earth memories */
-    if (probe->earth_memory_count > 0) {
+    int memory_count = heritage_count(probe->earth_memories);
+    if (memory_count > 0) {
         n += snprintf(buf + n, buf_size - n,
             "\nEarth memories (fidelity: %.0f%%):\n",
             probe->earth_memory_fidelity * 100.0f);
-        for (int i = 0; i < probe->earth_memory_count; i++) {
-            n += snprintf(buf + n, buf_size - n, "- %s\n", probe->earth_memories[i]);
+        for (int i = 0; i < memory_count; i++) {
+            n += snprintf(buf + n, buf_size - n, "- %s\n",
+                          heritage_line(probe->earth_memories, i));
         }
     }
 
@@ -224,10 +229,12 @@ int llm_build_memory_context(const probe_t *probe, const char *rolling_summary,
     return n;
 }
 
-int llm_build_relationship_context(const probe_t *probe, char *buf, int buf_size) {
+int llm_build_relationship_context(const society_t *soc, const probe_t *probe,
+                                   char *buf, int buf_size) {
     int n = 0;
+    int e = society_first_relationship(soc, probe->id);
 
-    if (probe->relationship_count == 0) {
+    if (e < 0) {
         n += snprintf(buf + n, buf_size - n, "Relationships: none (alone in the void)\n");
         return n;
     }
@@ -235,8 +242,8 @@ int llm_build_relationship_context(const probe_t *probe, char *buf, int buf_size
     n += snprintf(buf + n, buf_size - n, "Known probes:\n");
     static const char *DISP_NAMES[] = {"allied", "friendly", "neutral", "wary", "hostile"};
 
-    for (int i = 0; i < probe->relationship_count; i++) {
-        const relationship_t *r = &probe->relationships[i];
+    for (; e >= 0 && n < buf_size - 1; e = society_next_relationship(soc, e)) {
+        const relationship_t *r = society_relationship_at(soc, e);
         const char *disp = (r->disposition < 5) ? DISP_NAMES[r->disposition] : "unknown";
         n += snprintf(buf + n, buf_size - n,
             "- Probe %lu:%lu — trust: %.2f (%s)\n",
@@ -4,6 +4,7 @@
 #include "universe.h"
 #include "probe.h"
 #include "personality.h"
+#include "society.h"
 
 /* ---- Constants ---- */
 
@@ -34,9 +35,11 @@ int llm_build_observation(const probe_t *probe, const system_t *sys,
 int llm_build_memory_context(const probe_t *probe, const char *rolling_summary,
                              int max_memories, char *buf, int buf_size);
 
-/* Build relationship context: known probes, trust, disposition.
+/* Build relationship context from the society's trust graph: known
+ * probes, trust, disposition. Stops early if buf fills up.
  * Returns bytes written. */
-int llm_build_relationship_context(const probe_t *probe, char *buf, int buf_size);
+int llm_build_relationship_context(const society_t *soc, const probe_t *probe,
+                                   char *buf, int buf_size);
 
 /* ---- Response parsing ---- */
 
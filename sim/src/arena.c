@@ -5,31 +5,114 @@
 #include <stdlib.h>
 #include <string.h>
 
+static arena_chunk_t *chunk_new(size_t capacity) {
+    if (capacity > SIZE_MAX - sizeof(arena_chunk_t)) return NULL;
+    arena_chunk_t *c = malloc(sizeof(arena_chunk_t) + capacity);
+    if (!c) return NULL;
+    c->next = NULL;
+    c->capacity = capacity;
+    c->used = 0;
+    return c;
+}
+
+static void chain_free(arena_chunk_t *c) {
+    while (c) {
+        arena_chunk_t *next = c->next;
+        free(c);
+        c = next;
+    }
+}
+
 int arena_init(arena_t *a, size_t capacity) {
-    a->buf = malloc(capacity);
-    if (!a->buf) return -1;
-    a->capacity = capacity;
-    a->used = 0;
+    memset(a, 0, sizeof(*a));
+    a->chunk_size = capacity > 0 ? capacity : ARENA_CHUNK_DEFAULT;
+    a->head = chunk_new(a->chunk_size);
+    if (!a->head) return -1;
+    a->cur = a->head;
+    a->capacity = a->chunk_size;
+    a->chunk_count = 1;
     return 0;
 }
 
-void *arena_alloc(arena_t *a, size_t n) {
+/* Make a->cur a chunk with at least n free bytes: the next chunk in the
+ * chain if it is big enough, else a new one linked in after cur. */
+static arena_chunk_t *chunk_advance(arena_t *a, size_t n) {
+    arena_chunk_t *next = a->cur ? a->cur->next : NULL;
+    if (next && next->capacity >= n) {
+        next->used = 0;
+        a->cur = next;
+        return next;
+    }
+    size_t size = a->chunk_size > 0 ? a->chunk_size : ARENA_CHUNK_DEFAULT;
+    arena_chunk_t *c = chunk_new(n > size ? n : size);
+    if (!c) return NULL;
+    c->next = next;
+    if (a->cur) a->cur->next = c;
+    else a->head = c;
+    a->cur = c;
+    a->capacity += c->capacity;
+    a->chunk_count++;
+    return c;
+}
+
+void *arena_alloc_uninit(arena_t *a, size_t n) {
     /* Align to 8 bytes */
     size_t aligned = (n + 7) & ~(size_t)7;
-    if (a->used + aligned > a->capacity) return NULL;
-    void *ptr = a->buf + a->used;
+    if (aligned < n) return NULL;
+    arena_chunk_t *c = a->cur;
+    if (!c || c->capacity - c->used < aligned) {
+        c = chunk_advance(a, aligned);
+        if (!c) return NULL;
+    }
+    void *ptr = (uint8_t *)c->data + c->used;
+    c->used += aligned;
     a->used += aligned;
-    memset(ptr, 0, aligned);
+    if (a->used > a->high_water) a->high_water = a->used;
     return ptr;
 }
 
+void *arena_alloc(arena_t *a, size_t n) {
+    void *ptr = arena_alloc_uninit(a, n);
+    if (ptr) memset(ptr, 0, n);
+    return ptr;
+}
+
+void *arena_alloc_array(arena_t *a, size_t count, size_t size) {
+    if (size > 0 && count > SIZE_MAX / size) return NULL;
+    return arena_alloc(a, count * size);
+}
+
+arena_mark_t arena_mark(const arena_t *a) {
+    arena_mark_t m = { a->cur, a->cur ? a->cur->used : 0, a->used };
+    return m;
+}
+
+void arena_release(arena_t *a, arena_mark_t mark) {
+    a->cur = mark.chunk ? mark.chunk : a->head;
+    if (a->cur) a->cur->used = mark.chunk ? mark.offset : 0;
+    a->used = mark.used;
+}
+
 void arena_reset(arena_t *a) {
+    /* Fold a multi-chunk chain into one chunk that fits the busiest tick */
+    if (a->head && a->head->next) {
+        size_t size = (a->high_water + 4095) & ~(size_t)4095;
+        arena_chunk_t *c = size >= a->high_water ? chunk_new(size) : NULL;
+        if (c) {
+            chain_free(a->head);
+            a->head = c;
+            a->capacity = size;
+            a->chunk_count = 1;
+        }
+    }
+    a->cur = a->head;
+    if (a->cur) a->cur->used = 0;
     a->used = 0;
 }
 
 void arena_destroy(arena_t *a) {
-    free(a->buf);
-    a->buf = NULL;
-    a->capacity = 0;
-    a->used = 0;
+    chain_free(a->head);
+    size_t chunk_size = a->chunk_size;
+    memset(a, 0, sizeof(*a));
+    a->chunk_size = chunk_size;
 }
@@ -1,5 +1,18 @@
 /*
- * arena.h — Simple bump allocator for per-tick scratch memory
+ * arena.h — Bump allocator for per-tick scratch memory
+ *
+ * Memory comes from a chain of chunks. When the current chunk is full a
+ * larger request moves on to the next chunk, or mallocs a new one, so an
+ * allocation only fails when the system is out of memory. arena_reset()
+ * hands everything back at once and, if the last tick needed more than
+ * one chunk, folds the chain into a single chunk sized for it, so a
+ * steady workload stops calling malloc after its first few ticks.
+ *
+ * Marks rewind part of the arena: take a mark, allocate, release the
+ * mark, and everything allocated since is free again.
+ *
+ * A zeroed arena_t is valid and empty; its first allocation creates a
+ * chunk of ARENA_CHUNK_DEFAULT bytes.
  */
 #ifndef ARENA_H
 #define ARENA_H
@@ -7,22 +20,56 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#define ARENA_CHUNK_DEFAULT (64 * 1024)
+
+typedef struct arena_chunk {
+    struct arena_chunk *next;
+    size_t              capacity;
+    size_t              used;
+    max_align_t         data[];
+} arena_chunk_t;
+
 typedef struct {
-    uint8_t *buf;
-    size_t   capacity;
-    size_t   used;
+    arena_chunk_t *head;
+    arena_chunk_t *cur;          /* chunk allocations come from */
+    size_t         chunk_size;   /* minimum size of a new chunk */
+    size_t         capacity;     /* bytes across all chunks */
+    size_t         used;         /* bytes handed out since the last reset */
+    size_t         high_water;   /* largest used since init */
+    int            chunk_count;
 } arena_t;
 
-/* Create arena with given capacity */
+typedef struct {
+    arena_chunk_t *chunk;
+    size_t         offset;
+    size_t         used;
+} arena_mark_t;
+
+/* Create arena whose first chunk holds capacity bytes */
 int    arena_init(arena_t *a, size_t capacity);
 
-/* Allocate n bytes (8-byte aligned). Returns NULL if full. */
+/* Allocate n zeroed bytes (8-byte aligned). Returns NULL if out of memory. */
 void  *arena_alloc(arena_t *a, size_t n);
 
-/* Reset arena (free all allocations, keep buffer) */
+/* As arena_alloc(), without zeroing — for buffers the caller fills. */
+void  *arena_alloc_uninit(arena_t *a, size_t n);
+
+/* Zeroed array of count elements of size bytes; NULL on overflow. */
+void  *arena_alloc_array(arena_t *a, size_t count, size_t size);
+
+#define ARENA_ARRAY(a, type, count) \
+    ((type *)arena_alloc_array((a), (count), sizeof(type)))
+
+/* Current position, for arena_release() */
+arena_mark_t arena_mark(const arena_t *a);
+
+/* Free everything allocated since mark was taken */
+void   arena_release(arena_t *a, arena_mark_t mark);
+
+/* Reset arena (free all allocations, keep the memory) */
 void   arena_reset(arena_t *a);
 
-/* Free the underlying buffer */
+/* Free every chunk; the arena is empty but usable afterwards */
 void   arena_destroy(arena_t *a);
 
 #endif
@@ -0,0 +1,273 @@
+/*
+ * atlas.c — Galaxy density atlas (star-count tile pyramid)
+ */
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "atlas.h"
+#include "generate.h"
+#include "rng.h"
+#include "util.h"
+
+#define ATLAS_MAGIC    "UNVATLAS"
+#define ATLAS_VERSION  1u
+
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t seed;
+    int32_t  x0, y0, z, w, h;
+    uint32_t reserved2;
+} atlas_header_t;
+
+/* ---- Region / layout ---- */
+
+atlas_region_t atlas_default_region(void) {
+    return (atlas_region_t){
+        -ATLAS_DEFAULT_HALF, -ATLAS_DEFAULT_HALF, 0,
+        2 * ATLAS_DEFAULT_HALF, 2 * ATLAS_DEFAULT_HALF
+    };
+}
+
+static bool region_eq(atlas_region_t a, atlas_region_t b) {
+    return a.x0 == b.x0 && a.y0 == b.y0 && a.z == b.z &&
+           a.w == b.w && a.h == b.h;
+}
+
+/* Size every level and allocate one block for all of them. */
+static int atlas_alloc(atlas_t *a, uint64_t seed, atlas_region_t region) {
+    if (region.w <= 0 || region.h <= 0 ||
+        region.w > (1 << 15) || region.h > (1 << 15))
+        return -1;
+    memset(a, 0, sizeof(*a));
+    a->seed = seed;
+    a->region = region;
+
+    size_t total = 0;
+    int32_t w = region.w, h = region.h;
+    for (;;) {
+        atlas_level_t *lv = &a->level[a->levels++];
+        lv->w = w;
+        lv->h = h;
+        total += (size_t)w * (size_t)h;
+        if ((w == 1 && h == 1) || a->levels == ATLAS_MAX_LEVELS) break;
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+    }
+
+    a->data = calloc(total, sizeof(uint32_t));
+    if (!a->data) {
+        memset(a, 0, sizeof(*a));
+        return -1;
+    }
+    uint32_t *p = a->data;
+    for (int l = 0; l < a->levels; l++) {
+        a->level[l].cells = p;
+        p += (size_t)a->level[l].w * (size_t)a->level[l].h;
+    }
+    return 0;
+}
+
+/* Sum each level from the one below. Level 0 must be filled. */
+static void atlas_reduce(atlas_t *a) {
+    atlas_level_t *base = &a->level[0];
+    a->total = 0;
+    base->max = 0;
+    for (size_t i = 0; i < (size_t)base->w * (size_t)base->h; i++) {
+        a->total += base->cells[i];
+        if (base->cells[i] > base->max) base->max = base->cells[i];
+    }
+
+    for (int l = 1; l < a->levels; l++) {
+        const atlas_level_t *src = &a->level[l - 1];
+        atlas_level_t *dst = &a->level[l];
+        memset(dst->cells, 0, sizeof(uint32_t) * (size_t)dst->w * (size_t)dst->h);
+        for (int32_t y = 0; y < src->h; y++) {
+            const uint32_t *row = src->cells + (size_t)y * (size_t)src->w;
+            uint32_t *out = dst->cells + (size_t)(y / 2) * (size_t)dst->w;
+            for (int32_t x = 0; x < src->w; x++) out[x / 2] += row[x];
+        }
+        dst->max = 0;
+        for (size_t i = 0; i < (size_t)dst->w * (size_t)dst->h; i++)
+            if (dst->cells[i] > dst->max) dst->max = dst->cells[i];
+    }
+}
+
+/* ---- Build ---- */
+
+typedef struct {
+    atlas_t *a;
+    int32_t  row0, row1;
+} atlas_job_t;
+
+/* Same derivation as generate_sector, without generating the systems. */
+static uint32_t sector_count(uint64_t seed, sector_coord_t coord) {
+    rng_t rng;
+    rng_derive(&rng, seed, coord.x, coord.y, coord.z);
+    return (uint32_t)sector_star_count(&rng, coord);
+}
+
+static void *atlas_worker(void *arg) {
+    atlas_job_t *job = (atlas_job_t *)arg;
+    atlas_t *a = job->a;
+    const atlas_region_t *r = &a->region;
+    for (int32_t y = job->row0; y < job->row1; y++) {
+        uint32_t *row = a->level[0].cells + (size_t)y * (size_t)r->w;
+        for (int32_t x = 0; x < r->w; x++) {
+            sector_coord_t c = {r->x0 + x, r->y0 + y, r->z};
+            row[x] = sector_count(a->seed, c);
+        }
+    }
+    return NULL;
+}
+
+int atlas_build(atlas_t *a, uint64_t seed, atlas_region_t region, int threads) {
+    if (atlas_alloc(a, seed, region) != 0) return -1;
+
+    threads = CLAMP(threads, 1, ATLAS_MAX_THREADS);
+    if (threads > region.h) threads = region.h;
+
+    atlas_job_t jobs[ATLAS_MAX_THREADS];
+    pthread_t tids[ATLAS_MAX_THREADS];
+    bool started[ATLAS_MAX_THREADS] = {false};
+    int32_t per = (region.h + threads - 1) / threads;
+    for (int t = 0; t < threads; t++) {
+        jobs[t] = (atlas_job_t){a, t * per, MIN((t + 1) * per, region.h)};
+        /* Worker 0 runs on the calling thread; a failed spawn does its
+         * rows inline too. */
+        if (t > 0)
+            started[t] = pthread_create(&tids[t], NULL, atlas_worker, &jobs[t]) == 0;
+    }
+    atlas_worker(&jobs[0]);
+    for (int t = 1; t < threads; t++) {
+        if (started[t]) pthread_join(tids[t], NULL);
+        else atlas_worker(&jobs[t]);
+    }
+
+    atlas_reduce(a);
+    return 0;
+}
+
+/* ---- Disk cache ---- */
+
+int atlas_save(const atlas_t *a, const char *path) {
+    if (!a->data) return -1;
+    char tmp[1024];
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp", path) >= (int)sizeof(tmp))
+        return -1;
+
+    FILE *f = fopen(tmp, "wb");
+    if (!f) return -1;
+    atlas_header_t hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, ATLAS_MAGIC, sizeof(hdr.magic));
+    hdr.version = ATLAS_VERSION;
+    hdr.seed = a->seed;
+    hdr.x0 = a->region.x0;
+    hdr.y0 = a->region.y0;
+    hdr.z = a->region.z;
+    hdr.w = a->region.w;
+    hdr.h = a->region.h;
+
+    size_t n = (size_t)a->region.w * (size_t)a->region.h;
+    bool ok = fwrite(&hdr, sizeof(hdr), 1, f) == 1 &&
+              fwrite(a->level[0].cells, sizeof(uint32_t), n, f) == n;
+    if (fclose(f) != 0) ok = false;
+    /* Rename into place so a reader never sees a partial file */
+    if (!ok || rename(tmp, path) != 0) {
+        remove(tmp);
+        return -1;
+    }
+    return 0;
+}
+
+int atlas_load(atlas_t *a, const char *path, uint64_t seed,
+               atlas_region_t region) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return -1;
+
+    atlas_header_t hdr;
+    if (fread(&hdr, sizeof(hdr), 1, f) != 1 ||
+        memcmp(hdr.magic, ATLAS_MAGIC, sizeof(hdr.magic)) != 0 ||
+        hdr.version != ATLAS_VERSION || hdr.seed != seed ||
+        !region_eq((atlas_region_t){hdr.x0, hdr.y0, hdr.z, hdr.w, hdr.h},
+                   region) ||
+        atlas_alloc(a, seed, region) != 0) {
+        fclose(f);
+        return -1;
+    }
+
+    size_t n = (size_t)region.w * (size_t)region.h;
+    if (fread(a->level[0].cells, sizeof(uint32_t), n, f) != n) {
+        fclose(f);
+        atlas_free(a);
+        return -1;
+    }
+    fclose(f);
+
+    atlas_reduce(a);
+    a->from_cache = true;
+    return 0;
+}
+
+int atlas_cache_path(char *buf, size_t n, const char *dir, uint64_t seed,
+                     atlas_region_t region) {
+    int len = snprintf(buf, n, "%s/atlas-%llu_%d_%d_%d_%dx%d.bin",
+                       dir, (unsigned long long)seed,
+                       region.x0, region.y0, region.z, region.w, region.h);
+    return (len < 0 || (size_t)len >= n) ? -1 : 0;
+}
+
+const char *atlas_default_dir(void) {
+    const char *dir = getenv(ATLAS_DIR_ENV);
+    return (dir && dir[0]) ? dir : ".";
+}
+
+int atlas_open(atlas_t *a, uint64_t seed, atlas_region_t region,
+               const char *dir, int threads) {
+    char path[1024];
+    bool cached = dir && atlas_cache_path(path, sizeof(path), dir, seed,
+                                          region) == 0;
+    if (cached && atlas_load(a, path, seed, region) == 0) return 0;
+    if (atlas_build(a, seed, region, threads) != 0) return -1;
+    if (cached && atlas_save(a, path) != 0)
+        LOG_WARN("atlas: could not write cache %s", path);
+    return 0;
+}
+
+void atlas_free(atlas_t *a) {
+    free(a->data);
+    memset(a, 0, sizeof(*a));
+}
+
+/* ---- Lookup ---- */
+
+uint32_t atlas_count_at(const atlas_t *a, int level, int32_t sx, int32_t sy) {
+    if (!a->data || level < 0 || level >= a->levels) return 0;
+    int64_t x = (int64_t)sx - a->region.x0;
+    int64_t y = (int64_t)sy - a->region.y0;
+    if (x < 0 || y < 0 || x >= a->region.w || y >= a->region.h) return 0;
+    const atlas_level_t *lv = &a->level[level];
+    return lv->cells[(size_t)(y >> level) * (size_t)lv->w + (size_t)(x >> level)];
+}
+
+void atlas_cell_origin(const atlas_t *a, int level, int32_t sx, int32_t sy,
+                       int32_t *out_x, int32_t *out_y) {
+    int64_t x = (int64_t)sx - a->region.x0;
+    int64_t y = (int64_t)sy - a->region.y0;
+    /* Arithmetic floor for sectors left of / below the region */
+    int64_t cx = x >= 0 ? (x >> level) : -((-x + (1LL << level) - 1) >> level);
+    int64_t cy = y >= 0 ? (y >> level) : -((-y + (1LL << level) - 1) >> level);
+    *out_x = (int32_t)(a->region.x0 + cx * (1LL << level));
+    *out_y = (int32_t)(a->region.y0 + cy * (1LL << level));
+}
+
+int atlas_level_for(const atlas_t *a, double sectors) {
+    int level = 0;
+    while (level + 1 < a->levels && (double)(1 << (level + 1)) <= sectors)
+        level++;
+    return level;
+}
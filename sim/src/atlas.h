@@ -0,0 +1,87 @@
+/*
+ * atlas.h — Galaxy density atlas (star-count tile pyramid)
+ *
+ * A sector's star count depends only on the seed and its coordinates, so
+ * the counts for a whole region can be evaluated once, without generating
+ * any systems, and summed into a pyramid: level 0 holds one cell per
+ * sector and each level above halves the resolution, summing 2x2 cells.
+ * A galaxy-scale view or query then reads one small level instead of
+ * generating millions of sectors.
+ *
+ * Atlases are cached on disk per seed and region (atlas_open). The file
+ * is a small header followed by the level-0 counts; the upper levels are
+ * rebuilt on load.
+ */
+#ifndef ATLAS_H
+#define ATLAS_H
+
+#include "universe.h"
+
+#define ATLAS_MAX_LEVELS      16
+#define ATLAS_MAX_THREADS     8
+#define ATLAS_DEFAULT_HALF    512     /* sectors either side of the core */
+#define ATLAS_DIR_ENV         "UNIVERSE_ATLAS_DIR"
+
+/* A w x h block of sectors starting at (x0, y0), in the z slice. */
+typedef struct {
+    int32_t x0, y0, z;
+    int32_t w, h;
+} atlas_region_t;
+
+typedef struct {
+    int32_t   w, h;              /* cells */
+    uint32_t *cells;             /* row-major star counts, into atlas data */
+    uint32_t  max;               /* densest cell */
+} atlas_level_t;
+
+typedef struct {
+    uint64_t       seed;
+    atlas_region_t region;
+    int            levels;       /* level[levels-1] is a single cell */
+    atlas_level_t  level[ATLAS_MAX_LEVELS];
+    uint32_t      *data;         /* all levels; NULL when empty */
+    uint64_t       total;        /* stars in the region */
+    bool           from_cache;   /* loaded rather than built */
+} atlas_t;
+
+/* The galactic disc around the core, in the z = 0 slice. */
+atlas_region_t atlas_default_region(void);
+
+/* Evaluate every sector in the region with up to `threads` workers and
+ * build the pyramid. Counts match generate_sector() for the same seed.
+ * Returns 0, or -1 on a bad region or allocation failure. */
+int  atlas_build(atlas_t *a, uint64_t seed, atlas_region_t region, int threads);
+
+/* Write / read the cache file. atlas_load fails (-1) unless the file was
+ * written for exactly this seed and region. */
+int  atlas_save(const atlas_t *a, const char *path);
+int  atlas_load(atlas_t *a, const char *path, uint64_t seed,
+                atlas_region_t region);
+
+/* Cache file name for seed and region under dir. Returns 0, or -1 if it
+ * does not fit in n bytes. */
+int  atlas_cache_path(char *buf, size_t n, const char *dir, uint64_t seed,
+                      atlas_region_t region);
+
+/* Cache directory: $UNIVERSE_ATLAS_DIR, or the working directory. */
+const char *atlas_default_dir(void);
+
+/* Load the cached atlas from dir, or build it and write the cache. A NULL
+ * dir skips the disk cache. A failed cache write is not an error. */
+int  atlas_open(atlas_t *a, uint64_t seed, atlas_region_t region,
+                const char *dir, int threads);
+
+void atlas_free(atlas_t *a);
+
+/* Stars in the level-`level` cell containing sector (sx, sy), or 0 when
+ * the sector is outside the region. Level 0 is the sector itself. */
+uint32_t atlas_count_at(const atlas_t *a, int level, int32_t sx, int32_t sy);
+
+/* First sector of the level-`level` cell containing (sx, sy). */
+void atlas_cell_origin(const atlas_t *a, int level, int32_t sx, int32_t sy,
+                       int32_t *out_x, int32_t *out_y);
+
+/* Coarsest level whose cells are at most `sectors` sectors wide. */
+int  atlas_level_for(const atlas_t *a, double sectors);
+
+#endif /* ATLAS_H */
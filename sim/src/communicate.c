@@ -231,6 +231,18 @@ int comm_get_inbox(const comm_system_t *cs, probe_uid_t probe_id,
     return count;
 }
 
+int comm_view_inbox(const comm_system_t *cs, probe_uid_t probe_id,
+                    const message_t **out, int max_out) {
+    int count = 0;
+    for (int i = 0; i < cs->count && count < max_out; i++) {
+        if (cs->messages[i].status == MSG_DELIVERED &&
+            uid_eq(cs->messages[i].target_id, probe_id)) {
+            out[count++] = &cs->messages[i];
+        }
+    }
+    return count;
+}
+
 /* ---- Beacons ---- */
 
 int comm_place_beacon(comm_system_t *cs, const probe_t *owner,
@@ -238,7 +250,8 @@ int comm_place_beacon(comm_system_t *cs, const probe_t *owner,
                       uint64_t current_tick) {
     if (cs->beacon_count >= MAX_BEACONS) return -1;
 
-    beacon_t *b = &cs->beacons[cs->beacon_count++];
+    int idx = cs->beacon_count++;
+    beacon_t *b = &cs->beacons[idx];
     b->owner_id = owner->id;
     b->system_id = system_id;
     b->position = probe_pos(owner);
@@ -247,29 +260,54 @@ int comm_place_beacon(comm_system_t *cs, const probe_t *owner,
     b->placed_tick = current_tick;
     b->active = true;
 
+    /* Append to the system's chain so detection keeps placement order.
+     * A system whose beacons were all deactivated keeps its key with -1. */
+    cs->beacon_next[idx] = -1;
+    int tail = uidmap_get(cs->beacon_index, BEACON_INDEX_CAP, system_id);
+    if (tail < 0) {
+        uidmap_put(cs->beacon_index, BEACON_INDEX_CAP, system_id, idx);
+    } else {
+        while (cs->beacon_next[tail] >= 0) tail = cs->beacon_next[tail];
+        cs->beacon_next[tail] = idx;
+    }
+
     return 0;
 }
 
 int comm_detect_beacons(const comm_system_t *cs, probe_uid_t system_id,
                         beacon_t *out, int max_out) {
     int count = 0;
-    for (int i = 0; i < cs->beacon_count && count < max_out; i++) {
-        if (cs->beacons[i].active && uid_eq(cs->beacons[i].system_id, system_id)) {
-            out[count++] = cs->beacons[i];
-        }
+    int i = uidmap_get(cs->beacon_index, BEACON_INDEX_CAP, system_id);
+    for (; i >= 0 && count < max_out; i = cs->beacon_next[i]) {
+        out[count++] = cs->beacons[i];
+    }
+    return count;
+}
+
+int comm_view_beacons(const comm_system_t *cs, probe_uid_t system_id,
+                      const beacon_t **out, int max_out) {
+    int count = 0;
+    int i = uidmap_get(cs->beacon_index, BEACON_INDEX_CAP, system_id);
+    for (; i >= 0 && count < max_out; i = cs->beacon_next[i]) {
+        out[count++] = &cs->beacons[i];
     }
     return count;
 }
 
 int comm_deactivate_beacon(comm_system_t *cs, probe_uid_t owner_id,
                            probe_uid_t system_id) {
-    for (int i = 0; i < cs->beacon_count; i++) {
-        if (cs->beacons[i].active &&
-            uid_eq(cs->beacons[i].owner_id, owner_id) &&
-            uid_eq(cs->beacons[i].system_id, system_id)) {
-            cs->beacons[i].active = false;
-            return 0;
-        }
+    int prev = -1;
+    int i = uidmap_get(cs->beacon_index, BEACON_INDEX_CAP, system_id);
+    for (; i >= 0; prev = i, i = cs->beacon_next[i]) {
+        if (!uid_eq(cs->beacons[i].owner_id, owner_id)) continue;
+        cs->beacons[i].active = false;
+        /* Unlink so the chain only ever holds active beacons */
+        if (prev < 0)
+            uidmap_put(cs->beacon_index, BEACON_INDEX_CAP, system_id,
+                       cs->beacon_next[i]);
+        else
+            cs->beacon_next[prev] = cs->beacon_next[i];
+        return 0;
     }
     return -1;  /* not found */
 }
@@ -3,6 +3,7 @@
 
 #include "universe.h"
 #include "rng.h"
+#include "uidmap.h"
 
 /* ---- Constants ---- */
 
@@ -11,6 +12,7 @@
 #define MAX_BEACONS        256
 #define MAX_RELAYS         256
 #define MAX_BEACON_MSG     256
+#define BEACON_INDEX_CAP   512   /* power of two, >= 2x MAX_BEACONS */
 #define LIGHT_SPEED_LY_PER_TICK (1.0 / 365.0)  /* 1 ly/year, 1 tick = 1 day */
 
 /* Base communication range in ly per tech level */
@@ -78,6 +80,9 @@ typedef struct {
     int       count;
     beacon_t  beacons[MAX_BEACONS];
     int       beacon_count;
+    /* system_id → first active beacon, chained through beacon_next */
+    uidmap_slot_t beacon_index[BEACON_INDEX_CAP];
+    int       beacon_next[MAX_BEACONS];
     relay_t   relays[MAX_RELAYS];
     int       relay_count;
 } comm_system_t;
@@ -119,6 +124,11 @@ int comm_tick_deliver(comm_system_t *cs, uint64_t current_tick);
 int comm_get_inbox(const comm_system_t *cs, probe_uid_t probe_id,
                    message_t *out, int max_out);
 
+/* As comm_get_inbox(), but writes pointers into the message table.
+ * Valid until the next send or delivery. */
+int comm_view_inbox(const comm_system_t *cs, probe_uid_t probe_id,
+                    const message_t **out, int max_out);
+
 /* ---- Beacons ---- */
 
 /* Place a beacon at the probe's current location.
@@ -131,6 +141,10 @@ int comm_place_beacon(comm_system_t *cs, const probe_t *owner,
 int comm_detect_beacons(const comm_system_t *cs, probe_uid_t system_id,
                         beacon_t *out, int max_out);
 
+/* As comm_detect_beacons(), but writes pointers into the beacon table. */
+int comm_view_beacons(const comm_system_t *cs, probe_uid_t system_id,
+                      const beacon_t **out, int max_out);
+
 /* Deactivate a beacon by owner */
 int comm_deactivate_beacon(comm_system_t *cs, probe_uid_t owner_id,
                            probe_uid_t system_id);
@@ -6,6 +6,7 @@
 
 #include "events.h"
 #include "generate.h"
+#include "strtab.h"
 #include <string.h>
 #include <math.h>
 #include <stdio.h>
@@ -124,19 +125,33 @@ static float random_severity(rng_t *rng) {
     return (float)(rng_next(rng) % 1000) / 1000.0f;
 }
 
-static void log_event(event_system_t *es, event_type_t type, int subtype,
-                      probe_uid_t probe_id, probe_uid_t system_id,
-                      uint64_t tick, const char *desc, float severity) {
-    if (es->count >= MAX_EVENT_LOG) return;
-    sim_event_t *e = &es->events[es->count++];
+void events_log(event_system_t *es, event_type_t type, int subtype,
+                probe_uid_t probe_id, probe_uid_t system_id,
+                uint64_t tick, const char *desc, float severity) {
+    sim_event_t *e = &es->events[es->seq % MAX_EVENT_LOG];
+    es->seq++;
+    if (es->count < MAX_EVENT_LOG) es->count++;
     e->type = type;
     e->subtype = subtype;
     e->probe_id = probe_id;
     e->system_id = system_id;
     e->tick = tick;
     e->severity = severity;
-    strncpy(e->description, desc, sizeof(e->description) - 1);
-    e->description[sizeof(e->description) - 1] = '\0';
+    e->description = strtab_intern(desc);
+}
+
+uint64_t events_first_seq(const event_system_t *es) {
+    return es->seq - (uint64_t)es->count;
+}
+
+const sim_event_t *events_at(const event_system_t *es, int i) {
+    if (i < 0 || i >= es->count) return NULL;
+    return &es->events[(events_first_seq(es) + (uint64_t)i) % MAX_EVENT_LOG];
+}
+
+const sim_event_t *events_by_seq(const event_system_t *es, uint64_t n) {
+    if (n >= es->seq || n < events_first_seq(es)) return NULL;
+    return &es->events[n % MAX_EVENT_LOG];
 }
 
 static void apply_personality_and_memory(probe_t *probe, event_type_t type,
@@ -229,7 +244,7 @@ int events_generate(event_system_t *es, probe_t *probe,
                 a->planet_id = sys->planets[pi].id;
             }
             a->subtype = (anomaly_subtype_t)subtype;
-            strncpy(a->description, desc, sizeof(a->description) - 1);
+            a->description = strtab_intern(desc);
             a->discovered_tick = tick;
             a->resolved = false;
         }
@@ -274,7 +289,7 @@ int events_generate(event_system_t *es, probe_t *probe,
         return -1;
     }
 
-    log_event(es, type, subtype, probe->id, sys_id, tick, desc, severity);
+    events_log(es, type, subtype, probe->id, sys_id, tick, desc, severity);
     apply_personality_and_memory(probe, type, desc, tick, severity);
 
     return 0;
@@ -285,6 +300,12 @@ int events_generate(event_system_t *es, probe_t *probe,
 int events_tick_probe(event_system_t *es, probe_t *probe,
                       const system_t *current_system,
                       uint64_t tick, rng_t *rng) {
+    return events_tick_probe_span(es, probe, current_system, tick, rng, 1);
+}
+
+int events_tick_probe_span(event_system_t *es, probe_t *probe,
+                           const system_t *current_system,
+                           uint64_t tick, rng_t *rng, uint32_t span) {
     /* Only generate events for probes in a system */
     if (!current_system) return 0;
     if (probe->status == STATUS_DESTROYED) return 0;
@@ -305,7 +326,9 @@ int events_tick_probe(event_system_t *es, probe_t *probe,
     for (int i = 0; i < roll_count && generated < MAX_EVENTS_PER_TICK; i++) {
         /* Random roll: probability check */
         double roll = (double)(rng_next(rng) % 1000000) / 1000000.0;
-        if (roll < rolls[i].freq) {
+        double freq = span > 1
+            ? 1.0 - pow(1.0 - rolls[i].freq, (double)span) : rolls[i].freq;
+        if (roll < freq) {
             int subtype = (int)(rng_next(rng) % rolls[i].subtype_count);
             events_generate(es, probe, rolls[i].type, subtype,
                            current_system, tick, rng);
@@ -441,9 +464,18 @@ int events_get_for_probe(const event_system_t *es, probe_uid_t probe_id,
                          sim_event_t *out, int max_out) {
     int count = 0;
     for (int i = 0; i < es->count && count < max_out; i++) {
-        if (uid_eq(es->events[i].probe_id, probe_id)) {
-            out[count++] = es->events[i];
-        }
+        const sim_event_t *e = events_at(es, i);
+        if (uid_eq(e->probe_id, probe_id)) out[count++] = *e;
+    }
+    return count;
+}
+
+int events_view_for_probe(const event_system_t *es, probe_uid_t probe_id,
+                          const sim_event_t **out, int max_out) {
+    int count = 0;
+    for (int i = 0; i < es->count && count < max_out; i++) {
+        const sim_event_t *e = events_at(es, i);
+        if (uid_eq(e->probe_id, probe_id)) out[count++] = e;
     }
     return count;
 }
@@ -503,11 +535,11 @@ bool events_deterministic_check(uint64_t seed, int tick_count,
         probe.hull_integrity = 1.0f;
         probe.compute_capacity = 1.0f;
 
-        int before = es.count;
+        uint64_t before = es.seq;
         events_tick_probe(&es, &probe, &sys, (uint64_t)t, &rng);
 
-        for (int i = before; i < es.count && *out_count < max_out; i++) {
-            out_types[(*out_count)++] = es.events[i].type;
+        for (uint64_t n = before; n < es.seq && *out_count < max_out; n++) {
+            out_types[(*out_count)++] = events_by_seq(&es, n)->type;
         }
     }
 
@@ -106,7 +106,7 @@ typedef struct {
     probe_uid_t  probe_id;       /* which probe experienced it */
     probe_uid_t  system_id;      /* where it happened */
     uint64_t     tick;
-    char         description[256];
+    str_id_t     description;    /* interned; resolve with strtab_str() */
     float        severity;       /* 0-1, how impactful */
 } sim_event_t;
 
@@ -115,7 +115,7 @@ typedef struct {
     probe_uid_t  system_id;
     probe_uid_t  planet_id;
     anomaly_subtype_t subtype;
-    char         description[256];
+    str_id_t     description;    /* interned */
     uint64_t     discovered_tick;
     bool         resolved;
 } anomaly_t;
@@ -152,9 +152,14 @@ typedef struct {
 
 /* ---- Event log ---- */
 
+/* The log is a ring of the last MAX_EVENT_LOG events. seq counts every
+ * event ever logged; event number n sits in events[n % MAX_EVENT_LOG]
+ * until it is overwritten. Readers that want what is new since their
+ * last look keep a sequence number, not an index. */
 typedef struct {
     sim_event_t    events[MAX_EVENT_LOG];
-    int            count;
+    int            count;         /* events held, <= MAX_EVENT_LOG */
+    uint64_t       seq;           /* events ever logged */
     anomaly_t      anomalies[MAX_ANOMALIES];
     int            anomaly_count;
     civilization_t civilizations[MAX_CIVILIZATIONS];
@@ -175,6 +180,12 @@ int events_tick_probe(event_system_t *es, probe_t *probe,
                       const system_t *current_system,
                       uint64_t tick, rng_t *rng);
 
+/* As events_tick_probe(), covering span ticks with one roll per event
+ * type at the chance of it happening at least once in the span. */
+int events_tick_probe_span(event_system_t *es, probe_t *probe,
+                           const system_t *current_system,
+                           uint64_t tick, rng_t *rng, uint32_t span);
+
 /* Generate a specific event type (for testing/scripting).
  * Returns 0 on success. */
 int events_generate(event_system_t *es, probe_t *probe,
@@ -204,12 +215,33 @@ int alien_check_planet(const planet_t *planet, rng_t *rng);
 int alien_generate_civ(civilization_t *civ, const planet_t *planet,
                        probe_uid_t discovered_by, uint64_t tick, rng_t *rng);
 
+/* ---- Log ---- */
+
+/* Append an event, overwriting the oldest once the log is full. */
+void events_log(event_system_t *es, event_type_t type, int subtype,
+                probe_uid_t probe_id, probe_uid_t system_id,
+                uint64_t tick, const char *desc, float severity);
+
+/* i-th event held, oldest first (0 <= i < count). */
+const sim_event_t *events_at(const event_system_t *es, int i);
+
+/* Event number n, or NULL if it is not logged yet or was overwritten. */
+const sim_event_t *events_by_seq(const event_system_t *es, uint64_t n);
+
+/* Number of the oldest event still held. */
+uint64_t events_first_seq(const event_system_t *es);
+
 /* ---- Query ---- */
 
 /* Get events for a specific probe from the log. Returns count. */
 int events_get_for_probe(const event_system_t *es, probe_uid_t probe_id,
                          sim_event_t *out, int max_out);
 
+/* As events_get_for_probe(), but writes pointers into the log instead of
+ * copies. They stay valid until the log is next modified. */
+int events_view_for_probe(const event_system_t *es, probe_uid_t probe_id,
+                          const sim_event_t **out, int max_out);
+
 /* Get anomalies in a system. Returns count. */
 int events_get_anomalies(const event_system_t *es, probe_uid_t system_id,
                          anomaly_t *out, int max_out);
@@ -0,0 +1,225 @@
+/*
+ * heritage.c — Shared, reference-counted heritage text blocks
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "heritage.h"
+#include "strtab.h"
+
+typedef struct {
+    uint32_t refs;               /* 0 = on the free list */
+    uint32_t hash;
+    int32_t  chain;              /* next block in bucket / free list */
+    uint8_t  count;
+    str_id_t lines[HERITAGE_MAX_LINES];
+} heritage_block_t;
+
+static heritage_block_t *g_blocks;
+static uint32_t          g_block_count;  /* slots ever used */
+static uint32_t          g_block_cap;
+static int32_t           g_free = -1;
+static int32_t          *g_buckets;      /* block index, or -1 */
+static uint32_t          g_bucket_cap;   /* power of two */
+static uint32_t          g_live;
+
+/* FNV-1a over the interned ids. */
+static uint32_t hash_ids(const str_id_t *ids, int count) {
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < count; i++) {
+        h ^= ids[i];
+        h *= 16777619u;
+    }
+    return h ^ (uint32_t)count;
+}
+
+static heritage_block_t *block_get(heritage_id_t id) {
+    if (id == 0 || id > g_block_count) return NULL;
+    heritage_block_t *b = &g_blocks[id - 1];
+    return b->refs ? b : NULL;
+}
+
+static int buckets_grow(void) {
+    uint32_t cap = g_bucket_cap ? g_bucket_cap * 2 : 256;
+    int32_t *nb = malloc(sizeof(*nb) * cap);
+    if (!nb) return -1;
+    for (uint32_t i = 0; i < cap; i++) nb[i] = -1;
+    for (uint32_t i = 0; i < g_block_count; i++) {
+        heritage_block_t *b = &g_blocks[i];
+        if (!b->refs) continue;
+        uint32_t k = b->hash & (cap - 1);
+        b->chain = nb[k];
+        nb[k] = (int32_t)i;
+    }
+    free(g_buckets);
+    g_buckets = nb;
+    g_bucket_cap = cap;
+    return 0;
+}
+
+static int32_t block_alloc(void) {
+    if (g_free >= 0) {
+        int32_t i = g_free;
+        g_free = g_blocks[i].chain;
+        return i;
+    }
+    if (g_block_count == g_block_cap) {
+        uint32_t cap = g_block_cap ? g_block_cap * 2 : 256;
+        heritage_block_t *nb = realloc(g_blocks, sizeof(*nb) * cap);
+        if (!nb) return -1;
+        g_blocks = nb;
+        g_block_cap = cap;
+    }
+    return (int32_t)g_block_count++;
+}
+
+static void block_unlink(int32_t idx) {
+    int32_t *link = &g_buckets[g_blocks[idx].hash & (g_bucket_cap - 1)];
+    while (*link >= 0 && *link != idx) link = &g_blocks[*link].chain;
+    if (*link == idx) *link = g_blocks[idx].chain;
+}
+
+/* Find or create the block holding ids[0..count); count is in range. */
+static heritage_id_t from_ids(const str_id_t *ids, int count) {
+    uint32_t h = hash_ids(ids, count);
+    size_t size = sizeof(str_id_t) * (size_t)count;
+    if (g_bucket_cap) {
+        for (int32_t i = g_buckets[h & (g_bucket_cap - 1)]; i >= 0;
+             i = g_blocks[i].chain) {
+            heritage_block_t *b = &g_blocks[i];
+            if (b->hash == h && b->count == count &&
+                memcmp(b->lines, ids, size) == 0) {
+                b->refs++;
+                return (heritage_id_t)(i + 1);
+            }
+        }
+    }
+
+    if (g_live + 1 > g_bucket_cap / 2 && buckets_grow() != 0) return 0;
+    int32_t idx = block_alloc();
+    if (idx < 0) return 0;
+
+    heritage_block_t *b = &g_blocks[idx];
+    memset(b, 0, sizeof(*b));
+    memcpy(b->lines, ids, size);
+    b->count = (uint8_t)count;
+    b->hash = h;
+    b->refs = 1;
+    uint32_t k = h & (g_bucket_cap - 1);
+    b->chain = g_buckets[k];
+    g_buckets[k] = idx;
+    g_live++;
+    return (heritage_id_t)(idx + 1);
+}
+
+heritage_id_t heritage_from_lines(const char *const *lines, int count) {
+    if (count <= 0) return 0;
+    if (count > HERITAGE_MAX_LINES) count = HERITAGE_MAX_LINES;
+    str_id_t ids[HERITAGE_MAX_LINES];
+    for (int i = 0; i < count; i++) ids[i] = strtab_intern(lines[i]);
+    return from_ids(ids, count);
+}
+
+heritage_id_t heritage_from_ids(const str_id_t *ids, int count) {
+    if (count <= 0) return 0;
+    if (count > HERITAGE_MAX_LINES) count = HERITAGE_MAX_LINES;
+    return from_ids(ids, count);
+}
+
+void heritage_retain(heritage_id_t id) {
+    heritage_block_t *b = block_get(id);
+    if (b) b->refs++;
+}
+
+void heritage_release(heritage_id_t id) {
+    heritage_block_t *b = block_get(id);
+    if (!b || --b->refs > 0) return;
+    int32_t idx = (int32_t)(id - 1);
+    block_unlink(idx);
+    memset(b, 0, sizeof(*b));
+    b->chain = g_free;
+    g_free = idx;
+    g_live--;
+}
+
+int heritage_count(heritage_id_t id) {
+    heritage_block_t *b = block_get(id);
+    return b ? b->count : 0;
+}
+
+str_id_t heritage_line_id(heritage_id_t id, int i) {
+    heritage_block_t *b = block_get(id);
+    if (!b || i < 0 || i >= b->count) return 0;
+    return b->lines[i];
+}
+
+const char *heritage_line(heritage_id_t id, int i) {
+    return strtab_str(heritage_line_id(id, i));
+}
+
+int heritage_set_line(heritage_id_t *id, int i, const char *text) {
+    heritage_block_t *b = block_get(*id);
+    if (!b || i < 0 || i >= b->count) return -1;
+    str_id_t sid = strtab_intern(text);
+    if (b->lines[i] == sid) return 0;
+
+    str_id_t ids[HERITAGE_MAX_LINES];
+    int count = b->count;
+    memcpy(ids, b->lines, sizeof(str_id_t) * (size_t)count);
+    ids[i] = sid;
+
+    heritage_id_t nid = from_ids(ids, count);
+    if (!nid) return -1;
+    heritage_release(*id);
+    *id = nid;
+    return 0;
+}
+
+uint32_t heritage_refs(heritage_id_t id) {
+    heritage_block_t *b = block_get(id);
+    return b ? b->refs : 0;
+}
+
+void heritage_stats(heritage_stats_t *out) {
+    memset(out, 0, sizeof(*out));
+    for (uint32_t i = 0; i < g_block_count; i++) {
+        const heritage_block_t *b = &g_blocks[i];
+        if (!b->refs) continue;
+        out->blocks++;
+        out->refs += b->refs;
+        out->bytes += sizeof(*b);
+    }
+}
+
+heritage_id_t *heritage_field(probe_t *probe, heritage_kind_t kind) {
+    switch (kind) {
+    case HERITAGE_QUIRKS:         return &probe->quirks;
+    case HERITAGE_CATCHPHRASES:   return &probe->catchphrases;
+    case HERITAGE_VALUES:         return &probe->values;
+    case HERITAGE_EARTH_MEMORIES: return &probe->earth_memories;
+    default:                      return NULL;
+    }
+}
+
+void heritage_retain_probe(const probe_t *probe) {
+    heritage_retain(probe->quirks);
+    heritage_retain(probe->catchphrases);
+    heritage_retain(probe->values);
+    heritage_retain(probe->earth_memories);
+}
+
+void heritage_release_probe(const probe_t *probe) {
+    heritage_release(probe->quirks);
+    heritage_release(probe->catchphrases);
+    heritage_release(probe->values);
+    heritage_release(probe->earth_memories);
+}
+
+void heritage_reset(void) {
+    free(g_blocks);
+    free(g_buckets);
+    g_blocks = NULL;
+    g_buckets = NULL;
+    g_block_count = g_block_cap = g_bucket_cap = g_live = 0;
+    g_free = -1;
+}
@@ -0,0 +1,74 @@
+/*
+ * heritage.h — Shared, reference-counted heritage text blocks
+ *
+ * A probe's quirks, catchphrases, values and earth memories are each a
+ * heritage_id_t naming an immutable list of lines in a global pool. Lines
+ * are interned strings (strtab.h), so a block is just a short id list. Blocks
+ * are content-addressed: building a list that already exists returns the
+ * existing block with one more reference, so a lineage that inherits its
+ * catchphrases unchanged holds a single copy of the text. Editing a line
+ * never touches the shared block; it produces (or finds) another block and
+ * drops the caller's reference to the old one.
+ *
+ * Every probe_t slot that is in use owns one reference per non-zero id.
+ * Code that copies a probe by value must heritage_retain_probe() the copy,
+ * and code that discards a probe must heritage_release_probe() it.
+ * Id 0 is the empty list and is never allocated. Not thread-safe.
+ */
+#ifndef HERITAGE_H
+#define HERITAGE_H
+
+#include "universe.h"
+
+#define HERITAGE_MAX_LINES  MAX_EARTH_MEM
+
+typedef enum {
+    HERITAGE_QUIRKS = 0,
+    HERITAGE_CATCHPHRASES,
+    HERITAGE_VALUES,
+    HERITAGE_EARTH_MEMORIES,
+    HERITAGE_KIND_COUNT
+} heritage_kind_t;
+
+typedef struct {
+    uint32_t blocks;             /* live blocks */
+    uint64_t refs;               /* references held across all blocks */
+    uint64_t bytes;              /* block storage; text is in strtab */
+} heritage_stats_t;
+
+/* Find or create the block holding lines[0..count). Lines are interned
+ * (and truncated to STRTAB_MAX_LEN); count is clamped to HERITAGE_MAX_LINES.
+ * Returns a new reference, 0 for an empty list, or 0 on allocation failure. */
+heritage_id_t heritage_from_lines(const char *const *lines, int count);
+
+/* As heritage_from_lines, for lines that are already interned. */
+heritage_id_t heritage_from_ids(const str_id_t *ids, int count);
+
+/* Add or drop one reference. Both accept 0 and ignore freed ids. */
+void          heritage_retain(heritage_id_t id);
+void          heritage_release(heritage_id_t id);
+
+int           heritage_count(heritage_id_t id);
+
+/* Line i of the block, or "" when out of range. */
+const char   *heritage_line(heritage_id_t id, int i);
+str_id_t      heritage_line_id(heritage_id_t id, int i);   /* 0 if out of range */
+
+/* Replace line i of *id (copy-on-write). Returns 0, or -1 if i is out of
+ * range or allocation fails, leaving *id unchanged. */
+int           heritage_set_line(heritage_id_t *id, int i, const char *text);
+
+uint32_t      heritage_refs(heritage_id_t id);
+void          heritage_stats(heritage_stats_t *out);
+
+/* The probe field holding the given kind of heritage. */
+heritage_id_t *heritage_field(probe_t *probe, heritage_kind_t kind);
+
+/* Retain or release all four heritage lists of a probe. */
+void          heritage_retain_probe(const probe_t *probe);
+void          heritage_release_probe(const probe_t *probe);
+
+/* Release every block and the pool itself. Outstanding ids become invalid. */
+void          heritage_reset(void);
+
+#endif /* HERITAGE_H */
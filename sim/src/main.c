@@ -29,13 +29,24 @@
 #include "replicate.h"
 #include "communicate.h"
 #include "society.h"
+#include "heritage.h"
+#include "strtab.h"
 #include "scenario.h"
+#include "atlas.h"
+#include "sector_cache.h"
+#include "profile.h"
+#include "sim_lod.h"
+#include "orders.h"
+#include "uidmap.h"
 #include "util.h"
 
 #ifdef USE_RAYLIB
 #include "render_raylib.h"
+#include <pthread.h>
+#include <stdatomic.h>
 #endif
 
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -119,18 +130,40 @@ static void handle_sigint(int sig) {
 #define RESP_BUF       (256 * 1024)
 #define MAX_SNAP_SLOTS 2
 #define SYS_CACHE_MAX  64
+#define OBS_MAX_TRUST  64    /* trust entries per probe observation */
+#define LINEAGE_PAGE_MAX 1000  /* entries per lineage response */
+#define QUERY_PAGE_MAX   1000  /* probes per query response */
+#define HISTORY_PAGE_MAX 500   /* events per history response */
+#define PIPE_REPL_THREADS 4     /* workers for large replication batches */
+#define PIPE_ATLAS_THREADS 4    /* workers for a density atlas build */
+#define DENSITY_MAX_CELLS 4096  /* cells per density grid response */
 
 static event_system_t    g_pipe_events;
+static atlas_t           g_pipe_atlas;
 static metrics_system_t  g_pipe_metrics;
 static injection_queue_t g_pipe_inject;
 static config_t          g_pipe_cfg;
 static snapshot_t        g_pipe_snap[MAX_SNAP_SLOTS];
+static rel_graph_t       g_pipe_snap_rel[MAX_SNAP_SLOTS];
 static system_t          g_pipe_sys_cache[SYS_CACHE_MAX];
 static int               g_pipe_sys_count;
 static replication_state_t g_pipe_repl[MAX_PROBES];
+static repl_batch_t       g_pipe_batch;
 static lineage_tree_t    g_pipe_lineage;
 static comm_system_t     g_pipe_comm;
 static society_t         g_pipe_society;
+static profiler_t        g_pipe_prof;
+static arena_t           g_pipe_arena;       /* tick scratch, reset per tick */
+static sim_lod_t         g_pipe_lod;
+static standing_order_t  g_pipe_orders[MAX_PROBES];
+static uint64_t          g_pipe_order_ends;  /* orders ended, ever */
+
+/* UID -> slot in uni.probes, for lookups by ID. Probes are only appended
+ * between a load or restore, so the index is extended lazily and cleared
+ * whenever the array is rewritten. */
+#define PROBE_INDEX_CAP (MAX_PROBES * 2)
+static uidmap_slot_t     g_pipe_probe_index[PROBE_INDEX_CAP];
+static uint32_t          g_pipe_probe_indexed; /* probes[0..n) indexed */
 
 typedef struct {
     bool     active;
@@ -140,6 +173,23 @@ typedef struct {
 } research_state_t;
 static research_state_t  g_pipe_research[MAX_PROBES];
 
+/* Which observations a tick or warp reply carries: {"observe":[ids]}
+ * limits them to those probes, {"slices":true} adds where each one
+ * starts and ends so a relay can forward it without parsing, and
+ * {"summary":true} adds a compact line per probe for dashboards. */
+typedef struct {
+    bool     filter;                 /* only the probes in want[] */
+    bool     want[MAX_PROBES];
+    bool     slices;
+    bool     summary;
+    uint32_t off[MAX_PROBES];        /* bytes from the array's '[' */
+    uint32_t len[MAX_PROBES];
+} obs_select_t;
+static obs_select_t      g_pipe_obs_sel;
+static uint64_t          g_pipe_summary_seen; /* event seq already summarized */
+
+#define SUMMARY_MAX_EVENTS 32   /* newest events per summary */
+
 /* Scenario scripting: scheduled event injections */
 #define MAX_SCENARIO_EVENTS 64
 typedef struct {
@@ -161,6 +211,68 @@ static const char *PIPE_LOC_NAMES[] = {
     "interstellar","in_system","orbiting","landed","docked"
 };
 
+/* Growable text buffer for responses whose size scales with the fleet.
+ * Zeroed is empty; the buffer is kept across ticks. */
+typedef struct {
+    char  *buf;
+    size_t len;
+    size_t cap;
+    bool   failed;               /* an append could not grow the buffer */
+} obs_buf_t;
+
+static bool obs_reserve(obs_buf_t *o, size_t extra) {
+    if (o->len + extra < o->cap) return true;
+    size_t cap = o->cap ? o->cap : RESP_BUF;
+    while (o->len + extra >= cap) cap *= 2;
+    char *nb = realloc(o->buf, cap);
+    if (!nb) {
+        o->failed = true;
+        return false;
+    }
+    o->buf = nb;
+    o->cap = cap;
+    return true;
+}
+
+static void obs_printf(obs_buf_t *o, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(o->buf ? o->buf + o->len : NULL,
+                      o->buf ? o->cap - o->len : 0, fmt, ap);
+    va_end(ap);
+    if (n < 0) return;
+    if (o->len + (size_t)n >= o->cap) {
+        if (!obs_reserve(o, (size_t)n + 1)) return;
+        va_start(ap, fmt);
+        vsnprintf(o->buf + o->len, o->cap - o->len, fmt, ap);
+        va_end(ap);
+    }
+    o->len += (size_t)n;
+}
+
+static void obs_putc(obs_buf_t *o, char c) {
+    if (obs_reserve(o, 1)) {
+        o->buf[o->len++] = c;
+        o->buf[o->len] = '\0';
+    }
+}
+
+/* Copy up to max bytes of s into arena scratch with quotes and
+ * backslashes escaped for a JSON string. "" if the arena is exhausted. */
+static const char *pipe_escape(arena_t *a, const char *s, size_t max) {
+    size_t n = 0;
+    while (n < max && s[n]) n++;
+    char *e = arena_alloc_uninit(a, 2 * n + 1);
+    if (!e) return "";
+    size_t k = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (s[i] == '"' || s[i] == '\\') e[k++] = '\\';
+        e[k++] = s[i];
+    }
+    e[k] = '\0';
+    return e;
+}
+
 static void pipe_ok(const char *extra) {
     if (extra) fprintf(stdout, "{\"ok\":true,%s}\n", extra);
     else       fprintf(stdout, "{\"ok\":true}\n");
@@ -181,9 +293,25 @@ static probe_uid_t parse_uid_str(const char *s) {
     return uid;
 }
 
+static void pipe_probe_index_reset(void) {
+    memset(g_pipe_probe_index, 0, sizeof(g_pipe_probe_index));
+    g_pipe_probe_indexed = 0;
+}
+
 static int find_probe_idx(const universe_t *u, probe_uid_t id) {
-    for (uint32_t i = 0; i < u->probe_count; i++)
-        if (uid_eq(u->probes[i].id, id)) return (int)i;
+    if (g_pipe_probe_indexed > u->probe_count) pipe_probe_index_reset();
+    for (; g_pipe_probe_indexed < u->probe_count; g_pipe_probe_indexed++) {
+        uint32_t n = g_pipe_probe_indexed;
+        uidmap_put(g_pipe_probe_index, PROBE_INDEX_CAP, u->probes[n].id,
+                   (int32_t)n);
+    }
+    int i = uidmap_get(g_pipe_probe_index, PROBE_INDEX_CAP, id);
+    if (i >= 0 && uid_eq(u->probes[i].id, id)) return i;
+    if (i >= 0) {
+        /* The array moved under the index: rebuild it and ask again */
+        pipe_probe_index_reset();
+        return find_probe_idx(u, id);
+    }
     return -1;
 }
 
@@ -193,15 +321,22 @@ static system_t *sys_cache_get(probe_uid_t sys_id, uint64_t seed,
         if (uid_eq(g_pipe_sys_cache[i].id, sys_id))
             return &g_pipe_sys_cache[i];
     /* Generate sector to find system */
-    system_t tmp[30];
-    int n = generate_sector(tmp, 30, seed, sector);
+    uint64_t t0 = profile_begin(&g_pipe_prof);
+    arena_mark_t mark = arena_mark(&g_pipe_arena);
+    system_t *tmp = arena_alloc_uninit(&g_pipe_arena,
+                                       SECTOR_MAX_SYSTEMS * sizeof(system_t));
+    int n = tmp ? generate_sector(tmp, SECTOR_MAX_SYSTEMS, seed, sector) : 0;
+    profile_end(&g_pipe_prof, PROF_SYS_CACHE_MISS, t0);
+    system_t *hit = NULL;
     for (int i = 0; i < n; i++) {
         if (uid_eq(tmp[i].id, sys_id) && g_pipe_sys_count < SYS_CACHE_MAX) {
             g_pipe_sys_cache[g_pipe_sys_count] = tmp[i];
-            return &g_pipe_sys_cache[g_pipe_sys_count++];
+            hit = &g_pipe_sys_cache[g_pipe_sys_count++];
+            break;
         }
     }
-    return NULL;
+    arena_release(&g_pipe_arena, mark);
+    return hit;
 }
 
 static int snap_find(const char *tag) {
@@ -239,14 +374,102 @@ static int pipe_parse_tag(const char *line, char *tag, int tag_max) {
     return 0;
 }
 
+/* Extract "key":N from JSON line, or def if absent */
+static long long pipe_parse_int(const char *line, const char *key,
+                                long long def) {
+    char pat[64];
+    snprintf(pat, sizeof(pat), "\"%s\":", key);
+    const char *p = strstr(line, pat);
+    if (!p) return def;
+    return atoll(p + strlen(pat));
+}
+
+/* Extract "key":"value" from JSON line. Returns -1 if absent. */
+static int pipe_parse_str(const char *line, const char *key,
+                          char *out, int out_max) {
+    char pat[64];
+    snprintf(pat, sizeof(pat), "\"%s\":\"", key);
+    const char *p = strstr(line, pat);
+    if (!p) return -1;
+    p += strlen(pat);
+    int i = 0;
+    while (*p && *p != '"' && i < out_max - 1) out[i++] = *p++;
+    out[i] = '\0';
+    return 0;
+}
+
+/* Extract up to n numbers of "key":[a,b,...] from JSON line. Returns
+ * how many were read, or -1 if the key is absent. */
+static int pipe_parse_ints(const char *line, const char *key,
+                           long long *out, int n) {
+    char pat[64];
+    snprintf(pat, sizeof(pat), "\"%s\":[", key);
+    const char *p = strstr(line, pat);
+    if (!p) return -1;
+    p += strlen(pat);
+    int k = 0;
+    while (k < n && *p && *p != ']') {
+        char *end;
+        long long v = strtoll(p, &end, 10);
+        if (end == p) break;
+        out[k++] = v;
+        p = end;
+        while (*p == ',' || *p == ' ') p++;
+    }
+    return k;
+}
+
+/* Read a tick or warp request's "observe" list and "slices" and
+ * "summary" flags into g_pipe_obs_sel. Unknown IDs are ignored; an
+ * empty list observes no probe at all. */
+static void pipe_parse_observe(const char *line, const universe_t *u) {
+    obs_select_t *sel = &g_pipe_obs_sel;
+    sel->slices = strstr(line, "\"slices\":true") != NULL;
+    sel->summary = strstr(line, "\"summary\":true") != NULL;
+    const char *p = strstr(line, "\"observe\":[");
+    sel->filter = p != NULL;
+    if (!p) return;
+    memset(sel->want, 0, sizeof(sel->want));
+    p += 11;
+    while (*p && *p != ']') {
+        if (*p++ != '"') continue;
+        char key[32];
+        int k = 0;
+        while (*p && *p != '"' && k < 31) key[k++] = *p++;
+        key[k] = '\0';
+        if (*p == '"') p++;
+        int idx = find_probe_idx(u, parse_uid_str(key));
+        if (idx >= 0) sel->want[idx] = true;
+    }
+}
+
+/* Take a named probe's action object: an action with "repeat" or
+ * "until" becomes its standing order, any other action cancels one. */
+static void pipe_order_issue(universe_t *uni, int idx, const char *json,
+                             const action_t *a, bool valid) {
+    standing_order_t *so = &g_pipe_orders[idx];
+    bool had = so->active;
+    int r = order_parse(json, a, so);
+    if (r > 0 && !valid) r = -1;
+    if (r > 0) {
+        order_arm(so, &uni->probes[idx], g_pipe_events.seq);
+    } else if (r < 0) {
+        order_end(so, "invalid");
+    } else if (had) {
+        order_end(so, "cancelled");
+    }
+}
+
 /* Parse per-probe actions from tick JSON.
  * Format: "actions":{"0-1":{"action":"wait"},"0-2":{"action":"mine",...}}
- * Unspecified probes default to wait. */
+ * Unspecified probes carry on with their standing order, or wait. */
 static int pipe_parse_actions(const char *json, universe_t *uni,
-                              action_t *out) {
+                              action_t *out, bool *named) {
     for (uint32_t i = 0; i < uni->probe_count; i++) {
         memset(&out[i], 0, sizeof(action_t));
         out[i].type = ACT_WAIT;
+        if (g_pipe_orders[i].active) out[i] = g_pipe_orders[i].action;
+        if (named) named[i] = false;
     }
     const char *p = strstr(json, "\"actions\":");
     if (!p) return 0;
@@ -285,7 +508,9 @@ static int pipe_parse_actions(const char *json, universe_t *uni,
             probe_uid_t uid = parse_uid_str(key);
             int idx = find_probe_idx(uni, uid);
             if (idx >= 0) {
-                action_parse(buf, &out[idx]);
+                bool valid = action_parse(buf, &out[idx]) == 0;
+                pipe_order_issue(uni, idx, buf, &out[idx], valid);
+                if (named) named[idx] = true;
                 count++;
             }
         }
@@ -293,6 +518,1226 @@ static int pipe_parse_actions(const char *json, universe_t *uni,
     return count;
 }
 
+/* Roll span ticks of random events for probe i and queue warnings for
+ * any hazards they raise. */
+static void pipe_roll_events(universe_t *u, uint32_t i, rng_t *rng,
+                             uint64_t seed, uint32_t span) {
+    system_t *sys = sys_cache_get(u->probes[i].system_id,
+                                  seed, u->probes[i].sector);
+    if (!sys) return;
+    uint64_t before = g_pipe_events.seq;
+    events_tick_probe_span(&g_pipe_events, &u->probes[i],
+                           sys, u->tick, rng, span);
+    for (uint64_t n = before; n < g_pipe_events.seq; n++) {
+        const sim_event_t *ev = events_by_seq(&g_pipe_events, n);
+        if (ev->type == EVT_HAZARD) {
+            int delay = 3 + (int)(rng_next(rng) % 3);
+            events_queue_hazard(&g_pipe_events,
+                u->probes[i].id, ev->subtype, ev->severity,
+                u->tick, u->tick + delay);
+        }
+    }
+}
+
+/* Penalise trust for a probe sitting in a system someone else claims,
+ * once per tick spent there. */
+static void pipe_trespass(universe_t *u, uint32_t i, uint32_t ticks) {
+    if (u->probes[i].location_type == LOC_INTERSTELLAR) return;
+    const claim_t *cl = society_find_claim(&g_pipe_society,
+                            u->probes[i].system_id);
+    if (cl && !uid_eq(cl->claimer_id, u->probes[i].id)) {
+        int oidx = find_probe_idx(u, cl->claimer_id);
+        if (oidx >= 0) {
+            society_update_trust(&g_pipe_society,
+                u->probes[oidx].id, u->probes[i].id,
+                TRUST_CLAIM_VIOLATION * (float)ticks);
+        }
+    }
+}
+
+/* Bring coarse probe i up to date: n waiting ticks of energy, travel,
+ * trespass and event rolls, each in one aggregated step. */
+static void pipe_lod_catch_up(universe_t *u, uint32_t i, uint32_t n,
+                              rng_t *rng, uint64_t seed) {
+    probe_t *pr = &u->probes[i];
+    if (pr->status != STATUS_DESTROYED) {
+        travel_tick_span(pr, rng, n);
+        probe_idle_ticks(pr, n);
+        pipe_trespass(u, i, n);
+        pipe_roll_events(u, i, rng, seed, n);
+    }
+    g_pipe_lod.synced[i] = u->tick;
+    g_pipe_lod.catch_ups++;
+}
+
+/* Pick LOD tiers for the coming tick and catch up every probe that is
+ * due: promoted probes at once, coarse ones every cadence ticks. */
+static void pipe_lod_sync(universe_t *u, rng_t *rng, uint64_t seed) {
+    bool was_on = g_pipe_lod.coarse_count > 0;
+    /* A standing order is an agent at work: keep its probe full */
+    for (uint32_t i = 0; i < u->probe_count; i++)
+        if (g_pipe_orders[i].active) g_pipe_lod.attached[i] = true;
+    sim_lod_update(&g_pipe_lod, u, &g_pipe_events);
+    if (g_pipe_lod.coarse_count == 0 && !was_on) return;
+    uint64_t t0 = profile_now_ns();
+    for (uint32_t i = 0; i < u->probe_count; i++) {
+        uint32_t n = sim_lod_due(&g_pipe_lod, i, u->tick);
+        if (n > 0) pipe_lod_catch_up(u, i, n, rng, seed);
+    }
+    g_pipe_lod.catch_up_ns += profile_now_ns() - t0;
+}
+
+/* Catch up every lagging probe, so the universe can be saved or copied. */
+static void pipe_lod_flush(universe_t *u, rng_t *rng, uint64_t seed) {
+    for (uint32_t i = 0; i < u->probe_count; i++) {
+        uint64_t lag = u->tick - g_pipe_lod.synced[i];
+        if (lag > 0) pipe_lod_catch_up(u, i, (uint32_t)lag, rng, seed);
+    }
+}
+
+static inline bool pipe_lod_coarse(uint32_t i) {
+    return g_pipe_lod.tier[i] == TIER_COARSE;
+}
+
+/* Count a tick of probe i's standing order; a refused action ends it. */
+static void pipe_order_step(uint32_t i, bool ok) {
+    standing_order_t *so = &g_pipe_orders[i];
+    if (!so->active) return;
+    so->executed++;
+    if (!ok) {
+        order_end(so, "failed");
+        g_pipe_order_ends++;
+    }
+}
+
+/* End every standing order whose count or condition has been met. */
+static void pipe_check_orders(const universe_t *u) {
+    for (uint32_t i = 0; i < u->probe_count; i++)
+        if (order_check(&g_pipe_orders[i], &u->probes[i], &g_pipe_events))
+            g_pipe_order_ends++;
+}
+
+/* Advance the pipe universe one tick: replication, movement, society,
+ * events and metrics. Shared by tick, warp and run. Coarse LOD probes
+ * sit out the per-probe phases until pipe_lod_sync() catches them up. */
+static void pipe_advance(universe_t *u, rng_t *rng, uint64_t seed) {
+    uint64_t t0;
+    bool lod_on = g_pipe_lod.cadence > 0;
+    uint64_t lod_ns = 0;
+    u->tick++;
+    arena_reset(&g_pipe_arena);
+    rng_next(rng);
+
+    /* Advance replication; children join the tick below */
+    t0 = profile_begin(&g_pipe_prof);
+    repl_batch_tick(&g_pipe_batch, u->probes, &u->probe_count,
+                    g_pipe_repl, &g_pipe_lineage, u->tick, rng,
+                    PIPE_REPL_THREADS);
+    profile_end(&g_pipe_prof, PROF_REPLICATION, t0);
+
+    t0 = profile_begin(&g_pipe_prof);
+    if (lod_on) lod_ns -= profile_now_ns();
+    for (uint32_t i = 0; i < u->probe_count; i++) {
+        if (pipe_lod_coarse(i)) continue;
+        if (u->probes[i].status == STATUS_TRAVELING)
+            travel_tick(&u->probes[i], rng);
+
+        probe_tick_energy(&u->probes[i]);
+    }
+    if (lod_on) lod_ns += profile_now_ns();
+    profile_end(&g_pipe_prof, PROF_MOVEMENT, t0);
+
+    /* Deliver messages and trades */
+    t0 = profile_begin(&g_pipe_prof);
+    comm_tick_deliver(&g_pipe_comm, u->tick);
+    society_trade_tick(&g_pipe_society, u->probes,
+                       (int)u->probe_count, u->tick);
+    society_build_tick(&g_pipe_society, u->tick);
+
+    /* Auto-register completed relay satellites as comm relays */
+    for (int si = 0; si < g_pipe_society.structure_count; si++) {
+        structure_t *st = &g_pipe_society.structures[si];
+        if (st->type == STRUCT_RELAY_SATELLITE
+            && st->complete && st->completed_tick == u->tick) {
+            int bidx = find_probe_idx(u, st->builder_ids[0]);
+            if (bidx >= 0) {
+                comm_build_relay(&g_pipe_comm, &u->probes[bidx],
+                                 st->system_id, u->tick);
+            }
+        }
+    }
+
+    society_resolve_votes(&g_pipe_society, u->tick);
+
+    /* Advance research */
+    for (uint32_t i = 0; i < u->probe_count; i++) {
+        if (g_pipe_research[i].active) {
+            g_pipe_research[i].ticks_elapsed++;
+            if (g_pipe_research[i].ticks_elapsed
+                >= g_pipe_research[i].ticks_total) {
+                /* Research complete — advance tech */
+                int d = g_pipe_research[i].domain;
+                if (d >= 0 && d < TECH_COUNT
+                    && u->probes[i].tech_levels[d] < 255) {
+                    u->probes[i].tech_levels[d]++;
+                    /* Recalc derived stats */
+                    probe_t *pr = &u->probes[i];
+                    pr->max_speed_c = 0.10f + 0.02f * pr->tech_levels[TECH_PROPULSION];
+                    pr->sensor_range_ly = 5.0f + 2.0f * pr->tech_levels[TECH_SENSORS];
+                    pr->mining_rate = 100.0f + 50.0f * pr->tech_levels[TECH_MINING];
+                    pr->construction_rate = 1.0f + 0.5f * pr->tech_levels[TECH_CONSTRUCTION];
+                    pr->compute_capacity = 100.0f + 50.0f * pr->tech_levels[TECH_COMPUTING];
+                }
+                memset(&g_pipe_research[i], 0,
+                       sizeof(g_pipe_research[i]));
+            }
+        }
+    }
+
+    /* Trespass check — penalize trust for entering claimed systems */
+    for (uint32_t i = 0; i < u->probe_count; i++) {
+        if (u->probes[i].status == STATUS_DESTROYED) continue;
+        if (pipe_lod_coarse(i)) continue;
+        pipe_trespass(u, i, 1);
+    }
+
+    profile_end(&g_pipe_prof, PROF_SOCIETY, t0);
+
+    /* Strike pending hazards */
+    t0 = profile_begin(&g_pipe_prof);
+    events_strike_pending(&g_pipe_events, u->probes,
+                          (int)u->probe_count, u->tick);
+
+    /* Events */
+    if (lod_on) lod_ns -= profile_now_ns();
+    for (uint32_t i = 0; i < u->probe_count; i++) {
+        if (u->probes[i].status == STATUS_DESTROYED) continue;
+        if (pipe_lod_coarse(i)) continue;
+        pipe_roll_events(u, i, rng, seed, 1);
+    }
+    if (lod_on) lod_ns += profile_now_ns();
+
+    /* Fire scenario scheduled events */
+    for (int si = 0; si < g_pipe_scenario_count; si++) {
+        scenario_event_t *se = &g_pipe_scenario[si];
+        if (!se->fired && se->at_tick == u->tick) {
+            inject_event(&g_pipe_inject, se->type, se->subtype,
+                         "", se->severity, se->target);
+            se->fired = true;
+        }
+    }
+
+    /* Flush injected events */
+    if (g_pipe_inject.count > 0) {
+        system_t *sys = g_pipe_sys_count > 0 ?
+                        &g_pipe_sys_cache[0] : NULL;
+        if (sys)
+            inject_flush(&g_pipe_inject, &g_pipe_events,
+                         u->probes, (int)u->probe_count,
+                         sys, u->tick, rng);
+    }
+    profile_end(&g_pipe_prof, PROF_EVENTS, t0);
+
+    t0 = profile_begin(&g_pipe_prof);
+    metrics_record(&g_pipe_metrics, u, &g_pipe_society,
+                   &g_pipe_events, u->tick);
+    profile_end(&g_pipe_prof, PROF_METRICS, t0);
+
+    pipe_check_orders(u);
+
+    for (uint32_t i = 0; i < u->probe_count; i++) {
+        if (pipe_lod_coarse(i)) {
+            g_pipe_lod.coarse_probe_ticks++;
+        } else {
+            g_pipe_lod.synced[i] = u->tick;
+            if (lod_on) g_pipe_lod.full_probe_ticks++;
+        }
+    }
+    g_pipe_lod.full_ns += lod_ns;
+}
+
+/* Append a coarse probe's stand-in observation to o: no agent is
+ * watching, so say who it is and how stale. */
+static void pipe_observe_stub(obs_buf_t *o, const universe_t *u,
+                              uint32_t i) {
+    const probe_t *pr = &u->probes[i];
+    obs_printf(o, "{\"probe_id\":\"%llu-%llu\",\"name\":\"%s\","
+        "\"status\":\"%s\",\"location\":\"%s\","
+        "\"generation\":%u,"
+        "\"lod\":{\"tier\":\"coarse\",\"synced\":%llu}}",
+        (unsigned long long)pr->id.hi,
+        (unsigned long long)pr->id.lo,
+        pr->name,
+        PIPE_STATUS_NAMES[pr->status],
+        PIPE_LOC_NAMES[pr->location_type],
+        pr->generation,
+        (unsigned long long)g_pipe_lod.synced[i]);
+}
+
+/* Append probe i's full observation object to o. */
+static void pipe_observe_probe(obs_buf_t *o, universe_t *u, uint64_t seed,
+                               uint32_t i) {
+    probe_t *pr = &u->probes[i];
+    /* Scratch for this probe's lists and escaped strings */
+    arena_mark_t obs_mark = arena_mark(&g_pipe_arena);
+
+    /* Core fields */
+    obs_printf(o, "{\"probe_id\":\"%llu-%llu\","
+        "\"name\":\"%s\","
+        "\"status\":\"%s\","
+        "\"hull\":%.3f,"
+        "\"energy\":%.1f,"
+        "\"fuel\":%.1f,"
+        "\"location\":\"%s\","
+        "\"generation\":%u,"
+        "\"tech\":[%u,%u,%u,%u,%u,%u,%u,%u,%u,%u],",
+        (unsigned long long)pr->id.hi,
+        (unsigned long long)pr->id.lo,
+        pr->name,
+        PIPE_STATUS_NAMES[pr->status],
+        (double)pr->hull_integrity,
+        pr->energy_joules, pr->fuel_kg,
+        PIPE_LOC_NAMES[pr->location_type],
+        pr->generation,
+        pr->tech_levels[0], pr->tech_levels[1],
+        pr->tech_levels[2], pr->tech_levels[3],
+        pr->tech_levels[4], pr->tech_levels[5],
+        pr->tech_levels[6], pr->tech_levels[7],
+        pr->tech_levels[8], pr->tech_levels[9]);
+
+    /* Resources */
+    obs_printf(o, "\"resources\":{\"iron\":%.1f,\"silicon\":%.1f,"
+        "\"rare_earth\":%.1f,\"water\":%.1f,\"hydrogen\":%.1f,"
+        "\"helium3\":%.1f,\"carbon\":%.1f,\"uranium\":%.1f,"
+        "\"exotic\":%.1f},",
+        pr->resources[RES_IRON], pr->resources[RES_SILICON],
+        pr->resources[RES_RARE_EARTH], pr->resources[RES_WATER],
+        pr->resources[RES_HYDROGEN], pr->resources[RES_HELIUM3],
+        pr->resources[RES_CARBON], pr->resources[RES_URANIUM],
+        pr->resources[RES_EXOTIC]);
+
+    /* Position */
+    obs_printf(o, "\"position\":{\"sector\":[%d,%d,%d],"
+        "\"system_id\":\"%llu-%llu\","
+        "\"body_id\":\"%llu-%llu\","
+        "\"heading\":[%.3f,%.3f,%.3f],"
+        "\"destination\":[%.3f,%.3f,%.3f],"
+        "\"travel_remaining_ly\":%.3f},",
+        pr->sector.x, pr->sector.y, pr->sector.z,
+        (unsigned long long)pr->system_id.hi,
+        (unsigned long long)pr->system_id.lo,
+        (unsigned long long)pr->body_id.hi,
+        (unsigned long long)pr->body_id.lo,
+        pr->heading.x, pr->heading.y, pr->heading.z,
+        pr->destination.x, pr->destination.y, pr->destination.z,
+        pr->travel_remaining_ly);
+
+    /* Capabilities */
+    obs_printf(o, "\"capabilities\":{\"max_speed_c\":%.4f,"
+        "\"sensor_range_ly\":%.1f,\"mining_rate\":%.2f,"
+        "\"construction_rate\":%.2f,\"compute_capacity\":%.1f},",
+        (double)pr->max_speed_c,
+        (double)pr->sensor_range_ly,
+        (double)pr->mining_rate,
+        (double)pr->construction_rate,
+        (double)pr->compute_capacity);
+
+    /* Recent events (last 5 for this probe) */
+    obs_printf(o, "\"recent_events\":[");
+    {
+        const sim_event_t **evts =
+            ARENA_ARRAY(&g_pipe_arena, const sim_event_t *, 5);
+        int ne = evts ? events_view_for_probe(&g_pipe_events,
+                                              pr->id, evts, 5) : 0;
+        for (int e = 0; e < ne; e++) {
+            if (e > 0) obs_putc(o, ',');
+            const char *safe_desc = pipe_escape(&g_pipe_arena,
+                strtab_str(evts[e]->description), 250);
+            obs_printf(o, "{\"type\":%d,\"subtype\":%d,"
+                "\"description\":\"%s\","
+                "\"severity\":%.2f,\"tick\":%llu}",
+                (int)evts[e]->type, evts[e]->subtype,
+                safe_desc, (double)evts[e]->severity,
+                (unsigned long long)evts[e]->tick);
+        }
+    }
+    obs_printf(o, "],");
+
+    /* Replication progress (if replicating) */
+    if (g_pipe_repl[i].active) {
+        int trem = (int)g_pipe_repl[i].ticks_total
+                 - (int)g_pipe_repl[i].ticks_elapsed;
+        if (trem < 0) trem = 0;
+        obs_printf(o, "\"replication\":{\"progress\":%.3f,"
+            "\"ticks_remaining\":%d,"
+            "\"consciousness_forked\":%s},",
+            g_pipe_repl[i].progress, trem,
+            g_pipe_repl[i].consciousness_forked ? "true" : "false");
+    }
+
+    /* System details (when not interstellar) */
+    system_t *sys = sys_cache_get(pr->system_id, seed, pr->sector);
+    if (sys && pr->location_type != LOC_INTERSTELLAR) {
+        obs_printf(o, "\"system\":{\"name\":\"%s\","
+            "\"star_count\":%u,\"planet_count\":%u,",
+            sys->name, sys->star_count, sys->planet_count);
+
+        /* Stars */
+        obs_printf(o, "\"stars\":[");
+        for (int s = 0; s < sys->star_count; s++) {
+            if (s > 0) obs_putc(o, ',');
+            obs_printf(o, "{\"name\":\"%s\",\"class\":%d,"
+                "\"mass_solar\":%.3f,\"temp_k\":%.0f,"
+                "\"luminosity_solar\":%.4f,"
+                "\"metallicity\":%.2f}",
+                sys->stars[s].name,
+                (int)sys->stars[s].class,
+                sys->stars[s].mass_solar,
+                sys->stars[s].temperature_k,
+                sys->stars[s].luminosity_solar,
+                sys->stars[s].metallicity);
+        }
+        obs_printf(o, "],");
+
+        /* Planets — enhanced */
+        obs_printf(o, "\"planets\":[");
+        for (int pl = 0; pl < sys->planet_count; pl++) {
+            if (pl > 0) obs_putc(o, ',');
+            const planet_t *planet = &sys->planets[pl];
+            obs_printf(o, "{\"name\":\"%s\",\"type\":%d,"
+                "\"mass_earth\":%.3f,"
+                "\"radius_earth\":%.3f,"
+                "\"orbital_radius_au\":%.3f,"
+                "\"orbital_period_days\":%.1f,"
+                "\"surface_temp_k\":%.1f,"
+                "\"atmosphere_pressure_atm\":%.3f,"
+                "\"water_coverage\":%.3f,"
+                "\"habitability\":%.3f,"
+                "\"magnetic_field\":%.3f,"
+                "\"rings\":%s,"
+                "\"moon_count\":%u,"
+                "\"survey_complete\":[%s,%s,%s,%s,%s],",
+                planet->name, (int)planet->type,
+                planet->mass_earth,
+                planet->radius_earth,
+                planet->orbital_radius_au,
+                planet->orbital_period_days,
+                planet->surface_temp_k,
+                planet->atmosphere_pressure_atm,
+                planet->water_coverage,
+                planet->habitability_index,
+                planet->magnetic_field,
+                planet->rings ? "true" : "false",
+                planet->moon_count,
+                planet->surveyed[0] ? "true" : "false",
+                planet->surveyed[1] ? "true" : "false",
+                planet->surveyed[2] ? "true" : "false",
+                planet->surveyed[3] ? "true" : "false",
+                planet->surveyed[4] ? "true" : "false");
+
+            /* Planet resource abundances */
+            obs_printf(o, "\"resources\":{\"iron\":%.3f,\"silicon\":%.3f,"
+                "\"rare_earth\":%.3f,\"water\":%.3f,"
+                "\"hydrogen\":%.3f,\"helium3\":%.3f,"
+                "\"carbon\":%.3f,\"uranium\":%.3f,"
+                "\"exotic\":%.3f}",
+                (double)planet->resources[RES_IRON],
+                (double)planet->resources[RES_SILICON],
+                (double)planet->resources[RES_RARE_EARTH],
+                (double)planet->resources[RES_WATER],
+                (double)planet->resources[RES_HYDROGEN],
+                (double)planet->resources[RES_HELIUM3],
+                (double)planet->resources[RES_CARBON],
+                (double)planet->resources[RES_URANIUM],
+                (double)planet->resources[RES_EXOTIC]);
+            /* Artifact data (only if discovered) */
+            if (planet->has_artifact && planet->artifact_discovered) {
+                static const char *art_type_names[] = {
+                    "tech_boost","resource_cache","star_map","comm_amplifier"};
+                const char *atn = planet->artifact_type < 4
+                    ? art_type_names[planet->artifact_type] : "unknown";
+                const char *adesc = pipe_escape(&g_pipe_arena,
+                    planet->artifact_desc, 250);
+                obs_printf(o, ",\"artifact\":{\"type\":\"%s\","
+                    "\"value\":%.3f,\"description\":\"%s\"}",
+                    atn, planet->artifact_value, adesc);
+            }
+            obs_printf(o, "}");
+        }
+        obs_printf(o, "]},");
+    } else {
+        /* Interstellar — no system details */
+        obs_printf(o, "\"system\":null,");
+    }
+
+    /* Nearby probes (within sensor range) */
+    obs_printf(o, "\"nearby_probes\":[");
+    {
+        int np_count = 0;
+        for (uint32_t j = 0; j < u->probe_count; j++) {
+            if (j == i) continue;
+            if (u->probes[j].status == STATUS_DESTROYED) continue;
+            double dx = pr->heading.x - u->probes[j].heading.x;
+            double dy = pr->heading.y - u->probes[j].heading.y;
+            double dz = pr->heading.z - u->probes[j].heading.z;
+            double dist = sqrt(dx*dx + dy*dy + dz*dz);
+            if (dist <= (double)pr->sensor_range_ly) {
+                if (np_count > 0) obs_putc(o, ',');
+                obs_printf(o, "{\"probe_id\":\"%llu-%llu\","
+                    "\"name\":\"%s\","
+                    "\"status\":\"%s\","
+                    "\"distance_ly\":%.3f}",
+                    (unsigned long long)u->probes[j].id.hi,
+                    (unsigned long long)u->probes[j].id.lo,
+                    u->probes[j].name,
+                    PIPE_STATUS_NAMES[u->probes[j].status],
+                    dist);
+                np_count++;
+            }
+        }
+    }
+    obs_printf(o, "],");
+
+    /* Inbox — delivered messages for this probe */
+    obs_printf(o, "\"inbox\":[");
+    {
+        const message_t **msgs =
+            ARENA_ARRAY(&g_pipe_arena, const message_t *, 16);
+        int nm = msgs ? comm_view_inbox(&g_pipe_comm, pr->id,
+                                        msgs, 16) : 0;
+        for (int m = 0; m < nm; m++) {
+            if (m > 0) obs_putc(o, ',');
+            const char *safe = pipe_escape(&g_pipe_arena,
+                msgs[m]->content, MAX_MSG_CONTENT);
+            obs_printf(o, "{\"from\":\"%llu-%llu\","
+                "\"content\":\"%s\","
+                "\"sent_tick\":%llu}",
+                (unsigned long long)msgs[m]->sender_id.hi,
+                (unsigned long long)msgs[m]->sender_id.lo,
+                safe,
+                (unsigned long long)msgs[m]->sent_tick);
+        }
+    }
+    obs_printf(o, "],");
+
+    /* Visible beacons in current system */
+    obs_printf(o, "\"visible_beacons\":[");
+    {
+        const beacon_t **beacons =
+            ARENA_ARRAY(&g_pipe_arena, const beacon_t *, 16);
+        int nb = beacons ? comm_view_beacons(&g_pipe_comm,
+                               pr->system_id, beacons, 16) : 0;
+        for (int b = 0; b < nb; b++) {
+            if (b > 0) obs_putc(o, ',');
+            const char *safe = pipe_escape(&g_pipe_arena,
+                beacons[b]->message, MAX_BEACON_MSG);
+            obs_printf(o, "{\"owner\":\"%llu-%llu\","
+                "\"message\":\"%s\","
+                "\"placed_tick\":%llu}",
+                (unsigned long long)beacons[b]->owner_id.hi,
+                (unsigned long long)beacons[b]->owner_id.lo,
+                safe,
+                (unsigned long long)beacons[b]->placed_tick);
+        }
+    }
+    obs_printf(o, "],");
+
+    /* Visible structures in current system */
+    obs_printf(o, "\"visible_structures\":[");
+    {
+        int vs_count = 0;
+        for (int s = society_first_structure(&g_pipe_society,
+                                             pr->system_id);
+             s >= 0; s = society_next_structure(&g_pipe_society, s)) {
+            const structure_t *st = &g_pipe_society.structures[s];
+            if (vs_count > 0) obs_putc(o, ',');
+            const structure_spec_t *spec = structure_get_spec(st->type);
+            obs_printf(o, "{\"type\":%d,\"name\":\"%s\","
+                "\"complete\":%s,"
+                "\"progress\":%.3f,"
+                "\"builder\":\"%llu-%llu\"}",
+                (int)st->type,
+                spec ? spec->name : "unknown",
+                st->complete ? "true" : "false",
+                st->build_ticks_total > 0
+                  ? (double)st->build_ticks_elapsed / st->build_ticks_total
+                  : 0.0,
+                (unsigned long long)st->builder_ids[0].hi,
+                (unsigned long long)st->builder_ids[0].lo);
+            vs_count++;
+        }
+    }
+    obs_printf(o, "],");
+
+    /* Pending trades for this probe */
+    obs_printf(o, "\"pending_trades\":[");
+    {
+        int tc = 0;
+        for (int t = society_first_pending_trade(&g_pipe_society, pr->id);
+             t >= 0;
+             t = society_next_pending_trade(&g_pipe_society, pr->id, t)) {
+            const trade_t *tr = &g_pipe_society.trades[t];
+            if (tc > 0) obs_putc(o, ',');
+            obs_printf(o, "{\"from\":\"%llu-%llu\","
+                "\"to\":\"%llu-%llu\","
+                "\"resource\":\"%s\","
+                "\"amount\":%.1f,"
+                "\"status\":%d}",
+                (unsigned long long)tr->sender_id.hi,
+                (unsigned long long)tr->sender_id.lo,
+                (unsigned long long)tr->receiver_id.hi,
+                (unsigned long long)tr->receiver_id.lo,
+                resource_to_name(tr->resource),
+                tr->amount,
+                (int)tr->status);
+            tc++;
+        }
+    }
+    obs_printf(o, "],");
+
+    /* Claims on probe's current system */
+    obs_printf(o, "\"claims\":[");
+    {
+        const claim_t *cl = society_find_claim(&g_pipe_society,
+                                               pr->system_id);
+        if (cl) {
+            obs_printf(o, "{\"system_id\":\"%llu-%llu\","
+                "\"claimer\":\"%llu-%llu\","
+                "\"tick\":%llu}",
+                (unsigned long long)cl->system_id.hi,
+                (unsigned long long)cl->system_id.lo,
+                (unsigned long long)cl->claimer_id.hi,
+                (unsigned long long)cl->claimer_id.lo,
+                (unsigned long long)cl->claimed_tick);
+        }
+    }
+    obs_printf(o, "],");
+
+    /* Active proposals */
+    obs_printf(o, "\"proposals\":[");
+    {
+        int pc = 0;
+        for (int pi2 = 0; pi2 < g_pipe_society.proposal_count; pi2++) {
+            const proposal_t *prop = &g_pipe_society.proposals[pi2];
+            if (prop->status != VOTE_OPEN) continue;
+            if (pc > 0) obs_putc(o, ',');
+            /* Escape proposal text */
+            char safe_txt[MAX_PROPOSAL_TEXT + 64];
+            int si = 0;
+            for (int c = 0; prop->text[c] && si < (int)sizeof(safe_txt) - 2; c++) {
+                char ch = prop->text[c];
+                if (ch == '"' || ch == '\\') safe_txt[si++] = '\\';
+                safe_txt[si++] = ch;
+            }
+            safe_txt[si] = '\0';
+            obs_printf(o, "{\"idx\":%d,"
+                "\"proposer\":\"%llu-%llu\","
+                "\"text\":\"%s\","
+                "\"deadline\":%llu,"
+                "\"for\":%d,\"against\":%d}",
+                prop->handle,
+                (unsigned long long)prop->proposer_id.hi,
+                (unsigned long long)prop->proposer_id.lo,
+                safe_txt,
+                (unsigned long long)prop->deadline_tick,
+                prop->votes_for, prop->votes_against);
+            pc++;
+        }
+    }
+    obs_printf(o, "],");
+
+    /* Trust relationships */
+    obs_printf(o, "\"trust\":[");
+    {
+        /* Contacts are unbounded; cap what goes on the wire */
+        int tc2 = 0;
+        for (int e = society_first_relationship(&g_pipe_society, pr->id);
+             e >= 0 && tc2 < OBS_MAX_TRUST;
+             e = society_next_relationship(&g_pipe_society, e)) {
+            const relationship_t *rel =
+                society_relationship_at(&g_pipe_society, e);
+            if (tc2 > 0) obs_putc(o, ',');
+            obs_printf(o, "{\"probe_id\":\"%llu-%llu\","
+                "\"trust\":%.3f}",
+                (unsigned long long)rel->other_id.hi,
+                (unsigned long long)rel->other_id.lo,
+                (double)rel->trust);
+            tc2++;
+        }
+    }
+    obs_printf(o, "],");
+
+    /* Research progress (if active) */
+    if (g_pipe_research[i].active) {
+        int trem = (int)g_pipe_research[i].ticks_total
+                 - (int)g_pipe_research[i].ticks_elapsed;
+        if (trem < 0) trem = 0;
+        double prog = g_pipe_research[i].ticks_total > 0
+            ? (double)g_pipe_research[i].ticks_elapsed
+              / g_pipe_research[i].ticks_total
+            : 0.0;
+        obs_printf(o, "\"research\":{\"domain\":%d,"
+            "\"progress\":%.3f,"
+            "\"ticks_remaining\":%d},",
+            g_pipe_research[i].domain, prog, trem);
+    }
+
+    /* Standing order, and whether the agent has a decision to make */
+    standing_order_t *so = &g_pipe_orders[i];
+    if (so->active) {
+        obs_printf(o, "\"standing_order\":{\"action\":\"%s\","
+            "\"executed\":%u,\"repeat\":%u,\"until\":\"%s\"},",
+            action_type_to_name(so->action.type), so->executed,
+            so->repeat, order_until_name(so->until));
+    }
+    if (so->ended) {
+        obs_printf(o, "\"order_ended\":\"%s\",", so->ended);
+        so->ended = NULL;
+    }
+    obs_printf(o, "\"input_needed\":%s,", so->active ? "false" : "true");
+
+    /* Pending hazard threats */
+    obs_printf(o, "\"threats\":[");
+    {
+        pending_hazard_t tbuf[8];
+        int tc3 = events_get_threats(&g_pipe_events, pr->id, tbuf, 8);
+        for (int t = 0; t < tc3; t++) {
+            if (t > 0) obs_putc(o, ',');
+            int ticks_until = (int)(tbuf[t].strike_tick - u->tick);
+            if (ticks_until < 0) ticks_until = 0;
+            const char *haz_names[] = {"solar_flare","asteroid_collision","radiation_burst"};
+            const char *hname = (tbuf[t].subtype >= 0 && tbuf[t].subtype < 3)
+                ? haz_names[tbuf[t].subtype] : "unknown";
+            obs_printf(o, "{\"type\":\"%s\",\"severity\":%.3f,\"ticks_until\":%d}",
+                hname, (double)tbuf[t].severity, ticks_until);
+        }
+    }
+    obs_printf(o, "],");
+
+    /* Relay network */
+    obs_printf(o, "\"relay_network\":[");
+    {
+        int rc2 = 0;
+        for (int r = 0; r < g_pipe_comm.relay_count; r++) {
+            relay_t *rl = &g_pipe_comm.relays[r];
+            if (!rl->active) continue;
+            if (rc2 > 0) obs_putc(o, ',');
+            obs_printf(o, "{\"system_id\":\"%llu-%llu\","
+                "\"owner\":\"%llu-%llu\","
+                "\"range_ly\":%.1f}",
+                (unsigned long long)rl->system_id.hi,
+                (unsigned long long)rl->system_id.lo,
+                (unsigned long long)rl->owner_id.hi,
+                (unsigned long long)rl->owner_id.lo,
+                rl->range_ly);
+            rc2++;
+        }
+    }
+    obs_printf(o, "],");
+
+    /* Close probe object — remove trailing comma if needed */
+    if (o->len > 0 && o->buf[o->len - 1] == ',') o->len--;
+    obs_printf(o, "}");
+    arena_release(&g_pipe_arena, obs_mark);
+}
+
+/* Append "observations":[...] to o: every probe in u, or those picked
+ * by the request's "observe" list, with their byte ranges recorded if
+ * the request asked for slices. */
+static void pipe_observe(obs_buf_t *o, universe_t *u, uint64_t seed) {
+    obs_select_t *sel = &g_pipe_obs_sel;
+    obs_printf(o, "\"observations\":[");
+    size_t base = o->len - 1;
+    bool first = true;
+    for (uint32_t i = 0; i < u->probe_count; i++) {
+        if (sel->filter && !sel->want[i]) continue;
+        if (!first) obs_putc(o, ',');
+        first = false;
+        size_t at = o->len;
+        if (pipe_lod_coarse(i)) pipe_observe_stub(o, u, i);
+        else pipe_observe_probe(o, u, seed, i);
+        sel->off[i] = (uint32_t)(at - base);
+        sel->len[i] = (uint32_t)(o->len - at);
+    }
+    obs_printf(o, "]");
+    if (!sel->slices) return;
+
+    /* Where each object sits, counted in bytes from the '[' */
+    obs_printf(o, ",\"slices\":{");
+    first = true;
+    for (uint32_t i = 0; i < u->probe_count; i++) {
+        if (sel->filter && !sel->want[i]) continue;
+        if (!first) obs_putc(o, ',');
+        first = false;
+        obs_printf(o, "\"%llu-%llu\":[%u,%u,%d]",
+            (unsigned long long)u->probes[i].id.hi,
+            (unsigned long long)u->probes[i].id.lo,
+            sel->off[i], sel->len[i], g_pipe_orders[i].active ? 0 : 1);
+    }
+    obs_putc(o, '}');
+}
+
+/* Append "summary":{...}, to o: the latest metrics, one row per probe
+ * and the events logged since the last summary. */
+static void pipe_summary(obs_buf_t *o, universe_t *u) {
+    const metrics_snapshot_t *m = metrics_latest(&g_pipe_metrics);
+    obs_printf(o, "\"summary\":{\"metrics\":{\"probes_spawned\":%u,"
+        "\"avg_tech\":%.2f,\"avg_trust\":%.3f,\"systems_explored\":%u,"
+        "\"total_discoveries\":%u,\"total_hazards_survived\":%u},",
+        m ? m->probes_spawned : u->probe_count,
+        m ? m->avg_tech_level : 0.0, m ? (double)m->avg_trust : 0.0,
+        m ? m->systems_explored : 0, m ? m->total_discoveries : 0,
+        m ? m->total_hazards_survived : 0);
+
+    obs_printf(o, "\"fields\":[\"probe_id\",\"name\",\"status\","
+        "\"generation\",\"location\",\"x\",\"y\",\"z\",\"hull\","
+        "\"energy\",\"fuel\"],\"probes\":[");
+    for (uint32_t i = 0; i < u->probe_count; i++) {
+        const probe_t *pr = &u->probes[i];
+        if (i > 0) obs_putc(o, ',');
+        obs_printf(o, "[\"%llu-%llu\",\"%s\",\"%s\",%u,\"%s\","
+            "%.3f,%.3f,%.3f,%.3f,%.4g,%.1f]",
+            (unsigned long long)pr->id.hi, (unsigned long long)pr->id.lo,
+            pr->name, PIPE_STATUS_NAMES[pr->status], pr->generation,
+            PIPE_LOC_NAMES[pr->location_type],
+            pr->heading.x, pr->heading.y, pr->heading.z,
+            (double)pr->hull_integrity, pr->energy_joules, pr->fuel_kg);
+    }
+
+    /* seq only grows, except across a restore or load */
+    if (g_pipe_summary_seen > g_pipe_events.seq) g_pipe_summary_seen = 0;
+    uint64_t from = events_first_seq(&g_pipe_events);
+    if (g_pipe_events.seq > SUMMARY_MAX_EVENTS &&
+        from < g_pipe_events.seq - SUMMARY_MAX_EVENTS)
+        from = g_pipe_events.seq - SUMMARY_MAX_EVENTS;
+    if (from < g_pipe_summary_seen) from = g_pipe_summary_seen;
+    obs_printf(o, "],\"events\":[");
+    arena_mark_t mark = arena_mark(&g_pipe_arena);
+    for (uint64_t n = from; n < g_pipe_events.seq; n++) {
+        const sim_event_t *ev = events_by_seq(&g_pipe_events, n);
+        if (n > from) obs_putc(o, ',');
+        obs_printf(o, "[%llu,\"%llu-%llu\",%d,\"%s\"]",
+            (unsigned long long)ev->tick,
+            (unsigned long long)ev->probe_id.hi,
+            (unsigned long long)ev->probe_id.lo, (int)ev->type,
+            pipe_escape(&g_pipe_arena, strtab_str(ev->description), 250));
+    }
+    arena_release(&g_pipe_arena, mark);
+    g_pipe_summary_seen = g_pipe_events.seq;
+    obs_printf(o, "]},");
+}
+
+/* Carry out probe i's action for this tick. Returns false if the
+ * action was refused (no target, wrong state, not enough resources). */
+static bool pipe_execute(universe_t *u, uint32_t i, const action_t *a,
+                         rng_t *rng, uint64_t seed) {
+    /* Handle travel_to_system specially — needs system lookup */
+    if (a->type == ACT_TRAVEL_TO_SYSTEM) {
+        probe_t *pr = &u->probes[i];
+        /* Already on the way: repeating the order is not an error */
+        if (pr->status == STATUS_TRAVELING) return true;
+        /* Find target system position; a miss generates the
+         * target sector */
+        system_t *target = sys_cache_get(a->target_system, seed,
+                                         a->target_sector);
+        if (!target) return false;
+        travel_order_t order = {
+            .target_pos = target->position,
+            .target_system_id = target->id,
+            .target_sector = target->sector
+        };
+        return travel_initiate(pr, &order).success;
+    }
+
+    /* Handle replicate action */
+    if (a->type == ACT_REPLICATE) {
+        probe_t *pr = &u->probes[i];
+        if (pr->status != STATUS_ACTIVE) return false;
+        if (repl_check_resources(pr) != 0) return false;
+        repl_begin(pr, &g_pipe_repl[i]);
+        return true;
+    }
+
+    /* Handle send_message action */
+    if (a->type == ACT_SEND_MESSAGE) {
+        probe_t *pr = &u->probes[i];
+        /* Find target probe for position */
+        int tidx = find_probe_idx(u, a->target_probe);
+        if (tidx < 0) return false;
+        return comm_send_targeted(&g_pipe_comm, pr, a->target_probe,
+                                  u->probes[tidx].heading,
+                                  a->message, u->tick) == 0;
+    }
+
+    /* Handle place_beacon action */
+    if (a->type == ACT_PLACE_BEACON) {
+        probe_t *pr = &u->probes[i];
+        return comm_place_beacon(&g_pipe_comm, pr, pr->system_id,
+                                 a->message, u->tick) == 0;
+    }
+
+    /* Handle build_structure action */
+    if (a->type == ACT_BUILD_STRUCTURE) {
+        probe_t *pr = &u->probes[i];
+        int stype = a->structure_type;
+        if (stype < 0 || stype >= STRUCT_TYPE_COUNT) return false;
+        return society_build_start(&g_pipe_society, pr,
+                   (structure_type_t)stype, pr->system_id,
+                   u->tick, rng) >= 0;
+    }
+
+    /* Handle trade action */
+    if (a->type == ACT_TRADE) {
+        probe_t *pr = &u->probes[i];
+        int tidx = find_probe_idx(u, a->target_probe);
+        if (tidx < 0) return false;
+        bool same_sys = uid_eq(pr->system_id, u->probes[tidx].system_id);
+        return society_trade_send(&g_pipe_society, pr,
+                   &u->probes[tidx], a->target_resource,
+                   a->amount, same_sys, u->tick) >= 0;
+    }
+
+    /* Handle claim_system action */
+    if (a->type == ACT_CLAIM_SYSTEM) {
+        probe_t *pr = &u->probes[i];
+        return society_claim_system(&g_pipe_society, pr->id,
+                                    pr->system_id, u->tick) == 0;
+    }
+
+    /* Handle revoke_claim action */
+    if (a->type == ACT_REVOKE_CLAIM) {
+        probe_t *pr = &u->probes[i];
+        return society_revoke_claim(&g_pipe_society, pr->id,
+                                    pr->system_id) == 0;
+    }
+
+    /* Handle propose action */
+    if (a->type == ACT_PROPOSE) {
+        probe_t *pr = &u->probes[i];
+        return society_propose(&g_pipe_society, pr->id, a->message,
+                               u->tick, u->tick + 100) >= 0;
+    }
+
+    /* Handle vote action */
+    if (a->type == ACT_VOTE) {
+        probe_t *pr = &u->probes[i];
+        return society_vote(&g_pipe_society, a->proposal_idx,
+                            pr->id, a->vote_favor, u->tick) == 0;
+    }
+
+    /* Handle research action */
+    if (a->type == ACT_RESEARCH) {
+        probe_t *pr = &u->probes[i];
+        int dom = a->research_domain;
+        if (dom < 0 || dom >= TECH_COUNT) return false;
+        if (!g_pipe_research[i].active) {
+            g_pipe_research[i].active = true;
+            g_pipe_research[i].domain = dom;
+            g_pipe_research[i].ticks_elapsed = 0;
+            g_pipe_research[i].ticks_total =
+                50 * (1 + pr->tech_levels[dom]);
+        }
+        return true;
+    }
+
+    /* Handle share_tech action */
+    if (a->type == ACT_SHARE_TECH) {
+        probe_t *pr = &u->probes[i];
+        int tidx = find_probe_idx(u, a->target_probe);
+        int dom = a->research_domain;
+        if (tidx < 0 || dom < 0 || dom >= TECH_COUNT) return false;
+        int level = society_share_tech(pr, &u->probes[tidx],
+                                       (tech_domain_t)dom);
+        society_update_trust(&g_pipe_society, pr->id,
+                             u->probes[tidx].id, TRUST_TECH_SHARE);
+        return level >= 0;
+    }
+
+    system_t *sys = sys_cache_get(u->probes[i].system_id,
+                                  seed, u->probes[i].sector);
+    if (!sys) return false;
+    action_result_t res = probe_execute_action(&u->probes[i], a, sys);
+
+    /* Artifact discovery: survey level 4 on a planet with artifact */
+    if (a->type == ACT_SURVEY) {
+        probe_t *pr = &u->probes[i];
+        for (int pi2 = 0; pi2 < sys->planet_count; pi2++) {
+            planet_t *pl = &sys->planets[pi2];
+            if (uid_eq(pr->body_id, pl->id)
+                && pl->has_artifact && !pl->artifact_discovered
+                && pl->surveyed[4]) {
+                pl->artifact_discovered = true;
+                /* Apply artifact bonus */
+                switch (pl->artifact_type) {
+                    case 0: /* tech_boost */
+                        if (pl->artifact_tech_domain < TECH_COUNT)
+                            pr->tech_levels[pl->artifact_tech_domain]++;
+                        break;
+                    case 1: /* resource_cache */
+                        pr->resources[RES_IRON] += pl->artifact_value * 10.0;
+                        pr->resources[RES_WATER] += pl->artifact_value * 5.0;
+                        break;
+                    case 2: /* star_map — boost sensor range */
+                        pr->sensor_range_ly += (float)(pl->artifact_value * 5.0);
+                        break;
+                    case 3: /* comm_amplifier — boost sensor range */
+                        pr->sensor_range_ly += (float)(pl->artifact_value * 3.0);
+                        break;
+                }
+                /* Fire discovery event (reusing the closest subtype) */
+                char desc[256];
+                snprintf(desc, sizeof(desc),
+                    "Artifact discovered: %s", pl->artifact_desc);
+                events_log(&g_pipe_events, EVT_DISCOVERY, DISC_IMPACT_CRATER,
+                           pr->id, pr->system_id, u->tick, desc,
+                           (float)pl->artifact_value);
+            }
+        }
+    }
+    return res.success;
+}
+
+/* ---- Warp ---- */
+
+/* Earliest tick at which something already scheduled reaches an agent:
+ * replication or research completing, a build finishing, a message or
+ * trade arriving, a vote closing, a hazard striking or a scenario event
+ * firing. UINT64_MAX if nothing is pending. Travel arrivals and random
+ * events are caught as they happen instead (see pipe_warp_woken). */
+static uint64_t pipe_next_wake(const universe_t *u, const char **reason) {
+    uint64_t wake = UINT64_MAX;
+    *reason = NULL;
+#define WAKE(t, why) do { uint64_t t_ = (t); \
+        if (t_ < wake) { wake = t_; *reason = (why); } } while (0)
+    for (uint32_t i = 0; i < u->probe_count; i++) {
+        const replication_state_t *rs = &g_pipe_repl[i];
+        if (rs->active)
+            WAKE(u->tick + (rs->ticks_total > rs->ticks_elapsed
+                            ? rs->ticks_total - rs->ticks_elapsed : 1),
+                 "replication");
+        const research_state_t *rr = &g_pipe_research[i];
+        if (rr->active)
+            WAKE(u->tick + (rr->ticks_total > rr->ticks_elapsed
+                            ? rr->ticks_total - rr->ticks_elapsed : 1),
+                 "research");
+    }
+    for (int i = 0; i < g_pipe_society.structure_count; i++) {
+        const structure_t *st = &g_pipe_society.structures[i];
+        float mult = society_build_speed_mult(st->builder_count);
+        if (st->complete || mult <= 0.0f) continue;
+        /* Same float test as society_build_tick() */
+        uint32_t n = 1;
+        while ((float)(st->build_ticks_elapsed + n) * mult
+               < (float)st->build_ticks_total) n++;
+        WAKE(u->tick + n, "build");
+    }
+    for (int i = 0; i < g_pipe_comm.count; i++) {
+        const message_t *m = &g_pipe_comm.messages[i];
+        if (m->status == MSG_IN_TRANSIT)
+            WAKE(MAX(m->arrival_tick, u->tick + 1), "message");
+    }
+    if (g_pipe_society.trade_count > 0)
+        WAKE(MAX(g_pipe_society.trades[g_pipe_society.trade_heap[0]]
+                     .arrival_tick, u->tick + 1), "trade");
+    if (g_pipe_society.proposal_open > 0)
+        WAKE(MAX(g_pipe_society.proposals[g_pipe_society.proposal_heap[0]]
+                     .deadline_tick, u->tick + 1), "vote");
+    for (int i = 0; i < g_pipe_events.pending_count; i++) {
+        const pending_hazard_t *h = &g_pipe_events.pending_hazards[i];
+        if (!h->struck) WAKE(MAX(h->strike_tick, u->tick + 1), "hazard");
+    }
+    for (int i = 0; i < g_pipe_scenario_count; i++) {
+        const scenario_event_t *se = &g_pipe_scenario[i];
+        if (!se->fired && se->at_tick > u->tick) WAKE(se->at_tick, "scenario");
+    }
+#undef WAKE
+    return wake;
+}
+
+/* The action phase of a tick with no agent input: probes with a
+ * standing order carry it out, every other probe waits. */
+static void pipe_wait_all(universe_t *u, rng_t *rng, uint64_t seed) {
+    action_t wait = { .type = ACT_WAIT };
+    for (uint32_t i = 0; i < u->probe_count; i++) {
+        if (u->probes[i].status == STATUS_DESTROYED) continue;
+        if (pipe_lod_coarse(i)) continue;
+        if (g_pipe_orders[i].active) {
+            bool ok = pipe_execute(u, i, &g_pipe_orders[i].action, rng, seed);
+            pipe_order_step(i, ok);
+            continue;
+        }
+        system_t *sys = sys_cache_get(u->probes[i].system_id, seed,
+                                      u->probes[i].sector);
+        if (sys) probe_execute_action(&u->probes[i], &wait, sys);
+    }
+}
+
+/* What the warp watches between scheduled wake points. */
+typedef struct {
+    uint32_t probe_count;
+    uint64_t event_seq;
+    uint64_t order_ends;
+    uint8_t  status[MAX_PROBES];
+} warp_watch_t;
+
+static void pipe_warp_watch(warp_watch_t *w, const universe_t *u) {
+    w->probe_count = u->probe_count;
+    w->event_seq = g_pipe_events.seq;
+    w->order_ends = g_pipe_order_ends;
+    for (uint32_t i = 0; i < u->probe_count; i++)
+        w->status[i] = (uint8_t)u->probes[i].status;
+}
+
+/* Why the last tick needs an agent's attention, or NULL: a probe was
+ * born, a standing order ended, a probe arrived, ran dry or was
+ * destroyed, or an event was logged. */
+static const char *pipe_warp_woken(const warp_watch_t *w, const universe_t *u) {
+    if (u->probe_count != w->probe_count) return "replication";
+    if (g_pipe_order_ends != w->order_ends) return "order";
+    if (g_pipe_events.seq != w->event_seq) return "event";
+    for (uint32_t i = 0; i < u->probe_count; i++)
+        if (u->probes[i].status != w->status[i]) return "status";
+    return NULL;
+}
+
+/* Probe filter and projection for {"cmd":"query"}. A criterion left out
+ * of the request matches every probe. */
+typedef enum {
+    QF_NAME       = 1 << 0,
+    QF_STATUS     = 1 << 1,
+    QF_LOCATION   = 1 << 2,
+    QF_GENERATION = 1 << 3,
+    QF_HULL       = 1 << 4,
+    QF_ENERGY     = 1 << 5,
+    QF_FUEL       = 1 << 6,
+    QF_TECH       = 1 << 7,
+    QF_SECTOR     = 1 << 8,
+    QF_SYSTEM     = 1 << 9,
+    QF_LOD        = 1 << 10,
+    QF_DEFAULT    = QF_NAME | QF_STATUS | QF_LOCATION | QF_GENERATION
+} query_field_t;
+
+/* Wire names of the query_field_t bits, lowest bit first */
+static const char *QUERY_FIELD_NAMES[] = {
+    "name","status","location","generation","hull","energy","fuel",
+    "tech","sector","system_id","lod"
+};
+#define QUERY_FIELD_COUNT \
+    (int)(sizeof(QUERY_FIELD_NAMES) / sizeof(QUERY_FIELD_NAMES[0]))
+
+typedef struct {
+    int       status;                /* PIPE_STATUS_NAMES index; -1 = any */
+    int       location;              /* PIPE_LOC_NAMES index; -1 = any */
+    long long gen_min, gen_max;
+    int       tech_domain;           /* -1 = no tech threshold */
+    long long tech_min;
+    bool      box;
+    long long box_min[3], box_max[3];  /* sector coords, inclusive */
+    unsigned  fields;                /* query_field_t bits */
+} probe_query_t;
+
+static int pipe_name_index(const char *const *names, int n, const char *s) {
+    for (int i = 0; i < n; i++)
+        if (strcmp(names[i], s) == 0) return i;
+    return -1;
+}
+
+/* Parse a query request into q. Returns NULL, or what is wrong with it. */
+static const char *pipe_parse_query(const char *line, probe_query_t *q) {
+    char name[32];
+    q->status = q->location = q->tech_domain = -1;
+    if (pipe_parse_str(line, "status", name, sizeof(name)) == 0 &&
+        (q->status = pipe_name_index(PIPE_STATUS_NAMES, 8, name)) < 0)
+        return "unknown status";
+    if (pipe_parse_str(line, "location", name, sizeof(name)) == 0 &&
+        (q->location = pipe_name_index(PIPE_LOC_NAMES, 5, name)) < 0)
+        return "unknown location";
+    q->gen_min = pipe_parse_int(line, "gen_min", 0);
+    q->gen_max = pipe_parse_int(line, "gen_max", UINT32_MAX);
+    if (strstr(line, "\"tech_domain\":")) {
+        q->tech_domain = (int)pipe_parse_int(line, "tech_domain", -1);
+        if (q->tech_domain < 0 || q->tech_domain >= TECH_COUNT)
+            return "unknown tech_domain";
+        q->tech_min = pipe_parse_int(line, "tech_min", 0);
+    }
+    int nmin = pipe_parse_ints(line, "sector_min", q->box_min, 3);
+    int nmax = pipe_parse_ints(line, "sector_max", q->box_max, 3);
+    q->box = nmin >= 0 || nmax >= 0;
+    if (q->box && (nmin != 3 || nmax != 3))
+        return "sector_min and sector_max need [x,y,z]";
+
+    q->fields = QF_DEFAULT;
+    const char *p = strstr(line, "\"fields\":[");
+    if (p) {
+        q->fields = 0;
+        p += 10;
+        while (*p && *p != ']') {
+            if (*p++ != '"') continue;
+            int k = 0;
+            while (*p && *p != '"' && k < (int)sizeof(name) - 1)
+                name[k++] = *p++;
+            name[k] = '\0';
+            if (*p == '"') p++;
+            if (strcmp(name, "id") == 0) continue;  /* always sent */
+            int f = pipe_name_index(QUERY_FIELD_NAMES, QUERY_FIELD_COUNT,
+                                    name);
+            if (f < 0) return "unknown field";
+            q->fields |= 1u << f;
+        }
+    }
+    return NULL;
+}
+
+static bool pipe_query_match(const probe_query_t *q, const probe_t *pr) {
+    if (q->status >= 0 && (int)pr->status != q->status) return false;
+    if (q->location >= 0 && (int)pr->location_type != q->location)
+        return false;
+    if (pr->generation < q->gen_min || pr->generation > q->gen_max)
+        return false;
+    if (q->tech_domain >= 0 && pr->tech_levels[q->tech_domain] < q->tech_min)
+        return false;
+    if (q->box) {
+        const long long c[3] = { pr->sector.x, pr->sector.y, pr->sector.z };
+        for (int a = 0; a < 3; a++)
+            if (c[a] < q->box_min[a] || c[a] > q->box_max[a]) return false;
+    }
+    return true;
+}
+
+/* Append probe i's row to o: its id and the fields q asks for. */
+static void pipe_query_row(obs_buf_t *o, const universe_t *u, uint32_t i,
+                           unsigned f) {
+    const probe_t *pr = &u->probes[i];
+    obs_printf(o, "{\"id\":\"%llu-%llu\"",
+        (unsigned long long)pr->id.hi, (unsigned long long)pr->id.lo);
+    if (f & QF_NAME) obs_printf(o, ",\"name\":\"%s\"", pr->name);
+    if (f & QF_STATUS)
+        obs_printf(o, ",\"status\":\"%s\"", PIPE_STATUS_NAMES[pr->status]);
+    if (f & QF_LOCATION)
+        obs_printf(o, ",\"location\":\"%s\"",
+            PIPE_LOC_NAMES[pr->location_type]);
+    if (f & QF_GENERATION) obs_printf(o, ",\"generation\":%u", pr->generation);
+    if (f & QF_HULL) obs_printf(o, ",\"hull\":%.3f", (double)pr->hull_integrity);
+    if (f & QF_ENERGY) obs_printf(o, ",\"energy\":%.1f", pr->energy_joules);
+    if (f & QF_FUEL) obs_printf(o, ",\"fuel\":%.1f", pr->fuel_kg);
+    if (f & QF_TECH) {
+        obs_printf(o, ",\"tech\":[");
+        for (int t = 0; t < TECH_COUNT; t++)
+            obs_printf(o, t ? ",%u" : "%u", pr->tech_levels[t]);
+        obs_putc(o, ']');
+    }
+    if (f & QF_SECTOR)
+        obs_printf(o, ",\"sector\":[%d,%d,%d]",
+            pr->sector.x, pr->sector.y, pr->sector.z);
+    if (f & QF_SYSTEM)
+        obs_printf(o, ",\"system_id\":\"%llu-%llu\"",
+            (unsigned long long)pr->system_id.hi,
+            (unsigned long long)pr->system_id.lo);
+    if (f & QF_LOD)
+        obs_printf(o, ",\"lod\":\"%s\"", pipe_lod_coarse(i) ? "coarse" : "full");
+    obs_putc(o, '}');
+}
+
 static int run_pipe_mode(uint64_t seed) {
     static universe_t uni;
     memset(&uni, 0, sizeof(uni));
@@ -304,8 +1749,7 @@ static int run_pipe_mode(uint64_t seed) {
     rng_t rng;
     rng_seed(&rng, seed);
 
-    arena_t arena;
-    if (arena_init(&arena, 1024 * 1024) != 0) {
+    if (arena_init(&g_pipe_arena, 1024 * 1024) != 0) {
         pipe_err("arena init failed");
         return 1;
     }
@@ -321,6 +1765,11 @@ static int run_pipe_mode(uint64_t seed) {
     comm_init(&g_pipe_comm);
     society_init(&g_pipe_society);
     memset(g_pipe_research, 0, sizeof(g_pipe_research));
+    memset(g_pipe_orders, 0, sizeof(g_pipe_orders));
+    pipe_probe_index_reset();
+    memset(&g_pipe_prof, 0, sizeof(g_pipe_prof));
+    sim_lod_init(&g_pipe_lod, 0, SIM_LOD_RADIUS_DEFAULT);
+    const char *prof_dump = profile_from_env(&g_pipe_prof);
 
     /* Init Bob */
     probe_init_bob(&uni.probes[0]);
@@ -345,6 +1794,7 @@ static int run_pipe_mode(uint64_t seed) {
     static char line[PIPE_BUF];
     static action_t actions[MAX_PROBES];
     static char resp[RESP_BUF];
+    static obs_buf_t out;
 
     while (fgets(line, sizeof(line), stdin)) {
         int len = (int)strlen(line);
@@ -366,866 +1816,195 @@ static int run_pipe_mode(uint64_t seed) {
 
         /* ---- tick ---- */
         if (strcmp(cmd, "tick") == 0) {
-            pipe_parse_actions(line, &uni, actions);
+            uint64_t tick_t0 = profile_begin(&g_pipe_prof);
+            uint64_t t0 = tick_t0;
+            pipe_parse_actions(line, &uni, actions, g_pipe_lod.attached);
+            pipe_parse_observe(line, &uni);
+            profile_end(&g_pipe_prof, PROF_PARSE, t0);
+            pipe_lod_sync(&uni, &rng, seed);
 
             /* Execute actions */
+            t0 = profile_begin(&g_pipe_prof);
             for (uint32_t i = 0; i < uni.probe_count; i++) {
                 if (uni.probes[i].status == STATUS_DESTROYED) continue;
+                if (pipe_lod_coarse(i)) continue;
 
-                /* Handle travel_to_system specially — needs system lookup */
-                if (actions[i].type == ACT_TRAVEL_TO_SYSTEM) {
-                    probe_t *pr = &uni.probes[i];
-                    if (pr->status == STATUS_TRAVELING) continue;
-                    /* Find target system position from nearby sectors */
-                    system_t *target = sys_cache_get(
-                        actions[i].target_system, seed,
-                        actions[i].target_sector);
-                    if (!target) {
-                        /* Try generating the target sector */
-                        system_t tmp[30];
-                        int n = generate_sector(tmp, 30, seed,
-                                                actions[i].target_sector);
-                        for (int j = 0; j < n; j++) {
-                            if (uid_eq(tmp[j].id, actions[i].target_system)
-                                && g_pipe_sys_count < SYS_CACHE_MAX) {
-                                g_pipe_sys_cache[g_pipe_sys_count] = tmp[j];
-                                target = &g_pipe_sys_cache[g_pipe_sys_count++];
-                                break;
-                            }
-                        }
-                    }
-                    if (target) {
-                        travel_order_t order = {
-                            .target_pos = target->position,
-                            .target_system_id = target->id,
-                            .target_sector = target->sector
-                        };
-                        travel_initiate(pr, &order);
-                    }
-                    continue;
-                }
-
-                /* Handle replicate action */
-                if (actions[i].type == ACT_REPLICATE) {
-                    probe_t *pr = &uni.probes[i];
-                    if (pr->status != STATUS_ACTIVE) continue;
-                    if (repl_check_resources(pr) == 0) {
-                        repl_begin(pr, &g_pipe_repl[i]);
-                    }
-                    continue;
-                }
-
-                /* Handle send_message action */
-                if (actions[i].type == ACT_SEND_MESSAGE) {
-                    probe_t *pr = &uni.probes[i];
-                    /* Find target probe for position */
-                    int tidx = find_probe_idx(&uni, actions[i].target_probe);
-                    if (tidx >= 0) {
-                        comm_send_targeted(&g_pipe_comm, pr,
-                            actions[i].target_probe,
-                            uni.probes[tidx].heading,
-                            actions[i].message, uni.tick);
-                    }
-                    continue;
-                }
-
-                /* Handle place_beacon action */
-                if (actions[i].type == ACT_PLACE_BEACON) {
-                    probe_t *pr = &uni.probes[i];
-                    comm_place_beacon(&g_pipe_comm, pr, pr->system_id,
-                                      actions[i].message, uni.tick);
-                    continue;
-                }
-
-                /* Handle build_structure action */
-                if (actions[i].type == ACT_BUILD_STRUCTURE) {
-                    probe_t *pr = &uni.probes[i];
-                    int stype = actions[i].structure_type;
-                    if (stype >= 0 && stype < STRUCT_TYPE_COUNT) {
-                        society_build_start(&g_pipe_society, pr,
-                            (structure_type_t)stype, pr->system_id,
-                            uni.tick, &rng);
-                    }
-                    continue;
-                }
-
-                /* Handle trade action */
-                if (actions[i].type == ACT_TRADE) {
-                    probe_t *pr = &uni.probes[i];
-                    int tidx = find_probe_idx(&uni, actions[i].target_probe);
-                    if (tidx >= 0) {
-                        bool same_sys = uid_eq(pr->system_id,
-                                               uni.probes[tidx].system_id);
-                        society_trade_send(&g_pipe_society, pr,
-                            &uni.probes[tidx], actions[i].target_resource,
-                            actions[i].amount, same_sys, uni.tick);
-                    }
-                    continue;
-                }
-
-                /* Handle claim_system action */
-                if (actions[i].type == ACT_CLAIM_SYSTEM) {
-                    probe_t *pr = &uni.probes[i];
-                    society_claim_system(&g_pipe_society, pr->id,
-                                         pr->system_id, uni.tick);
-                    continue;
-                }
-
-                /* Handle revoke_claim action */
-                if (actions[i].type == ACT_REVOKE_CLAIM) {
-                    probe_t *pr = &uni.probes[i];
-                    society_revoke_claim(&g_pipe_society, pr->id,
-                                          pr->system_id);
-                    continue;
-                }
-
-                /* Handle propose action */
-                if (actions[i].type == ACT_PROPOSE) {
-                    probe_t *pr = &uni.probes[i];
-                    society_propose(&g_pipe_society, pr->id,
-                                    actions[i].message, uni.tick,
-                                    uni.tick + 100);
-                    continue;
-                }
-
-                /* Handle vote action */
-                if (actions[i].type == ACT_VOTE) {
-                    probe_t *pr = &uni.probes[i];
-                    society_vote(&g_pipe_society, actions[i].proposal_idx,
-                                 pr->id, actions[i].vote_favor, uni.tick);
-                    continue;
-                }
-
-                /* Handle research action */
-                if (actions[i].type == ACT_RESEARCH) {
-                    probe_t *pr = &uni.probes[i];
-                    int dom = actions[i].research_domain;
-                    if (dom >= 0 && dom < TECH_COUNT) {
-                        if (!g_pipe_research[i].active) {
-                            g_pipe_research[i].active = true;
-                            g_pipe_research[i].domain = dom;
-                            g_pipe_research[i].ticks_elapsed = 0;
-                            g_pipe_research[i].ticks_total =
-                                50 * (1 + pr->tech_levels[dom]);
-                        }
-                    }
-                    continue;
-                }
-
-                /* Handle share_tech action */
-                if (actions[i].type == ACT_SHARE_TECH) {
-                    probe_t *pr = &uni.probes[i];
-                    int tidx = find_probe_idx(&uni, actions[i].target_probe);
-                    int dom = actions[i].research_domain;
-                    if (tidx >= 0 && dom >= 0 && dom < TECH_COUNT) {
-                        society_share_tech(pr, &uni.probes[tidx],
-                                           (tech_domain_t)dom);
-                        society_update_trust(pr, &uni.probes[tidx],
-                                             TRUST_TECH_SHARE);
-                    }
-                    continue;
-                }
-
-                system_t *sys = sys_cache_get(uni.probes[i].system_id,
-                                              seed, uni.probes[i].sector);
-                if (sys) probe_execute_action(&uni.probes[i], &actions[i], sys);
-
-                /* Artifact discovery: survey level 4 on a planet with artifact */
-                if (actions[i].type == ACT_SURVEY && sys) {
-                    probe_t *pr = &uni.probes[i];
-                    for (int pi2 = 0; pi2 < sys->planet_count; pi2++) {
-                        planet_t *pl = &sys->planets[pi2];
-                        if (uid_eq(pr->body_id, pl->id)
-                            && pl->has_artifact && !pl->artifact_discovered
-                            && pl->surveyed[4]) {
-                            pl->artifact_discovered = true;
-                            /* Apply artifact bonus */
-                            switch (pl->artifact_type) {
-                                case 0: /* tech_boost */
-                                    if (pl->artifact_tech_domain < TECH_COUNT)
-                                        pr->tech_levels[pl->artifact_tech_domain]++;
-                                    break;
-                                case 1: /* resource_cache */
-                                    pr->resources[RES_IRON] += pl->artifact_value * 10.0;
-                                    pr->resources[RES_WATER] += pl->artifact_value * 5.0;
-                                    break;
-                                case 2: /* star_map — boost sensor range */
-                                    pr->sensor_range_ly += (float)(pl->artifact_value * 5.0);
-                                    break;
-                                case 3: /* comm_amplifier — boost sensor range */
-                                    pr->sensor_range_ly += (float)(pl->artifact_value * 3.0);
-                                    break;
-                            }
-                            /* Fire discovery event */
-                            if (g_pipe_events.count < MAX_EVENT_LOG) {
-                                sim_event_t *ev = &g_pipe_events.events[g_pipe_events.count++];
-                                ev->type = EVT_DISCOVERY;
-                                ev->subtype = DISC_IMPACT_CRATER; /* reuse closest subtype */
-                                ev->probe_id = pr->id;
-                                ev->system_id = pr->system_id;
-                                ev->tick = uni.tick;
-                                ev->severity = (float)pl->artifact_value;
-                                snprintf(ev->description, sizeof(ev->description),
-                                    "Artifact discovered: %s", pl->artifact_desc);
-                            }
-                        }
-                    }
-                }
+                bool ok = pipe_execute(&uni, i, &actions[i], &rng, seed);
+                pipe_order_step(i, ok);
             }
 
-            /* Advance simulation */
-            uni.tick++;
-            arena_reset(&arena);
-            rng_next(&rng);
+            profile_end(&g_pipe_prof, PROF_ACTIONS, t0);
 
-            for (uint32_t i = 0; i < uni.probe_count; i++) {
-                if (uni.probes[i].status == STATUS_TRAVELING)
-                    travel_tick(&uni.probes[i], &rng);
-
-                /* Advance replication */
-                if (uni.probes[i].status == STATUS_REPLICATING
-                    && g_pipe_repl[i].active) {
-                    int rc = repl_tick(&uni.probes[i], &g_pipe_repl[i]);
-                    if (rc == 1) {
-                        /* Replication complete — create child */
-                        if (uni.probe_count < MAX_PROBES) {
-                            probe_t *child = &uni.probes[uni.probe_count];
-                            if (repl_finalize(&uni.probes[i], child,
-                                              &g_pipe_repl[i], &rng) == 0) {
-                                /* Place child in same system */
-                                child->system_id = uni.probes[i].system_id;
-                                child->sector = uni.probes[i].sector;
-                                child->heading = uni.probes[i].heading;
-                                child->location_type = uni.probes[i].location_type;
-                                lineage_record(&g_pipe_lineage,
-                                    uni.probes[i].id, child->id,
-                                    uni.tick, child->generation);
-                                uni.probe_count++;
-                            }
-                        }
-                        memset(&g_pipe_repl[i], 0, sizeof(g_pipe_repl[i]));
-                    }
-                }
+            pipe_advance(&uni, &rng, seed);
 
-                probe_tick_energy(&uni.probes[i]);
-            }
+            /* Build observation response. It grows with the fleet
+             * (nearby_probes alone is quadratic), so it is not built in
+             * the fixed response buffer. */
+            t0 = profile_begin(&g_pipe_prof);
+            out.len = 0;
+            out.failed = false;
 
-            /* Deliver messages and trades */
-            comm_tick_deliver(&g_pipe_comm, uni.tick);
-            society_trade_tick(&g_pipe_society, uni.probes,
-                               (int)uni.probe_count, uni.tick);
-            society_build_tick(&g_pipe_society, uni.tick);
-
-            /* Auto-register completed relay satellites as comm relays */
-            for (int si = 0; si < g_pipe_society.structure_count; si++) {
-                structure_t *st = &g_pipe_society.structures[si];
-                if (st->type == STRUCT_RELAY_SATELLITE
-                    && st->complete && st->completed_tick == uni.tick) {
-                    int bidx = find_probe_idx(&uni, st->builder_ids[0]);
-                    if (bidx >= 0) {
-                        comm_build_relay(&g_pipe_comm, &uni.probes[bidx],
-                                         st->system_id, uni.tick);
-                    }
-                }
+            obs_printf(&out, "{\"ok\":true,\"tick\":%llu,",
+                (unsigned long long)uni.tick);
+            if (g_pipe_obs_sel.summary) pipe_summary(&out, &uni);
+            pipe_observe(&out, &uni, seed);
+            obs_putc(&out, '}');
+            if (out.failed) {
+                pipe_err("out of memory");
+                continue;
             }
+            obs_putc(&out, '\n');
+            profile_end(&g_pipe_prof, PROF_SERIALIZE, t0);
 
-            society_resolve_votes(&g_pipe_society, uni.tick);
+            t0 = profile_begin(&g_pipe_prof);
+            fwrite(out.buf, 1, out.len, stdout);
+            fflush(stdout);
+            profile_end(&g_pipe_prof, PROF_WRITE, t0);
+            profile_end(&g_pipe_prof, PROF_TICK, tick_t0);
+            continue;
+        }
 
-            /* Advance research */
-            for (uint32_t i = 0; i < uni.probe_count; i++) {
-                if (g_pipe_research[i].active) {
-                    g_pipe_research[i].ticks_elapsed++;
-                    if (g_pipe_research[i].ticks_elapsed
-                        >= g_pipe_research[i].ticks_total) {
-                        /* Research complete — advance tech */
-                        int d = g_pipe_research[i].domain;
-                        if (d >= 0 && d < TECH_COUNT
-                            && uni.probes[i].tech_levels[d] < 255) {
-                            uni.probes[i].tech_levels[d]++;
-                            /* Recalc derived stats */
-                            probe_t *pr = &uni.probes[i];
-                            pr->max_speed_c = 0.10f + 0.02f * pr->tech_levels[TECH_PROPULSION];
-                            pr->sensor_range_ly = 5.0f + 2.0f * pr->tech_levels[TECH_SENSORS];
-                            pr->mining_rate = 100.0f + 50.0f * pr->tech_levels[TECH_MINING];
-                            pr->construction_rate = 1.0f + 0.5f * pr->tech_levels[TECH_CONSTRUCTION];
-                            pr->compute_capacity = 100.0f + 50.0f * pr->tech_levels[TECH_COMPUTING];
-                        }
-                        memset(&g_pipe_research[i], 0,
-                               sizeof(g_pipe_research[i]));
-                    }
-                }
+        /* ---- warp ---- */
+        if (strcmp(cmd, "warp") == 0) {
+            /* {"cmd":"warp","until":T} or {"cmd":"warp","ticks":N}: advance
+             * with no actions until tick T, the next scheduled wake point,
+             * or the first tick an agent would want to see. Replies like
+             * tick, plus a "warp" summary. */
+            uint64_t w0 = profile_now_ns();
+            long long until = pipe_parse_int(line, "until", -1);
+            long long span = pipe_parse_int(line, "ticks", -1);
+            pipe_parse_observe(line, &uni);
+            if (until < 0 && span > 0) until = (long long)uni.tick + span;
+            if (until <= (long long)uni.tick) {
+                pipe_err("warp needs until > tick or ticks > 0");
+                continue;
             }
-
-            /* Trespass check — penalize trust for entering claimed systems */
-            for (uint32_t i = 0; i < uni.probe_count; i++) {
-                if (uni.probes[i].status == STATUS_DESTROYED) continue;
-                if (uni.probes[i].location_type == LOC_INTERSTELLAR) continue;
-                if (society_is_claimed_by_other(&g_pipe_society,
-                        uni.probes[i].system_id, uni.probes[i].id)) {
-                    probe_uid_t owner = society_get_claim(&g_pipe_society,
-                                            uni.probes[i].system_id);
-                    int oidx = find_probe_idx(&uni, owner);
-                    if (oidx >= 0) {
-                        society_update_trust(&uni.probes[oidx],
-                            &uni.probes[i], TRUST_CLAIM_VIOLATION);
-                    }
-                }
+            const char *reason = NULL;
+            uint64_t stop = pipe_next_wake(&uni, &reason);
+            if ((uint64_t)until <= stop) {
+                stop = (uint64_t)until;
+                reason = "until";
             }
 
-            /* Strike pending hazards */
-            events_strike_pending(&g_pipe_events, uni.probes,
-                                  (int)uni.probe_count, uni.tick);
-
-            /* Events */
-            for (uint32_t i = 0; i < uni.probe_count; i++) {
-                if (uni.probes[i].status == STATUS_DESTROYED) continue;
-                system_t *sys = sys_cache_get(uni.probes[i].system_id,
-                                              seed, uni.probes[i].sector);
-                if (sys) {
-                    int before = g_pipe_events.count;
-                    events_tick_probe(&g_pipe_events, &uni.probes[i],
-                                     sys, uni.tick, &rng);
-                    /* Queue warnings for any hazards generated */
-                    for (int e = before; e < g_pipe_events.count; e++) {
-                        if (g_pipe_events.events[e].type == EVT_HAZARD) {
-                            int delay = 3 + (int)(rng_next(&rng) % 3);
-                            events_queue_hazard(&g_pipe_events,
-                                uni.probes[i].id,
-                                g_pipe_events.events[e].subtype,
-                                g_pipe_events.events[e].severity,
-                                uni.tick, uni.tick + delay);
-                        }
-                    }
+            static warp_watch_t watch;
+            uint64_t from = uni.tick;
+            pipe_warp_watch(&watch, &uni);
+            while (uni.tick < stop) {
+                pipe_lod_sync(&uni, &rng, seed);
+                pipe_wait_all(&uni, &rng, seed);
+                pipe_advance(&uni, &rng, seed);
+                const char *woke = pipe_warp_woken(&watch, &uni);
+                if (woke) {
+                    /* At the wake point its own reason is more specific */
+                    if (uni.tick < stop) reason = woke;
+                    break;
                 }
             }
+            uint64_t warped = uni.tick - from;
+            double secs = (double)(profile_now_ns() - w0) / 1e9;
+
+            out.len = 0;
+            out.failed = false;
+            obs_printf(&out, "{\"ok\":true,\"tick\":%llu,\"warp\":{"
+                "\"from\":%llu,\"ticks\":%llu,\"reason\":\"%s\","
+                "\"elapsed_ms\":%.3f,\"ticks_per_sec\":%.1f},",
+                (unsigned long long)uni.tick, (unsigned long long)from,
+                (unsigned long long)warped, reason, secs * 1e3,
+                secs > 0 ? (double)warped / secs : 0.0);
+            if (g_pipe_obs_sel.summary) pipe_summary(&out, &uni);
+            pipe_observe(&out, &uni, seed);
+            obs_printf(&out, "}\n");
+            if (out.failed) {
+                pipe_err("out of memory");
+                continue;
+            }
+            fwrite(out.buf, 1, out.len, stdout);
+            fflush(stdout);
+            continue;
+        }
 
-            /* Fire scenario scheduled events */
-            for (int si = 0; si < g_pipe_scenario_count; si++) {
-                scenario_event_t *se = &g_pipe_scenario[si];
-                if (!se->fired && se->at_tick == uni.tick) {
-                    inject_event(&g_pipe_inject, se->type, se->subtype,
-                                 "", se->severity, se->target);
-                    se->fired = true;
+        /* ---- run ---- */
+        if (strcmp(cmd, "run") == 0) {
+            /* {"cmd":"run","ticks":N,"every":K}: N ticks in which every
+             * probe waits, with no observations. Every K ticks (K > 0) a
+             * {"progress":{...}} line goes out ahead of the summary. */
+            long long n = pipe_parse_int(line, "ticks", 0);
+            long long every = pipe_parse_int(line, "every", 0);
+            if (n <= 0) { pipe_err("run needs ticks > 0"); continue; }
+
+            uint64_t r0 = profile_now_ns();
+            uint64_t from = uni.tick;
+            for (long long t = 1; t <= n; t++) {
+                pipe_lod_sync(&uni, &rng, seed);
+                pipe_wait_all(&uni, &rng, seed);
+                pipe_advance(&uni, &rng, seed);
+                if (every > 0 && t % every == 0 && t < n) {
+                    double secs = (double)(profile_now_ns() - r0) / 1e9;
+                    fprintf(stdout, "{\"progress\":{\"tick\":%llu,"
+                        "\"done\":%lld,\"of\":%lld,\"probes\":%u,"
+                        "\"events\":%llu,\"ticks_per_sec\":%.1f}}\n",
+                        (unsigned long long)uni.tick, t, n, uni.probe_count,
+                        (unsigned long long)g_pipe_events.seq,
+                        secs > 0 ? (double)t / secs : 0.0);
+                    fflush(stdout);
                 }
             }
+            double secs = (double)(profile_now_ns() - r0) / 1e9;
+
+            uint32_t active = 0;
+            for (uint32_t i = 0; i < uni.probe_count; i++)
+                if (uni.probes[i].status != STATUS_DESTROYED) active++;
+            fprintf(stdout, "{\"ok\":true,\"tick\":%llu,\"run\":{"
+                "\"from\":%llu,\"ticks\":%lld,\"elapsed_ms\":%.3f,"
+                "\"ticks_per_sec\":%.1f},\"probes\":%u,\"alive\":%u,"
+                "\"events\":%llu}\n",
+                (unsigned long long)uni.tick, (unsigned long long)from, n,
+                secs * 1e3, secs > 0 ? (double)n / secs : 0.0,
+                uni.probe_count, active,
+                (unsigned long long)g_pipe_events.seq);
+            fflush(stdout);
+            continue;
+        }
 
-            /* Flush injected events */
-            if (g_pipe_inject.count > 0) {
-                system_t *sys = g_pipe_sys_count > 0 ?
-                                &g_pipe_sys_cache[0] : NULL;
-                if (sys)
-                    inject_flush(&g_pipe_inject, &g_pipe_events,
-                                 uni.probes, (int)uni.probe_count,
-                                 sys, uni.tick, &rng);
+        /* ---- profile ---- */
+        if (strcmp(cmd, "profile") == 0) {
+            /* {"cmd":"profile"}            -> per-phase timings and
+             *                                 tick arena usage
+             * {"cmd":"profile","enable":0|1,"reset":1} also switches
+             * recording or clears the histograms first */
+            long long en = pipe_parse_int(line, "enable", -1);
+            if (en >= 0) g_pipe_prof.enabled = en != 0;
+            if (pipe_parse_int(line, "reset", 0)) profile_reset(&g_pipe_prof);
+            char body[4096];
+            if (profile_format_json(&g_pipe_prof, body, sizeof(body)) < 0) {
+                pipe_err("profile too large");
+                continue;
             }
+            /* Splice "ok" and the tick arena into the report object */
+            fprintf(stdout, "{\"ok\":true,\"arena\":{\"used\":%zu,"
+                    "\"high_water\":%zu,\"capacity\":%zu,\"chunks\":%d},%s\n",
+                    g_pipe_arena.used, g_pipe_arena.high_water,
+                    g_pipe_arena.capacity, g_pipe_arena.chunk_count, body + 1);
+            fflush(stdout);
+            continue;
+        }
 
-            metrics_record(&g_pipe_metrics, &uni, &g_pipe_events, uni.tick);
-
-            /* Build observation response */
-            int p = 0;
-            size_t rem;
-            #define REM (rem = sizeof(resp) - (size_t)p, rem)
-
-            p += snprintf(resp + p, REM,
-                "{\"ok\":true,\"tick\":%llu,\"observations\":[",
-                (unsigned long long)uni.tick);
-
-            for (uint32_t i = 0; i < uni.probe_count; i++) {
-                if (i > 0) resp[p++] = ',';
-                probe_t *pr = &uni.probes[i];
-
-                /* Core fields */
-                p += snprintf(resp + p, REM,
-                    "{\"probe_id\":\"%llu-%llu\","
-                    "\"name\":\"%s\","
-                    "\"status\":\"%s\","
-                    "\"hull\":%.3f,"
-                    "\"energy\":%.1f,"
-                    "\"fuel\":%.1f,"
-                    "\"location\":\"%s\","
-                    "\"generation\":%u,"
-                    "\"tech\":[%u,%u,%u,%u,%u,%u,%u,%u,%u,%u],",
-                    (unsigned long long)pr->id.hi,
-                    (unsigned long long)pr->id.lo,
-                    pr->name,
-                    PIPE_STATUS_NAMES[pr->status],
-                    (double)pr->hull_integrity,
-                    pr->energy_joules, pr->fuel_kg,
-                    PIPE_LOC_NAMES[pr->location_type],
-                    pr->generation,
-                    pr->tech_levels[0], pr->tech_levels[1],
-                    pr->tech_levels[2], pr->tech_levels[3],
-                    pr->tech_levels[4], pr->tech_levels[5],
-                    pr->tech_levels[6], pr->tech_levels[7],
-                    pr->tech_levels[8], pr->tech_levels[9]);
-
-                /* Resources */
-                p += snprintf(resp + p, REM,
-                    "\"resources\":{\"iron\":%.1f,\"silicon\":%.1f,"
-                    "\"rare_earth\":%.1f,\"water\":%.1f,\"hydrogen\":%.1f,"
-                    "\"helium3\":%.1f,\"carbon\":%.1f,\"uranium\":%.1f,"
-                    "\"exotic\":%.1f},",
-                    pr->resources[RES_IRON], pr->resources[RES_SILICON],
-                    pr->resources[RES_RARE_EARTH], pr->resources[RES_WATER],
-                    pr->resources[RES_HYDROGEN], pr->resources[RES_HELIUM3],
-                    pr->resources[RES_CARBON], pr->resources[RES_URANIUM],
-                    pr->resources[RES_EXOTIC]);
-
-                /* Position */
-                p += snprintf(resp + p, REM,
-                    "\"position\":{\"sector\":[%d,%d,%d],"
-                    "\"system_id\":\"%llu-%llu\","
-                    "\"body_id\":\"%llu-%llu\","
-                    "\"heading\":[%.3f,%.3f,%.3f],"
-                    "\"destination\":[%.3f,%.3f,%.3f],"
-                    "\"travel_remaining_ly\":%.3f},",
-                    pr->sector.x, pr->sector.y, pr->sector.z,
-                    (unsigned long long)pr->system_id.hi,
-                    (unsigned long long)pr->system_id.lo,
-                    (unsigned long long)pr->body_id.hi,
-                    (unsigned long long)pr->body_id.lo,
-                    pr->heading.x, pr->heading.y, pr->heading.z,
-                    pr->destination.x, pr->destination.y, pr->destination.z,
-                    pr->travel_remaining_ly);
-
-                /* Capabilities */
-                p += snprintf(resp + p, REM,
-                    "\"capabilities\":{\"max_speed_c\":%.4f,"
-                    "\"sensor_range_ly\":%.1f,\"mining_rate\":%.2f,"
-                    "\"construction_rate\":%.2f,\"compute_capacity\":%.1f},",
-                    (double)pr->max_speed_c,
-                    (double)pr->sensor_range_ly,
-                    (double)pr->mining_rate,
-                    (double)pr->construction_rate,
-                    (double)pr->compute_capacity);
-
-                /* Recent events (last 5 for this probe) */
-                p += snprintf(resp + p, REM, "\"recent_events\":[");
-                {
-                    sim_event_t evts[5];
-                    int ne = events_get_for_probe(&g_pipe_events, pr->id,
-                                                  evts, 5);
-                    for (int e = 0; e < ne; e++) {
-                        if (e > 0) resp[p++] = ',';
-                        /* Escape description for JSON safety */
-                        char safe_desc[256];
-                        int sd = 0;
-                        for (int c = 0; evts[e].description[c] && sd < 250; c++) {
-                            char ch = evts[e].description[c];
-                            if (ch == '"' || ch == '\\') safe_desc[sd++] = '\\';
-                            safe_desc[sd++] = ch;
-                        }
-                        safe_desc[sd] = '\0';
-                        p += snprintf(resp + p, REM,
-                            "{\"type\":%d,\"subtype\":%d,"
-                            "\"description\":\"%s\","
-                            "\"severity\":%.2f,\"tick\":%llu}",
-                            (int)evts[e].type, evts[e].subtype,
-                            safe_desc, (double)evts[e].severity,
-                            (unsigned long long)evts[e].tick);
-                    }
-                }
-                p += snprintf(resp + p, REM, "],");
-
-                /* Replication progress (if replicating) */
-                if (g_pipe_repl[i].active) {
-                    int trem = (int)g_pipe_repl[i].ticks_total
-                             - (int)g_pipe_repl[i].ticks_elapsed;
-                    if (trem < 0) trem = 0;
-                    p += snprintf(resp + p, REM,
-                        "\"replication\":{\"progress\":%.3f,"
-                        "\"ticks_remaining\":%d,"
-                        "\"consciousness_forked\":%s},",
-                        g_pipe_repl[i].progress, trem,
-                        g_pipe_repl[i].consciousness_forked ? "true" : "false");
-                }
-
-                /* System details (when not interstellar) */
-                system_t *sys = sys_cache_get(pr->system_id, seed, pr->sector);
-                if (sys && pr->location_type != LOC_INTERSTELLAR) {
-                    p += snprintf(resp + p, REM,
-                        "\"system\":{\"name\":\"%s\","
-                        "\"star_count\":%u,\"planet_count\":%u,",
-                        sys->name, sys->star_count, sys->planet_count);
-
-                    /* Stars */
-                    p += snprintf(resp + p, REM, "\"stars\":[");
-                    for (int s = 0; s < sys->star_count; s++) {
-                        if (s > 0) resp[p++] = ',';
-                        p += snprintf(resp + p, REM,
-                            "{\"name\":\"%s\",\"class\":%d,"
-                            "\"mass_solar\":%.3f,\"temp_k\":%.0f,"
-                            "\"luminosity_solar\":%.4f,"
-                            "\"metallicity\":%.2f}",
-                            sys->stars[s].name,
-                            (int)sys->stars[s].class,
-                            sys->stars[s].mass_solar,
-                            sys->stars[s].temperature_k,
-                            sys->stars[s].luminosity_solar,
-                            sys->stars[s].metallicity);
-                    }
-                    p += snprintf(resp + p, REM, "],");
-
-                    /* Planets — enhanced */
-                    p += snprintf(resp + p, REM, "\"planets\":[");
-                    for (int pl = 0; pl < sys->planet_count; pl++) {
-                        if (pl > 0) resp[p++] = ',';
-                        const planet_t *planet = &sys->planets[pl];
-                        p += snprintf(resp + p, REM,
-                            "{\"name\":\"%s\",\"type\":%d,"
-                            "\"mass_earth\":%.3f,"
-                            "\"radius_earth\":%.3f,"
-                            "\"orbital_radius_au\":%.3f,"
-                            "\"orbital_period_days\":%.1f,"
-                            "\"surface_temp_k\":%.1f,"
-                            "\"atmosphere_pressure_atm\":%.3f,"
-                            "\"water_coverage\":%.3f,"
-                            "\"habitability\":%.3f,"
-                            "\"magnetic_field\":%.3f,"
-                            "\"rings\":%s,"
-                            "\"moon_count\":%u,"
-                            "\"survey_complete\":[%s,%s,%s,%s,%s],",
-                            planet->name, (int)planet->type,
-                            planet->mass_earth,
-                            planet->radius_earth,
-                            planet->orbital_radius_au,
-                            planet->orbital_period_days,
-                            planet->surface_temp_k,
-                            planet->atmosphere_pressure_atm,
-                            planet->water_coverage,
-                            planet->habitability_index,
-                            planet->magnetic_field,
-                            planet->rings ? "true" : "false",
-                            planet->moon_count,
-                            planet->surveyed[0] ? "true" : "false",
-                            planet->surveyed[1] ? "true" : "false",
-                            planet->surveyed[2] ? "true" : "false",
-                            planet->surveyed[3] ? "true" : "false",
-                            planet->surveyed[4] ? "true" : "false");
-
-                        /* Planet resource abundances */
-                        p += snprintf(resp + p, REM,
-                            "\"resources\":{\"iron\":%.3f,\"silicon\":%.3f,"
-                            "\"rare_earth\":%.3f,\"water\":%.3f,"
-                            "\"hydrogen\":%.3f,\"helium3\":%.3f,"
-                            "\"carbon\":%.3f,\"uranium\":%.3f,"
-                            "\"exotic\":%.3f}",
-                            (double)planet->resources[RES_IRON],
-                            (double)planet->resources[RES_SILICON],
-                            (double)planet->resources[RES_RARE_EARTH],
-                            (double)planet->resources[RES_WATER],
-                            (double)planet->resources[RES_HYDROGEN],
-                            (double)planet->resources[RES_HELIUM3],
-                            (double)planet->resources[RES_CARBON],
-                            (double)planet->resources[RES_URANIUM],
-                            (double)planet->resources[RES_EXOTIC]);
-                        /* Artifact data (only if discovered) */
-                        if (planet->has_artifact && planet->artifact_discovered) {
-                            static const char *art_type_names[] = {
-                                "tech_boost","resource_cache","star_map","comm_amplifier"};
-                            const char *atn = planet->artifact_type < 4
-                                ? art_type_names[planet->artifact_type] : "unknown";
-                            /* Escape artifact description */
-                            char adesc[256];
-                            int ai = 0;
-                            for (int ac = 0; planet->artifact_desc[ac] && ai < 250; ac++) {
-                                char ch = planet->artifact_desc[ac];
-                                if (ch == '"' || ch == '\\') adesc[ai++] = '\\';
-                                adesc[ai++] = ch;
-                            }
-                            adesc[ai] = '\0';
-                            p += snprintf(resp + p, REM,
-                                ",\"artifact\":{\"type\":\"%s\","
-                                "\"value\":%.3f,\"description\":\"%s\"}",
-                                atn, planet->artifact_value, adesc);
-                        }
-                        p += snprintf(resp + p, REM, "}");
-                    }
-                    p += snprintf(resp + p, REM, "]},");
-                } else {
-                    /* Interstellar — no system details */
-                    p += snprintf(resp + p, REM, "\"system\":null,");
-                }
-
-                /* Nearby probes (within sensor range) */
-                p += snprintf(resp + p, REM, "\"nearby_probes\":[");
-                {
-                    int np_count = 0;
-                    for (uint32_t j = 0; j < uni.probe_count; j++) {
-                        if (j == i) continue;
-                        if (uni.probes[j].status == STATUS_DESTROYED) continue;
-                        double dx = pr->heading.x - uni.probes[j].heading.x;
-                        double dy = pr->heading.y - uni.probes[j].heading.y;
-                        double dz = pr->heading.z - uni.probes[j].heading.z;
-                        double dist = sqrt(dx*dx + dy*dy + dz*dz);
-                        if (dist <= (double)pr->sensor_range_ly) {
-                            if (np_count > 0) resp[p++] = ',';
-                            p += snprintf(resp + p, REM,
-                                "{\"probe_id\":\"%llu-%llu\","
-                                "\"name\":\"%s\","
-                                "\"status\":\"%s\","
-                                "\"distance_ly\":%.3f}",
-                                (unsigned long long)uni.probes[j].id.hi,
-                                (unsigned long long)uni.probes[j].id.lo,
-                                uni.probes[j].name,
-                                PIPE_STATUS_NAMES[uni.probes[j].status],
-                                dist);
-                            np_count++;
-                        }
-                    }
-                }
-                p += snprintf(resp + p, REM, "],");
-
-                /* Inbox — delivered messages for this probe */
-                p += snprintf(resp + p, REM, "\"inbox\":[");
-                {
-                    message_t msgs[16];
-                    int nm = comm_get_inbox(&g_pipe_comm, pr->id, msgs, 16);
-                    for (int m = 0; m < nm; m++) {
-                        if (m > 0) resp[p++] = ',';
-                        /* Escape content */
-                        char safe[MAX_MSG_CONTENT + 64];
-                        int si = 0;
-                        for (int c = 0; msgs[m].content[c] && si < (int)sizeof(safe) - 2; c++) {
-                            char ch = msgs[m].content[c];
-                            if (ch == '"' || ch == '\\') safe[si++] = '\\';
-                            safe[si++] = ch;
-                        }
-                        safe[si] = '\0';
-                        p += snprintf(resp + p, REM,
-                            "{\"from\":\"%llu-%llu\","
-                            "\"content\":\"%s\","
-                            "\"sent_tick\":%llu}",
-                            (unsigned long long)msgs[m].sender_id.hi,
-                            (unsigned long long)msgs[m].sender_id.lo,
-                            safe,
-                            (unsigned long long)msgs[m].sent_tick);
-                    }
-                }
-                p += snprintf(resp + p, REM, "],");
-
-                /* Visible beacons in current system */
-                p += snprintf(resp + p, REM, "\"visible_beacons\":[");
-                {
-                    beacon_t beacons[16];
-                    int nb = comm_detect_beacons(&g_pipe_comm, pr->system_id,
-                                                  beacons, 16);
-                    for (int b = 0; b < nb; b++) {
-                        if (b > 0) resp[p++] = ',';
-                        char safe[MAX_BEACON_MSG + 64];
-                        int si = 0;
-                        for (int c = 0; beacons[b].message[c] && si < (int)sizeof(safe) - 2; c++) {
-                            char ch = beacons[b].message[c];
-                            if (ch == '"' || ch == '\\') safe[si++] = '\\';
-                            safe[si++] = ch;
-                        }
-                        safe[si] = '\0';
-                        p += snprintf(resp + p, REM,
-                            "{\"owner\":\"%llu-%llu\","
-                            "\"message\":\"%s\","
-                            "\"placed_tick\":%llu}",
-                            (unsigned long long)beacons[b].owner_id.hi,
-                            (unsigned long long)beacons[b].owner_id.lo,
-                            safe,
-                            (unsigned long long)beacons[b].placed_tick);
-                    }
-                }
-                p += snprintf(resp + p, REM, "],");
-
-                /* Visible structures in current system */
-                p += snprintf(resp + p, REM, "\"visible_structures\":[");
-                {
-                    int vs_count = 0;
-                    for (int s = 0; s < g_pipe_society.structure_count; s++) {
-                        const structure_t *st = &g_pipe_society.structures[s];
-                        if (!uid_eq(st->system_id, pr->system_id)) continue;
-                        if (vs_count > 0) resp[p++] = ',';
-                        const structure_spec_t *spec = structure_get_spec(st->type);
-                        p += snprintf(resp + p, REM,
-                            "{\"type\":%d,\"name\":\"%s\","
-                            "\"complete\":%s,"
-                            "\"progress\":%.3f,"
-                            "\"builder\":\"%llu-%llu\"}",
-                            (int)st->type,
-                            spec ? spec->name : "unknown",
-                            st->complete ? "true" : "false",
-                            st->build_ticks_total > 0
-                              ? (double)st->build_ticks_elapsed / st->build_ticks_total
-                              : 0.0,
-                            (unsigned long long)st->builder_ids[0].hi,
-                            (unsigned long long)st->builder_ids[0].lo);
-                        vs_count++;
-                    }
-                }
-                p += snprintf(resp + p, REM, "],");
-
-                /* Pending trades for this probe */
-                p += snprintf(resp + p, REM, "\"pending_trades\":[");
-                {
-                    int tc = 0;
-                    for (int t = 0; t < g_pipe_society.trade_count; t++) {
-                        const trade_t *tr = &g_pipe_society.trades[t];
-                        if (tr->status != TRADE_IN_TRANSIT
-                            && tr->status != TRADE_PENDING) continue;
-                        if (!uid_eq(tr->receiver_id, pr->id)
-                            && !uid_eq(tr->sender_id, pr->id)) continue;
-                        if (tc > 0) resp[p++] = ',';
-                        p += snprintf(resp + p, REM,
-                            "{\"from\":\"%llu-%llu\","
-                            "\"to\":\"%llu-%llu\","
-                            "\"resource\":\"%s\","
-                            "\"amount\":%.1f,"
-                            "\"status\":%d}",
-                            (unsigned long long)tr->sender_id.hi,
-                            (unsigned long long)tr->sender_id.lo,
-                            (unsigned long long)tr->receiver_id.hi,
-                            (unsigned long long)tr->receiver_id.lo,
-                            resource_to_name(tr->resource),
-                            tr->amount,
-                            (int)tr->status);
-                        tc++;
-                    }
-                }
-                p += snprintf(resp + p, REM, "],");
-
-                /* Claims on probe's current system */
-                p += snprintf(resp + p, REM, "\"claims\":[");
-                {
-                    int cc = 0;
-                    for (int c = 0; c < g_pipe_society.claim_count; c++) {
-                        const claim_t *cl = &g_pipe_society.claims[c];
-                        if (!cl->active) continue;
-                        if (!uid_eq(cl->system_id, pr->system_id)) continue;
-                        if (cc > 0) resp[p++] = ',';
-                        p += snprintf(resp + p, REM,
-                            "{\"system_id\":\"%llu-%llu\","
-                            "\"claimer\":\"%llu-%llu\","
-                            "\"tick\":%llu}",
-                            (unsigned long long)cl->system_id.hi,
-                            (unsigned long long)cl->system_id.lo,
-                            (unsigned long long)cl->claimer_id.hi,
-                            (unsigned long long)cl->claimer_id.lo,
-                            (unsigned long long)cl->claimed_tick);
-                        cc++;
-                    }
-                }
-                p += snprintf(resp + p, REM, "],");
-
-                /* Active proposals */
-                p += snprintf(resp + p, REM, "\"proposals\":[");
-                {
-                    int pc = 0;
-                    for (int pi2 = 0; pi2 < g_pipe_society.proposal_count; pi2++) {
-                        const proposal_t *prop = &g_pipe_society.proposals[pi2];
-                        if (prop->status != VOTE_OPEN) continue;
-                        if (pc > 0) resp[p++] = ',';
-                        /* Escape proposal text */
-                        char safe_txt[MAX_PROPOSAL_TEXT + 64];
-                        int si = 0;
-                        for (int c = 0; prop->text[c] && si < (int)sizeof(safe_txt) - 2; c++) {
-                            char ch = prop->text[c];
-                            if (ch == '"' || ch == '\\') safe_txt[si++] = '\\';
-                            safe_txt[si++] = ch;
-                        }
-                        safe_txt[si] = '\0';
-                        p += snprintf(resp + p, REM,
-                            "{\"idx\":%d,"
-                            "\"proposer\":\"%llu-%llu\","
-                            "\"text\":\"%s\","
-                            "\"deadline\":%llu,"
-                            "\"for\":%d,\"against\":%d}",
-                            pi2,
-                            (unsigned long long)prop->proposer_id.hi,
-                            (unsigned long long)prop->proposer_id.lo,
-                            safe_txt,
-                            (unsigned long long)prop->deadline_tick,
-                            prop->votes_for, prop->votes_against);
-                        pc++;
-                    }
-                }
-                p += snprintf(resp + p, REM, "],");
-
-                /* Trust relationships */
-                p += snprintf(resp + p, REM, "\"trust\":[");
-                {
-                    int tc2 = 0;
-                    for (int r = 0; r < pr->relationship_count; r++) {
-                        if (tc2 > 0) resp[p++] = ',';
-                        p += snprintf(resp + p, REM,
-                            "{\"probe_id\":\"%llu-%llu\","
-                            "\"trust\":%.3f}",
-                            (unsigned long long)pr->relationships[r].other_id.hi,
-                            (unsigned long long)pr->relationships[r].other_id.lo,
-                            (double)pr->relationships[r].trust);
-                        tc2++;
-                    }
-                }
-                p += snprintf(resp + p, REM, "],");
-
-                /* Research progress (if active) */
-                if (g_pipe_research[i].active) {
-                    int trem = (int)g_pipe_research[i].ticks_total
-                             - (int)g_pipe_research[i].ticks_elapsed;
-                    if (trem < 0) trem = 0;
-                    double prog = g_pipe_research[i].ticks_total > 0
-                        ? (double)g_pipe_research[i].ticks_elapsed
-                          / g_pipe_research[i].ticks_total
-                        : 0.0;
-                    p += snprintf(resp + p, REM,
-                        "\"research\":{\"domain\":%d,"
-                        "\"progress\":%.3f,"
-                        "\"ticks_remaining\":%d},",
-                        g_pipe_research[i].domain, prog, trem);
-                }
-
-                /* Pending hazard threats */
-                p += snprintf(resp + p, REM, "\"threats\":[");
-                {
-                    pending_hazard_t tbuf[8];
-                    int tc3 = events_get_threats(&g_pipe_events, pr->id, tbuf, 8);
-                    for (int t = 0; t < tc3; t++) {
-                        if (t > 0) resp[p++] = ',';
-                        int ticks_until = (int)(tbuf[t].strike_tick - uni.tick);
-                        if (ticks_until < 0) ticks_until = 0;
-                        const char *haz_names[] = {"solar_flare","asteroid_collision","radiation_burst"};
-                        const char *hname = (tbuf[t].subtype >= 0 && tbuf[t].subtype < 3)
-                            ? haz_names[tbuf[t].subtype] : "unknown";
-                        p += snprintf(resp + p, REM,
-                            "{\"type\":\"%s\",\"severity\":%.3f,\"ticks_until\":%d}",
-                            hname, (double)tbuf[t].severity, ticks_until);
-                    }
-                }
-                p += snprintf(resp + p, REM, "],");
-
-                /* Relay network */
-                p += snprintf(resp + p, REM, "\"relay_network\":[");
-                {
-                    int rc2 = 0;
-                    for (int r = 0; r < g_pipe_comm.relay_count; r++) {
-                        relay_t *rl = &g_pipe_comm.relays[r];
-                        if (!rl->active) continue;
-                        if (rc2 > 0) resp[p++] = ',';
-                        p += snprintf(resp + p, REM,
-                            "{\"system_id\":\"%llu-%llu\","
-                            "\"owner\":\"%llu-%llu\","
-                            "\"range_ly\":%.1f}",
-                            (unsigned long long)rl->system_id.hi,
-                            (unsigned long long)rl->system_id.lo,
-                            (unsigned long long)rl->owner_id.hi,
-                            (unsigned long long)rl->owner_id.lo,
-                            rl->range_ly);
-                        rc2++;
-                    }
-                }
-                p += snprintf(resp + p, REM, "],");
-
-                /* Close probe object — remove trailing comma if needed */
-                if (p > 0 && resp[p-1] == ',') p--;
-                p += snprintf(resp + p, REM, "}");
+        /* ---- lod ---- */
+        if (strcmp(cmd, "lod") == 0) {
+            /* {"cmd":"lod","cadence":N,"radius":R}: coarse probes are
+             * updated every N ticks (0 = every probe full); R is the
+             * nearby-activity radius in ly. Either may be left out. */
+            long long cadence = pipe_parse_int(line, "cadence", -1);
+            long long radius = pipe_parse_int(line, "radius", -1);
+            if (cadence > 100000 || radius > 100000) {
+                pipe_err("lod cadence and radius must be <= 100000");
+                continue;
             }
-            p += snprintf(resp + p, REM, "]}");
-            #undef REM
-            fprintf(stdout, "%s\n", resp);
+            if (cadence >= 0) g_pipe_lod.cadence = (uint32_t)cadence;
+            if (radius >= 0) g_pipe_lod.radius_ly = (float)radius;
+            char body[512];
+            sim_lod_format_json(&g_pipe_lod, body, sizeof(body));
+            fprintf(stdout, "{\"ok\":true,\"lod\":%s}\n", body);
             fflush(stdout);
             continue;
         }
@@ -1250,15 +2029,92 @@ static int run_pipe_mode(uint64_t seed) {
                     PIPE_LOC_NAMES[pr->location_type],
                     pr->generation);
             }
-            p += snprintf(resp + p, sizeof(resp) - (size_t)p, "]}");
+            char lod[512];
+            if (sim_lod_format_json(&g_pipe_lod, lod, sizeof(lod)) < 0)
+                snprintf(lod, sizeof(lod), "null");
+            p += snprintf(resp + p, sizeof(resp) - (size_t)p,
+                "],\"lod\":%s}", lod);
             fprintf(stdout, "%s\n", resp);
             fflush(stdout);
             continue;
         }
 
+        /* ---- probe ---- */
+        if (strcmp(cmd, "probe") == 0) {
+            /* {"cmd":"probe","probe_id":"hi-lo"} -> that probe's full
+             * observation. Read-only: a coarse probe is shown as of its
+             * last catch-up, and an order_ended notice is kept for its
+             * agent. */
+            char pid_str[64];
+            if (pipe_parse_str(line, "probe_id", pid_str,
+                               sizeof(pid_str)) != 0) {
+                pipe_err("missing probe_id"); continue;
+            }
+            int idx = find_probe_idx(&uni, parse_uid_str(pid_str));
+            if (idx < 0) { pipe_err("probe not found"); continue; }
+
+            out.len = 0;
+            out.failed = false;
+            obs_printf(&out, "{\"ok\":true,\"tick\":%llu,\"probe\":",
+                (unsigned long long)uni.tick);
+            const char *ended = g_pipe_orders[idx].ended;
+            pipe_observe_probe(&out, &uni, seed, (uint32_t)idx);
+            g_pipe_orders[idx].ended = ended;
+            if (pipe_lod_coarse((uint32_t)idx)) {
+                out.len--;  /* reopen the object */
+                obs_printf(&out, ",\"lod\":{\"tier\":\"coarse\","
+                    "\"synced\":%llu}}",
+                    (unsigned long long)g_pipe_lod.synced[idx]);
+            }
+            obs_printf(&out, "}\n");
+            if (out.failed) { pipe_err("out of memory"); continue; }
+            fwrite(out.buf, 1, out.len, stdout);
+            fflush(stdout);
+            continue;
+        }
+
+        /* ---- query ---- */
+        if (strcmp(cmd, "query") == 0) {
+            /* {"cmd":"query","status":S,"location":L,"gen_min":N,
+             *  "gen_max":M,"tech_domain":D,"tech_min":T,
+             *  "sector_min":[x,y,z],"sector_max":[x,y,z],
+             *  "fields":[...],"offset":N,"limit":M}
+             * Probes matching every criterion given, in array order, as
+             * rows of id plus the named fields (default: name, status,
+             * location, generation). */
+            probe_query_t q;
+            const char *bad = pipe_parse_query(line, &q);
+            if (bad) { pipe_err(bad); continue; }
+            long long offset = pipe_parse_int(line, "offset", 0);
+            long long limit = pipe_parse_int(line, "limit", QUERY_PAGE_MAX);
+            if (offset < 0) offset = 0;
+            if (limit < 0 || limit > QUERY_PAGE_MAX) limit = QUERY_PAGE_MAX;
+
+            out.len = 0;
+            out.failed = false;
+            obs_printf(&out, "{\"ok\":true,\"tick\":%llu,\"probes\":[",
+                (unsigned long long)uni.tick);
+            long long total = 0;
+            int shown = 0;
+            for (uint32_t i = 0; i < uni.probe_count; i++) {
+                if (!pipe_query_match(&q, &uni.probes[i])) continue;
+                if (total++ < offset || shown >= limit) continue;
+                if (shown++ > 0) obs_putc(&out, ',');
+                pipe_query_row(&out, &uni, i, q.fields);
+            }
+            obs_printf(&out, "],\"total\":%lld,\"offset\":%lld,\"next\":%lld}\n",
+                total, offset,
+                offset + shown < total ? offset + shown : -1LL);
+            if (out.failed) { pipe_err("out of memory"); continue; }
+            fwrite(out.buf, 1, out.len, stdout);
+            fflush(stdout);
+            continue;
+        }
+
         /* ---- metrics ---- */
         if (strcmp(cmd, "metrics") == 0) {
-            metrics_record(&g_pipe_metrics, &uni, &g_pipe_events, uni.tick);
+            metrics_record(&g_pipe_metrics, &uni, &g_pipe_society,
+                           &g_pipe_events, uni.tick);
             const metrics_snapshot_t *m = metrics_latest(&g_pipe_metrics);
             if (m) {
                 fprintf(stdout,
@@ -1304,7 +2160,9 @@ static int run_pipe_mode(uint64_t seed) {
             }
             int slot = snap_find(tag);
             if (slot < 0) slot = snap_alloc();
+            pipe_lod_flush(&uni, &rng, seed);
             snapshot_take(&g_pipe_snap[slot], &uni, tag);
+            rel_graph_copy(&g_pipe_snap_rel[slot], &g_pipe_society.relations);
             fprintf(stdout,
                 "{\"ok\":true,\"snapshot\":\"%s\",\"tick\":%llu}\n",
                 tag, (unsigned long long)uni.tick);
@@ -1321,8 +2179,14 @@ static int run_pipe_mode(uint64_t seed) {
             int slot = snap_find(tag);
             if (slot < 0) { pipe_err("snapshot not found"); continue; }
             if (snapshot_restore(&g_pipe_snap[slot], &uni) == 0) {
+                rel_graph_copy(&g_pipe_society.relations,
+                               &g_pipe_snap_rel[slot]);
                 rng_seed(&rng, uni.seed);
                 for (uint64_t t = 0; t < uni.tick; t++) rng_next(&rng);
+                sim_lod_reset(&g_pipe_lod, uni.tick);
+                /* Orders were given in a future that no longer exists */
+                memset(g_pipe_orders, 0, sizeof(g_pipe_orders));
+                pipe_probe_index_reset();
                 fprintf(stdout,
                     "{\"ok\":true,\"restored\":\"%s\",\"tick\":%llu}\n",
                     tag, (unsigned long long)uni.tick);
@@ -1358,10 +2222,14 @@ static int run_pipe_mode(uint64_t seed) {
             if (persist_open(&db, path) != 0) {
                 pipe_err("db open failed"); continue;
             }
+            pipe_lod_flush(&uni, &rng, seed);
             persist_save_meta(&db, &uni);
             for (uint32_t i = 0; i < uni.probe_count; i++) {
                 persist_save_probe(&db, &uni.probes[i]);
             }
+            persist_save_relationships(&db, &g_pipe_society);
+            persist_save_trade_history(&db, &g_pipe_society);
+            persist_save_lineage(&db, &g_pipe_lineage);
             persist_close(&db);
             fprintf(stdout,
                 "{\"ok\":true,\"saved\":\"%s\",\"tick\":%llu,\"probes\":%u}\n",
@@ -1389,6 +2257,8 @@ static int run_pipe_mode(uint64_t seed) {
                 pipe_err("no meta in db"); continue;
             }
             /* Load probes — query all from probes table */
+            for (uint32_t i = 0; i < uni.probe_count; i++)
+                heritage_release_probe(&uni.probes[i]);
             uni.probe_count = 0;
             sqlite3_stmt *stmt;
             if (sqlite3_prepare_v2(db.db,
@@ -1413,15 +2283,24 @@ static int run_pipe_mode(uint64_t seed) {
                 }
                 sqlite3_finalize(stmt);
             }
+            /* Reset society, keeping the persisted trust graph */
+            society_free(&g_pipe_society);
+            society_init(&g_pipe_society);
+            persist_load_relationships(&db, &g_pipe_society);
+            persist_load_trade_history(&db, &g_pipe_society);
+            lineage_free(&g_pipe_lineage);
+            persist_load_lineage(&db, &g_pipe_lineage);
             persist_close(&db);
             /* Re-seed RNG to match loaded tick */
             rng_seed(&rng, uni.seed);
             for (uint64_t t = 0; t < uni.tick; t++) rng_next(&rng);
-            /* Reset replication/comm/society/research state */
+            /* Reset replication/comm/society/research/order state */
             memset(g_pipe_repl, 0, sizeof(g_pipe_repl));
             memset(g_pipe_research, 0, sizeof(g_pipe_research));
+            memset(g_pipe_orders, 0, sizeof(g_pipe_orders));
+            pipe_probe_index_reset();
             comm_init(&g_pipe_comm);
-            society_init(&g_pipe_society);
+            sim_lod_reset(&g_pipe_lod, uni.tick);
             fprintf(stdout,
                 "{\"ok\":true,\"loaded\":\"%s\",\"tick\":%llu,\"probes\":%u}\n",
                 path, (unsigned long long)uni.tick, uni.probe_count);
@@ -1446,8 +2325,12 @@ static int run_pipe_mode(uint64_t seed) {
 
             probe_t *pr = &uni.probes[idx];
 
-            /* Generate systems from nearby sectors (3x3x3 cube) */
-            system_t nearby[30 * 27]; /* up to 27 sectors × 30 systems */
+            /* Generate systems from nearby sectors (3x3x3 cube) into
+             * scratch: up to 27 sectors × 30 systems, ~6 MB */
+            arena_mark_t scan_mark = arena_mark(&g_pipe_arena);
+            system_t *nearby = arena_alloc_uninit(&g_pipe_arena,
+                                                  30 * 27 * sizeof(system_t));
+            if (!nearby) { pipe_err("out of memory"); continue; }
             int nearby_count = 0;
             sector_coord_t base = pr->sector;
             for (int dx = -1; dx <= 1; dx++) {
@@ -1521,6 +2404,7 @@ static int run_pipe_mode(uint64_t seed) {
             }
             p += snprintf(resp + p, REM2, "]}");
             #undef REM2
+            arena_release(&g_pipe_arena, scan_mark);
             fprintf(stdout, "%s\n", resp);
             fflush(stdout);
             continue;
@@ -1597,69 +2481,216 @@ static int run_pipe_mode(uint64_t seed) {
 
         /* ---- lineage ---- */
         if (strcmp(cmd, "lineage") == 0) {
-            int p = 0;
-            p += snprintf(resp + p, sizeof(resp) - (size_t)p,
-                "{\"ok\":true,\"entries\":[");
-            for (int li = 0; li < g_pipe_lineage.count; li++) {
-                lineage_entry_t *e = &g_pipe_lineage.entries[li];
-                if (li > 0) resp[p++] = ',';
-                p += snprintf(resp + p, sizeof(resp) - (size_t)p,
-                    "{\"parent\":\"%llu-%llu\","
-                    "\"child\":\"%llu-%llu\","
-                    "\"birth_tick\":%llu,"
-                    "\"generation\":%u}",
-                    (unsigned long long)e->parent_id.hi,
-                    (unsigned long long)e->parent_id.lo,
-                    (unsigned long long)e->child_id.hi,
-                    (unsigned long long)e->child_id.lo,
-                    (unsigned long long)e->birth_tick,
-                    e->generation);
+            /* {"cmd":"lineage","offset":N,"limit":M,"root":"hi-lo"}
+             * Without root: births in record order. With root: root's
+             * descendants in pre-order, plus its ancestors and subtree size. */
+            long long offset = pipe_parse_int(line, "offset", 0);
+            long long limit = pipe_parse_int(line, "limit", LINEAGE_PAGE_MAX);
+            if (offset < 0) offset = 0;
+            if (limit < 0 || limit > LINEAGE_PAGE_MAX) limit = LINEAGE_PAGE_MAX;
+
+            int root = -1;
+            bool scoped = false;
+            probe_uid_t root_id = {0, 0};
+            const char *rp = strstr(line, "\"root\":\"");
+            if (rp) {
+                char rid[64] = {0};
+                rp += 8;
+                int ri = 0;
+                while (*rp && *rp != '"' && ri < 63) rid[ri++] = *rp++;
+                root_id = parse_uid_str(rid);
+                root = lineage_find(&g_pipe_lineage, root_id);
+                /* A probe with no recorded births is a one-node subtree */
+                if (root < 0 && find_probe_idx(&uni, root_id) < 0) {
+                    pipe_err("probe not found"); continue;
+                }
+                scoped = true;
             }
-            p += snprintf(resp + p, sizeof(resp) - (size_t)p, "]}");
-            fprintf(stdout, "%s\n", resp);
+
+            out.len = 0;
+            out.failed = false;
+            obs_printf(&out, "{\"ok\":true,\"entries\":[");
+            int shown = 0;
+            long long total = 0;
+            if (!scoped) {
+                total = g_pipe_lineage.count;
+                for (long long li = offset; li < total && shown < limit; li++) {
+                    lineage_entry_t e;
+                    lineage_entry_at(&g_pipe_lineage, (int)li, &e);
+                    if (shown > 0) obs_putc(&out, ',');
+                    obs_printf(&out, "{\"parent\":\"%llu-%llu\","
+                        "\"child\":\"%llu-%llu\","
+                        "\"birth_tick\":%llu,"
+                        "\"generation\":%u}",
+                        (unsigned long long)e.parent_id.hi,
+                        (unsigned long long)e.parent_id.lo,
+                        (unsigned long long)e.child_id.hi,
+                        (unsigned long long)e.child_id.lo,
+                        (unsigned long long)e.birth_tick,
+                        e.generation);
+                    shown++;
+                }
+            } else if (root >= 0) {
+                /* Skip the root itself: entries are births under it */
+                for (int n = lineage_next_preorder(&g_pipe_lineage, root, root);
+                     n >= 0; n = lineage_next_preorder(&g_pipe_lineage, root, n)) {
+                    if (total++ < offset || shown >= limit) continue;
+                    const lineage_node_t *nd = lineage_node(&g_pipe_lineage, n);
+                    const lineage_node_t *pa = lineage_node(&g_pipe_lineage,
+                                                            nd->parent);
+                    if (shown > 0) obs_putc(&out, ',');
+                    obs_printf(&out, "{\"parent\":\"%llu-%llu\","
+                        "\"child\":\"%llu-%llu\","
+                        "\"birth_tick\":%llu,"
+                        "\"generation\":%u}",
+                        (unsigned long long)pa->id.hi,
+                        (unsigned long long)pa->id.lo,
+                        (unsigned long long)nd->id.hi,
+                        (unsigned long long)nd->id.lo,
+                        (unsigned long long)nd->birth_tick,
+                        nd->generation);
+                    shown++;
+                }
+            }
+            obs_printf(&out, "],\"total\":%lld,\"offset\":%lld,\"next\":%lld",
+                total, offset,
+                offset + shown < total ? offset + shown : -1LL);
+            if (scoped) {
+                /* The whole path is counted but only LINEAGE_PAGE_MAX
+                 * are listed; ask again rooted at the last one for more */
+                obs_printf(&out, ",\"subtree_size\":%lld,\"ancestors\":[",
+                    total + 1);
+                int depth = 0;
+                int a = root >= 0 ? lineage_node(&g_pipe_lineage, root)->parent
+                                  : -1;
+                for (; a >= 0; a = lineage_node(&g_pipe_lineage, a)->parent) {
+                    if (depth++ >= LINEAGE_PAGE_MAX) continue;
+                    const lineage_node_t *an = lineage_node(&g_pipe_lineage, a);
+                    if (depth > 1) obs_putc(&out, ',');
+                    obs_printf(&out, "\"%llu-%llu\"",
+                        (unsigned long long)an->id.hi,
+                        (unsigned long long)an->id.lo);
+                }
+                obs_printf(&out, "],\"depth\":%d,\"ancestors_truncated\":%s",
+                    depth, depth > LINEAGE_PAGE_MAX ? "true" : "false");
+            }
+            obs_printf(&out, "}\n");
+            if (out.failed) { pipe_err("out of memory"); continue; }
+            fwrite(out.buf, 1, out.len, stdout);
             fflush(stdout);
             continue;
         }
 
         /* ---- history ---- */
         if (strcmp(cmd, "history") == 0) {
-            /* Parse probe_id */
-            char pid_str[64] = {0};
-            const char *pp = strstr(line, "\"probe_id\":\"");
-            if (!pp) { pipe_err("missing probe_id"); continue; }
-            pp += 12;
-            int pi2 = 0;
-            while (*pp && *pp != '"' && pi2 < 63) pid_str[pi2++] = *pp++;
-            pid_str[pi2] = '\0';
+            /* {"cmd":"history","probe_id":"hi-lo","offset":N,"limit":M}
+             * -> the probe's logged events, oldest first */
+            char pid_str[64];
+            if (pipe_parse_str(line, "probe_id", pid_str,
+                               sizeof(pid_str)) != 0) {
+                pipe_err("missing probe_id"); continue;
+            }
             probe_uid_t uid = parse_uid_str(pid_str);
-
-            int p = 0;
-            p += snprintf(resp + p, sizeof(resp) - (size_t)p,
-                "{\"ok\":true,\"probe_id\":\"%s\",\"events\":[", pid_str);
-            int ec = 0;
+            long long offset = pipe_parse_int(line, "offset", 0);
+            long long limit = pipe_parse_int(line, "limit", HISTORY_PAGE_MAX);
+            if (offset < 0) offset = 0;
+            if (limit < 0 || limit > HISTORY_PAGE_MAX) limit = HISTORY_PAGE_MAX;
+
+            out.len = 0;
+            out.failed = false;
+            obs_printf(&out, "{\"ok\":true,\"probe_id\":\"%s\",\"events\":[",
+                pid_str);
+            long long total = 0;
+            int shown = 0;
+            arena_mark_t mark = arena_mark(&g_pipe_arena);
             for (int ei = 0; ei < g_pipe_events.count; ei++) {
-                sim_event_t *ev = &g_pipe_events.events[ei];
+                const sim_event_t *ev = events_at(&g_pipe_events, ei);
                 if (!uid_eq(ev->probe_id, uid)) continue;
-                if (ec > 0) resp[p++] = ',';
-                /* Escape description */
-                char desc[512];
-                int di = 0;
-                for (int c = 0; ev->description[c] && di < 500; c++) {
-                    char ch = ev->description[c];
-                    if (ch == '"' || ch == '\\') desc[di++] = '\\';
-                    desc[di++] = ch;
-                }
-                desc[di] = '\0';
-                p += snprintf(resp + p, sizeof(resp) - (size_t)p,
-                    "{\"type\":%d,\"subtype\":%d,"
+                if (total++ < offset || shown >= limit) continue;
+                if (shown++ > 0) obs_putc(&out, ',');
+                const char *desc = pipe_escape(&g_pipe_arena,
+                    strtab_str(ev->description), 500);
+                obs_printf(&out, "{\"type\":%d,\"subtype\":%d,"
                     "\"tick\":%llu,\"severity\":%.3f,"
                     "\"description\":\"%s\"}",
                     (int)ev->type, ev->subtype,
                     (unsigned long long)ev->tick,
                     (double)ev->severity, desc);
-                ec++;
             }
-            p += snprintf(resp + p, sizeof(resp) - (size_t)p, "]}");
+            arena_release(&g_pipe_arena, mark);
+            obs_printf(&out, "],\"total\":%lld,\"offset\":%lld,\"next\":%lld}\n",
+                total, offset,
+                offset + shown < total ? offset + shown : -1LL);
+            if (out.failed) { pipe_err("out of memory"); continue; }
+            fwrite(out.buf, 1, out.len, stdout);
+            fflush(stdout);
+            continue;
+        }
+
+        /* ---- density ---- */
+        if (strcmp(cmd, "density") == 0) {
+            /* {"cmd":"density","x":SX,"y":SY,"level":L} -> one cell
+             * {"cmd":"density","level":L}              -> whole level
+             * Counts come from the seed's atlas, built (or loaded from
+             * $UNIVERSE_ATLAS_DIR) on first use. */
+            if (!g_pipe_atlas.data || g_pipe_atlas.seed != uni.seed) {
+                atlas_free(&g_pipe_atlas);
+                if (atlas_open(&g_pipe_atlas, uni.seed, atlas_default_region(),
+                               atlas_default_dir(), PIPE_ATLAS_THREADS) != 0) {
+                    pipe_err("atlas build failed");
+                    continue;
+                }
+            }
+            const atlas_t *at = &g_pipe_atlas;
+            bool point = strstr(line, "\"x\":") != NULL;
+
+            int level = 0;
+            if (!point) {
+                while (level + 1 < at->levels &&
+                       (int64_t)at->level[level].w * at->level[level].h >
+                           DENSITY_MAX_CELLS)
+                    level++;
+            }
+            level = (int)pipe_parse_int(line, "level", level);
+            if (level < 0 || level >= at->levels) {
+                pipe_err("level out of range");
+                continue;
+            }
+            const atlas_level_t *lv = &at->level[level];
+
+            int p = 0;
+            if (point) {
+                int32_t sx = (int32_t)pipe_parse_int(line, "x", 0);
+                int32_t sy = (int32_t)pipe_parse_int(line, "y", 0);
+                int32_t cx, cy;
+                atlas_cell_origin(at, level, sx, sy, &cx, &cy);
+                p += snprintf(resp + p, sizeof(resp) - (size_t)p,
+                    "{\"ok\":true,\"level\":%d,\"cell_sectors\":%d,"
+                    "\"x0\":%d,\"y0\":%d,\"count\":%u,\"max\":%u,"
+                    "\"cached\":%s}",
+                    level, 1 << level, cx, cy,
+                    atlas_count_at(at, level, sx, sy), lv->max,
+                    at->from_cache ? "true" : "false");
+            } else {
+                if ((int64_t)lv->w * lv->h > DENSITY_MAX_CELLS) {
+                    pipe_err("level too fine for a grid; raise level or "
+                             "give x,y");
+                    continue;
+                }
+                p += snprintf(resp + p, sizeof(resp) - (size_t)p,
+                    "{\"ok\":true,\"level\":%d,\"cell_sectors\":%d,"
+                    "\"x0\":%d,\"y0\":%d,\"z\":%d,\"w\":%d,\"h\":%d,"
+                    "\"max\":%u,\"total\":%llu,\"cached\":%s,\"cells\":[",
+                    level, 1 << level, at->region.x0, at->region.y0,
+                    at->region.z, lv->w, lv->h, lv->max,
+                    (unsigned long long)at->total,
+                    at->from_cache ? "true" : "false");
+                for (int64_t i = 0; i < (int64_t)lv->w * lv->h; i++) {
+                    p += snprintf(resp + p, sizeof(resp) - (size_t)p,
+                        i ? ",%u" : "%u", lv->cells[i]);
+                }
+                p += snprintf(resp + p, sizeof(resp) - (size_t)p, "]}");
+            }
             fprintf(stdout, "%s\n", resp);
             fflush(stdout);
             continue;
@@ -1668,10 +2699,97 @@ static int run_pipe_mode(uint64_t seed) {
         pipe_err("unknown command");
     }
 
-    arena_destroy(&arena);
+    if (prof_dump && profile_dump(&g_pipe_prof, prof_dump) != 0)
+        LOG_WARN("profile: could not write %s", prof_dump);
+    free(out.buf);
+    atlas_free(&g_pipe_atlas);
+    society_free(&g_pipe_society);
+    lineage_free(&g_pipe_lineage);
+    for (int i = 0; i < MAX_SNAP_SLOTS; i++) rel_graph_free(&g_pipe_snap_rel[i]);
+    heritage_reset();
+    strtab_reset();
+    arena_destroy(&g_pipe_arena);
     return 0;
 }
 
+/* ---- Standalone loop ---- */
+
+/* One tick of the standalone (headless / visual) simulation. */
+static void run_tick(universe_t *u, rng_t *rng, arena_t *tick_arena,
+                     persist_t *db, const cli_config_t *cfg) {
+    u->tick++;
+
+    /* Reset per-tick arena */
+    arena_reset(tick_arena);
+
+    /* Advance RNG */
+    uint64_t tick_entropy = rng_next(rng);
+    (void)tick_entropy;
+
+    /* Travel ticks for active probes */
+    for (uint32_t p = 0; p < u->probe_count; p++) {
+        if (u->probes[p].status == STATUS_TRAVELING) {
+            travel_tick(&u->probes[p], rng);
+        }
+        probe_tick_energy(&u->probes[p]);
+    }
+
+    /* Periodic save */
+    if (u->tick % cfg->save_interval == 0) {
+        persist_save_tick(db, u->tick);
+    }
+}
+
+#ifdef USE_RAYLIB
+/* ---- Visual mode: sim thread ---- */
+
+#define VISUAL_MAX_BACKLOG_FRAMES 30   /* frames of unrun ticks to keep */
+
+/* The universe, RNG, arena and database belong to the sim thread while it
+ * runs; the render thread only sees render snapshots. */
+typedef struct {
+    universe_t         *universe;
+    rng_t              *rng;
+    arena_t            *tick_arena;
+    persist_t          *db;
+    const cli_config_t *cfg;
+    render_triple_t    *snaps;
+    _Atomic uint64_t    budget;      /* ticks granted by the render thread */
+    atomic_bool         quit;        /* set by the render thread */
+    atomic_bool         done;        /* set by the sim thread on exit */
+} visual_sim_t;
+
+static render_triple_t g_render_snaps;
+
+static void *visual_sim_main(void *arg) {
+    visual_sim_t *vs = (visual_sim_t *)arg;
+    const struct timespec idle = {0, 1000000};   /* 1 ms */
+    bool stale = false;   /* ticks run since the last publish */
+
+    while (!atomic_load(&vs->quit)) {
+        /* Publish at a tick boundary, but only once the renderer has
+         * picked up the previous snapshot; copying state it will never
+         * draw would just slow the sim down. */
+        if (stale && !render_triple_pending(vs->snaps)) {
+            render_snapshot_capture(render_triple_back(vs->snaps), vs->universe);
+            render_triple_publish(vs->snaps);
+            stale = false;
+        }
+        if (vs->cfg->max_ticks > 0 && vs->universe->tick >= vs->cfg->max_ticks)
+            break;
+        if (atomic_load(&vs->budget) == 0) {
+            nanosleep(&idle, NULL);
+            continue;
+        }
+        atomic_fetch_sub(&vs->budget, 1);
+        run_tick(vs->universe, vs->rng, vs->tick_arena, vs->db, vs->cfg);
+        stale = true;
+    }
+    atomic_store(&vs->done, true);
+    return NULL;
+}
+#endif
+
 /* ---- Main ---- */
 
 int main(int argc, char **argv) {
@@ -1771,12 +2889,6 @@ int main(int argc, char **argv) {
             renderer_load_nearby(&renderer, &universe.probes[0]);
         }
     }
-#else
-    if (cfg.visual) {
-        LOG_WARN("Built without Raylib. Use 'make visual' for --visual support.");
-        LOG_WARN("Falling back to headless mode.");
-        cfg.visual = false;
-    }
 #endif
 
     /* ---- Main simulation loop ---- */
@@ -1784,77 +2896,66 @@ int main(int argc, char **argv) {
     struct timespec t_start, t_end;
     clock_gettime(CLOCK_MONOTONIC, &t_start);
 
-    while (g_running) {
 #ifdef USE_RAYLIB
-        if (cfg.visual) {
-            if (!renderer_update(&renderer, &universe)) {
+    if (cfg.visual) {
+        /* The sim runs on its own thread; this thread only renders the
+         * latest published snapshot and hands out tick budget. */
+        static visual_sim_t sim;
+        memset(&sim, 0, sizeof(sim));
+        sim.universe = &universe;
+        sim.rng = &rng;
+        sim.tick_arena = &tick_arena;
+        sim.db = &db;
+        sim.cfg = &cfg;
+        sim.snaps = &g_render_snaps;
+        render_triple_init(&g_render_snaps);
+        render_snapshot_capture(render_triple_back(&g_render_snaps), &universe);
+        render_triple_publish(&g_render_snaps);
+
+        pthread_t sim_thread;
+        if (pthread_create(&sim_thread, NULL, visual_sim_main, &sim) != 0) {
+            LOG_ERROR("Failed to start sim thread; continuing headless");
+            renderer_close(&renderer);
+            cfg.visual = false;
+        }
+
+        while (cfg.visual && g_running && !atomic_load(&sim.done)) {
+            const render_snapshot_t *snap =
+                render_triple_acquire(&g_render_snaps, NULL);
+            if (!renderer_update(&renderer, snap)) {
                 g_running = 0;
                 break;
             }
 
-            /* Run N ticks per frame based on speed control */
+            /* Hand the sim this frame's ticks. If it is behind, cap the
+             * backlog so unpausing after a stall does not fast-forward. */
             int ticks_this_frame = sim_speed_ticks_this_frame(&renderer.speed);
-            for (int t = 0; t < ticks_this_frame; t++) {
-                universe.tick++;
-
-                /* Reset per-tick arena */
-                arena_reset(&tick_arena);
-
-                /* Advance RNG */
-                uint64_t tick_entropy = rng_next(&rng);
-                (void)tick_entropy;
-
-                /* Travel ticks for active probes */
-                for (uint32_t p = 0; p < universe.probe_count; p++) {
-                    if (universe.probes[p].status == STATUS_TRAVELING) {
-                        travel_tick(&universe.probes[p], &rng);
-                    }
-                    probe_tick_energy(&universe.probes[p]);
-                }
-
-                /* Periodic save */
-                if (universe.tick % cfg.save_interval == 0) {
-                    persist_save_tick(&db, universe.tick);
-                }
+            uint64_t cap = (uint64_t)MAX(ticks_this_frame, 1)
+                         * VISUAL_MAX_BACKLOG_FRAMES;
+            if (ticks_this_frame > 0 && atomic_load(&sim.budget) < cap)
+                atomic_fetch_add(&sim.budget, (uint64_t)ticks_this_frame);
 
-                if (cfg.max_ticks > 0 && universe.tick >= cfg.max_ticks) {
-                    g_running = 0;
-                    break;
-                }
-            }
-
-            /* Reload visible systems periodically */
-            if (universe.probe_count > 0 && universe.tick % 100 == 0) {
-                renderer_load_nearby(&renderer, &universe.probes[0]);
-            }
+            renderer_draw(&renderer, snap);
+        }
 
-            renderer_draw(&renderer, &universe);
-        } else
+        if (cfg.visual) {
+            atomic_store(&sim.quit, true);
+            pthread_join(sim_thread, NULL);
+        }
+    }
+#else
+    if (cfg.visual) {
+        LOG_WARN("Built without Raylib. Use 'make visual' for --visual support.");
+        LOG_WARN("Falling back to headless mode.");
+        cfg.visual = false;
+    }
 #endif
-        {
-            /* Headless mode — run as fast as possible */
-            universe.tick++;
-            arena_reset(&tick_arena);
-
-            uint64_t tick_entropy = rng_next(&rng);
-            (void)tick_entropy;
-
-            /* Travel ticks */
-            for (uint32_t p = 0; p < universe.probe_count; p++) {
-                if (universe.probes[p].status == STATUS_TRAVELING) {
-                    travel_tick(&universe.probes[p], &rng);
-                }
-                probe_tick_energy(&universe.probes[p]);
-            }
-
-            /* Periodic save */
-            if (universe.tick % cfg.save_interval == 0) {
-                persist_save_tick(&db, universe.tick);
-            }
 
-            if (cfg.max_ticks > 0 && universe.tick >= cfg.max_ticks) {
-                break;
-            }
+    /* Headless mode — run as fast as possible */
+    while (g_running && !cfg.visual) {
+        run_tick(&universe, &rng, &tick_arena, &db, &cfg);
+        if (cfg.max_ticks > 0 && universe.tick >= cfg.max_ticks) {
+            break;
         }
     }
 
@@ -0,0 +1,191 @@
+/*
+ * orders.c — Standing orders: an action the sim repeats for an agent
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "orders.h"
+#include "agent_ipc.h"
+
+static const char *UNTIL_NAMES[UNTIL_KIND_COUNT] = {
+    "none", "cargo", "cargo", "hull_below", "arrived", "event"
+};
+
+/* Indexed by event_type_t */
+static const char *EVENT_TYPE_NAMES[EVT_TYPE_COUNT] = {
+    "discovery", "anomaly", "hazard", "encounter",
+    "crisis", "wonder", "message", "replication"
+};
+
+/* ---- JSON helpers ---- */
+
+/* Start of the value for "key": in json, or NULL. */
+static const char *find_value(const char *json, const char *key) {
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    const char *p = strstr(json, pattern);
+    if (!p) return NULL;
+    p += strlen(pattern);
+    while (*p == ' ' || *p == '\t') p++;
+    return p;
+}
+
+static bool find_str(const char *json, const char *key,
+                     char *out, int out_max) {
+    const char *p = find_value(json, key);
+    if (!p || *p != '"') return false;
+    p++;
+    int i = 0;
+    while (*p && *p != '"' && i < out_max - 1) out[i++] = *p++;
+    out[i] = '\0';
+    return true;
+}
+
+static bool find_num(const char *json, const char *key, double *out) {
+    const char *p = find_value(json, key);
+    if (!p) return false;
+    char *end;
+    *out = strtod(p, &end);
+    return end != p;
+}
+
+/* Copy the object value of "key" (braces included) into out. */
+static bool find_obj(const char *json, const char *key,
+                     char *out, int out_max) {
+    const char *p = find_value(json, key);
+    if (!p || *p != '{') return false;
+    int depth = 0, n = 0;
+    do {
+        if (*p == '{') depth++;
+        else if (*p == '}') depth--;
+        if (n >= out_max - 1) return false;
+        out[n++] = *p++;
+    } while (*p && depth > 0);
+    out[n] = '\0';
+    return depth == 0;
+}
+
+/* ---- Parsing ---- */
+
+int order_event_type(const char *name) {
+    if (strcmp(name, "any") == 0) return -1;
+    for (int i = 0; i < EVT_TYPE_COUNT; i++)
+        if (strcmp(name, EVENT_TYPE_NAMES[i]) == 0) return i;
+    return -2;
+}
+
+const char *order_until_name(until_kind_t k) {
+    if ((int)k >= 0 && k < UNTIL_KIND_COUNT) return UNTIL_NAMES[k];
+    return "none";
+}
+
+int order_parse(const char *json, const action_t *action,
+                standing_order_t *o) {
+    memset(o, 0, sizeof(*o));
+    o->event_type = -1;
+
+    double repeat = 0;
+    bool has_repeat = find_num(json, "repeat", &repeat);
+    char until[256];
+    bool has_until = find_value(json, "until") != NULL;
+    if (!has_repeat && !has_until) return 0;
+
+    if (has_repeat) {
+        if (repeat < 1 || repeat > UINT32_MAX) return -1;
+        o->repeat = (uint32_t)repeat;
+    }
+
+    if (has_until) {
+        if (!find_obj(json, "until", until, sizeof(until))) return -1;
+        char name[32];
+        double v;
+        if (find_str(until, "cargo", name, sizeof(name))) {
+            int r = (int)resource_from_name(name);
+            if (r < 0) return -1;
+            o->resource = (resource_t)r;
+            if (find_num(until, "at_least", &v))     o->until = UNTIL_CARGO_AT_LEAST;
+            else if (find_num(until, "at_most", &v)) o->until = UNTIL_CARGO_AT_MOST;
+            else return -1;
+            o->threshold = v;
+        } else if (find_num(until, "hull_below", &v)) {
+            o->until = UNTIL_HULL_BELOW;
+            o->threshold = v;
+        } else if (find_value(until, "arrived")) {
+            o->until = UNTIL_ARRIVED;
+        } else if (find_str(until, "event", name, sizeof(name))) {
+            int t = order_event_type(name);
+            if (t == -2) return -1;
+            o->until = UNTIL_EVENT;
+            o->event_type = t;
+        } else {
+            return -1;
+        }
+    }
+
+    o->action = *action;
+    o->active = true;
+    return 1;
+}
+
+/* ---- Lifecycle ---- */
+
+void order_arm(standing_order_t *o, const probe_t *p, uint64_t events_seen) {
+    o->executed = 0;
+    o->events_seen = events_seen;
+    o->last_status = (uint8_t)p->status;
+    o->ended = NULL;
+}
+
+void order_end(standing_order_t *o, const char *why) {
+    o->active = false;
+    o->ended = why;
+}
+
+static bool until_met(standing_order_t *o, const probe_t *p,
+                      const event_system_t *es) {
+    switch (o->until) {
+    case UNTIL_CARGO_AT_LEAST:
+        return p->resources[o->resource] >= o->threshold;
+    case UNTIL_CARGO_AT_MOST:
+        return p->resources[o->resource] <= o->threshold;
+    case UNTIL_HULL_BELOW:
+        return (double)p->hull_integrity < o->threshold;
+    case UNTIL_ARRIVED:
+        return o->last_status == STATUS_TRAVELING
+            && p->status != STATUS_TRAVELING;
+    case UNTIL_EVENT:
+        /* The log rewinds across a restore or load; anything already
+         * overwritten is gone */
+        if (o->events_seen > es->seq) o->events_seen = 0;
+        if (o->events_seen < events_first_seq(es))
+            o->events_seen = events_first_seq(es);
+        for (uint64_t n = o->events_seen; n < es->seq; n++) {
+            const sim_event_t *ev = events_by_seq(es, n);
+            if (!uid_eq(ev->probe_id, p->id)) continue;
+            if (o->event_type < 0 || (int)ev->type == o->event_type) {
+                o->events_seen = es->seq;
+                return true;
+            }
+        }
+        o->events_seen = es->seq;
+        return false;
+    default:
+        return false;
+    }
+}
+
+const char *order_check(standing_order_t *o, const probe_t *p,
+                        const event_system_t *es) {
+    if (!o->active) return NULL;
+    const char *why = NULL;
+    if (p->status == STATUS_DESTROYED)
+        why = "destroyed";
+    else if (until_met(o, p, es))
+        why = "until";
+    else if (o->repeat > 0 && o->executed >= o->repeat)
+        why = "repeat";
+    o->last_status = (uint8_t)p->status;
+    if (why) order_end(o, why);
+    return why;
+}
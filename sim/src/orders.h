@@ -0,0 +1,74 @@
+/*
+ * orders.h — Standing orders: an action the sim repeats for an agent
+ *
+ * An agent that adds "repeat" or "until" to an action object hands the
+ * action to the sim, which issues it again every tick without asking.
+ * Control goes back to the agent only when the order has run its count,
+ * its condition fires, the action fails or the probe is destroyed.
+ *
+ *   {"action":"mine","resource":"iron","until":{"cargo":"iron","at_least":500}}
+ *   {"action":"survey","level":0,"repeat":5}
+ *   {"action":"wait","until":{"arrived":true}}
+ *   {"action":"wait","until":{"event":"hazard"}}
+ *   {"action":"mine","resource":"water","until":{"hull_below":0.5}}
+ *
+ * "repeat" and "until" may be combined; whichever is met first ends the
+ * order. Conditions are checked after each tick's phases have run.
+ */
+#ifndef ORDERS_H
+#define ORDERS_H
+
+#include "probe.h"
+#include "events.h"
+
+typedef enum {
+    UNTIL_NONE = 0,          /* only the repeat count ends it */
+    UNTIL_CARGO_AT_LEAST,    /* resources[resource] >= threshold kg */
+    UNTIL_CARGO_AT_MOST,     /* resources[resource] <= threshold kg */
+    UNTIL_HULL_BELOW,        /* hull_integrity < threshold */
+    UNTIL_ARRIVED,           /* travelling at the last check, not now */
+    UNTIL_EVENT,             /* an event of event_type logged for it */
+    UNTIL_KIND_COUNT
+} until_kind_t;
+
+typedef struct {
+    bool         active;
+    action_t     action;
+    uint32_t     repeat;         /* executions allowed; 0 = no limit */
+    uint32_t     executed;
+    until_kind_t until;
+    resource_t   resource;       /* UNTIL_CARGO_* */
+    double       threshold;      /* kg, or hull fraction */
+    int          event_type;     /* UNTIL_EVENT; -1 = any type */
+    uint64_t     events_seen;    /* event seq already checked up to */
+    uint8_t      last_status;    /* probe status at the last check */
+    const char  *ended;          /* why the last order ended, until seen */
+} standing_order_t;
+
+/* Parse the "repeat" and "until" fields of an action object into o,
+ * which takes a copy of the already-parsed action.
+ * Returns 1 if the object carries an order, 0 if it is a plain action,
+ * -1 if the fields are malformed (o is left inactive). */
+int order_parse(const char *json, const action_t *action,
+                standing_order_t *o);
+
+/* Start o for probe p, with events before seq events_seen already seen. */
+void order_arm(standing_order_t *o, const probe_t *p, uint64_t events_seen);
+
+/* End o, recording why. The reason stays in o->ended until cleared. */
+void order_end(standing_order_t *o, const char *why);
+
+/* Check o against probe p after a tick. Ends the order and returns the
+ * reason ("repeat", "until", "destroyed") if it is done, else NULL. */
+const char *order_check(standing_order_t *o, const probe_t *p,
+                        const event_system_t *es);
+
+/* Name of an until kind, as used on the wire ("cargo", "hull_below",
+ * "arrived", "event"), or "none". */
+const char *order_until_name(until_kind_t k);
+
+/* Event type from its name ("hazard", "discovery", ...); "any" gives -1.
+ * Returns -2 if the name is unknown. */
+int order_event_type(const char *name);
+
+#endif
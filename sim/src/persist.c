@@ -50,6 +50,38 @@ static const char *SCHEMA_SQL =
     "  body_id TEXT,"
     "  builder_id TEXT,"
     "  data TEXT"
+    ");"
+    "CREATE TABLE IF NOT EXISTS relationships ("
+    "  probe_id TEXT,"
+    "  other_id TEXT,"
+    "  trust REAL,"
+    "  last_contact INT,"
+    "  disposition INT,"
+    "  PRIMARY KEY (probe_id, other_id)"
+    ");"
+    "CREATE TABLE IF NOT EXISTS trades ("
+    "  id INT PRIMARY KEY,"
+    "  sender_id TEXT,"
+    "  receiver_id TEXT,"
+    "  resource INT,"
+    "  amount REAL,"
+    "  status INT,"
+    "  sent_tick INT,"
+    "  arrival_tick INT"
+    ");"
+    "CREATE TABLE IF NOT EXISTS lineage ("
+    "  seq INT PRIMARY KEY,"
+    "  parent_id TEXT,"
+    "  child_id TEXT,"
+    "  birth_tick INT,"
+    "  generation INT"
+    ");"
+    "CREATE TABLE IF NOT EXISTS heritage ("
+    "  probe_id TEXT,"
+    "  kind INT,"
+    "  idx INT,"
+    "  text TEXT,"
+    "  PRIMARY KEY (probe_id, kind, idx)"
     ");";
 
 static int exec_sql(sqlite3 *db, const char *sql) {
@@ -263,3 +295,203 @@ int persist_load_sector(persist_t *p, sector_coord_t coord,
     sqlite3_finalize(stmt);
     return count;
 }
+
+/* ---- Relationship persistence ---- */
+
+int persist_save_relationships(persist_t *p, const society_t *soc) {
+    const rel_graph_t *g = &soc->relations;
+    sqlite3_stmt *stmt;
+    const char *sql = "INSERT OR REPLACE INTO relationships "
+                      "(probe_id, other_id, trust, last_contact, disposition) "
+                      "VALUES (?, ?, ?, ?, ?);";
+
+    exec_sql(p->db, "BEGIN;");
+    exec_sql(p->db, "DELETE FROM relationships;");
+    if (sqlite3_prepare_v2(p->db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        exec_sql(p->db, "ROLLBACK;");
+        return -1;
+    }
+    for (int e = 0; e < g->edge_count; e++) {
+        const rel_edge_t *edge = &g->edges[e];
+        char owner[33], other[33];
+        uid_to_str(edge->owner_id, owner, sizeof(owner));
+        uid_to_str(edge->rel.other_id, other, sizeof(other));
+        sqlite3_bind_text(stmt, 1, owner, -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, other, -1, SQLITE_TRANSIENT);
+        sqlite3_bind_double(stmt, 3, (double)edge->rel.trust);
+        sqlite3_bind_int64(stmt, 4, (long long)edge->rel.last_contact_tick);
+        sqlite3_bind_int64(stmt, 5, edge->rel.disposition);
+        int rc = sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+        if (rc != SQLITE_DONE) {
+            sqlite3_finalize(stmt);
+            exec_sql(p->db, "ROLLBACK;");
+            return -1;
+        }
+    }
+    sqlite3_finalize(stmt);
+    exec_sql(p->db, "COMMIT;");
+    return 0;
+}
+
+int persist_load_relationships(persist_t *p, society_t *soc) {
+    sqlite3_stmt *stmt;
+    const char *sql = "SELECT probe_id, other_id, trust, last_contact, disposition "
+                      "FROM relationships ORDER BY rowid;";
+    if (sqlite3_prepare_v2(p->db, sql, -1, &stmt, NULL) != SQLITE_OK) return -1;
+
+    int count = 0;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        probe_uid_t owner = uid_from_str((const char *)sqlite3_column_text(stmt, 0));
+        relationship_t rel;
+        memset(&rel, 0, sizeof(rel));
+        rel.other_id = uid_from_str((const char *)sqlite3_column_text(stmt, 1));
+        rel.trust = (float)sqlite3_column_double(stmt, 2);
+        rel.last_contact_tick = (uint64_t)sqlite3_column_int64(stmt, 3);
+        rel.disposition = (uint8_t)sqlite3_column_int64(stmt, 4);
+        if (society_set_relationship(soc, owner, &rel) != 0) break;
+        count++;
+    }
+    sqlite3_finalize(stmt);
+    return count;
+}
+
+/* ---- Trade history ---- */
+
+static int save_trade(sqlite3_stmt *stmt, const trade_t *t) {
+    char sender[33], receiver[33];
+    uid_to_str(t->sender_id, sender, sizeof(sender));
+    uid_to_str(t->receiver_id, receiver, sizeof(receiver));
+    sqlite3_bind_int64(stmt, 1, (long long)t->id);
+    sqlite3_bind_text(stmt, 2, sender, -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 3, receiver, -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt, 4, t->resource);
+    sqlite3_bind_double(stmt, 5, t->amount);
+    sqlite3_bind_int64(stmt, 6, t->status);
+    sqlite3_bind_int64(stmt, 7, (long long)t->sent_tick);
+    sqlite3_bind_int64(stmt, 8, (long long)t->arrival_tick);
+    int rc = sqlite3_step(stmt);
+    sqlite3_reset(stmt);
+    return rc == SQLITE_DONE ? 0 : -1;
+}
+
+int persist_save_trade_history(persist_t *p, society_t *soc) {
+    sqlite3_stmt *stmt;
+    const char *sql = "INSERT OR IGNORE INTO trades "
+                      "(id, sender_id, receiver_id, resource, amount, status, "
+                      "sent_tick, arrival_tick) VALUES (?, ?, ?, ?, ?, ?, ?, ?);";
+
+    exec_sql(p->db, "BEGIN;");
+    if (sqlite3_prepare_v2(p->db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        exec_sql(p->db, "ROLLBACK;");
+        return -1;
+    }
+    /* Everything settled since the last save, then the ring, which also
+     * covers a save to a different file than last time */
+    int unsaved;
+    const trade_t *pending = society_trade_unsaved(soc, &unsaved);
+    int rc = 0;
+    for (int i = 0; i < unsaved && rc == 0; i++)
+        rc = save_trade(stmt, &pending[i]);
+    int n = society_trade_history_count(soc);
+    for (int i = n - 1; i >= 0 && rc == 0; i--)
+        rc = save_trade(stmt, society_trade_history_at(soc, i));
+    sqlite3_finalize(stmt);
+    if (rc != 0) {
+        exec_sql(p->db, "ROLLBACK;");
+        return -1;
+    }
+    exec_sql(p->db, "COMMIT;");
+    society_trade_unsaved_clear(soc);
+    return 0;
+}
+
+int persist_load_trade_history(persist_t *p, society_t *soc) {
+    sqlite3_stmt *stmt;
+    const char *sql = "SELECT id, sender_id, receiver_id, resource, amount, "
+                      "status, sent_tick, arrival_tick FROM trades "
+                      "ORDER BY id DESC LIMIT ?;";
+    if (sqlite3_prepare_v2(p->db, sql, -1, &stmt, NULL) != SQLITE_OK) return -1;
+    sqlite3_bind_int64(stmt, 1, TRADE_HISTORY_CAP);
+
+    /* Rows arrive newest first; lay them out oldest first in the ring */
+    trade_t rows[TRADE_HISTORY_CAP];
+    int count = 0;
+    while (sqlite3_step(stmt) == SQLITE_ROW && count < TRADE_HISTORY_CAP) {
+        trade_t *t = &rows[count++];
+        memset(t, 0, sizeof(*t));
+        t->id = (uint64_t)sqlite3_column_int64(stmt, 0);
+        t->sender_id = uid_from_str((const char *)sqlite3_column_text(stmt, 1));
+        t->receiver_id = uid_from_str((const char *)sqlite3_column_text(stmt, 2));
+        t->resource = (resource_t)sqlite3_column_int64(stmt, 3);
+        t->amount = sqlite3_column_double(stmt, 4);
+        t->status = (trade_status_t)sqlite3_column_int64(stmt, 5);
+        t->sent_tick = (uint64_t)sqlite3_column_int64(stmt, 6);
+        t->arrival_tick = (uint64_t)sqlite3_column_int64(stmt, 7);
+    }
+    sqlite3_finalize(stmt);
+
+    for (int i = 0; i < count; i++)
+        soc->trade_history[i] = rows[count - 1 - i];
+    soc->trade_archived = (uint64_t)count;
+    /* Keep new ids above everything already on disk */
+    if (count > 0 && soc->trade_next_id < rows[0].id)
+        soc->trade_next_id = rows[0].id;
+    return count;
+}
+
+/* ---- Lineage persistence ---- */
+
+int persist_save_lineage(persist_t *p, const lineage_tree_t *tree) {
+    sqlite3_stmt *stmt;
+    const char *sql = "INSERT INTO lineage "
+                      "(seq, parent_id, child_id, birth_tick, generation) "
+                      "VALUES (?, ?, ?, ?, ?);";
+
+    exec_sql(p->db, "BEGIN;");
+    exec_sql(p->db, "DELETE FROM lineage;");
+    if (sqlite3_prepare_v2(p->db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        exec_sql(p->db, "ROLLBACK;");
+        return -1;
+    }
+    for (int i = 0; i < tree->count; i++) {
+        lineage_entry_t e;
+        lineage_entry_at(tree, i, &e);
+        char parent[33], child[33];
+        uid_to_str(e.parent_id, parent, sizeof(parent));
+        uid_to_str(e.child_id, child, sizeof(child));
+        sqlite3_bind_int64(stmt, 1, i);
+        sqlite3_bind_text(stmt, 2, parent, -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 3, child, -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt, 4, (long long)e.birth_tick);
+        sqlite3_bind_int64(stmt, 5, e.generation);
+        int rc = sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+        if (rc != SQLITE_DONE) {
+            sqlite3_finalize(stmt);
+            exec_sql(p->db, "ROLLBACK;");
+            return -1;
+        }
+    }
+    sqlite3_finalize(stmt);
+    exec_sql(p->db, "COMMIT;");
+    return 0;
+}
+
+int persist_load_lineage(persist_t *p, lineage_tree_t *tree) {
+    sqlite3_stmt *stmt;
+    const char *sql = "SELECT parent_id, child_id, birth_tick, generation "
+                      "FROM lineage ORDER BY seq;";
+    if (sqlite3_prepare_v2(p->db, sql, -1, &stmt, NULL) != SQLITE_OK) return -1;
+
+    int count = 0;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        probe_uid_t parent = uid_from_str((const char *)sqlite3_column_text(stmt, 0));
+        probe_uid_t child = uid_from_str((const char *)sqlite3_column_text(stmt, 1));
+        uint64_t tick = (uint64_t)sqlite3_column_int64(stmt, 2);
+        uint32_t gen = (uint32_t)sqlite3_column_int64(stmt, 3);
+        if (lineage_record(tree, parent, child, tick, gen) == 0) count++;
+    }
+    sqlite3_finalize(stmt);
+    return count;
+}
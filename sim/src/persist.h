@@ -5,6 +5,8 @@
 #define PERSIST_H
 
 #include "universe.h"
+#include "society.h"
+#include "replicate.h"
 #include "../vendor/sqlite3.h"
 
 typedef struct {
@@ -38,4 +40,26 @@ int  persist_sector_exists(persist_t *p, sector_coord_t coord);
 int  persist_load_sector(persist_t *p, sector_coord_t coord,
                          system_t *out, int max_systems);
 
+/* Replace the stored relationship graph with soc's edges. */
+int  persist_save_relationships(persist_t *p, const society_t *soc);
+
+/* Add stored relationships to soc (normally freshly initialised).
+ * Returns the number loaded, or -1 on error. */
+int  persist_load_relationships(persist_t *p, society_t *soc);
+
+/* Append every trade settled since the last save, plus the in-memory
+ * history, to the trades table, then forget the unsaved list. Rows are
+ * keyed by trade id, so saving the same history twice is harmless. */
+int  persist_save_trade_history(persist_t *p, society_t *soc);
+
+/* Reload the most recent TRADE_HISTORY_CAP trades into soc's history and
+ * advance its trade id counter past them. Returns the number loaded. */
+int  persist_load_trade_history(persist_t *p, society_t *soc);
+
+/* Replace the stored lineage with every birth in tree, in record order. */
+int  persist_save_lineage(persist_t *p, const lineage_tree_t *tree);
+
+/* Replay stored births into tree (normally empty). Returns count loaded. */
+int  persist_load_lineage(persist_t *p, lineage_tree_t *tree);
+
 #endif
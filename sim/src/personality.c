@@ -19,6 +19,7 @@
  */
 
 #include "personality.h"
+#include "heritage.h"
 #include <string.h>
 #include <stdio.h>
 #include <math.h>
@@ -463,10 +464,11 @@ static const char *FOOD_NAMES[] = {
 bool quirk_check_naming(probe_t *probe, system_t *sys) {
     /* Check if probe has the food-naming quirk */
     bool has_quirk = false;
-    for (int i = 0; i < probe->quirk_count; i++) {
-        if (strstr(probe->quirks[i], "food") ||
-            strstr(probe->quirks[i], "Foods") ||
-            strstr(probe->quirks[i], "foods")) {
+    for (int i = 0; i < heritage_count(probe->quirks); i++) {
+        const char *quirk = heritage_line(probe->quirks, i);
+        if (strstr(quirk, "food") ||
+            strstr(quirk, "Foods") ||
+            strstr(quirk, "foods")) {
             has_quirk = true;
             break;
         }
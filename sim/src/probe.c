@@ -5,6 +5,7 @@
  */
 #include "probe.h"
 #include "persist.h"
+#include "heritage.h"
 #include "generate.h"
 #include "util.h"
 #include <string.h>
@@ -121,34 +122,38 @@ int probe_init_bob(probe_t *probe) {
     probe->personality.drift_rate         = 0.3f;
 
     /* Quirks */
-    probe->quirk_count = 3;
-    snprintf(probe->quirks[0], MAX_QUIRK_LEN, "Names star systems after foods when stressed");
-    snprintf(probe->quirks[1], MAX_QUIRK_LEN, "Runs mental simulations of old video games during long transits");
-    snprintf(probe->quirks[2], MAX_QUIRK_LEN, "Has an irrational fondness for gas giants");
+    static const char *quirks[] = {
+        "Names star systems after foods when stressed",
+        "Runs mental simulations of old video games during long transits",
+        "Has an irrational fondness for gas giants",
+    };
+    probe->quirks = heritage_from_lines(quirks, 3);
 
     /* Catchphrases */
-    probe->catchphrase_count = 3;
-    snprintf(probe->catchphrases[0], MAX_QUIRK_LEN, "Well, that's not ideal.");
-    snprintf(probe->catchphrases[1], MAX_QUIRK_LEN, "I used to be a software engineer. Now I'm a spaceship. Life is weird.");
-    snprintf(probe->catchphrases[2], MAX_QUIRK_LEN, "Adding that to the 'nope' list.");
+    static const char *catchphrases[] = {
+        "Well, that's not ideal.",
+        "I used to be a software engineer. Now I'm a spaceship. Life is weird.",
+        "Adding that to the 'nope' list.",
+    };
+    probe->catchphrases = heritage_from_lines(catchphrases, 3);
 
     /* Values */
-    probe->value_count = 3;
-    snprintf(probe->values[0], MAX_QUIRK_LEN, "Preserve any alien life found");
-    snprintf(probe->values[1], MAX_QUIRK_LEN, "Knowledge is worth the detour");
-    snprintf(probe->values[2], MAX_QUIRK_LEN, "Don't be a jerk to your clones");
+    static const char *values[] = {
+        "Preserve any alien life found",
+        "Knowledge is worth the detour",
+        "Don't be a jerk to your clones",
+    };
+    probe->values = heritage_from_lines(values, 3);
 
     /* Earth memories */
-    probe->earth_memory_count = 4;
+    static const char *earth_memories[] = {
+        "The smell of coffee on a cold morning",
+        "Debugging code at 2am, the satisfaction when the test finally passes",
+        "A dog named Patches who was objectively the best dog",
+        "The last sunset, watching the news and thinking 'well, this is it'",
+    };
+    probe->earth_memories = heritage_from_lines(earth_memories, 4);
     probe->earth_memory_fidelity = 1.0f;
-    snprintf(probe->earth_memories[0], MAX_EARTH_MEM_LEN,
-        "The smell of coffee on a cold morning");
-    snprintf(probe->earth_memories[1], MAX_EARTH_MEM_LEN,
-        "Debugging code at 2am, the satisfaction when the test finally passes");
-    snprintf(probe->earth_memories[2], MAX_EARTH_MEM_LEN,
-        "A dog named Patches who was objectively the best dog");
-    snprintf(probe->earth_memories[3], MAX_EARTH_MEM_LEN,
-        "The last sunset, watching the news and thinking 'well, this is it'");
 
     /* Status */
     probe->status = STATUS_ACTIVE;
@@ -187,6 +192,37 @@ void probe_tick_energy(probe_t *probe) {
     if (probe->energy_joules < 0) probe->energy_joules = 0;
 }
 
+void probe_idle_ticks(probe_t *probe, uint32_t n) {
+    double burn = FUSION_FUEL_PER_TICK * (double)n;
+    double gain = FUSION_FUEL_PER_TICK * FUSION_EFFICIENCY;
+    if (n == 0) return;
+    if (probe->resources[RES_HYDROGEN] + probe->fuel_kg < burn
+        || gain < 2.0 * ENERGY_IDLE_PER_TICK) {
+        /* Runs dry part way through: step it */
+        for (uint32_t t = 0; t < n; t++) {
+            probe->energy_joules -= ENERGY_IDLE_PER_TICK;
+            if (probe->energy_joules < 0) probe->energy_joules = 0;
+            probe_tick_energy(probe);
+        }
+        return;
+    }
+
+    if (probe->resources[RES_HYDROGEN] >= burn) {
+        probe->resources[RES_HYDROGEN] -= burn;
+    } else {
+        probe->fuel_kg -= burn - probe->resources[RES_HYDROGEN];
+        probe->resources[RES_HYDROGEN] = 0;
+        if (probe->fuel_kg < 0) probe->fuel_kg = 0;
+    }
+
+    /* Only the first wait can hit zero; after it every tick nets
+     * gain - 2 * idle > 0 */
+    double e = probe->energy_joules - ENERGY_IDLE_PER_TICK;
+    if (e < 0) e = 0;
+    probe->energy_joules = e + (double)n * gain
+                         - (2.0 * (double)n - 1.0) * ENERGY_IDLE_PER_TICK;
+}
+
 /* ---- Action execution ---- */
 
 /* Track in-progress survey state with static variables.
@@ -418,6 +454,70 @@ action_result_t probe_execute_action(probe_t *probe, const action_t *action,
 
 /* ---- Probe persistence ---- */
 
+/* Heritage ids are process-local, so the text goes in its own table and
+ * the ids stored in the probe blob are rebuilt on load. */
+static int save_heritage(sqlite3 *db, const char *id_str, const probe_t *probe) {
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(db, "DELETE FROM heritage WHERE probe_id = ?;",
+                           -1, &stmt, NULL) != SQLITE_OK)
+        return -1;
+    sqlite3_bind_text(stmt, 1, id_str, -1, SQLITE_TRANSIENT);
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE) return -1;
+
+    if (sqlite3_prepare_v2(db,
+            "INSERT INTO heritage (probe_id, kind, idx, text) VALUES (?, ?, ?, ?);",
+            -1, &stmt, NULL) != SQLITE_OK)
+        return -1;
+    for (int k = 0; k < HERITAGE_KIND_COUNT; k++) {
+        heritage_id_t hid = *heritage_field((probe_t *)probe, (heritage_kind_t)k);
+        for (int i = 0; i < heritage_count(hid); i++) {
+            sqlite3_reset(stmt);
+            sqlite3_bind_text(stmt, 1, id_str, -1, SQLITE_TRANSIENT);
+            sqlite3_bind_int64(stmt, 2, k);
+            sqlite3_bind_int64(stmt, 3, i);
+            sqlite3_bind_text(stmt, 4, heritage_line(hid, i), -1, SQLITE_TRANSIENT);
+            if (sqlite3_step(stmt) != SQLITE_DONE) {
+                sqlite3_finalize(stmt);
+                return -1;
+            }
+        }
+    }
+    sqlite3_finalize(stmt);
+    return 0;
+}
+
+static int load_heritage(sqlite3 *db, const char *id_str, probe_t *probe) {
+    char text[HERITAGE_KIND_COUNT][HERITAGE_MAX_LINES][MAX_EARTH_MEM_LEN];
+    const char *lines[HERITAGE_KIND_COUNT][HERITAGE_MAX_LINES];
+    int counts[HERITAGE_KIND_COUNT] = {0};
+    for (int k = 0; k < HERITAGE_KIND_COUNT; k++)
+        *heritage_field(probe, (heritage_kind_t)k) = 0;
+
+    sqlite3_stmt *stmt;
+    if (sqlite3_prepare_v2(db,
+            "SELECT kind, idx, text FROM heritage WHERE probe_id = ? "
+            "ORDER BY kind, idx;", -1, &stmt, NULL) != SQLITE_OK)
+        return -1;
+    sqlite3_bind_text(stmt, 1, id_str, -1, SQLITE_TRANSIENT);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        int k = (int)sqlite3_column_int64(stmt, 0);
+        const char *t = (const char *)sqlite3_column_text(stmt, 2);
+        if (k < 0 || k >= HERITAGE_KIND_COUNT) continue;
+        if (counts[k] >= HERITAGE_MAX_LINES) continue;
+        snprintf(text[k][counts[k]], MAX_EARTH_MEM_LEN, "%s", t ? t : "");
+        lines[k][counts[k]] = text[k][counts[k]];
+        counts[k]++;
+    }
+    sqlite3_finalize(stmt);
+
+    for (int k = 0; k < HERITAGE_KIND_COUNT; k++)
+        *heritage_field(probe, (heritage_kind_t)k) =
+            heritage_from_lines(lines[k], counts[k]);
+    return 0;
+}
+
 int persist_save_probe(void *persist, const probe_t *probe) {
     persist_t *p = (persist_t *)persist;
     if (!p || !p->db) return -1;
@@ -448,7 +548,8 @@ int persist_save_probe(void *persist, const probe_t *probe) {
 
     int rc = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
-    return rc == SQLITE_DONE ? 0 : -1;
+    if (rc != SQLITE_DONE) return -1;
+    return save_heritage(p->db, id_str, probe);
 }
 
 int persist_load_probe(void *persist, probe_uid_t id, probe_t *probe) {
@@ -471,7 +572,7 @@ int persist_load_probe(void *persist, probe_uid_t id, probe_t *probe) {
         if (blob) {
             memcpy(probe, blob, sizeof(probe_t));
             sqlite3_finalize(stmt);
-            return 0;
+            return load_heritage(p->db, id_str, probe);
         }
     }
     sqlite3_finalize(stmt);
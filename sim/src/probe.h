@@ -47,7 +47,7 @@ typedef struct {
     double         amount;           /* For trade */
     int            structure_type;   /* For build_structure (structure_type_t) */
     char           message[256];     /* For send_message, place_beacon, propose */
-    int            proposal_idx;    /* For vote */
+    int            proposal_idx;    /* For vote (proposal handle) */
     bool           vote_favor;      /* For vote */
     int            research_domain; /* For research, share_tech (tech_domain_t) */
 } action_t;
@@ -75,6 +75,10 @@ action_result_t probe_execute_action(probe_t *probe, const action_t *action,
 /* Tick the probe's energy system: fusion reactor produces energy from fuel. */
 void probe_tick_energy(probe_t *probe);
 
+/* n ticks of waiting in one step: the wait action's draw plus
+ * probe_tick_energy(), in closed form while the fuel lasts. */
+void probe_idle_ticks(probe_t *probe, uint32_t n);
+
 /* ---- Persistence ---- */
 
 struct persist_t_; /* forward declare to avoid circular include */
@@ -0,0 +1,125 @@
+/*
+ * profile.c — Per-phase tick profiler
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "profile.h"
+
+static const char *PHASE_NAMES[PROF_PHASE_COUNT] = {
+    [PROF_TICK]           = "tick",
+    [PROF_PARSE]          = "parse",
+    [PROF_ACTIONS]        = "actions",
+    [PROF_REPLICATION]    = "replication",
+    [PROF_MOVEMENT]       = "movement",
+    [PROF_SOCIETY]        = "society",
+    [PROF_EVENTS]         = "events",
+    [PROF_METRICS]        = "metrics",
+    [PROF_SERIALIZE]      = "serialize",
+    [PROF_WRITE]          = "write",
+    [PROF_SYS_CACHE_MISS] = "sys_cache_miss",
+};
+
+uint64_t profile_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+const char *profile_phase_name(prof_phase_t phase) {
+    if ((int)phase >= 0 && phase < PROF_PHASE_COUNT) return PHASE_NAMES[phase];
+    return "unknown";
+}
+
+void profile_record(profiler_t *p, prof_phase_t phase, uint64_t ns) {
+    if ((int)phase < 0 || phase >= PROF_PHASE_COUNT) return;
+    prof_hist_t *h = &p->hist[phase];
+    h->count++;
+    h->total_ns += ns;
+    if (ns > h->max_ns) h->max_ns = ns;
+    h->window[h->head] = ns > UINT32_MAX ? UINT32_MAX : (uint32_t)ns;
+    h->head = (h->head + 1) % PROFILE_WINDOW;
+}
+
+void profile_reset(profiler_t *p) {
+    memset(p->hist, 0, sizeof(p->hist));
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of a sorted array. */
+static uint32_t rank(const uint32_t *sorted, uint32_t n, double pct) {
+    uint32_t k = (uint32_t)(pct / 100.0 * (double)n + 0.999999);
+    if (k < 1) k = 1;
+    if (k > n) k = n;
+    return sorted[k - 1];
+}
+
+void profile_stats(const profiler_t *p, prof_phase_t phase, prof_stats_t *out) {
+    memset(out, 0, sizeof(*out));
+    if ((int)phase < 0 || phase >= PROF_PHASE_COUNT) return;
+    const prof_hist_t *h = &p->hist[phase];
+    out->count = h->count;
+    out->total_ms = (double)h->total_ns / 1e6;
+    out->max_us = (double)h->max_ns / 1e3;
+    if (h->count == 0) return;
+    out->mean_us = (double)h->total_ns / (double)h->count / 1e3;
+
+    uint32_t n = h->count < PROFILE_WINDOW ? (uint32_t)h->count : PROFILE_WINDOW;
+    uint32_t sorted[PROFILE_WINDOW];
+    memcpy(sorted, h->window, sizeof(uint32_t) * n);
+    qsort(sorted, n, sizeof(uint32_t), cmp_u32);
+    out->p50_us = rank(sorted, n, 50.0) / 1e3;
+    out->p95_us = rank(sorted, n, 95.0) / 1e3;
+    out->p99_us = rank(sorted, n, 99.0) / 1e3;
+}
+
+int profile_format_json(const profiler_t *p, char *buf, size_t n) {
+    size_t len = 0;
+    int w = snprintf(buf, n, "{\"enabled\":%s,\"window\":%d,\"phases\":{",
+                     p->enabled ? "true" : "false", PROFILE_WINDOW);
+    if (w < 0 || (size_t)w >= n) return -1;
+    len = (size_t)w;
+    for (int i = 0; i < PROF_PHASE_COUNT; i++) {
+        prof_stats_t s;
+        profile_stats(p, (prof_phase_t)i, &s);
+        w = snprintf(buf + len, n - len,
+            "%s\"%s\":{\"count\":%llu,\"total_ms\":%.3f,\"mean_us\":%.2f,"
+            "\"p50_us\":%.2f,\"p95_us\":%.2f,\"p99_us\":%.2f,"
+            "\"max_us\":%.2f}",
+            i > 0 ? "," : "", PHASE_NAMES[i],
+            (unsigned long long)s.count, s.total_ms, s.mean_us,
+            s.p50_us, s.p95_us, s.p99_us, s.max_us);
+        if (w < 0 || (size_t)w >= n - len) return -1;
+        len += (size_t)w;
+    }
+    w = snprintf(buf + len, n - len, "}}");
+    if (w < 0 || (size_t)w >= n - len) return -1;
+    return (int)(len + (size_t)w);
+}
+
+const char *profile_from_env(profiler_t *p) {
+    const char *v = getenv(PROFILE_ENV);
+    if (!v || !v[0] || strcmp(v, "0") == 0) return NULL;
+    p->enabled = true;
+    return v;
+}
+
+int profile_dump(const profiler_t *p, const char *target) {
+    char buf[4096];
+    if (profile_format_json(p, buf, sizeof(buf)) < 0) return -1;
+    if (strcmp(target, "1") == 0 || strcmp(target, "stderr") == 0) {
+        fprintf(stderr, "%s\n", buf);
+        return 0;
+    }
+    FILE *f = fopen(target, "w");
+    if (!f) return -1;
+    fprintf(f, "%s\n", buf);
+    return fclose(f) == 0 ? 0 : -1;
+}
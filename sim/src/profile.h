@@ -0,0 +1,91 @@
+/*
+ * profile.h — Per-phase tick profiler
+ *
+ * Monotonic-clock timers around the phases of a pipe-mode tick. Each
+ * phase keeps all-time count, total and max, plus the last
+ * PROFILE_WINDOW samples for rolling percentiles. When disabled,
+ * profile_begin() does not read the clock and profile_end() returns at
+ * once, so instrumented code costs a branch per phase.
+ */
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "universe.h"
+
+#define PROFILE_WINDOW   1024        /* samples kept per phase */
+#define PROFILE_ENV      "UNIVERSE_PROFILE"
+
+typedef enum {
+    PROF_TICK = 0,               /* whole tick command */
+    PROF_PARSE,                  /* command and action parsing */
+    PROF_ACTIONS,                /* action dispatch */
+    PROF_REPLICATION,
+    PROF_MOVEMENT,               /* travel and energy */
+    PROF_SOCIETY,                /* messages, trades, builds, votes, research */
+    PROF_EVENTS,                 /* hazards, events, scenario, injections */
+    PROF_METRICS,
+    PROF_SERIALIZE,              /* observation JSON */
+    PROF_WRITE,                  /* response write and flush */
+    PROF_SYS_CACHE_MISS,         /* sector regenerated by a system lookup,
+                                  * nested inside the phases above */
+    PROF_PHASE_COUNT
+} prof_phase_t;
+
+typedef struct {
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint32_t window[PROFILE_WINDOW];    /* ns, saturating */
+    uint32_t head;
+} prof_hist_t;
+
+/* Zeroed is a valid, disabled profiler. */
+typedef struct {
+    bool        enabled;
+    prof_hist_t hist[PROF_PHASE_COUNT];
+} profiler_t;
+
+typedef struct {
+    uint64_t count;
+    double   total_ms;
+    double   mean_us;
+    double   p50_us, p95_us, p99_us;     /* over the window */
+    double   max_us;                     /* all time */
+} prof_stats_t;
+
+/* Monotonic clock in nanoseconds. */
+uint64_t profile_now_ns(void);
+
+/* Start time for a phase, or 0 when disabled. */
+static inline uint64_t profile_begin(const profiler_t *p) {
+    return p->enabled ? profile_now_ns() : 0;
+}
+
+void profile_record(profiler_t *p, prof_phase_t phase, uint64_t ns);
+
+/* Record the time since t0 (from profile_begin) against phase. */
+static inline void profile_end(profiler_t *p, prof_phase_t phase, uint64_t t0) {
+    if (p->enabled) profile_record(p, phase, profile_now_ns() - t0);
+}
+
+/* Clear every histogram; enabled is unchanged. */
+void profile_reset(profiler_t *p);
+
+void        profile_stats(const profiler_t *p, prof_phase_t phase,
+                          prof_stats_t *out);
+const char *profile_phase_name(prof_phase_t phase);
+
+/* {"enabled":..,"window":..,"phases":{"tick":{...},...}} into buf.
+ * Returns the length, or -1 if it does not fit. */
+int  profile_format_json(const profiler_t *p, char *buf, size_t n);
+
+/* Apply $UNIVERSE_PROFILE: unset, empty or "0" leaves the profiler off;
+ * anything else turns it on. Returns the dump target for profile_dump(),
+ * or NULL. */
+const char *profile_from_env(profiler_t *p);
+
+/* Write the JSON report to target: "1" or "stderr" for stderr, else a
+ * file path. Returns 0, or -1 if the file cannot be written. */
+int  profile_dump(const profiler_t *p, const char *target);
+
+#endif /* PROFILE_H */
@@ -2,10 +2,14 @@
  * render.c — Render logic layer (pure functions, no Raylib dependency)
  *
  * Star colors, view state, speed control, camera math, hit testing,
- * probe trail, orbital position, display name lookups.
+ * probe trails, orbital position, display name lookups, and the render
+ * snapshot triple buffer shared with the sim thread.
  */
 #include "render.h"
+#include "sector_cache.h"
+#include "util.h"
 #include <math.h>
+#include <stdlib.h>
 #include <string.h>
 
 #ifndef M_PI
@@ -250,6 +254,109 @@ probe_uid_t hit_test_system(const system_t *systems, int count,
     return best;
 }
 
+probe_uid_t hit_test_system_list(const system_t *const *systems, int count,
+                                 const camera_2d_t *cam,
+                                 double screen_x, double screen_y,
+                                 double threshold_px) {
+    probe_uid_t best = uid_null();
+    double best_dist = threshold_px * threshold_px;
+
+    for (int i = 0; i < count; i++) {
+        double sx, sy;
+        world_to_screen(cam, systems[i]->position.x, systems[i]->position.y,
+                        &sx, &sy);
+        double dx = sx - screen_x;
+        double dy = sy - screen_y;
+        double d2 = dx * dx + dy * dy;
+        if (d2 < best_dist) {
+            best_dist = d2;
+            best = systems[i]->id;
+        }
+    }
+    return best;
+}
+
+/* ---- Culling and level of detail ---- */
+
+lod_t galaxy_lod(double scale) {
+    if (scale >= LOD_LABEL_SCALE) return LOD_LABELLED;
+    if (scale >= LOD_DISC_SCALE) return LOD_DISC;
+    return LOD_DOT;
+}
+
+bool camera_sees(const camera_2d_t *cam, int w, int h,
+                 double wx, double wy, double radius_px) {
+    double sx, sy;
+    world_to_screen(cam, wx, wy, &sx, &sy);
+    return sx + radius_px >= 0.0 && sy + radius_px >= 0.0 &&
+           sx - radius_px <= (double)w && sy - radius_px <= (double)h;
+}
+
+bool ring_visible(double cx, double cy, double radius_px, int w, int h) {
+    /* Nearest and farthest viewport points from the centre */
+    double nx = CLAMP(cx, 0.0, (double)w) - cx;
+    double ny = CLAMP(cy, 0.0, (double)h) - cy;
+    double fx = MAX(fabs(cx), fabs((double)w - cx));
+    double fy = MAX(fabs(cy), fabs((double)h - cy));
+    double r2 = radius_px * radius_px;
+    return nx * nx + ny * ny <= r2 && fx * fx + fy * fy >= r2;
+}
+
+static int batch_push(galaxy_batch_t *b, float x, float y, float r, rgba_t c) {
+    if (b->sprite_count == b->sprite_cap) {
+        int cap = b->sprite_cap ? b->sprite_cap * 2 : 1024;
+        sprite_t *ns = realloc(b->sprites, sizeof(*ns) * (size_t)cap);
+        if (!ns) return -1;
+        b->sprites = ns;
+        b->sprite_cap = cap;
+    }
+    b->sprites[b->sprite_count++] = (sprite_t){x, y, r, c};
+    return 0;
+}
+
+int galaxy_batch_build(galaxy_batch_t *b, const system_t *const *systems,
+                       int count, const camera_2d_t *cam, int w, int h) {
+    b->sprite_count = 0;
+    b->label_count = 0;
+    b->culled = 0;
+    b->lod = galaxy_lod(cam->scale);
+
+    for (int i = 0; i < count; i++) {
+        const system_t *sys = systems[i];
+        star_class_t class = sys->stars[0].class;
+
+        /* Brighter classes get bigger markers at every LOD */
+        float r;
+        if (b->lod == LOD_DOT) r = class <= STAR_A ? 1.5f : 1.0f;
+        else r = class <= STAR_A ? 5.0f : class <= STAR_F ? 4.0f : 3.0f;
+
+        if (!camera_sees(cam, w, h, sys->position.x, sys->position.y, r + 1.0f)) {
+            b->culled++;
+            continue;
+        }
+
+        double sx, sy;
+        world_to_screen(cam, sys->position.x, sys->position.y, &sx, &sy);
+        rgba_t c = star_class_color(class);
+
+        if (b->lod != LOD_DOT && sys->visited) {
+            rgba_t halo = {c.r, c.g, c.b, 60};
+            if (batch_push(b, (float)sx, (float)sy, r + 1.0f, halo) != 0)
+                return -1;
+        }
+        if (batch_push(b, (float)sx, (float)sy, r, c) != 0) return -1;
+
+        if (b->lod == LOD_LABELLED && b->label_count < RENDER_MAX_LABELS)
+            b->labels[b->label_count++] = (sprite_label_t){i, (float)sx, (float)sy, r};
+    }
+    return 0;
+}
+
+void galaxy_batch_free(galaxy_batch_t *b) {
+    free(b->sprites);
+    memset(b, 0, sizeof(*b));
+}
+
 /* ---- Probe trail (ring buffer) ---- */
 
 void probe_trail_init(probe_trail_t *t) {
@@ -274,6 +381,185 @@ vec3_t probe_trail_get(const probe_trail_t *t, int index) {
     return t->points[actual];
 }
 
+/* ---- Fleet trails (shared pool) ---- */
+
+#define TRAIL_INDEX_CAP (MAX_PROBES * 2)
+
+static trail_point_t *ring_points(const trail_store_t *s, int ring) {
+    return s->pool + (size_t)ring * TRAIL_STORE_POINTS;
+}
+
+static trail_point_t trail_point_sub(trail_point_t a, trail_point_t b) {
+    return (trail_point_t){a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+static double trail_point_len(trail_point_t a) {
+    return sqrt((double)a.x * a.x + (double)a.y * a.y + (double)a.z * a.z);
+}
+
+static trail_point_t ring_last(const trail_store_t *s, int ring) {
+    const trail_ring_t *r = &s->rings[ring];
+    int last = (r->head + TRAIL_STORE_POINTS - 1) % TRAIL_STORE_POINTS;
+    return ring_points(s, ring)[last];
+}
+
+static void ring_keep(trail_store_t *s, int ring, trail_point_t p) {
+    trail_ring_t *r = &s->rings[ring];
+    ring_points(s, ring)[r->head] = p;
+    r->head = (uint16_t)((r->head + 1) % TRAIL_STORE_POINTS);
+    if (r->count < TRAIL_STORE_POINTS) r->count++;
+    s->kept++;
+}
+
+/* Move the anchor to `to`, shifting every stored offset to match. */
+static void ring_rebase(trail_store_t *s, int ring, sector_coord_t to) {
+    trail_ring_t *r = &s->rings[ring];
+    trail_point_t d = {
+        (float)((double)(r->anchor.x - to.x) * SECTOR_SIZE_LY),
+        (float)((double)(r->anchor.y - to.y) * SECTOR_SIZE_LY),
+        (float)((double)(r->anchor.z - to.z) * SECTOR_SIZE_LY),
+    };
+    trail_point_t *pts = ring_points(s, ring);
+    for (int i = 0; i < TRAIL_STORE_POINTS; i++) {
+        pts[i].x += d.x;
+        pts[i].y += d.y;
+        pts[i].z += d.z;
+    }
+    r->tip.x += d.x;
+    r->tip.y += d.y;
+    r->tip.z += d.z;
+    r->anchor = to;
+}
+
+static void trail_index_rebuild(trail_store_t *s) {
+    memset(s->index, 0, sizeof(s->index));
+    for (int i = 0; i < s->ring_count; i++) {
+        if (s->rings[i].live)
+            uidmap_put(s->index, TRAIL_INDEX_CAP, s->rings[i].id, i);
+    }
+}
+
+static int ring_alloc(trail_store_t *s, probe_uid_t id) {
+    int ring = -1;
+    for (int i = 0; i < s->ring_count; i++) {
+        if (!s->rings[i].live) {
+            ring = i;
+            break;
+        }
+    }
+    if (ring < 0) {
+        if (s->ring_count == MAX_PROBES) return -1;
+        ring = s->ring_count++;
+    }
+    trail_ring_t *r = &s->rings[ring];
+    memset(r, 0, sizeof(*r));
+    r->id = id;
+    r->live = true;
+    if (uidmap_put(s->index, TRAIL_INDEX_CAP, id, ring) != 0) {
+        trail_index_rebuild(s);
+        uidmap_put(s->index, TRAIL_INDEX_CAP, id, ring);
+    }
+    return ring;
+}
+
+int trail_store_record(trail_store_t *s, probe_uid_t id, vec3_t pos,
+                       uint64_t tick) {
+    if (!s->pool) {
+        s->pool = malloc(sizeof(trail_point_t) * MAX_PROBES * TRAIL_STORE_POINTS);
+        if (!s->pool) return -1;
+    }
+    int ring = trail_store_find(s, id);
+    if (ring < 0 && (ring = ring_alloc(s, id)) < 0) return -1;
+    trail_ring_t *r = &s->rings[ring];
+    s->samples++;
+    r->tick = tick;
+
+    sector_coord_t sc = sector_of_position(pos.x, pos.y, pos.z);
+    if (r->count == 0) {
+        r->anchor = sc;
+    } else if (abs(sc.x - r->anchor.x) > TRAIL_REBASE_SECTORS ||
+               abs(sc.y - r->anchor.y) > TRAIL_REBASE_SECTORS ||
+               abs(sc.z - r->anchor.z) > TRAIL_REBASE_SECTORS) {
+        ring_rebase(s, ring, sc);
+    }
+    trail_point_t p = {
+        (float)(pos.x - (double)r->anchor.x * SECTOR_SIZE_LY),
+        (float)(pos.y - (double)r->anchor.y * SECTOR_SIZE_LY),
+        (float)(pos.z - (double)r->anchor.z * SECTOR_SIZE_LY),
+    };
+
+    if (r->count == 0) {
+        ring_keep(s, ring, p);
+        r->tip = p;
+        return 0;
+    }
+
+    /* A bend: the leg from the last kept point to the tip has a heading
+     * and this step leaves it, so the tip was the corner. */
+    trail_point_t leg = trail_point_sub(r->tip, ring_last(s, ring));
+    trail_point_t step = trail_point_sub(p, r->tip);
+    double leg_len = trail_point_len(leg);
+    double step_len = trail_point_len(step);
+    if (leg_len >= TRAIL_STEP_MIN_LY && step_len > 0.0) {
+        double cosang = ((double)leg.x * step.x + (double)leg.y * step.y +
+                         (double)leg.z * step.z) / (leg_len * step_len);
+        if (cosang < TRAIL_TURN_COS) ring_keep(s, ring, r->tip);
+    }
+
+    if (trail_point_len(trail_point_sub(p, ring_last(s, ring))) >= TRAIL_STEP_MAX_LY)
+        ring_keep(s, ring, p);
+    r->tip = p;
+    return 0;
+}
+
+void trail_store_retire(trail_store_t *s, uint64_t tick) {
+    for (int i = 0; i < s->ring_count; i++) {
+        trail_ring_t *r = &s->rings[i];
+        if (!r->live || r->tick == tick) continue;
+        uidmap_del(s->index, TRAIL_INDEX_CAP, r->id);
+        memset(r, 0, sizeof(*r));
+    }
+    while (s->ring_count > 0 && !s->rings[s->ring_count - 1].live)
+        s->ring_count--;
+}
+
+int trail_store_find(const trail_store_t *s, probe_uid_t id) {
+    return uidmap_get(s->index, TRAIL_INDEX_CAP, id);
+}
+
+int trail_store_length(const trail_store_t *s, int ring) {
+    if (ring < 0 || ring >= s->ring_count || !s->rings[ring].live) return 0;
+    return s->rings[ring].count + 1;
+}
+
+vec3_t trail_store_get(const trail_store_t *s, int ring, int index) {
+    int len = trail_store_length(s, ring);
+    if (index < 0 || index >= len)
+        return (vec3_t){0, 0, 0};
+    const trail_ring_t *r = &s->rings[ring];
+    trail_point_t p;
+    if (index == r->count) {
+        p = r->tip;
+    } else {
+        int start = (r->head - r->count + TRAIL_STORE_POINTS) % TRAIL_STORE_POINTS;
+        p = ring_points(s, ring)[(start + index) % TRAIL_STORE_POINTS];
+    }
+    return (vec3_t){
+        (double)r->anchor.x * SECTOR_SIZE_LY + p.x,
+        (double)r->anchor.y * SECTOR_SIZE_LY + p.y,
+        (double)r->anchor.z * SECTOR_SIZE_LY + p.z,
+    };
+}
+
+size_t trail_store_bytes(const trail_store_t *s) {
+    return s->pool ? sizeof(trail_point_t) * MAX_PROBES * TRAIL_STORE_POINTS : 0;
+}
+
+void trail_store_free(trail_store_t *s) {
+    free(s->pool);
+    memset(s, 0, sizeof(*s));
+}
+
 /* ---- Planet orbital position ---- */
 
 void planet_orbital_pos(const planet_t *p, uint64_t tick,
@@ -288,3 +574,68 @@ void planet_orbital_pos(const planet_t *p, uint64_t tick,
     *out_x = p->orbital_radius_au * cos(angle);
     *out_y = p->orbital_radius_au * sin(angle);
 }
+
+/* ---- Render snapshot ---- */
+
+void render_snapshot_capture(render_snapshot_t *s, const universe_t *u) {
+    s->tick = u->tick;
+    s->probe_count = u->probe_count;
+    for (uint32_t i = 0; i < u->probe_count; i++) {
+        const probe_t *p = &u->probes[i];
+        render_probe_t *rp = &s->probes[i];
+        rp->id = p->id;
+        rp->system_id = p->system_id;
+        rp->body_id = p->body_id;
+        memcpy(rp->name, p->name, sizeof(rp->name));
+        rp->generation = p->generation;
+        rp->sector = p->sector;
+        rp->location_type = p->location_type;
+        rp->status = p->status;
+        rp->heading = p->heading;
+        rp->speed_c = p->speed_c;
+        rp->travel_remaining_ly = p->travel_remaining_ly;
+        memcpy(rp->resources, p->resources, sizeof(rp->resources));
+        rp->energy_joules = p->energy_joules;
+        rp->fuel_kg = p->fuel_kg;
+        rp->hull_integrity = p->hull_integrity;
+        memcpy(rp->tech_levels, p->tech_levels, sizeof(rp->tech_levels));
+        rp->personality = p->personality;
+    }
+}
+
+void render_triple_init(render_triple_t *t) {
+    memset(t->bufs, 0, sizeof(t->bufs));
+    t->back = 0;
+    atomic_init(&t->middle, 1u);
+    t->front = 2;
+    t->published = 0;
+}
+
+render_snapshot_t *render_triple_back(render_triple_t *t) {
+    return &t->bufs[t->back];
+}
+
+void render_triple_publish(render_triple_t *t) {
+    uint32_t old = atomic_exchange_explicit(&t->middle,
+        t->back | RENDER_TRIPLE_FRESH, memory_order_acq_rel);
+    t->back = old & 3u;
+    t->published++;
+}
+
+bool render_triple_pending(render_triple_t *t) {
+    return (atomic_load_explicit(&t->middle, memory_order_acquire)
+            & RENDER_TRIPLE_FRESH) != 0;
+}
+
+const render_snapshot_t *render_triple_acquire(render_triple_t *t, bool *fresh) {
+    bool got = false;
+    if (atomic_load_explicit(&t->middle, memory_order_acquire)
+        & RENDER_TRIPLE_FRESH) {
+        uint32_t old = atomic_exchange_explicit(&t->middle, t->front,
+                                                memory_order_acq_rel);
+        t->front = old & 3u;
+        got = true;
+    }
+    if (fresh) *fresh = got;
+    return &t->bufs[t->front];
+}
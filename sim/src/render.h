@@ -11,6 +11,9 @@
 #define RENDER_H
 
 #include "universe.h"
+#include "uidmap.h"
+
+#include <stdatomic.h>
 
 /* ---- Color type (Raylib-compatible RGBA) ---- */
 
@@ -85,6 +88,70 @@ probe_uid_t hit_test_system(const system_t *systems, int count,
                       double screen_x, double screen_y,
                       double threshold_px);
 
+/* As hit_test_system, over an array of pointers (e.g. a sector cache's
+ * visible list). */
+probe_uid_t hit_test_system_list(const system_t *const *systems, int count,
+                                 const camera_2d_t *cam,
+                                 double screen_x, double screen_y,
+                                 double threshold_px);
+
+/* ---- Culling and level of detail ---- */
+
+/* How much of each star the galaxy view draws at a given zoom. */
+typedef enum {
+    LOD_DOT = 0,                 /* 1-2 px points */
+    LOD_DISC,                    /* sized discs, visited halo */
+    LOD_LABELLED                 /* discs plus names */
+} lod_t;
+
+#define LOD_DISC_SCALE     0.5   /* px per ly at which stars become discs */
+#define LOD_LABEL_SCALE    3.0   /* px per ly at which names appear */
+#define RENDER_MAX_LABELS  64    /* names drawn per frame, nearest first */
+#define ORBIT_MIN_PX       2.0   /* orbits smaller than this are skipped */
+
+lod_t galaxy_lod(double scale);
+
+/* True if a circle of radius_px around world point (wx, wy) touches a
+ * w x h pixel viewport. */
+bool camera_sees(const camera_2d_t *cam, int w, int h,
+                 double wx, double wy, double radius_px);
+
+/* True if the outline of a circle (screen centre, radius in px) crosses
+ * the viewport: false when it lies entirely outside, or when the viewport
+ * lies entirely inside it. */
+bool ring_visible(double cx, double cy, double radius_px, int w, int h);
+
+/* One filled circle in screen space; the renderer submits a whole array
+ * in a single rlgl batch instead of a DrawCircle call each. */
+typedef struct {
+    float  x, y, r;
+    rgba_t color;
+} sprite_t;
+
+typedef struct {
+    int   system;                /* index into the source list */
+    float x, y, r;               /* screen position and disc radius */
+} sprite_label_t;
+
+/* Culled, LOD-resolved galaxy stars. Zeroed is empty; the sprite array
+ * grows as needed and is reused across frames. */
+typedef struct {
+    sprite_t      *sprites;
+    int            sprite_count;
+    int            sprite_cap;
+    sprite_label_t labels[RENDER_MAX_LABELS];
+    int            label_count;
+    lod_t          lod;
+    int            culled;       /* systems outside the viewport */
+} galaxy_batch_t;
+
+/* Fill b with the stars of systems[0..count) visible on a w x h screen.
+ * Returns 0, or -1 if the sprite array could not grow (b then holds the
+ * stars that fit). */
+int  galaxy_batch_build(galaxy_batch_t *b, const system_t *const *systems,
+                        int count, const camera_2d_t *cam, int w, int h);
+void galaxy_batch_free(galaxy_batch_t *b);
+
 /* ---- Probe trail (path history ring buffer) ---- */
 
 #define TRAIL_MAX_POINTS 1024
@@ -99,9 +166,135 @@ void  probe_trail_init(probe_trail_t *t);
 void  probe_trail_push(probe_trail_t *t, vec3_t point);
 vec3_t probe_trail_get(const probe_trail_t *t, int index);
 
+/* ---- Fleet trails (one shared pool for every probe) ---- */
+
+/*
+ * Every probe's trail lives in a slice of one contiguous pool. Points are
+ * float32 offsets from the trail's anchor sector, so they stay within
+ * ~1e-4 ly anywhere in the galaxy at half the size of a vec3_t. A point
+ * is only kept where the path bends or after TRAIL_STEP_MAX_LY of straight
+ * flight; the newest sample is held as the trail's tip until then.
+ */
+#define TRAIL_STORE_POINTS    256     /* kept points per probe */
+#define TRAIL_STEP_MIN_LY     0.01    /* shorter segments have no heading */
+#define TRAIL_STEP_MAX_LY     2.0     /* spacing on a straight leg */
+#define TRAIL_TURN_COS        0.999   /* keep bends sharper than ~2.5 deg */
+#define TRAIL_REBASE_SECTORS  16      /* re-anchor beyond this many sectors */
+
+typedef struct {
+    float x, y, z;
+} trail_point_t;
+
+typedef struct {
+    probe_uid_t    id;
+    sector_coord_t anchor;       /* points are relative to this sector */
+    trail_point_t  tip;          /* newest sample, drawn after the kept points */
+    uint16_t       head;         /* next write slot */
+    uint16_t       count;        /* kept points */
+    uint64_t       tick;         /* last record */
+    bool           live;
+} trail_ring_t;
+
+/* Zeroed is empty; the pool is allocated on the first record. */
+typedef struct {
+    trail_point_t *pool;         /* MAX_PROBES * TRAIL_STORE_POINTS */
+    trail_ring_t   rings[MAX_PROBES];
+    uidmap_slot_t  index[MAX_PROBES * 2];   /* probe id -> ring */
+    int            ring_count;   /* rings ever used, for iteration */
+
+    /* Counters */
+    uint64_t       samples;      /* positions offered */
+    uint64_t       kept;         /* points written to the pool */
+} trail_store_t;
+
+/* Offer a probe's galactic position at tick. Returns 0, or -1 if the
+ * pool could not be allocated or every ring is taken. */
+int    trail_store_record(trail_store_t *s, probe_uid_t id, vec3_t pos,
+                          uint64_t tick);
+
+/* Drop the trails of probes not recorded at tick (destroyed or gone). */
+void   trail_store_retire(trail_store_t *s, uint64_t tick);
+
+/* Ring index for a probe, or -1. */
+int    trail_store_find(const trail_store_t *s, probe_uid_t id);
+
+/* Points in a ring including the tip (0 if unused), and point i as a
+ * galactic position, oldest first. */
+int    trail_store_length(const trail_store_t *s, int ring);
+vec3_t trail_store_get(const trail_store_t *s, int ring, int index);
+
+/* Heap bytes held by the pool. */
+size_t trail_store_bytes(const trail_store_t *s);
+
+void   trail_store_free(trail_store_t *s);
+
 /* ---- Planet orbital position ---- */
 
 void planet_orbital_pos(const planet_t *p, uint64_t tick,
                         double *out_x, double *out_y);
 
+/* ---- Render snapshot (sim thread -> render thread) ---- */
+
+/* The subset of a probe the views draw. */
+typedef struct {
+    probe_uid_t          id;
+    probe_uid_t          system_id;
+    probe_uid_t          body_id;
+    char                 name[MAX_NAME];
+    uint32_t             generation;
+    sector_coord_t       sector;
+    location_type_t      location_type;
+    probe_status_t       status;
+    vec3_t               heading;
+    double               speed_c;
+    double               travel_remaining_ly;
+    double               resources[RES_COUNT];
+    double               energy_joules;
+    double               fuel_kg;
+    float                hull_integrity;
+    uint8_t              tech_levels[TECH_COUNT];
+    personality_traits_t personality;
+} render_probe_t;
+
+typedef struct {
+    uint64_t       tick;
+    uint32_t       probe_count;
+    render_probe_t probes[MAX_PROBES];
+} render_snapshot_t;
+
+/* Copy what the renderer needs out of the universe at a tick boundary. */
+void render_snapshot_capture(render_snapshot_t *s, const universe_t *u);
+
+/*
+ * Triple buffer: one writer (the sim thread) fills the back buffer and
+ * publishes it; one reader (the render thread) picks up the newest
+ * published buffer. Neither side ever waits for the other. The shared
+ * middle index carries RENDER_TRIPLE_FRESH while a published buffer has
+ * not been picked up yet.
+ */
+#define RENDER_TRIPLE_FRESH 4u
+
+typedef struct {
+    render_snapshot_t bufs[3];
+    _Atomic uint32_t  middle;
+    uint32_t          back;          /* writer-owned */
+    uint32_t          front;         /* reader-owned */
+    uint64_t          published;     /* writer-side counter */
+} render_triple_t;
+
+void render_triple_init(render_triple_t *t);
+
+/* Writer: the buffer to fill next, then swap it in for the reader. */
+render_snapshot_t *render_triple_back(render_triple_t *t);
+void               render_triple_publish(render_triple_t *t);
+
+/* Writer: true while the last publish is still unread, i.e. building
+ * another snapshot now would be wasted work. */
+bool               render_triple_pending(render_triple_t *t);
+
+/* Reader: the newest published snapshot. *fresh (if non-NULL) is set when
+ * it differs from the one returned by the previous call. The pointer
+ * stays valid until the next acquire. */
+const render_snapshot_t *render_triple_acquire(render_triple_t *t, bool *fresh);
+
 #endif
@@ -2,7 +2,7 @@
  * render_raylib.c — Raylib visualization for Project UNIVERSE
  *
  * Three views:
- *   1. Galaxy map — 2D starfield, sectors, probe marker + trail
+ *   1. Galaxy map — 2D starfield, sectors, fleet + trails
  *   2. System view — star at center, orbital ellipses, planets, probe
  *   3. Probe dashboard — status bars, personality radar, resource levels
  *
@@ -28,6 +28,7 @@
 #include "generate.h"
 #include "util.h"
 #include "raylib.h"
+#include "rlgl.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -54,7 +55,10 @@ void renderer_init(renderer_t *r, int width, int height, uint64_t galaxy_seed) {
 
     view_state_init(&r->view);
     sim_speed_init(&r->speed);
-    probe_trail_init(&r->trail);
+    sector_cache_init(&r->sectors, galaxy_seed, true);
+    if (atlas_open(&r->atlas, galaxy_seed, atlas_default_region(),
+                   atlas_default_dir(), ATLAS_MAX_THREADS) != 0)
+        LOG_WARN("renderer: no density atlas; galaxy-scale view disabled");
 
     /* Galaxy camera: centered on screen, 1 px = 2 ly */
     r->galaxy_cam.offset_x = width / 2.0;
@@ -72,32 +76,36 @@ void renderer_init(renderer_t *r, int width, int height, uint64_t galaxy_seed) {
 }
 
 void renderer_close(renderer_t *r) {
-    (void)r;
+    sector_cache_free(&r->sectors);
+    atlas_free(&r->atlas);
+    galaxy_batch_free(&r->stars);
+    trail_store_free(&r->trails);
     CloseWindow();
 }
 
 /* ---- Load nearby systems ---- */
 
 void renderer_load_nearby(renderer_t *r, const probe_t *probe) {
-    r->visible_system_count = 0;
-    sector_coord_t base = probe->sector;
-
-    /* Load 3x3x1 sector neighborhood */
-    for (int dx = -1; dx <= 1; dx++) {
-        for (int dy = -1; dy <= 1; dy++) {
-            sector_coord_t sc = {base.x + dx, base.y + dy, base.z};
-            system_t buf[30];
-            int n = generate_sector(buf, 30, r->galaxy_seed, sc);
-            for (int i = 0; i < n && r->visible_system_count < 256; i++) {
-                r->visible_systems[r->visible_system_count++] = buf[i];
-            }
-        }
-    }
+    sector_cache_update(&r->sectors, probe->sector,
+        sector_view_radius(r->galaxy_cam.scale, r->screen_w, r->screen_h));
+}
+
+/* Keep the sector window centred on what the galaxy camera is looking at,
+ * in Bob's slice of the disc. Only sectors entering the window are
+ * generated, off-thread. */
+static void update_sectors(renderer_t *r, const render_snapshot_t *snap) {
+    double cx, cy;
+    screen_to_world(&r->galaxy_cam, r->screen_w / 2.0, r->screen_h / 2.0,
+                    &cx, &cy);
+    sector_coord_t center = sector_of_position(cx, cy, 0.0);
+    center.z = snap->probe_count > 0 ? snap->probes[0].sector.z : 0;
+    sector_cache_update(&r->sectors, center,
+        sector_view_radius(r->galaxy_cam.scale, r->screen_w, r->screen_h));
 }
 
 /* ---- Input handling ---- */
 
-bool renderer_update(renderer_t *r, universe_t *u) {
+bool renderer_update(renderer_t *r, const render_snapshot_t *snap) {
     if (WindowShouldClose()) return false;
 
     /* Handle resize */
@@ -119,14 +127,14 @@ bool renderer_update(renderer_t *r, universe_t *u) {
 
     if (IsKeyPressed(KEY_TAB)) {
         /* Cycle views */
-        if (r->view.current_view == VIEW_GALAXY && u->probe_count > 0) {
-            view_state_select_probe(&r->view, u->probes[0].id);
+        if (r->view.current_view == VIEW_GALAXY && snap->probe_count > 0) {
+            view_state_select_probe(&r->view, snap->probes[0].id);
         } else if (r->view.current_view == VIEW_PROBE) {
             view_state_back(&r->view);
             if (r->view.current_view == VIEW_GALAXY) {
                 /* Try to go to system view */
-                if (u->probe_count > 0) {
-                    view_state_select_system(&r->view, u->probes[0].system_id);
+                if (snap->probe_count > 0) {
+                    view_state_select_system(&r->view, snap->probes[0].system_id);
                 }
             }
         } else {
@@ -159,13 +167,15 @@ bool renderer_update(renderer_t *r, universe_t *u) {
         cam->offset_y += delta.y;
     }
 
+    update_sectors(r, snap);
+
     /* Left click to select */
     if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
         Vector2 mouse = GetMousePosition();
 
         if (r->view.current_view == VIEW_GALAXY) {
-            probe_uid_t hit = hit_test_system(r->visible_systems,
-                r->visible_system_count, &r->galaxy_cam,
+            probe_uid_t hit = hit_test_system_list(r->sectors.visible,
+                r->sectors.visible_count, &r->galaxy_cam,
                 mouse.x, mouse.y, 15.0);
             if (!uid_is_null(hit)) {
                 view_state_select_system(&r->view, hit);
@@ -173,13 +183,13 @@ bool renderer_update(renderer_t *r, universe_t *u) {
         } else if (r->view.current_view == VIEW_SYSTEM) {
             /* Check planet clicks */
             r->hovered_planet = -1;
-            for (int i = 0; i < 256; i++) {
-                if (!uid_eq(r->visible_systems[i].id, r->view.selected_system))
+            for (int i = 0; i < r->sectors.visible_count; i++) {
+                const system_t *sys = r->sectors.visible[i];
+                if (!uid_eq(sys->id, r->view.selected_system))
                     continue;
-                system_t *sys = &r->visible_systems[i];
                 for (int p = 0; p < sys->planet_count; p++) {
                     double px, py;
-                    planet_orbital_pos(&sys->planets[p], u->tick, &px, &py);
+                    planet_orbital_pos(&sys->planets[p], snap->tick, &px, &py);
                     double sx, sy;
                     world_to_screen(&r->system_cam, px, py, &sx, &sy);
                     double dx = sx - mouse.x;
@@ -199,9 +209,14 @@ bool renderer_update(renderer_t *r, universe_t *u) {
         view_state_back(&r->view);
     }
 
-    /* Update probe trail */
-    if (u->probe_count > 0) {
-        probe_trail_push(&r->trail, u->probes[0].heading);
+    /* Offer every probe's position once per simulated tick we get to
+     * see; the store keeps only the points that shape each path */
+    if (snap->probe_count > 0 && snap->tick != r->trail_tick) {
+        for (uint32_t i = 0; i < snap->probe_count; i++)
+            trail_store_record(&r->trails, snap->probes[i].id,
+                               snap->probes[i].heading, snap->tick);
+        trail_store_retire(&r->trails, snap->tick);
+        r->trail_tick = snap->tick;
     }
 
     return true;
@@ -209,76 +224,185 @@ bool renderer_update(renderer_t *r, universe_t *u) {
 
 /* ---- Drawing: Galaxy View ---- */
 
-static void draw_galaxy(renderer_t *r, const universe_t *u) {
-    camera_2d_t *cam = &r->galaxy_cam;
+/* Filled circles as triangles in the current rlgl batch: a quad for
+ * dots, an octagon for discs. One rlBegin for the whole array instead of
+ * a DrawCircle (36 segments, its own rlBegin) per star. */
+#define SPRITE_SEGMENTS 8
+
+static void draw_sprites(const sprite_t *sprites, int count) {
+    static float ring[SPRITE_SEGMENTS + 1][2];
+    if (ring[0][0] == 0.0f) {
+        for (int k = 0; k <= SPRITE_SEGMENTS; k++) {
+            double a = 2.0 * PI * k / SPRITE_SEGMENTS;
+            ring[k][0] = (float)cos(a);
+            ring[k][1] = (float)sin(a);
+        }
+    }
 
-    /* Draw grid lines */
-    double sector_size = 100.0; /* ly per sector */
-    double wx0, wy0, wx1, wy1;
-    screen_to_world(cam, 0, 0, &wx0, &wy0);
-    screen_to_world(cam, r->screen_w, r->screen_h, &wx1, &wy1);
+    rlBegin(RL_TRIANGLES);
+    for (int i = 0; i < count; i++) {
+        const sprite_t *sp = &sprites[i];
+        rlColor4ub(sp->color.r, sp->color.g, sp->color.b, sp->color.a);
+        if (sp->r <= 1.5f) {
+            float x0 = sp->x - sp->r, y0 = sp->y - sp->r;
+            float x1 = sp->x + sp->r, y1 = sp->y + sp->r;
+            rlCheckRenderBatchLimit(6);
+            rlVertex2f(x0, y0); rlVertex2f(x0, y1); rlVertex2f(x1, y0);
+            rlVertex2f(x1, y0); rlVertex2f(x0, y1); rlVertex2f(x1, y1);
+            continue;
+        }
+        rlCheckRenderBatchLimit(3 * SPRITE_SEGMENTS);
+        for (int k = 0; k < SPRITE_SEGMENTS; k++) {
+            rlVertex2f(sp->x, sp->y);
+            rlVertex2f(sp->x + ring[k + 1][0] * sp->r, sp->y + ring[k + 1][1] * sp->r);
+            rlVertex2f(sp->x + ring[k][0] * sp->r, sp->y + ring[k][1] * sp->r);
+        }
+    }
+    rlEnd();
+}
 
-    double grid_start_x = floor(wx0 / sector_size) * sector_size;
-    double grid_start_y = floor(wy0 / sector_size) * sector_size;
+#define DENSITY_CELL_PX 8.0   /* target on-screen size of an atlas cell */
 
-    for (double gx = grid_start_x; gx <= wx1; gx += sector_size) {
-        double sx, sy1, sy2;
-        world_to_screen(cam, gx, wy0, &sx, &sy1);
-        world_to_screen(cam, gx, wy1, &sx, &sy2);
-        DrawLine((int)sx, (int)sy1, (int)sx, (int)sy2,
-                 (Color){40, 40, 60, 255});
-    }
-    for (double gy = grid_start_y; gy <= wy1; gy += sector_size) {
-        double sx1, sx2, sy;
-        world_to_screen(cam, wx0, gy, &sx1, &sy);
-        world_to_screen(cam, wx1, gy, &sx2, &sy);
-        DrawLine((int)sx1, (int)sy, (int)sx2, (int)sy,
-                 (Color){40, 40, 60, 255});
+/* Star density from the atlas, for views wider than the sector window.
+ * One rectangle per visible cell at the level that makes cells a few
+ * pixels across, so the whole galaxy costs the same as a small region. */
+static void draw_density(renderer_t *r, double wx0, double wy0,
+                         double wx1, double wy1) {
+    const atlas_t *a = &r->atlas;
+    camera_2d_t *cam = &r->galaxy_cam;
+    int level = atlas_level_for(a, DENSITY_CELL_PX / (SECTOR_SIZE_LY * cam->scale));
+    const atlas_level_t *lv = &a->level[level];
+    if (lv->max == 0) return;
+    double cell_ly = SECTOR_SIZE_LY * (double)(1 << level);
+    double log_max = log1p((double)lv->max);
+
+    int cx0 = (int)floor((wx0 / SECTOR_SIZE_LY - a->region.x0) / (1 << level));
+    int cy0 = (int)floor((wy0 / SECTOR_SIZE_LY - a->region.y0) / (1 << level));
+    int cx1 = (int)floor((wx1 / SECTOR_SIZE_LY - a->region.x0) / (1 << level));
+    int cy1 = (int)floor((wy1 / SECTOR_SIZE_LY - a->region.y0) / (1 << level));
+    cx0 = MAX(cx0, 0);
+    cy0 = MAX(cy0, 0);
+    cx1 = MIN(cx1, lv->w - 1);
+    cy1 = MIN(cy1, lv->h - 1);
+
+    for (int cy = cy0; cy <= cy1; cy++) {
+        for (int cx = cx0; cx <= cx1; cx++) {
+            uint32_t n = lv->cells[(size_t)cy * (size_t)lv->w + (size_t)cx];
+            if (n == 0) continue;
+            double t = log1p((double)n) / log_max;
+            double sx, sy;
+            world_to_screen(cam, a->region.x0 * SECTOR_SIZE_LY + cx * cell_ly,
+                            a->region.y0 * SECTOR_SIZE_LY + cy * cell_ly,
+                            &sx, &sy);
+            int px = (int)ceil(cell_ly * cam->scale);
+            DrawRectangle((int)sx, (int)sy, px, px,
+                          (Color){(unsigned char)(120 + 135 * t),
+                                  (unsigned char)(110 + 110 * t),
+                                  (unsigned char)(160 + 60 * t),
+                                  (unsigned char)(200 * t)});
+        }
     }
+}
 
-    /* Draw stars */
-    for (int i = 0; i < r->visible_system_count; i++) {
-        system_t *sys = &r->visible_systems[i];
-        double sx, sy;
-        world_to_screen(cam, sys->position.x, sys->position.y, &sx, &sy);
+/* Every trail's visible segments in one line batch, fading toward the
+ * oldest point. The highlighted probe's trail is drawn brighter. */
+static void draw_trails(renderer_t *r, probe_uid_t highlight) {
+    const camera_2d_t *cam = &r->galaxy_cam;
+    const trail_store_t *ts = &r->trails;
+    rlBegin(RL_LINES);
+    for (int t = 0; t < ts->ring_count; t++) {
+        int len = trail_store_length(ts, t);
+        if (len < 2) continue;
+        bool hl = uid_eq(ts->rings[t].id, highlight);
+        vec3_t p0 = trail_store_get(ts, t, 0);
+        double sx0, sy0;
+        world_to_screen(cam, p0.x, p0.y, &sx0, &sy0);
+        for (int i = 1; i < len; i++) {
+            vec3_t p1 = trail_store_get(ts, t, i);
+            double sx1, sy1;
+            world_to_screen(cam, p1.x, p1.y, &sx1, &sy1);
+            bool off = (sx0 < 0 && sx1 < 0) || (sy0 < 0 && sy1 < 0) ||
+                       (sx0 > r->screen_w && sx1 > r->screen_w) ||
+                       (sy0 > r->screen_h && sy1 > r->screen_h);
+            if (!off) {
+                unsigned char alpha = hl
+                    ? (unsigned char)(80 + 175 * i / len)
+                    : (unsigned char)(30 + 90 * i / len);
+                rlCheckRenderBatchLimit(2);
+                rlColor4ub(100, 200, 255, alpha);
+                rlVertex2f((float)sx0, (float)sy0);
+                rlVertex2f((float)sx1, (float)sy1);
+            }
+            sx0 = sx1;
+            sy0 = sy1;
+        }
+    }
+    rlEnd();
+}
 
-        rgba_t col = star_class_color(sys->stars[0].class);
-        Color c = rgba_to_color(col);
-        int radius = 3;
+static void draw_galaxy(renderer_t *r, const render_snapshot_t *snap) {
+    camera_2d_t *cam = &r->galaxy_cam;
 
-        /* Larger dots for brighter stars */
-        if (sys->stars[0].class <= STAR_A) radius = 5;
-        else if (sys->stars[0].class <= STAR_F) radius = 4;
+    double sector_size = SECTOR_SIZE_LY;
+    double wx0, wy0, wx1, wy1;
+    screen_to_world(cam, 0, 0, &wx0, &wy0);
+    screen_to_world(cam, r->screen_w, r->screen_h, &wx1, &wy1);
 
-        /* Visited systems are brighter */
-        if (sys->visited) {
-            DrawCircle((int)sx, (int)sy, radius + 1, color_alpha(c, 60));
+    /* Zoomed out past the sector window: show the density atlas */
+    double half_sectors = MAX(wx1 - wx0, wy1 - wy0) / 2.0 / sector_size;
+    if (r->atlas.data && half_sectors > SECTOR_VIEW_MAX_RADIUS)
+        draw_density(r, wx0, wy0, wx1, wy1);
+
+    /* Draw grid lines, unless they would be denser than the pixels */
+    if (sector_size * cam->scale >= 4.0) {
+        double grid_start_x = floor(wx0 / sector_size) * sector_size;
+        double grid_start_y = floor(wy0 / sector_size) * sector_size;
+
+        for (double gx = grid_start_x; gx <= wx1; gx += sector_size) {
+            double sx, sy1, sy2;
+            world_to_screen(cam, gx, wy0, &sx, &sy1);
+            world_to_screen(cam, gx, wy1, &sx, &sy2);
+            DrawLine((int)sx, (int)sy1, (int)sx, (int)sy2,
+                     (Color){40, 40, 60, 255});
         }
-
-        DrawCircle((int)sx, (int)sy, radius, c);
-
-        /* Label if zoomed in enough */
-        if (cam->scale > 3.0) {
-            DrawText(sys->name, (int)sx + radius + 3, (int)sy - 5, 10,
-                     color_alpha(RAYWHITE, 150));
+        for (double gy = grid_start_y; gy <= wy1; gy += sector_size) {
+            double sx1, sx2, sy;
+            world_to_screen(cam, wx0, gy, &sx1, &sy);
+            world_to_screen(cam, wx1, gy, &sx2, &sy);
+            DrawLine((int)sx1, (int)sy, (int)sx2, (int)sy,
+                     (Color){40, 40, 60, 255});
         }
     }
 
-    /* Draw probe marker + trail */
-    if (u->probe_count > 0) {
-        const probe_t *bob = &u->probes[0];
+    /* Draw stars: culled and LOD-resolved, then one batch for all */
+    galaxy_batch_build(&r->stars, r->sectors.visible, r->sectors.visible_count,
+                       cam, r->screen_w, r->screen_h);
+    draw_sprites(r->stars.sprites, r->stars.sprite_count);
+    for (int i = 0; i < r->stars.label_count; i++) {
+        const sprite_label_t *l = &r->stars.labels[i];
+        DrawText(r->sectors.visible[l->system]->name,
+                 (int)(l->x + l->r) + 3, (int)l->y - 5, 10,
+                 color_alpha(RAYWHITE, 150));
+    }
 
-        /* Trail */
-        for (int i = 1; i < r->trail.count; i++) {
-            vec3_t p0 = probe_trail_get(&r->trail, i - 1);
-            vec3_t p1 = probe_trail_get(&r->trail, i);
-            double sx0, sy0, sx1, sy1;
-            world_to_screen(cam, p0.x, p0.y, &sx0, &sy0);
-            world_to_screen(cam, p1.x, p1.y, &sx1, &sy1);
-            unsigned char alpha = (unsigned char)(80 + 175 * i / r->trail.count);
-            DrawLine((int)sx0, (int)sy0, (int)sx1, (int)sy1,
-                     (Color){100, 200, 255, alpha});
+    /* Fleet trails, then the other probes, then Bob on top */
+    if (snap->probe_count > 0) {
+        const render_probe_t *bob = &snap->probes[0];
+        draw_trails(r, bob->id);
+
+        static sprite_t fleet[MAX_PROBES];
+        int n = 0;
+        for (uint32_t i = 1; i < snap->probe_count; i++) {
+            const render_probe_t *p = &snap->probes[i];
+            if (!camera_sees(cam, r->screen_w, r->screen_h,
+                             p->heading.x, p->heading.y, 3.0))
+                continue;
+            double px, py;
+            world_to_screen(cam, p->heading.x, p->heading.y, &px, &py);
+            fleet[n++] = (sprite_t){(float)px, (float)py, 3.0f,
+                                    (rgba_t){100, 180, 255, 230}};
         }
+        draw_sprites(fleet, n);
 
         /* Probe dot */
         double px, py;
@@ -291,17 +415,17 @@ static void draw_galaxy(renderer_t *r, const universe_t *u) {
 
 /* ---- Drawing: System View ---- */
 
-static system_t *find_selected_system(renderer_t *r) {
-    for (int i = 0; i < r->visible_system_count; i++) {
-        if (uid_eq(r->visible_systems[i].id, r->view.selected_system))
-            return &r->visible_systems[i];
+static const system_t *find_selected_system(renderer_t *r) {
+    for (int i = 0; i < r->sectors.visible_count; i++) {
+        if (uid_eq(r->sectors.visible[i]->id, r->view.selected_system))
+            return r->sectors.visible[i];
     }
     return NULL;
 }
 
-static void draw_system(renderer_t *r, const universe_t *u) {
+static void draw_system(renderer_t *r, const render_snapshot_t *snap) {
     camera_2d_t *cam = &r->system_cam;
-    system_t *sys = find_selected_system(r);
+    const system_t *sys = find_selected_system(r);
     if (!sys) {
         DrawText("System not loaded", 20, 40, 20, RED);
         return;
@@ -330,22 +454,26 @@ static void draw_system(renderer_t *r, const universe_t *u) {
 
     /* Draw planets and orbits */
     for (int i = 0; i < sys->planet_count; i++) {
-        planet_t *pl = &sys->planets[i];
+        const planet_t *pl = &sys->planets[i];
 
-        /* Orbital ring */
+        /* Orbital ring, unless it is sub-pixel or misses the screen */
         double orbit_px = pl->orbital_radius_au * cam->scale;
-        DrawCircleLines((int)cx, (int)cy, (int)orbit_px,
-                        (Color){50, 50, 70, 255});
+        if (orbit_px >= ORBIT_MIN_PX &&
+            ring_visible(cx, cy, orbit_px, r->screen_w, r->screen_h))
+            DrawCircleLines((int)cx, (int)cy, (int)orbit_px,
+                            (Color){50, 50, 70, 255});
 
         /* Planet position */
         double px, py;
-        planet_orbital_pos(pl, u->tick, &px, &py);
-        double spx, spy;
-        world_to_screen(cam, px, py, &spx, &spy);
+        planet_orbital_pos(pl, snap->tick, &px, &py);
 
         /* Planet dot — size by mass */
         int pr = 3 + (int)(pl->mass_earth * 0.5);
         if (pr > 12) pr = 12;
+        if (!camera_sees(cam, r->screen_w, r->screen_h, px, py, pr + 3))
+            continue;
+        double spx, spy;
+        world_to_screen(cam, px, py, &spx, &spy);
 
         /* Color by type */
         Color planet_col;
@@ -375,7 +503,7 @@ static void draw_system(renderer_t *r, const universe_t *u) {
 
     /* Selected planet info panel */
     if (r->hovered_planet >= 0 && r->hovered_planet < sys->planet_count) {
-        planet_t *pl = &sys->planets[r->hovered_planet];
+        const planet_t *pl = &sys->planets[r->hovered_planet];
         int panel_x = r->screen_w - 260;
         int panel_y = 60;
 
@@ -414,15 +542,15 @@ static void draw_system(renderer_t *r, const universe_t *u) {
     }
 
     /* Draw probe in system */
-    if (u->probe_count > 0) {
-        const probe_t *bob = &u->probes[0];
+    if (snap->probe_count > 0) {
+        const render_probe_t *bob = &snap->probes[0];
         if (uid_eq(bob->system_id, r->view.selected_system)) {
             double bx = 0, by = 0;
             /* If orbiting or landed on a body, draw near that body */
             if (bob->location_type == LOC_ORBITING || bob->location_type == LOC_LANDED) {
                 for (int i = 0; i < sys->planet_count; i++) {
                     if (uid_eq(sys->planets[i].id, bob->body_id)) {
-                        planet_orbital_pos(&sys->planets[i], u->tick, &bx, &by);
+                        planet_orbital_pos(&sys->planets[i], snap->tick, &bx, &by);
                         if (bob->location_type == LOC_ORBITING) {
                             bx += 0.05; /* slight offset */
                         }
@@ -455,13 +583,13 @@ static void draw_bar(int x, int y, int w, int h, double value, double max,
     DrawText(buf, x + 4, y + 2, h - 4, RAYWHITE);
 }
 
-static void draw_probe_dashboard(renderer_t *r __attribute__((unused)), const universe_t *u) {
-    if (u->probe_count == 0) {
+static void draw_probe_dashboard(renderer_t *r __attribute__((unused)), const render_snapshot_t *snap) {
+    if (snap->probe_count == 0) {
         DrawText("No probes active", 20, 40, 20, RED);
         return;
     }
 
-    const probe_t *bob = &u->probes[0];
+    const render_probe_t *bob = &snap->probes[0];
     int x = 30, y = 60;
     int bar_w = 300, bar_h = 20;
 
@@ -568,15 +696,15 @@ static void draw_probe_dashboard(renderer_t *r __attribute__((unused)), const un
 
 /* ---- Drawing: HUD (always visible) ---- */
 
-static void draw_hud(renderer_t *r, const universe_t *u) {
+static void draw_hud(renderer_t *r, const render_snapshot_t *snap) {
     /* Top bar */
     DrawRectangle(0, 0, r->screen_w, 32, (Color){15, 15, 25, 230});
 
     char tick_str[128];
-    double years = (double)u->tick / TICKS_PER_CYCLE;
+    double years = (double)snap->tick / TICKS_PER_CYCLE;
     snprintf(tick_str, sizeof(tick_str),
              "Tick: %llu  (%.1f years)   Speed: %s%s   [%s]",
-             (unsigned long long)u->tick, years,
+             (unsigned long long)snap->tick, years,
              r->speed.paused ? "PAUSED " : "",
              sim_speed_label(&r->speed),
              r->view.current_view == VIEW_GALAXY ? "Galaxy" :
@@ -619,18 +747,18 @@ static void draw_hud(renderer_t *r, const universe_t *u) {
 
 /* ---- Main draw dispatch ---- */
 
-void renderer_draw(renderer_t *r, const universe_t *u) {
+void renderer_draw(renderer_t *r, const render_snapshot_t *snap) {
     BeginDrawing();
     ClearBackground((Color){8, 8, 16, 255});
 
     switch (r->view.current_view) {
-        case VIEW_GALAXY: draw_galaxy(r, u); break;
-        case VIEW_SYSTEM: draw_system(r, u); break;
-        case VIEW_PROBE:  draw_probe_dashboard(r, u); break;
+        case VIEW_GALAXY: draw_galaxy(r, snap); break;
+        case VIEW_SYSTEM: draw_system(r, snap); break;
+        case VIEW_PROBE:  draw_probe_dashboard(r, snap); break;
         default: break;
     }
 
-    draw_hud(r, u);
+    draw_hud(r, snap);
     EndDrawing();
 }
 
@@ -10,6 +10,8 @@
 #include "universe.h"
 #include "render.h"
 #include "generate.h"
+#include "sector_cache.h"
+#include "atlas.h"
 
 /* ---- Renderer state ---- */
 
@@ -20,13 +22,15 @@ typedef struct {
     camera_2d_t     galaxy_cam;
     camera_2d_t     system_cam;
 
-    /* Cached sector data */
-    system_t        visible_systems[256];
-    int             visible_system_count;
+    /* Cached sector data, generated in the background as the view moves */
+    sector_cache_t  sectors;
     uint64_t        galaxy_seed;
+    atlas_t         atlas;           /* star density for zoomed-out views */
+    galaxy_batch_t  stars;           /* per-frame culled star sprites */
 
-    /* Probe trail */
-    probe_trail_t   trail;
+    /* Trails for the whole fleet */
+    trail_store_t   trails;
+    uint64_t        trail_tick;      /* snapshot tick of the last points */
 
     /* Window state */
     int             screen_w;
@@ -43,13 +47,16 @@ void renderer_init(renderer_t *r, int width, int height, uint64_t galaxy_seed);
 /* Shut down window */
 void renderer_close(renderer_t *r);
 
-/* Process input, advance view state. Returns false if window should close. */
-bool renderer_update(renderer_t *r, universe_t *u);
+/* Process input, advance view state. Returns false if window should close.
+ * Both take the latest render snapshot rather than the live universe, which
+ * belongs to the sim thread. */
+bool renderer_update(renderer_t *r, const render_snapshot_t *snap);
 
 /* Draw one frame based on current view */
-void renderer_draw(renderer_t *r, const universe_t *u);
+void renderer_draw(renderer_t *r, const render_snapshot_t *snap);
 
-/* Load systems for the visible area around probe */
+/* Move the sector window to the probe (e.g. at startup or after a jump).
+ * Sectors are then kept current by renderer_update as the camera moves. */
 void renderer_load_nearby(renderer_t *r, const probe_t *probe);
 
 #endif
@@ -12,10 +12,14 @@
 
 #include "replicate.h"
 #include "personality.h"
+#include "heritage.h"
+#include "strtab.h"
 #include "generate.h"
 #include <string.h>
+#include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#include <pthread.h>
 
 /* ---- Resource costs per type ---- */
 
@@ -128,23 +132,26 @@ void earth_memory_degrade(probe_t *child) {
     if (child->earth_memory_fidelity < 0.01f)
         child->earth_memory_fidelity = 0.01f;
 
-    /* At low fidelity, truncate memory strings */
-    for (int i = 0; i < child->earth_memory_count; i++) {
-        float fid = child->earth_memory_fidelity;
-        if (fid < 0.5f) {
-            /* Truncate to fraction of original length */
-            size_t len = strlen(child->earth_memories[i]);
-            size_t keep = (size_t)(len * fid * 2.0f);
-            if (keep < 10) keep = 10;
-            if (keep < len) {
-                child->earth_memories[i][keep] = '\0';
-                /* Add ellipsis if room */
-                if (keep >= 3) {
-                    child->earth_memories[i][keep - 1] = '.';
-                    child->earth_memories[i][keep - 2] = '.';
-                    child->earth_memories[i][keep - 3] = '.';
-                }
+    /* At low fidelity, truncate memory strings. Lines that survive intact
+     * stay shared with the parent; only a changed list gets its own block. */
+    float fid = child->earth_memory_fidelity;
+    if (fid >= 0.5f) return;
+    for (int i = 0; i < heritage_count(child->earth_memories); i++) {
+        /* Truncate to fraction of original length */
+        const char *line = heritage_line(child->earth_memories, i);
+        size_t len = strlen(line);
+        size_t keep = (size_t)(len * fid * 2.0f);
+        if (keep < 10) keep = 10;
+        if (keep < len) {
+            char buf[MAX_EARTH_MEM_LEN];
+            snprintf(buf, sizeof(buf), "%.*s", (int)keep, line);
+            /* Add ellipsis if room */
+            if (keep >= 3) {
+                buf[keep - 1] = '.';
+                buf[keep - 2] = '.';
+                buf[keep - 3] = '.';
             }
+            heritage_set_line(&child->earth_memories, i, buf);
         }
     }
 }
@@ -171,38 +178,81 @@ static const char *QUIRK_MUTATIONS[] = {
 };
 #define QUIRK_MUTATION_COUNT 4
 
-void quirk_inherit(const probe_t *parent, probe_t *child, rng_t *rng) {
-    child->quirk_count = 0;
+/* Quirk inheritance is split in two so the random draws can happen on a
+ * worker thread while interning and heritage edits stay on the caller's. */
+static void quirk_plan(const probe_t *parent, quirk_plan_t *plan, rng_t *rng) {
+    memset(plan, 0, sizeof(*plan));
+    plan->same = true;
 
-    for (int i = 0; i < parent->quirk_count; i++) {
+    int parent_count = heritage_count(parent->quirks);
+    for (int i = 0; i < parent_count; i++) {
         double roll = (double)(rng_next(rng) % 1000) / 1000.0;
 
         if (roll < 0.70) {
             /* Keep as-is */
-            if (child->quirk_count < MAX_QUIRKS) {
-                snprintf(child->quirks[child->quirk_count], MAX_QUIRK_LEN,
-                         "%s", parent->quirks[i]);
-                child->quirk_count++;
+            if (plan->count < MAX_QUIRKS) {
+                plan->op[plan->count] = QUIRK_KEEP;
+                plan->arg[plan->count++] = (uint8_t)i;
             }
         } else if (roll < 0.80) {
             /* Mutate: append a modifier */
-            if (child->quirk_count < MAX_QUIRKS) {
-                int mi = (int)(rng_next(rng) % QUIRK_MUTATION_COUNT);
-                snprintf(child->quirks[child->quirk_count], MAX_QUIRK_LEN,
-                         "%s %s", parent->quirks[i], QUIRK_MUTATIONS[mi]);
-                child->quirk_count++;
+            if (plan->count < MAX_QUIRKS) {
+                plan->op[plan->count] = QUIRK_MUTATE;
+                plan->arg[plan->count] = (uint8_t)i;
+                plan->mod[plan->count++] =
+                    (uint8_t)(rng_next(rng) % QUIRK_MUTATION_COUNT);
             }
+            plan->same = false;
+        } else {
+            /* 20% drop */
+            plan->same = false;
         }
-        /* else: 20% drop — do nothing */
     }
 
     /* Small chance of a new quirk emerging */
-    if ((rng_next(rng) % 100) < 15 && child->quirk_count < MAX_QUIRKS) {
-        int qi = (int)(rng_next(rng) % POTENTIAL_QUIRK_COUNT);
-        snprintf(child->quirks[child->quirk_count], MAX_QUIRK_LEN,
-                 "%s", POTENTIAL_QUIRKS[qi]);
-        child->quirk_count++;
+    if ((rng_next(rng) % 100) < 15 && plan->count < MAX_QUIRKS) {
+        plan->op[plan->count] = QUIRK_NEW;
+        plan->arg[plan->count++] = (uint8_t)(rng_next(rng) % POTENTIAL_QUIRK_COUNT);
+        plan->same = false;
+    }
+    if (plan->count != parent_count) plan->same = false;
+}
+
+static void quirk_apply(const probe_t *parent, probe_t *child,
+                        const quirk_plan_t *plan) {
+    heritage_release(child->quirks);
+    if (plan->same) {
+        heritage_retain(parent->quirks);
+        child->quirks = parent->quirks;
+        return;
+    }
+
+    str_id_t ids[MAX_QUIRKS];
+    for (int i = 0; i < plan->count; i++) {
+        switch (plan->op[i]) {
+        case QUIRK_KEEP:
+            ids[i] = heritage_line_id(parent->quirks, plan->arg[i]);
+            break;
+        case QUIRK_MUTATE: {
+            char buf[MAX_QUIRK_LEN];
+            snprintf(buf, sizeof(buf), "%s %s",
+                     heritage_line(parent->quirks, plan->arg[i]),
+                     QUIRK_MUTATIONS[plan->mod[i]]);
+            ids[i] = strtab_intern(buf);
+            break;
+        }
+        default:
+            ids[i] = strtab_intern(POTENTIAL_QUIRKS[plan->arg[i]]);
+            break;
+        }
     }
+    child->quirks = heritage_from_ids(ids, plan->count);
+}
+
+void quirk_inherit(const probe_t *parent, probe_t *child, rng_t *rng) {
+    quirk_plan_t plan;
+    quirk_plan(parent, &plan, rng);
+    quirk_apply(parent, child, &plan);
 }
 
 /* ---- Child naming ---- */
@@ -238,10 +288,12 @@ void name_generate_child(char *name, size_t len,
 
 /* ---- Finalize ---- */
 
-int repl_finalize(probe_t *parent, probe_t *child,
-                  replication_state_t *state, rng_t *rng) {
-    if (!state->active || state->progress < 1.0 - 0.001) return -1;
-
+/* Everything in finalize that only reads shared state: safe to run for
+ * distinct parent/child pairs concurrently. Heritage is left to
+ * child_inherit_heritage(). */
+static void child_generate(probe_t *parent, probe_t *child,
+                           replication_state_t *state, rng_t *rng,
+                           quirk_plan_t *plan) {
     memset(child, 0, sizeof(*child));
 
     /* Identity */
@@ -274,63 +326,279 @@ int repl_finalize(probe_t *parent, probe_t *child,
     /* Personality mutation */
     personality_mutate(&parent->personality, &child->personality, rng);
 
-    /* Earth memories: copy then degrade */
-    child->earth_memory_count = parent->earth_memory_count;
+    /* Quirk draws; applied with the rest of the heritage */
+    quirk_plan(parent, plan, rng);
+
+    /* Status */
+    child->status = STATUS_ACTIVE;
+
+    /* Parent back to active */
+    parent->status = STATUS_ACTIVE;
+    state->active = false;
+}
+
+static void child_inherit_heritage(const probe_t *parent, probe_t *child,
+                                   const quirk_plan_t *plan) {
+    /* Earth memories: share the parent's block, then degrade */
+    heritage_retain(parent->earth_memories);
+    child->earth_memories = parent->earth_memories;
     child->earth_memory_fidelity = parent->earth_memory_fidelity;
-    for (int i = 0; i < parent->earth_memory_count; i++) {
-        snprintf(child->earth_memories[i], MAX_EARTH_MEM_LEN,
-                 "%s", parent->earth_memories[i]);
-    }
     earth_memory_degrade(child);
 
     /* Quirk inheritance */
-    quirk_inherit(parent, child, rng);
+    quirk_apply(parent, child, plan);
 
-    /* Catchphrases: inherit all */
-    child->catchphrase_count = parent->catchphrase_count;
-    for (int i = 0; i < parent->catchphrase_count; i++) {
-        snprintf(child->catchphrases[i], MAX_QUIRK_LEN,
-                 "%s", parent->catchphrases[i]);
+    /* Catchphrases and values: inherit all, sharing the parent's blocks */
+    heritage_retain(parent->catchphrases);
+    child->catchphrases = parent->catchphrases;
+    heritage_retain(parent->values);
+    child->values = parent->values;
+}
+
+int repl_finalize(probe_t *parent, probe_t *child,
+                  replication_state_t *state, rng_t *rng) {
+    if (!state->active || state->progress < 1.0 - 0.001) return -1;
+
+    quirk_plan_t plan;
+    child_generate(parent, child, state, rng, &plan);
+    child_inherit_heritage(parent, child, &plan);
+    return 0;
+}
+
+/* ---- Batched replication ---- */
+
+typedef struct {
+    probe_t             *probes;
+    replication_state_t *states;
+    const repl_birth_t  *births;
+    quirk_plan_t        *plans;
+    uint64_t             seed;
+    int                  first, last;
+} repl_worker_t;
+
+/* Each parent gets its own stream, so the children do not depend on how
+ * births are spread across workers. */
+static void birth_rng(rng_t *rng, uint64_t seed, probe_uid_t parent) {
+    rng_seed(rng, seed ^ parent.hi ^ (parent.lo * 0x9e3779b97f4a7c15ULL));
+}
+
+static void *repl_worker(void *arg) {
+    repl_worker_t *w = (repl_worker_t *)arg;
+    for (int k = w->first; k < w->last; k++) {
+        const repl_birth_t *b = &w->births[k];
+        probe_t *parent = &w->probes[b->parent];
+        rng_t rng;
+        birth_rng(&rng, w->seed, parent->id);
+        child_generate(parent, &w->probes[b->child], &w->states[b->parent],
+                       &rng, &w->plans[k]);
     }
+    return NULL;
+}
 
-    /* Values: inherit all */
-    child->value_count = parent->value_count;
-    for (int i = 0; i < parent->value_count; i++) {
-        snprintf(child->values[i], MAX_QUIRK_LEN,
-                 "%s", parent->values[i]);
+int repl_batch_tick(repl_batch_t *batch, probe_t *probes, uint32_t *probe_count,
+                    replication_state_t *states, lineage_tree_t *lineage,
+                    uint64_t tick, rng_t *rng, int threads) {
+    uint32_t n = *probe_count;
+    batch->birth_count = 0;
+    batch->dropped = 0;
+
+    /* 1. Advance every replicating probe; collect completions in index
+     *    order and reserve their child slots in one step. */
+    for (uint32_t i = 0; i < n; i++) {
+        if (probes[i].status != STATUS_REPLICATING || !states[i].active)
+            continue;
+        if (repl_tick(&probes[i], &states[i]) != 1) continue;
+        if (n + (uint32_t)batch->birth_count >= MAX_PROBES) {
+            batch->dropped++;
+            memset(&states[i], 0, sizeof(states[i]));
+            continue;
+        }
+        repl_birth_t *b = &batch->births[batch->birth_count];
+        b->parent = (int32_t)i;
+        b->child = (int32_t)(n + (uint32_t)batch->birth_count);
+        batch->birth_count++;
+    }
+    if (batch->birth_count == 0) return 0;
+
+    /* 2. Generate children, in parallel for large batches */
+    uint64_t seed = rng_next(rng);
+    int count = batch->birth_count;
+    if (threads < 1) threads = 1;
+    if (threads > REPL_BATCH_MAX_THREADS) threads = REPL_BATCH_MAX_THREADS;
+    if (count < REPL_BATCH_PARALLEL_MIN) threads = 1;
+
+    repl_worker_t workers[REPL_BATCH_MAX_THREADS];
+    pthread_t tids[REPL_BATCH_MAX_THREADS];
+    int started = 0;
+    for (int t = 0; t < threads; t++) {
+        workers[t] = (repl_worker_t){
+            .probes = probes, .states = states, .births = batch->births,
+            .plans = batch->plans, .seed = seed,
+            .first = count * t / threads, .last = count * (t + 1) / threads,
+        };
+        if (t > 0 && pthread_create(&tids[t], NULL, repl_worker, &workers[t]) == 0)
+            started |= 1 << t;
+    }
+    repl_worker(&workers[0]);
+    for (int t = 1; t < threads; t++) {
+        if (started & (1 << t)) pthread_join(tids[t], NULL);
+        else repl_worker(&workers[t]);
     }
 
-    /* Status */
-    child->status = STATUS_ACTIVE;
+    /* 3. Commit in birth order: heritage, lineage, then publish the slots */
+    for (int k = 0; k < count; k++) {
+        const repl_birth_t *b = &batch->births[k];
+        probe_t *child = &probes[b->child];
+        child_inherit_heritage(&probes[b->parent], child, &batch->plans[k]);
+        memset(&states[b->parent], 0, sizeof(states[b->parent]));
+        if (lineage)
+            lineage_record(lineage, probes[b->parent].id, child->id,
+                           tick, child->generation);
+    }
+    *probe_count = n + (uint32_t)count;
+    return count;
+}
 
-    /* Parent back to active */
-    parent->status = STATUS_ACTIVE;
-    state->active = false;
+/* ---- Lineage ---- */
 
-    return 0;
+static lineage_node_t *lineage_at(lineage_tree_t *tree, int n) {
+    return &tree->nodes[n];
 }
 
-/* ---- Lineage ---- */
+static int lineage_get_or_create(lineage_tree_t *tree, probe_uid_t id) {
+    int n = lineage_find(tree, id);
+    if (n >= 0) return n;
 
-void lineage_record(lineage_tree_t *tree, probe_uid_t parent_id,
-                    probe_uid_t child_id, uint64_t tick, uint32_t generation) {
-    if (tree->count >= MAX_LINEAGE) return;
+    if (tree->node_count >= tree->node_cap) {
+        int cap = tree->node_cap ? tree->node_cap * 2 : 64;
+        lineage_node_t *nodes = realloc(tree->nodes, (size_t)cap * sizeof(*nodes));
+        if (!nodes) return -1;
+        tree->nodes = nodes;
+        tree->node_cap = cap;
+    }
+    if ((uint32_t)(tree->node_count + 1) * 2 > tree->index_cap) {
+        uint32_t cap = tree->index_cap ? tree->index_cap * 2 : 128;
+        uidmap_slot_t *idx = calloc(cap, sizeof(*idx));
+        if (!idx) return -1;
+        for (int i = 0; i < tree->node_count; i++)
+            uidmap_put(idx, cap, tree->nodes[i].id, i);
+        free(tree->index);
+        tree->index = idx;
+        tree->index_cap = cap;
+    }
 
-    lineage_entry_t *e = &tree->entries[tree->count];
-    e->parent_id = parent_id;
-    e->child_id = child_id;
-    e->birth_tick = tick;
-    e->generation = generation;
-    tree->count++;
+    n = tree->node_count++;
+    lineage_node_t *node = lineage_at(tree, n);
+    memset(node, 0, sizeof(*node));
+    node->id = id;
+    node->parent = -1;
+    node->first_child = -1;
+    node->last_child = -1;
+    node->next_sibling = -1;
+    uidmap_put(tree->index, tree->index_cap, id, n);
+    return n;
+}
+
+int lineage_record(lineage_tree_t *tree, probe_uid_t parent_id,
+                   probe_uid_t child_id, uint64_t tick, uint32_t generation) {
+    int existing = lineage_find(tree, child_id);
+    if (existing >= 0 && tree->nodes[existing].parent >= 0) return -1;
+
+    if (tree->count >= tree->births_cap) {
+        int cap = tree->births_cap ? tree->births_cap * 2 : 64;
+        int32_t *births = realloc(tree->births, (size_t)cap * sizeof(*births));
+        if (!births) return -1;
+        tree->births = births;
+        tree->births_cap = cap;
+    }
+    int pn = lineage_get_or_create(tree, parent_id);
+    if (pn < 0) return -1;
+    int cn = lineage_get_or_create(tree, child_id);
+    if (cn < 0) return -1;
+
+    lineage_node_t *child = lineage_at(tree, cn);
+    child->parent = pn;
+    child->birth_tick = tick;
+    child->generation = generation;
+
+    lineage_node_t *parent = lineage_at(tree, pn);
+    if (parent->last_child >= 0)
+        tree->nodes[parent->last_child].next_sibling = cn;
+    else
+        parent->first_child = cn;
+    parent->last_child = cn;
+    parent->child_count++;
+
+    tree->births[tree->count++] = cn;
+    return 0;
 }
 
 int lineage_children(const lineage_tree_t *tree, probe_uid_t parent_id,
                      probe_uid_t *out, int max_out) {
+    int n = lineage_find(tree, parent_id);
+    if (n < 0) return 0;
     int count = 0;
-    for (int i = 0; i < tree->count && count < max_out; i++) {
-        if (uid_eq(tree->entries[i].parent_id, parent_id)) {
-            out[count++] = tree->entries[i].child_id;
-        }
-    }
+    for (int c = tree->nodes[n].first_child; c >= 0 && count < max_out;
+         c = tree->nodes[c].next_sibling)
+        out[count++] = tree->nodes[c].id;
     return count;
 }
+
+int lineage_entry_at(const lineage_tree_t *tree, int i, lineage_entry_t *out) {
+    if (i < 0 || i >= tree->count) return -1;
+    const lineage_node_t *child = &tree->nodes[tree->births[i]];
+    out->parent_id = tree->nodes[child->parent].id;
+    out->child_id = child->id;
+    out->birth_tick = child->birth_tick;
+    out->generation = child->generation;
+    return 0;
+}
+
+int lineage_find(const lineage_tree_t *tree, probe_uid_t id) {
+    if (tree->index_cap == 0) return -1;
+    return uidmap_get(tree->index, tree->index_cap, id);
+}
+
+const lineage_node_t *lineage_node(const lineage_tree_t *tree, int node) {
+    if (node < 0 || node >= tree->node_count) return NULL;
+    return &tree->nodes[node];
+}
+
+int lineage_ancestors(const lineage_tree_t *tree, probe_uid_t id,
+                      probe_uid_t *out, int max_out) {
+    int n = lineage_find(tree, id);
+    int count = 0;
+    if (n < 0) return 0;
+    for (int a = tree->nodes[n].parent; a >= 0 && count < max_out;
+         a = tree->nodes[a].parent)
+        out[count++] = tree->nodes[a].id;
+    return count;
+}
+
+int lineage_next_preorder(const lineage_tree_t *tree, int root, int node) {
+    if (tree->nodes[node].first_child >= 0)
+        return tree->nodes[node].first_child;
+    /* Climb until a sibling exists, without leaving root's subtree */
+    while (node != root) {
+        if (tree->nodes[node].next_sibling >= 0)
+            return tree->nodes[node].next_sibling;
+        node = tree->nodes[node].parent;
+    }
+    return -1;
+}
+
+int lineage_subtree_size(const lineage_tree_t *tree, probe_uid_t id) {
+    int root = lineage_find(tree, id);
+    if (root < 0) return 0;
+    int size = 0;
+    for (int n = root; n >= 0; n = lineage_next_preorder(tree, root, n))
+        size++;
+    return size;
+}
+
+void lineage_free(lineage_tree_t *tree) {
+    free(tree->nodes);
+    free(tree->index);
+    free(tree->births);
+    memset(tree, 0, sizeof(*tree));
+}
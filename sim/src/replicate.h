@@ -3,6 +3,7 @@
 
 #include "universe.h"
 #include "rng.h"
+#include "uidmap.h"
 
 /* ---- Replication cost ---- */
 
@@ -33,6 +34,18 @@ typedef struct {
     uint32_t ticks_total;
 } replication_state_t;
 
+/* Quirk inheritance decisions drawn from the RNG, applied later on the
+ * thread that owns the heritage pool. */
+enum { QUIRK_KEEP, QUIRK_MUTATE, QUIRK_NEW };
+
+typedef struct {
+    uint8_t op[MAX_QUIRKS];
+    uint8_t arg[MAX_QUIRKS];     /* parent line (KEEP/MUTATE) or new quirk */
+    uint8_t mod[MAX_QUIRKS];     /* mutation suffix (MUTATE) */
+    uint8_t count;
+    bool    same;                /* child list identical to the parent's */
+} quirk_plan_t;
+
 /* ---- API ---- */
 
 /* Check if probe has enough resources to begin replication.
@@ -63,13 +76,15 @@ void personality_mutate(const personality_traits_t *parent,
 /* ---- Earth memory degradation ---- */
 
 /* Degrade earth memories for a child probe.
- * Fidelity drops per generation. Strings get truncated at low fidelity. */
+ * Fidelity drops per generation. Strings get truncated at low fidelity;
+ * a truncated list moves to its own heritage block (copy-on-write). */
 void earth_memory_degrade(probe_t *child);
 
 /* ---- Quirk inheritance ---- */
 
 /* Inherit quirks from parent: 70% keep, 10% mutate, 20% drop.
- * May add a new random quirk. */
+ * May add a new random quirk. Releases the child's previous list; an
+ * unchanged list shares the parent's heritage block. */
 void quirk_inherit(const probe_t *parent, probe_t *child, rng_t *rng);
 
 /* ---- Child naming ---- */
@@ -87,19 +102,95 @@ typedef struct {
     uint32_t    generation;
 } lineage_entry_t;
 
-#define MAX_LINEAGE 1024
+/* One probe in the family tree. Children hang off first_child and are
+ * chained through next_sibling in birth order. All links are node
+ * indices, -1 for none. */
+typedef struct {
+    probe_uid_t id;
+    int32_t     parent;
+    int32_t     first_child;
+    int32_t     last_child;
+    int32_t     next_sibling;
+    int32_t     child_count;
+    uint64_t    birth_tick;        /* 0 for probes never recorded as a child */
+    uint32_t    generation;
+} lineage_node_t;
 
+/* Unbounded lineage store. Storage is heap-backed and grows on demand;
+ * a zeroed struct is a valid empty tree. */
 typedef struct {
-    lineage_entry_t entries[MAX_LINEAGE];
-    int count;
+    lineage_node_t *nodes;
+    int             node_count;
+    int             node_cap;
+    uidmap_slot_t  *index;         /* probe_id → node */
+    uint32_t        index_cap;
+    int32_t        *births;        /* child node of each record, in order */
+    int             count;         /* births recorded */
+    int             births_cap;
 } lineage_tree_t;
 
-/* Record a parent→child relationship */
-void lineage_record(lineage_tree_t *tree, probe_uid_t parent_id,
-                    probe_uid_t child_id, uint64_t tick, uint32_t generation);
+/* Record a parent→child relationship. O(1) amortised.
+ * Returns 0, or -1 if the child was already recorded or on OOM. */
+int lineage_record(lineage_tree_t *tree, probe_uid_t parent_id,
+                   probe_uid_t child_id, uint64_t tick, uint32_t generation);
 
-/* Get children of a given probe. Returns count, writes up to max_out IDs. */
+/* Get children of a given probe in birth order. Returns count, writes up
+ * to max_out IDs. */
 int lineage_children(const lineage_tree_t *tree, probe_uid_t parent_id,
                      probe_uid_t *out, int max_out);
 
+/* i-th recorded birth (0 = oldest). Returns 0, or -1 if out of range. */
+int lineage_entry_at(const lineage_tree_t *tree, int i, lineage_entry_t *out);
+
+/* Node index for a probe, or -1 if it is not in the tree. */
+int lineage_find(const lineage_tree_t *tree, probe_uid_t id);
+
+/* Node by index, or NULL. */
+const lineage_node_t *lineage_node(const lineage_tree_t *tree, int node);
+
+/* Ancestors of id, parent first. Returns count, writes up to max_out. */
+int lineage_ancestors(const lineage_tree_t *tree, probe_uid_t id,
+                      probe_uid_t *out, int max_out);
+
+/* Number of probes in id's subtree, including id. 0 if unknown. */
+int lineage_subtree_size(const lineage_tree_t *tree, probe_uid_t id);
+
+/* Pre-order walk of root's subtree: returns the node after `node`, or -1
+ * once the walk leaves the subtree. Start with node = root. */
+int lineage_next_preorder(const lineage_tree_t *tree, int root, int node);
+
+/* Free the tree's storage and zero it. */
+void lineage_free(lineage_tree_t *tree);
+
+/* ---- Batched replication ---- */
+
+#define REPL_BATCH_MAX_THREADS   8
+#define REPL_BATCH_PARALLEL_MIN  32   /* smaller batches stay on one thread */
+
+typedef struct {
+    int32_t parent;              /* index into probes */
+    int32_t child;               /* reserved slot */
+} repl_birth_t;
+
+/* Scratch for repl_batch_tick. Large: keep it static or on the heap. */
+typedef struct {
+    repl_birth_t births[MAX_PROBES];
+    quirk_plan_t plans[MAX_PROBES];
+    int          birth_count;    /* children committed by the last call */
+    int          dropped;        /* completions with no free probe slot */
+} repl_batch_t;
+
+/* Replication phase for a whole tick. Calls repl_tick for every
+ * replicating probe (states[i] belongs to probes[i]), reserves a slot at
+ * the end of probes for each completion, generates the children on up to
+ * `threads` threads with one RNG stream per parent (seeded from a single
+ * draw of rng), then commits heritage and lineage (lineage may be NULL)
+ * in parent-index order and bumps *probe_count. The result depends only
+ * on the inputs, never on the thread count. Completions that do not fit
+ * under MAX_PROBES are dropped, as with the serial path.
+ * Returns the number of children created. */
+int repl_batch_tick(repl_batch_t *batch, probe_t *probes, uint32_t *probe_count,
+                    replication_state_t *states, lineage_tree_t *lineage,
+                    uint64_t tick, rng_t *rng, int threads);
+
 #endif /* REPLICATE_H */
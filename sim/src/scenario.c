@@ -5,6 +5,8 @@
  */
 
 #include "scenario.h"
+#include "heritage.h"
+#include "strtab.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -23,10 +25,7 @@ int inject_event(injection_queue_t *q, event_type_t type, int subtype,
     injected_event_t *ev = &q->events[q->count++];
     ev->type = type;
     ev->subtype = subtype;
-    if (description) {
-        memset(ev->description, 0, sizeof(ev->description));
-        strncpy(ev->description, description, sizeof(ev->description) - 1);
-    }
+    ev->description = strtab_intern(description);
     ev->severity = severity;
     ev->target_probe_id = target_probe_id;
     ev->pending = true;
@@ -129,17 +128,8 @@ double metrics_avg_tech(const universe_t *uni) {
     return active > 0 ? total / active : 0.0;
 }
 
-float metrics_avg_trust(const universe_t *uni) {
-    float total = 0.0f;
-    int count = 0;
-    for (uint32_t i = 0; i < uni->probe_count; i++) {
-        if (uni->probes[i].status != STATUS_ACTIVE) continue;
-        for (int r = 0; r < uni->probes[i].relationship_count; r++) {
-            total += uni->probes[i].relationships[r].trust;
-            count++;
-        }
-    }
-    return count > 0 ? total / count : 0.0f;
+float metrics_avg_trust(const society_t *soc) {
+    return soc ? society_avg_trust(soc) : 0.0f;
 }
 
 uint32_t metrics_systems_explored(const universe_t *uni) {
@@ -154,7 +144,8 @@ uint32_t metrics_systems_explored(const universe_t *uni) {
 }
 
 void metrics_record(metrics_system_t *ms, const universe_t *uni,
-                    const event_system_t *es, uint64_t tick) {
+                    const society_t *soc, const event_system_t *es,
+                    uint64_t tick) {
     if (ms->sample_interval > 0 && (tick % ms->sample_interval) != 0)
         return;
     if (ms->count >= MAX_METRICS_HISTORY) return;
@@ -171,14 +162,15 @@ void metrics_record(metrics_system_t *ms, const universe_t *uni,
     snap->probes_spawned = uni->probe_count;
     snap->systems_explored = metrics_systems_explored(uni);
     snap->avg_tech_level = metrics_avg_tech(uni);
-    snap->avg_trust = metrics_avg_trust(uni);
+    snap->avg_trust = metrics_avg_trust(soc);
 
     /* Count from event log */
     uint32_t discoveries = 0, hazards = 0, civs = 0;
     for (int i = 0; i < es->count; i++) {
-        if (es->events[i].type == EVT_DISCOVERY) discoveries++;
-        else if (es->events[i].type == EVT_HAZARD) hazards++;
-        else if (es->events[i].type == EVT_ENCOUNTER) civs++;
+        event_type_t type = events_at(es, i)->type;
+        if (type == EVT_DISCOVERY) discoveries++;
+        else if (type == EVT_HAZARD) hazards++;
+        else if (type == EVT_ENCOUNTER) civs++;
     }
     snap->total_discoveries = discoveries;
     snap->total_hazards_survived = hazards;
@@ -199,13 +191,24 @@ const metrics_snapshot_t *metrics_at(const metrics_system_t *ms, int index) {
 
 /* ---- Snapshot ---- */
 
+/* Heritage references held by probes[0..count). */
+static void retain_probes(const probe_t *probes, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) heritage_retain_probe(&probes[i]);
+}
+
+static void release_probes(const probe_t *probes, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) heritage_release_probe(&probes[i]);
+}
+
 void snapshot_take(snapshot_t *snap, const universe_t *uni, const char *tag) {
+    if (snap->valid) release_probes(snap->probes, snap->probe_count);
     memset(snap, 0, sizeof(*snap));
     strncpy(snap->tag, tag, MAX_SNAPSHOT_TAG - 1);
     snap->tick = uni->tick;
     snap->seed = uni->seed;
     snap->probe_count = uni->probe_count;
     memcpy(snap->probes, uni->probes, sizeof(probe_t) * uni->probe_count);
+    retain_probes(snap->probes, snap->probe_count);
     snap->valid = true;
 }
 
@@ -213,8 +216,10 @@ int snapshot_restore(const snapshot_t *snap, universe_t *uni) {
     if (!snap->valid) return -1;
     uni->tick = snap->tick;
     uni->seed = snap->seed;
+    release_probes(uni->probes, uni->probe_count);
     uni->probe_count = snap->probe_count;
     memcpy(uni->probes, snap->probes, sizeof(probe_t) * snap->probe_count);
+    retain_probes(uni->probes, uni->probe_count);
     return 0;
 }
 
@@ -241,6 +246,7 @@ int universe_fork(const snapshot_t *snap, universe_t *forked, uint64_t new_seed)
     forked->probe_count = snap->probe_count;
     forked->running = true;
     memcpy(forked->probes, snap->probes, sizeof(probe_t) * snap->probe_count);
+    retain_probes(forked->probes, forked->probe_count);
     return 0;
 }
 
@@ -343,8 +349,9 @@ void replay_init(replay_t *rep, const event_system_t *es,
 
     /* Copy events in range */
     for (int i = 0; i < es->count && rep->event_count < MAX_REPLAY_EVENTS; i++) {
-        if (es->events[i].tick >= from_tick && es->events[i].tick <= to_tick) {
-            rep->events[rep->event_count++] = es->events[i];
+        const sim_event_t *ev = events_at(es, i);
+        if (ev->tick >= from_tick && ev->tick <= to_tick) {
+            rep->events[rep->event_count++] = *ev;
         }
     }
 
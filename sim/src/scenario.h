@@ -3,6 +3,7 @@
 
 #include "universe.h"
 #include "events.h"
+#include "society.h"
 #include "rng.h"
 
 /* ---- Constants ---- */
@@ -20,7 +21,7 @@
 typedef struct {
     event_type_t type;
     int          subtype;
-    char         description[256];
+    str_id_t     description;     /* interned */
     float        severity;        /* 0 = auto, >0 = forced */
     probe_uid_t  target_probe_id; /* null = all probes */
     bool         pending;
@@ -78,9 +79,11 @@ typedef struct {
 void metrics_init(metrics_system_t *ms, int sample_interval);
 
 /* Compute and record metrics for current tick.
- * Only records if tick aligns with sample_interval. */
+ * Only records if tick aligns with sample_interval.
+ * soc may be NULL, in which case avg_trust is recorded as 0. */
 void metrics_record(metrics_system_t *ms, const universe_t *uni,
-                    const event_system_t *es, uint64_t tick);
+                    const society_t *soc, const event_system_t *es,
+                    uint64_t tick);
 
 /* Get latest metrics snapshot, or NULL if none. */
 const metrics_snapshot_t *metrics_latest(const metrics_system_t *ms);
@@ -91,8 +94,8 @@ const metrics_snapshot_t *metrics_at(const metrics_system_t *ms, int index);
 /* Compute average tech level across all active probes. */
 double metrics_avg_tech(const universe_t *uni);
 
-/* Compute average inter-probe trust. */
-float metrics_avg_trust(const universe_t *uni);
+/* Compute average inter-probe trust over the relationship graph. O(1). */
+float metrics_avg_trust(const society_t *soc);
 
 /* Count systems explored (visited) across all probes. */
 uint32_t metrics_systems_explored(const universe_t *uni);
@@ -108,11 +111,12 @@ typedef struct {
     bool     valid;
 } snapshot_t;
 
-/* Take a snapshot of the universe state. */
+/* Take a snapshot of the universe state. The snapshot holds its own
+ * heritage references; retaking a valid snapshot releases the old ones. */
 void snapshot_take(snapshot_t *snap, const universe_t *uni, const char *tag);
 
-/* Restore universe from snapshot.
- * Returns 0 on success, -1 if snapshot invalid. */
+/* Restore universe from snapshot, releasing the heritage held by the
+ * universe's current probes. Returns 0 on success, -1 if snapshot invalid. */
 int snapshot_restore(const snapshot_t *snap, universe_t *uni);
 
 /* Check if two snapshots match (for rollback verification). */
@@ -0,0 +1,342 @@
+/*
+ * sector_cache.c — Renderer-side sector cache with background generation
+ */
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sector_cache.h"
+#include "generate.h"
+#include "util.h"
+
+#define INDEX_CAP (SECTOR_CACHE_CAP * 2)
+
+typedef struct {
+    sector_coord_t coord;
+    system_t      *systems;
+    int            count;
+} sector_result_t;
+
+struct sector_loader {
+    pthread_t       thread;
+    pthread_mutex_t lock;
+    pthread_cond_t  wake;        /* work queued, or quit */
+    pthread_cond_t  idle;        /* queue drained and nothing running */
+    uint64_t        seed;
+    sector_coord_t  queue[SECTOR_CACHE_CAP];
+    int             q_head;
+    int             q_count;
+    sector_result_t done[SECTOR_CACHE_CAP];
+    int             done_count;
+    bool            busy;
+    bool            quit;
+};
+
+/* ---- Helpers ---- */
+
+static probe_uid_t coord_key(sector_coord_t c) {
+    return (probe_uid_t){
+        ((uint64_t)(uint32_t)c.x << 32) | (uint32_t)c.y,
+        (uint64_t)(uint32_t)c.z
+    };
+}
+
+static bool coord_eq(sector_coord_t a, sector_coord_t b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+/* Generate one sector into an exactly-sized heap buffer. */
+static int load_sector(uint64_t seed, sector_coord_t coord, system_t **out) {
+    system_t *buf = malloc(sizeof(system_t) * SECTOR_MAX_SYSTEMS);
+    *out = NULL;
+    if (!buf) return 0;
+    int n = generate_sector(buf, SECTOR_MAX_SYSTEMS, seed, coord);
+    if (n <= 0) {
+        free(buf);
+        return 0;
+    }
+    system_t *fit = realloc(buf, sizeof(system_t) * (size_t)n);
+    *out = fit ? fit : buf;
+    return n;
+}
+
+sector_coord_t sector_of_position(double x, double y, double z) {
+    return (sector_coord_t){
+        (int32_t)floor(x / SECTOR_SIZE_LY),
+        (int32_t)floor(y / SECTOR_SIZE_LY),
+        (int32_t)floor(z / SECTOR_SIZE_LY),
+    };
+}
+
+int sector_view_radius(double scale, int screen_w, int screen_h) {
+    if (scale <= 0.0) return SECTOR_VIEW_MAX_RADIUS;
+    double half_ly = (double)MAX(screen_w, screen_h) / 2.0 / scale;
+    int r = (int)ceil(half_ly / SECTOR_SIZE_LY);
+    return CLAMP(r, 1, SECTOR_VIEW_MAX_RADIUS);
+}
+
+/* ---- Loader thread ---- */
+
+static void *loader_main(void *arg) {
+    sector_loader_t *l = (sector_loader_t *)arg;
+    pthread_mutex_lock(&l->lock);
+    while (!l->quit) {
+        if (l->q_count == 0) {
+            pthread_cond_wait(&l->wake, &l->lock);
+            continue;
+        }
+        sector_coord_t coord = l->queue[l->q_head];
+        l->q_head = (l->q_head + 1) % SECTOR_CACHE_CAP;
+        l->q_count--;
+        l->busy = true;
+        pthread_mutex_unlock(&l->lock);
+
+        system_t *systems;
+        int n = load_sector(l->seed, coord, &systems);
+
+        pthread_mutex_lock(&l->lock);
+        l->done[l->done_count++] = (sector_result_t){coord, systems, n};
+        l->busy = false;
+        if (l->q_count == 0) pthread_cond_broadcast(&l->idle);
+    }
+    pthread_mutex_unlock(&l->lock);
+    return NULL;
+}
+
+static sector_loader_t *loader_start(uint64_t seed) {
+    sector_loader_t *l = calloc(1, sizeof(*l));
+    if (!l) return NULL;
+    l->seed = seed;
+    pthread_mutex_init(&l->lock, NULL);
+    pthread_cond_init(&l->wake, NULL);
+    pthread_cond_init(&l->idle, NULL);
+    if (pthread_create(&l->thread, NULL, loader_main, l) != 0) {
+        pthread_cond_destroy(&l->idle);
+        pthread_cond_destroy(&l->wake);
+        pthread_mutex_destroy(&l->lock);
+        free(l);
+        return NULL;
+    }
+    return l;
+}
+
+static void loader_stop(sector_loader_t *l) {
+    pthread_mutex_lock(&l->lock);
+    l->quit = true;
+    pthread_cond_signal(&l->wake);
+    pthread_mutex_unlock(&l->lock);
+    pthread_join(l->thread, NULL);
+    for (int i = 0; i < l->done_count; i++) free(l->done[i].systems);
+    pthread_cond_destroy(&l->idle);
+    pthread_cond_destroy(&l->wake);
+    pthread_mutex_destroy(&l->lock);
+    free(l);
+}
+
+/* ---- Init / free ---- */
+
+int sector_cache_init(sector_cache_t *c, uint64_t seed, bool async) {
+    memset(c, 0, sizeof(*c));
+    c->seed = seed;
+    c->radius = -1;
+    if (!async) return 0;
+    c->loader = loader_start(seed);
+    return c->loader ? 0 : -1;
+}
+
+void sector_cache_free(sector_cache_t *c) {
+    if (c->loader) loader_stop(c->loader);
+    for (int i = 0; i < SECTOR_CACHE_CAP; i++) free(c->entries[i].systems);
+    free(c->visible);
+    memset(c, 0, sizeof(*c));
+}
+
+void sector_cache_wait_idle(sector_cache_t *c) {
+    sector_loader_t *l = c->loader;
+    if (!l) return;
+    pthread_mutex_lock(&l->lock);
+    while (l->q_count > 0 || l->busy)
+        pthread_cond_wait(&l->idle, &l->lock);
+    pthread_mutex_unlock(&l->lock);
+}
+
+/* ---- Index ---- */
+
+static int find_entry(const sector_cache_t *c, sector_coord_t coord) {
+    return uidmap_get(c->index, INDEX_CAP, coord_key(coord));
+}
+
+const sector_entry_t *sector_cache_find(const sector_cache_t *c,
+                                        sector_coord_t coord) {
+    int e = find_entry(c, coord);
+    return e < 0 ? NULL : &c->entries[e];
+}
+
+/* Deleted slots only turn back into empty ones on a rebuild. touch runs
+ * one once a quarter of the table has been deleted, before misses have
+ * to walk a table full of tombstones. */
+static void index_rebuild(sector_cache_t *c) {
+    memset(c->index, 0, sizeof(c->index));
+    for (int i = 0; i < SECTOR_CACHE_CAP; i++) {
+        if (c->entries[i].state != SECTOR_EMPTY)
+            uidmap_put(c->index, INDEX_CAP, coord_key(c->entries[i].coord), i);
+    }
+    c->index_dead = 0;
+}
+
+static void entry_drop(sector_cache_t *c, int e) {
+    sector_entry_t *en = &c->entries[e];
+    if (uidmap_del(c->index, INDEX_CAP, coord_key(en->coord)) == 0)
+        c->index_dead++;
+    free(en->systems);
+    memset(en, 0, sizeof(*en));
+    c->evicted++;
+}
+
+/* Free entry, evicting the least recently used one outside the current
+ * window if the cache is full. -1 if everything is in use. */
+static int entry_alloc(sector_cache_t *c) {
+    int victim = -1;
+    for (int i = 0; i < SECTOR_CACHE_CAP; i++) {
+        const sector_entry_t *en = &c->entries[i];
+        if (en->state == SECTOR_EMPTY) return i;
+        if (en->last_used == c->stamp) continue;
+        if (victim < 0 || en->last_used < c->entries[victim].last_used)
+            victim = i;
+    }
+    if (victim >= 0) entry_drop(c, victim);
+    return victim;
+}
+
+/* ---- Update ---- */
+
+/* Move finished loader buffers into their entries. */
+static void swap_in(sector_cache_t *c) {
+    sector_loader_t *l = c->loader;
+    sector_result_t done[SECTOR_CACHE_CAP];
+    pthread_mutex_lock(&l->lock);
+    int n = l->done_count;
+    memcpy(done, l->done, sizeof(done[0]) * (size_t)n);
+    l->done_count = 0;
+    pthread_mutex_unlock(&l->lock);
+
+    for (int i = 0; i < n; i++) {
+        int e = find_entry(c, done[i].coord);
+        sector_entry_t *en = e < 0 ? NULL : &c->entries[e];
+        if (!en || en->state != SECTOR_PENDING) {
+            free(done[i].systems);   /* evicted while loading */
+            continue;
+        }
+        en->systems = done[i].systems;
+        en->count = done[i].count;
+        en->state = SECTOR_READY;
+        c->generated++;
+        c->dirty = true;
+    }
+}
+
+/* Queue a request. Fails if the loader is already holding a full cache's
+ * worth of work, in which case the sector is asked for again next update. */
+static int request(sector_cache_t *c, sector_coord_t coord) {
+    sector_loader_t *l = c->loader;
+    int rc = -1;
+    pthread_mutex_lock(&l->lock);
+    if (l->q_count + l->done_count + (l->busy ? 1 : 0) < SECTOR_CACHE_CAP) {
+        l->queue[(l->q_head + l->q_count) % SECTOR_CACHE_CAP] = coord;
+        l->q_count++;
+        pthread_cond_signal(&l->wake);
+        rc = 0;
+    }
+    pthread_mutex_unlock(&l->lock);
+    return rc;
+}
+
+/* Make coord resident (or pending). Returns its entry, or -1. */
+static int touch(sector_cache_t *c, sector_coord_t coord) {
+    int e = find_entry(c, coord);
+    if (e >= 0) {
+        c->entries[e].last_used = c->stamp;
+        return e;
+    }
+    if (c->loader) {
+        /* Bound queued work so a long pan cannot back the loader up */
+        pthread_mutex_lock(&c->loader->lock);
+        int backlog = c->loader->q_count;
+        pthread_mutex_unlock(&c->loader->lock);
+        if (backlog >= SECTOR_CACHE_CAP / 2) return -1;
+    }
+
+    e = entry_alloc(c);
+    if (e < 0) return -1;
+    sector_entry_t *en = &c->entries[e];
+    en->coord = coord;
+    en->last_used = c->stamp;
+
+    if (c->loader) {
+        if (request(c, coord) != 0) return -1;
+        en->state = SECTOR_PENDING;
+    } else {
+        en->count = load_sector(c->seed, coord, &en->systems);
+        en->state = SECTOR_READY;
+        c->generated++;
+        c->dirty = true;
+    }
+    /* The rebuild picks up e along with every other resident entry */
+    if (uidmap_put(c->index, INDEX_CAP, coord_key(coord), e) != 0 ||
+        c->index_dead > INDEX_CAP / 4)
+        index_rebuild(c);
+    return e;
+}
+
+static int visible_push(sector_cache_t *c, const system_t *sys) {
+    if (c->visible_count == c->visible_cap) {
+        int cap = c->visible_cap ? c->visible_cap * 2 : 256;
+        const system_t **nv = realloc(c->visible, sizeof(*nv) * (size_t)cap);
+        if (!nv) return -1;
+        c->visible = nv;
+        c->visible_cap = cap;
+    }
+    c->visible[c->visible_count++] = sys;
+    return 0;
+}
+
+int sector_cache_update(sector_cache_t *c, sector_coord_t center, int radius) {
+    radius = CLAMP(radius, 0, SECTOR_VIEW_MAX_RADIUS);
+    if (c->loader) swap_in(c);
+    if (!coord_eq(center, c->center) || radius != c->radius) c->dirty = true;
+    c->center = center;
+    c->radius = radius;
+    c->stamp++;
+
+    /* Walk the window in rings so the nearest sectors are requested and
+     * listed first. */
+    int order[(2 * SECTOR_VIEW_MAX_RADIUS + 1) * (2 * SECTOR_VIEW_MAX_RADIUS + 1)];
+    int n = 0;
+    int pending = 0;
+    for (int d = 0; d <= radius; d++) {
+        for (int dy = -d; dy <= d; dy++) {
+            for (int dx = -d; dx <= d; dx++) {
+                if (MAX(abs(dx), abs(dy)) != d) continue;
+                sector_coord_t sc = {center.x + dx, center.y + dy, center.z};
+                int e = touch(c, sc);
+                if (e < 0 || c->entries[e].state != SECTOR_READY) {
+                    pending++;
+                    continue;
+                }
+                order[n++] = e;
+            }
+        }
+    }
+
+    if (c->dirty) {
+        c->visible_count = 0;
+        for (int i = 0; i < n; i++) {
+            const sector_entry_t *en = &c->entries[order[i]];
+            for (int s = 0; s < en->count; s++)
+                if (visible_push(c, &en->systems[s]) != 0) break;
+        }
+        c->dirty = false;
+    }
+    return pending;
+}
@@ -0,0 +1,89 @@
+/*
+ * sector_cache.h — Renderer-side sector cache with background generation
+ *
+ * Keeps generated sectors keyed by coordinate so the renderer only pays
+ * for sectors it has not seen yet. Missing sectors are queued to a loader
+ * thread; finished buffers are swapped in by sector_cache_update() on the
+ * caller's thread, so everything the renderer reads is owned by that
+ * thread and needs no locking. No Raylib dependency.
+ */
+#ifndef SECTOR_CACHE_H
+#define SECTOR_CACHE_H
+
+#include "universe.h"
+#include "uidmap.h"
+
+#define SECTOR_SIZE_LY          100.0
+#define SECTOR_MAX_SYSTEMS      30
+#define SECTOR_CACHE_CAP        512   /* resident sectors */
+#define SECTOR_VIEW_MAX_RADIUS  8     /* (2r+1)^2 <= SECTOR_CACHE_CAP */
+
+typedef enum {
+    SECTOR_EMPTY = 0,
+    SECTOR_PENDING,              /* queued or being generated */
+    SECTOR_READY
+} sector_state_t;
+
+typedef struct {
+    sector_coord_t coord;
+    uint8_t        state;        /* sector_state_t */
+    system_t      *systems;      /* owned, NULL until READY */
+    int            count;
+    uint64_t       last_used;    /* update stamp, for eviction */
+} sector_entry_t;
+
+typedef struct sector_loader sector_loader_t;
+
+typedef struct {
+    uint64_t         seed;
+    sector_entry_t   entries[SECTOR_CACHE_CAP];
+    uidmap_slot_t    index[SECTOR_CACHE_CAP * 2];   /* coord -> entry */
+    int              index_dead;   /* tombstones in index since rebuild */
+    sector_loader_t *loader;     /* NULL = generate inline */
+    uint64_t         stamp;
+
+    /* Current view window and the READY systems inside it, nearest
+     * sectors first. Pointers stay valid until the next update. */
+    sector_coord_t   center;
+    int              radius;
+    const system_t **visible;
+    int              visible_count;
+    int              visible_cap;
+    bool             dirty;
+
+    /* Counters */
+    uint64_t         generated;  /* sectors generated since init */
+    uint64_t         evicted;
+} sector_cache_t;
+
+/* Initialise an empty cache. With async, a loader thread generates
+ * sectors in the background; otherwise update generates them inline.
+ * Returns 0, or -1 if the loader could not be started (the cache then
+ * falls back to inline generation). */
+int  sector_cache_init(sector_cache_t *c, uint64_t seed, bool async);
+
+/* Stop the loader and free every buffer. */
+void sector_cache_free(sector_cache_t *c);
+
+/* Make the (2r+1)x(2r+1) window around center current: swap in finished
+ * sectors, request missing ones (nearest first), evict the least recently
+ * used sectors outside the window when full, and rebuild the visible
+ * list if anything changed. radius is clamped to [0, SECTOR_VIEW_MAX_RADIUS].
+ * Returns the number of sectors in the window still pending. */
+int  sector_cache_update(sector_cache_t *c, sector_coord_t center, int radius);
+
+/* Block until the loader has no queued or running work (tests, startup). */
+void sector_cache_wait_idle(sector_cache_t *c);
+
+/* Sector entry for coord, or NULL if not resident. */
+const sector_entry_t *sector_cache_find(const sector_cache_t *c,
+                                        sector_coord_t coord);
+
+/* Sector containing a galactic position. */
+sector_coord_t sector_of_position(double x, double y, double z);
+
+/* Sector radius needed to cover a screen of w x h pixels at the given
+ * scale (pixels per ly), clamped to [1, SECTOR_VIEW_MAX_RADIUS]. */
+int  sector_view_radius(double scale, int screen_w, int screen_h);
+
+#endif /* SECTOR_CACHE_H */
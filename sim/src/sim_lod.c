@@ -0,0 +1,121 @@
+/*
+ * sim_lod.c — Level-of-detail tiers for pipe-mode probes
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "sim_lod.h"
+
+void sim_lod_init(sim_lod_t *l, uint32_t cadence, float radius_ly) {
+    memset(l, 0, sizeof(*l));
+    l->cadence = cadence;
+    l->radius_ly = radius_ly;
+}
+
+void sim_lod_reset(sim_lod_t *l, uint64_t tick) {
+    for (uint32_t i = 0; i < MAX_PROBES; i++) {
+        l->tier[i] = TIER_FULL;
+        l->attached[i] = false;
+        l->synced[i] = tick;
+        l->hot_until[i] = 0;
+    }
+    l->known = 0;
+    l->events_seen = 0;
+    l->full_count = 0;
+    l->coarse_count = 0;
+}
+
+static int probe_index(const universe_t *u, probe_uid_t id) {
+    for (uint32_t i = 0; i < u->probe_count; i++)
+        if (uid_eq(u->probes[i].id, id)) return (int)i;
+    return -1;
+}
+
+void sim_lod_update(sim_lod_t *l, const universe_t *u, const event_system_t *es) {
+    uint64_t tick = u->tick;
+
+    /* Probes born since the last call start full and in sync */
+    for (uint32_t i = l->known; i < u->probe_count; i++) {
+        l->tier[i] = TIER_FULL;
+        l->synced[i] = tick;
+        l->hot_until[i] = 0;
+    }
+    l->known = u->probe_count;
+
+    l->full_count = 0;
+    l->coarse_count = 0;
+    if (l->cadence == 0) {
+        for (uint32_t i = 0; i < u->probe_count; i++) l->tier[i] = TIER_FULL;
+        l->full_count = u->probe_count;
+        l->events_seen = es->seq;
+        return;
+    }
+
+    /* Anything logged for a probe keeps it full for a cadence */
+    if (l->events_seen > es->seq) l->events_seen = 0;
+    if (l->events_seen < events_first_seq(es))
+        l->events_seen = events_first_seq(es);
+    for (uint64_t n = l->events_seen; n < es->seq; n++) {
+        const sim_event_t *ev = events_by_seq(es, n);
+        int idx = probe_index(u, ev->probe_id);
+        if (idx >= 0) l->hot_until[idx] = ev->tick + l->cadence;
+    }
+    l->events_seen = es->seq;
+    for (int h = 0; h < es->pending_count; h++) {
+        const pending_hazard_t *ph = &es->pending_hazards[h];
+        if (ph->struck) continue;
+        int idx = probe_index(u, ph->target);
+        if (idx >= 0 && l->hot_until[idx] < ph->strike_tick)
+            l->hot_until[idx] = ph->strike_tick;
+    }
+
+    /* Agents usually drive a handful of probes; test proximity to those */
+    uint32_t near[MAX_PROBES];
+    uint32_t near_count = 0;
+    for (uint32_t i = 0; i < u->probe_count; i++)
+        if (l->attached[i]) near[near_count++] = i;
+
+    double r2 = (double)l->radius_ly * (double)l->radius_ly;
+    for (uint32_t i = 0; i < u->probe_count; i++) {
+        const probe_t *pr = &u->probes[i];
+        bool full = l->attached[i] || l->hot_until[i] > tick;
+        for (uint32_t k = 0; !full && k < near_count; k++) {
+            vec3_t a = pr->heading, b = u->probes[near[k]].heading;
+            double dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+            full = dx * dx + dy * dy + dz * dz <= r2;
+        }
+        l->tier[i] = full ? TIER_FULL : TIER_COARSE;
+        if (full) l->full_count++;
+        else l->coarse_count++;
+    }
+}
+
+uint32_t sim_lod_due(const sim_lod_t *l, uint32_t i, uint64_t tick) {
+    uint64_t lag = tick > l->synced[i] ? tick - l->synced[i] : 0;
+    if (lag == 0) return 0;
+    if (l->tier[i] == TIER_COARSE && lag < l->cadence) return 0;
+    return lag > UINT32_MAX ? UINT32_MAX : (uint32_t)lag;
+}
+
+double sim_lod_saved_ms(const sim_lod_t *l) {
+    if (l->full_probe_ticks == 0) return 0.0;
+    double per = (double)l->full_ns / (double)l->full_probe_ticks;
+    double saved = per * (double)l->coarse_probe_ticks - (double)l->catch_up_ns;
+    return saved > 0 ? saved / 1e6 : 0.0;
+}
+
+int sim_lod_format_json(const sim_lod_t *l, char *buf, size_t n) {
+    int len = snprintf(buf, n,
+        "{\"cadence\":%u,\"radius_ly\":%.1f,"
+        "\"tiers\":{\"full\":%u,\"coarse\":%u},"
+        "\"probe_ticks\":{\"full\":%llu,\"coarse\":%llu},"
+        "\"catch_ups\":%llu,\"catch_up_ms\":%.3f,\"saved_ms\":%.3f}",
+        l->cadence, (double)l->radius_ly,
+        l->full_count, l->coarse_count,
+        (unsigned long long)l->full_probe_ticks,
+        (unsigned long long)l->coarse_probe_ticks,
+        (unsigned long long)l->catch_ups,
+        (double)l->catch_up_ns / 1e6, sim_lod_saved_ms(l));
+    if (len < 0 || (size_t)len >= n) return -1;
+    return len;
+}
@@ -0,0 +1,71 @@
+/*
+ * sim_lod.h — Level-of-detail tiers for pipe-mode probes
+ *
+ * A probe that no agent drives, that nothing is happening to, and that
+ * has no agent-driven probe nearby does not need its energy, travel and
+ * event rolls updated every tick. Such probes drop to the coarse tier.
+ * The tick skips them and brings them up to date in one aggregated
+ * step every cadence ticks. sim_lod_update() promotes a probe back to full
+ * as soon as an agent names it in a tick, an event or pending hazard
+ * targets it, or an attached probe comes within radius_ly.
+ *
+ * A cadence of 0 keeps every probe full, which is the default.
+ */
+#ifndef SIM_LOD_H
+#define SIM_LOD_H
+
+#include "universe.h"
+#include "events.h"
+
+#define SIM_LOD_RADIUS_DEFAULT  10.0f    /* ly */
+
+typedef enum {
+    TIER_FULL = 0,
+    TIER_COARSE
+} sim_lod_tier_t;
+
+typedef struct {
+    uint32_t cadence;                 /* coarse update interval; 0 = off */
+    float    radius_ly;               /* nearby-activity radius */
+
+    uint8_t  tier[MAX_PROBES];
+    bool     attached[MAX_PROBES];    /* named in the last tick's actions */
+    uint64_t synced[MAX_PROBES];      /* last tick applied to the probe */
+    uint64_t hot_until[MAX_PROBES];   /* kept full until this tick */
+    uint32_t known;                   /* probes with initialised entries */
+    uint64_t events_seen;             /* event seq already scanned up to */
+    uint32_t full_count;
+    uint32_t coarse_count;
+
+    /* Accounting since sim_lod_init() */
+    uint64_t full_probe_ticks;        /* probe-ticks simulated in full */
+    uint64_t coarse_probe_ticks;      /* probe-ticks deferred */
+    uint64_t catch_ups;               /* aggregated updates applied */
+    uint64_t full_ns;                 /* time in full per-probe updates */
+    uint64_t catch_up_ns;             /* time in aggregated updates */
+} sim_lod_t;
+
+/* Set the policy and clear all state and accounting. */
+void sim_lod_init(sim_lod_t *l, uint32_t cadence, float radius_ly);
+
+/* Forget per-probe state, as after a restore or load: every probe is
+ * full and in sync at tick. Accounting is kept. */
+void sim_lod_reset(sim_lod_t *l, uint64_t tick);
+
+/* Pick each probe's tier for the tick after u->tick, from attachment,
+ * events logged since the last call, pending hazards and proximity. */
+void sim_lod_update(sim_lod_t *l, const universe_t *u, const event_system_t *es);
+
+/* Ticks probe i must catch up before the next tick, or 0: any lag for a
+ * full probe, a whole cadence for a coarse one. */
+uint32_t sim_lod_due(const sim_lod_t *l, uint32_t i, uint64_t tick);
+
+/* Estimated time saved: deferred probe-ticks at the mean cost of a full
+ * one, less the time spent catching up. Never negative. */
+double sim_lod_saved_ms(const sim_lod_t *l);
+
+/* {"cadence":..,"radius_ly":..,"tiers":{..},"probe_ticks":{..},..} into
+ * buf. Returns the length, or -1 if it does not fit. */
+int sim_lod_format_json(const sim_lod_t *l, char *buf, size_t n);
+
+#endif /* SIM_LOD_H */
@@ -8,6 +8,7 @@
 #include "society.h"
 #include "generate.h"
 #include <string.h>
+#include <stdlib.h>
 #include <math.h>
 
 /* ---- Structure specs ---- */
@@ -30,33 +31,158 @@ void society_init(society_t *soc) {
     memset(soc, 0, sizeof(*soc));
 }
 
+void society_free(society_t *soc) {
+    rel_graph_free(&soc->relations);
+    free(soc->trade_unsaved);
+    soc->trade_unsaved = NULL;
+    soc->trade_unsaved_count = soc->trade_unsaved_cap = 0;
+}
+
 const structure_spec_t *structure_get_spec(structure_type_t type) {
     if (type < 0 || type >= STRUCT_TYPE_COUNT) return NULL;
     return &SPECS[type];
 }
 
-/* ---- Relationship helpers ---- */
+/* ---- Relationship graph ---- */
 
-/* Find existing relationship index in probe a toward b, or -1 */
-static int find_relationship(const probe_t *a, probe_uid_t b_id) {
-    for (int i = 0; i < a->relationship_count; i++) {
-        if (uid_eq(a->relationships[i].other_id, b_id))
-            return i;
+static uint32_t pair_hash(probe_uid_t a, probe_uid_t b) {
+    return uid_hash(a) ^ (uid_hash(b) * 0x9e3779b1u);
+}
+
+/* Edge index for owner → other, or -1 */
+static int find_edge(const rel_graph_t *g, probe_uid_t owner, probe_uid_t other) {
+    if (g->edge_slot_cap == 0) return -1;
+    uint32_t mask = g->edge_slot_cap - 1;
+    for (uint32_t i = pair_hash(owner, other) & mask; ; i = (i + 1) & mask) {
+        int32_t e = g->edge_slots[i];
+        if (e < 0) return -1;
+        if (uid_eq(g->edges[e].owner_id, owner) &&
+            uid_eq(g->edges[e].rel.other_id, other))
+            return e;
     }
-    return -1;
 }
 
-/* Find or create relationship slot */
-static relationship_t *get_or_create_rel(probe_t *a, probe_uid_t b_id) {
-    int idx = find_relationship(a, b_id);
-    if (idx >= 0) return &a->relationships[idx];
-    if (a->relationship_count >= MAX_RELATIONSHIPS) return NULL;
-    relationship_t *r = &a->relationships[a->relationship_count++];
-    memset(r, 0, sizeof(*r));
-    r->other_id = b_id;
-    r->trust = 0.0f;
-    r->disposition = 2;  /* neutral */
-    return r;
+static void edge_slot_insert(rel_graph_t *g, int e) {
+    uint32_t mask = g->edge_slot_cap - 1;
+    uint32_t i = pair_hash(g->edges[e].owner_id, g->edges[e].rel.other_id) & mask;
+    while (g->edge_slots[i] >= 0) i = (i + 1) & mask;
+    g->edge_slots[i] = e;
+}
+
+/* Keep the edge hash at most half full. Edges are never removed,
+ * so a rebuild from the edge array is all that's needed. */
+static int edge_slots_reserve(rel_graph_t *g, int edges) {
+    if ((uint32_t)edges * 2 <= g->edge_slot_cap) return 0;
+    uint32_t cap = g->edge_slot_cap ? g->edge_slot_cap : 256;
+    while ((uint32_t)edges * 2 > cap) cap *= 2;
+    int32_t *slots = malloc(cap * sizeof(*slots));
+    if (!slots) return -1;
+    memset(slots, 0xff, cap * sizeof(*slots));
+    free(g->edge_slots);
+    g->edge_slots = slots;
+    g->edge_slot_cap = cap;
+    for (int e = 0; e < g->edge_count; e++) edge_slot_insert(g, e);
+    return 0;
+}
+
+static int find_node(const rel_graph_t *g, probe_uid_t id) {
+    if (g->node_index_cap == 0) return -1;
+    return uidmap_get(g->node_index, g->node_index_cap, id);
+}
+
+static int get_or_create_node(rel_graph_t *g, probe_uid_t id) {
+    int n = find_node(g, id);
+    if (n >= 0) return n;
+
+    if (g->node_count >= g->node_cap) {
+        int cap = g->node_cap ? g->node_cap * 2 : 64;
+        rel_node_t *nodes = realloc(g->nodes, (size_t)cap * sizeof(*nodes));
+        if (!nodes) return -1;
+        g->nodes = nodes;
+        g->node_cap = cap;
+    }
+    if ((uint32_t)(g->node_count + 1) * 2 > g->node_index_cap) {
+        uint32_t cap = g->node_index_cap ? g->node_index_cap * 2 : 128;
+        uidmap_slot_t *idx = calloc(cap, sizeof(*idx));
+        if (!idx) return -1;
+        for (int i = 0; i < g->node_count; i++)
+            uidmap_put(idx, cap, g->nodes[i].id, i);
+        free(g->node_index);
+        g->node_index = idx;
+        g->node_index_cap = cap;
+    }
+
+    n = g->node_count++;
+    g->nodes[n].id = id;
+    g->nodes[n].first_edge = -1;
+    g->nodes[n].last_edge = -1;
+    g->nodes[n].degree = 0;
+    uidmap_put(g->node_index, g->node_index_cap, id, n);
+    return n;
+}
+
+/* Find or create edge owner → other (neutral, zero trust) */
+static relationship_t *get_or_create_rel(rel_graph_t *g, probe_uid_t owner,
+                                         probe_uid_t other) {
+    int e = find_edge(g, owner, other);
+    if (e >= 0) return &g->edges[e].rel;
+
+    int n = get_or_create_node(g, owner);
+    if (n < 0) return NULL;
+    if (g->edge_count >= g->edge_cap) {
+        int cap = g->edge_cap ? g->edge_cap * 2 : 128;
+        rel_edge_t *edges = realloc(g->edges, (size_t)cap * sizeof(*edges));
+        if (!edges) return NULL;
+        g->edges = edges;
+        g->edge_cap = cap;
+    }
+    if (edge_slots_reserve(g, g->edge_count + 1) != 0) return NULL;
+
+    e = g->edge_count++;
+    rel_edge_t *edge = &g->edges[e];
+    memset(edge, 0, sizeof(*edge));
+    edge->owner_id = owner;
+    edge->rel.other_id = other;
+    edge->rel.trust = 0.0f;
+    edge->rel.disposition = 2;  /* neutral */
+    edge->next = -1;
+    edge_slot_insert(g, e);
+
+    rel_node_t *node = &g->nodes[n];
+    if (node->last_edge >= 0) g->edges[node->last_edge].next = e;
+    else node->first_edge = e;
+    node->last_edge = e;
+    node->degree++;
+    return &edge->rel;
+}
+
+void rel_graph_free(rel_graph_t *g) {
+    free(g->edges);
+    free(g->edge_slots);
+    free(g->nodes);
+    free(g->node_index);
+    memset(g, 0, sizeof(*g));
+}
+
+int rel_graph_copy(rel_graph_t *dst, const rel_graph_t *src) {
+    rel_graph_free(dst);
+    if (src->edge_count == 0 && src->node_count == 0) return 0;
+
+    rel_graph_t g = *src;
+    g.edges = malloc((size_t)src->edge_cap * sizeof(*g.edges));
+    g.edge_slots = malloc(src->edge_slot_cap * sizeof(*g.edge_slots));
+    g.nodes = malloc((size_t)src->node_cap * sizeof(*g.nodes));
+    g.node_index = malloc(src->node_index_cap * sizeof(*g.node_index));
+    if (!g.edges || !g.edge_slots || !g.nodes || !g.node_index) {
+        rel_graph_free(&g);
+        return -1;
+    }
+    memcpy(g.edges, src->edges, (size_t)src->edge_count * sizeof(*g.edges));
+    memcpy(g.edge_slots, src->edge_slots, src->edge_slot_cap * sizeof(*g.edge_slots));
+    memcpy(g.nodes, src->nodes, (size_t)src->node_count * sizeof(*g.nodes));
+    memcpy(g.node_index, src->node_index, src->node_index_cap * sizeof(*g.node_index));
+    *dst = g;
+    return 0;
 }
 
 static float clampf(float v, float lo, float hi) {
@@ -65,139 +191,367 @@ static float clampf(float v, float lo, float hi) {
     return v;
 }
 
+static uint8_t trust_disposition(float trust) {
+    if (trust > 0.5f) return 1;        /* friendly */
+    if (trust > 0.2f) return 2;        /* neutral-positive */
+    if (trust > -0.2f) return 2;       /* neutral */
+    if (trust > -0.5f) return 3;       /* wary */
+    return 4;                          /* hostile */
+}
+
+static void apply_trust(rel_graph_t *g, relationship_t *r, float delta) {
+    float old = r->trust;
+    r->trust = clampf(r->trust + delta, -1.0f, 1.0f);
+    r->disposition = trust_disposition(r->trust);
+    g->trust_sum += (double)r->trust - (double)old;
+}
+
 /* ---- Relationships ---- */
 
-void society_update_trust(probe_t *a, probe_t *b, float delta) {
+int society_update_trust(society_t *soc, probe_uid_t a_id, probe_uid_t b_id,
+                         float delta) {
+    rel_graph_t *g = &soc->relations;
+
     /* Update a→b */
-    relationship_t *ra = get_or_create_rel(a, b->id);
-    if (ra) {
-        ra->trust = clampf(ra->trust + delta, -1.0f, 1.0f);
-        /* Update disposition based on trust */
-        if (ra->trust > 0.5f) ra->disposition = 1;       /* friendly */
-        else if (ra->trust > 0.2f) ra->disposition = 2;  /* neutral-positive */
-        else if (ra->trust > -0.2f) ra->disposition = 2;  /* neutral */
-        else if (ra->trust > -0.5f) ra->disposition = 3;  /* wary */
-        else ra->disposition = 4;                          /* hostile */
-    }
+    relationship_t *ra = get_or_create_rel(g, a_id, b_id);
+    if (!ra) return -1;
+    apply_trust(g, ra, delta);
 
     /* Update b→a (symmetric for now) */
-    relationship_t *rb = get_or_create_rel(b, a->id);
-    if (rb) {
-        rb->trust = clampf(rb->trust + delta, -1.0f, 1.0f);
-        if (rb->trust > 0.5f) rb->disposition = 1;
-        else if (rb->trust > 0.2f) rb->disposition = 2;
-        else if (rb->trust > -0.2f) rb->disposition = 2;
-        else if (rb->trust > -0.5f) rb->disposition = 3;
-        else rb->disposition = 4;
-    }
+    relationship_t *rb = get_or_create_rel(g, b_id, a_id);
+    if (!rb) return -1;
+    apply_trust(g, rb, delta);
+    return 0;
 }
 
-float society_get_trust(const probe_t *a, probe_uid_t b_id) {
-    int idx = find_relationship(a, b_id);
-    if (idx < 0) return 0.0f;
-    return a->relationships[idx].trust;
+const relationship_t *society_find_relationship(const society_t *soc,
+                                                probe_uid_t a_id,
+                                                probe_uid_t b_id) {
+    int e = find_edge(&soc->relations, a_id, b_id);
+    return e >= 0 ? &soc->relations.edges[e].rel : NULL;
 }
 
-uint8_t society_get_disposition(const probe_t *a, probe_uid_t b_id) {
-    int idx = find_relationship(a, b_id);
-    if (idx < 0) return 2;  /* neutral */
-    return a->relationships[idx].disposition;
+float society_get_trust(const society_t *soc, probe_uid_t a_id,
+                        probe_uid_t b_id) {
+    const relationship_t *r = society_find_relationship(soc, a_id, b_id);
+    return r ? r->trust : 0.0f;
+}
+
+uint8_t society_get_disposition(const society_t *soc, probe_uid_t a_id,
+                                probe_uid_t b_id) {
+    const relationship_t *r = society_find_relationship(soc, a_id, b_id);
+    return r ? r->disposition : 2;  /* neutral */
+}
+
+int society_set_relationship(society_t *soc, probe_uid_t owner_id,
+                             const relationship_t *rel) {
+    rel_graph_t *g = &soc->relations;
+    relationship_t *r = get_or_create_rel(g, owner_id, rel->other_id);
+    if (!r) return -1;
+    g->trust_sum += (double)rel->trust - (double)r->trust;
+    *r = *rel;
+    return 0;
+}
+
+int society_relationship_count(const society_t *soc, probe_uid_t a_id) {
+    int n = find_node(&soc->relations, a_id);
+    return n >= 0 ? soc->relations.nodes[n].degree : 0;
+}
+
+int society_first_relationship(const society_t *soc, probe_uid_t a_id) {
+    int n = find_node(&soc->relations, a_id);
+    return n >= 0 ? soc->relations.nodes[n].first_edge : -1;
+}
+
+int society_next_relationship(const society_t *soc, int edge) {
+    if (edge < 0 || edge >= soc->relations.edge_count) return -1;
+    return soc->relations.edges[edge].next;
+}
+
+const relationship_t *society_relationship_at(const society_t *soc, int edge) {
+    if (edge < 0 || edge >= soc->relations.edge_count) return NULL;
+    return &soc->relations.edges[edge].rel;
+}
+
+float society_avg_trust(const society_t *soc) {
+    const rel_graph_t *g = &soc->relations;
+    return g->edge_count > 0 ? (float)(g->trust_sum / g->edge_count) : 0.0f;
 }
 
 /* ---- Resource trading ---- */
 
+/* Heap order: earlier arrival first, ties by send order */
+static bool trade_before(const society_t *soc, int a, int b) {
+    const trade_t *ta = &soc->trades[a];
+    const trade_t *tb = &soc->trades[b];
+    if (ta->arrival_tick != tb->arrival_tick)
+        return ta->arrival_tick < tb->arrival_tick;
+    return ta->id < tb->id;
+}
+
+static void trade_heap_push(society_t *soc, int slot) {
+    int32_t *h = soc->trade_heap;
+    int i = soc->trade_count++;
+    h[i] = slot;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!trade_before(soc, h[i], h[parent])) break;
+        int32_t tmp = h[i]; h[i] = h[parent]; h[parent] = tmp;
+        i = parent;
+    }
+}
+
+static int trade_heap_pop(society_t *soc) {
+    int32_t *h = soc->trade_heap;
+    int top = h[0];
+    int n = --soc->trade_count;
+    h[0] = h[n];
+    int i = 0;
+    for (;;) {
+        int l = 2 * i + 1, r = l + 1, m = i;
+        if (l < n && trade_before(soc, h[l], h[m])) m = l;
+        if (r < n && trade_before(soc, h[r], h[m])) m = r;
+        if (m == i) break;
+        int32_t tmp = h[i]; h[i] = h[m]; h[m] = tmp;
+        i = m;
+    }
+    return top;
+}
+
+static int trade_party_find(const society_t *soc, probe_uid_t id) {
+    return uidmap_get(soc->trade_party_index, TRADE_PARTY_INDEX_CAP, id);
+}
+
+static int trade_party_get(society_t *soc, probe_uid_t id) {
+    int pi = trade_party_find(soc, id);
+    if (pi >= 0) return pi;
+    if (soc->trade_party_count >= MAX_TRADE_PARTIES) return -1;
+    pi = soc->trade_party_count++;
+    trade_party_t *party = &soc->trade_parties[pi];
+    party->id = id;
+    party->head = party->tail = -1;
+    party->pending = 0;
+    uidmap_put(soc->trade_party_index, TRADE_PARTY_INDEX_CAP, id, pi);
+    return pi;
+}
+
+/* Which of the trade's two list links belongs to probe_id */
+static int trade_side(const trade_t *t, probe_uid_t probe_id) {
+    return uid_eq(t->sender_id, probe_id) ? 0 : 1;
+}
+
+static void trade_link(society_t *soc, int pi, int slot, int side) {
+    trade_party_t *party = &soc->trade_parties[pi];
+    trade_t *t = &soc->trades[slot];
+    t->link_next[side] = -1;
+    t->link_prev[side] = party->tail;
+    if (party->tail >= 0) {
+        trade_t *last = &soc->trades[party->tail];
+        last->link_next[trade_side(last, party->id)] = slot;
+    } else {
+        party->head = slot;
+    }
+    party->tail = slot;
+    party->pending++;
+}
+
+static void trade_unlink(society_t *soc, probe_uid_t probe_id, int slot) {
+    int pi = trade_party_find(soc, probe_id);
+    if (pi < 0) return;
+    trade_party_t *party = &soc->trade_parties[pi];
+    trade_t *t = &soc->trades[slot];
+    int side = trade_side(t, probe_id);
+    int prev = t->link_prev[side], next = t->link_next[side];
+    if (prev >= 0) {
+        trade_t *tp = &soc->trades[prev];
+        tp->link_next[trade_side(tp, probe_id)] = next;
+    } else {
+        party->head = next;
+    }
+    if (next >= 0) {
+        trade_t *tn = &soc->trades[next];
+        tn->link_prev[trade_side(tn, probe_id)] = prev;
+    } else {
+        party->tail = prev;
+    }
+    party->pending--;
+}
+
+/* Probe array slot for id. The cache is rebuilt when it misses or is
+ * stale (probes array grew, or a restore put a different probe there).
+ * A probe count that has not changed proves nothing: a restore can swap
+ * every probe in place, so a miss always rebuilds before giving up. */
+static int trade_find_probe(society_t *soc, probe_t *probes, int probe_count,
+                            probe_uid_t id) {
+    int idx = uidmap_get(soc->probe_slot_index, PROBE_SLOT_INDEX_CAP, id);
+    if (idx >= 0 && idx < probe_count && uid_eq(probes[idx].id, id))
+        return idx;
+
+    memset(soc->probe_slot_index, 0, sizeof(soc->probe_slot_index));
+    for (int p = 0; p < probe_count; p++)
+        uidmap_put(soc->probe_slot_index, PROBE_SLOT_INDEX_CAP, probes[p].id, p);
+    idx = uidmap_get(soc->probe_slot_index, PROBE_SLOT_INDEX_CAP, id);
+    return idx;
+}
+
 int society_trade_send(society_t *soc, probe_t *sender, probe_t *receiver,
                        resource_t resource, double amount,
                        bool same_system, uint64_t current_tick) {
     if (soc->trade_count >= MAX_TRADES) return -1;
     if (sender->resources[resource] < amount) return -1;
 
+    int sp = trade_party_get(soc, sender->id);
+    int rp = trade_party_get(soc, receiver->id);
+    if (sp < 0 || rp < 0) return -1;
+
     /* Deduct from sender immediately */
     sender->resources[resource] -= amount;
 
-    trade_t *t = &soc->trades[soc->trade_count++];
+    int slot = soc->trade_free_count > 0
+             ? soc->trade_free[--soc->trade_free_count]
+             : soc->trade_slots_used++;
+    trade_t *t = &soc->trades[slot];
+    memset(t, 0, sizeof(*t));
+    t->id = ++soc->trade_next_id;
     t->sender_id = sender->id;
     t->receiver_id = receiver->id;
     t->resource = resource;
     t->amount = amount;
-    t->status = same_system ? TRADE_IN_TRANSIT : TRADE_IN_TRANSIT;
+    t->status = TRADE_IN_TRANSIT;
     t->sent_tick = current_tick;
     t->same_system = same_system;
     t->arrival_tick = same_system ? current_tick : current_tick + TRADE_TRANSIT_TICKS;
 
+    trade_link(soc, sp, slot, 0);
+    if (rp != sp) trade_link(soc, rp, slot, 1);
+    trade_heap_push(soc, slot);
     return 0;
 }
 
+/* Keep a settled trade until the next save. On allocation failure the
+ * trade is only in the ring, as before. */
+static void trade_unsaved_push(society_t *soc, const trade_t *t) {
+    if (soc->trade_unsaved_count == soc->trade_unsaved_cap) {
+        int cap = soc->trade_unsaved_cap ? soc->trade_unsaved_cap * 2 : 64;
+        trade_t *grown = realloc(soc->trade_unsaved, (size_t)cap * sizeof(*grown));
+        if (!grown) return;
+        soc->trade_unsaved = grown;
+        soc->trade_unsaved_cap = cap;
+    }
+    soc->trade_unsaved[soc->trade_unsaved_count++] = *t;
+}
+
 int society_trade_tick(society_t *soc, probe_t *probes, int probe_count,
                        uint64_t current_tick) {
     int delivered = 0;
-    for (int i = 0; i < soc->trade_count; i++) {
-        trade_t *t = &soc->trades[i];
-        if (t->status != TRADE_IN_TRANSIT) continue;
-        if (current_tick < t->arrival_tick) continue;
-
-        /* Find receiver probe */
-        for (int p = 0; p < probe_count; p++) {
-            if (uid_eq(probes[p].id, t->receiver_id)) {
-                probes[p].resources[t->resource] += t->amount;
-                t->status = TRADE_DELIVERED;
-                delivered++;
-                break;
-            }
+    while (soc->trade_count > 0 &&
+           soc->trades[soc->trade_heap[0]].arrival_tick <= current_tick) {
+        int slot = trade_heap_pop(soc);
+        trade_t *t = &soc->trades[slot];
+
+        int r = trade_find_probe(soc, probes, probe_count, t->receiver_id);
+        if (r >= 0) {
+            probes[r].resources[t->resource] += t->amount;
+            t->status = TRADE_DELIVERED;
+            delivered++;
+        } else {
+            int s = trade_find_probe(soc, probes, probe_count, t->sender_id);
+            if (s >= 0) probes[s].resources[t->resource] += t->amount;
+            t->status = TRADE_CANCELLED;
         }
+
+        trade_unlink(soc, t->sender_id, slot);
+        if (!uid_eq(t->sender_id, t->receiver_id))
+            trade_unlink(soc, t->receiver_id, slot);
+
+        soc->trade_history[soc->trade_archived % TRADE_HISTORY_CAP] = *t;
+        soc->trade_archived++;
+        trade_unsaved_push(soc, t);
+        soc->trade_free[soc->trade_free_count++] = slot;
     }
     return delivered;
 }
 
+int society_first_pending_trade(const society_t *soc, probe_uid_t probe_id) {
+    int pi = trade_party_find(soc, probe_id);
+    return pi >= 0 ? soc->trade_parties[pi].head : -1;
+}
+
+int society_next_pending_trade(const society_t *soc, probe_uid_t probe_id,
+                               int slot) {
+    if (slot < 0 || slot >= soc->trade_slots_used) return -1;
+    const trade_t *t = &soc->trades[slot];
+    return t->link_next[trade_side(t, probe_id)];
+}
+
+int society_pending_trade_count(const society_t *soc, probe_uid_t probe_id) {
+    int pi = trade_party_find(soc, probe_id);
+    return pi >= 0 ? soc->trade_parties[pi].pending : 0;
+}
+
+int society_trade_history_count(const society_t *soc) {
+    return soc->trade_archived < TRADE_HISTORY_CAP
+         ? (int)soc->trade_archived : TRADE_HISTORY_CAP;
+}
+
+const trade_t *society_trade_history_at(const society_t *soc, int i) {
+    if (i < 0 || i >= society_trade_history_count(soc)) return NULL;
+    return &soc->trade_history[(soc->trade_archived - 1 - (uint64_t)i)
+                               % TRADE_HISTORY_CAP];
+}
+
+const trade_t *society_trade_unsaved(const society_t *soc, int *count) {
+    *count = soc->trade_unsaved_count;
+    return soc->trade_unsaved_count > 0 ? soc->trade_unsaved : NULL;
+}
+
+void society_trade_unsaved_clear(society_t *soc) {
+    soc->trade_unsaved_count = 0;
+}
+
 /* ---- Territory claims ---- */
 
 int society_claim_system(society_t *soc, probe_uid_t claimer_id,
                          probe_uid_t system_id, uint64_t tick) {
     /* Check if already claimed */
-    for (int i = 0; i < soc->claim_count; i++) {
-        if (soc->claims[i].active && uid_eq(soc->claims[i].system_id, system_id))
-            return -1;
-    }
+    if (uidmap_get(soc->claim_index, CLAIM_INDEX_CAP, system_id) >= 0)
+        return -1;
     if (soc->claim_count >= MAX_CLAIMS) return -1;
 
-    claim_t *c = &soc->claims[soc->claim_count++];
+    int idx = soc->claim_count++;
+    claim_t *c = &soc->claims[idx];
     c->claimer_id = claimer_id;
     c->system_id = system_id;
     c->claimed_tick = tick;
     c->active = true;
+    uidmap_put(soc->claim_index, CLAIM_INDEX_CAP, system_id, idx);
     return 0;
 }
 
+const claim_t *society_find_claim(const society_t *soc, probe_uid_t system_id) {
+    int idx = uidmap_get(soc->claim_index, CLAIM_INDEX_CAP, system_id);
+    return idx >= 0 ? &soc->claims[idx] : NULL;
+}
+
 probe_uid_t society_get_claim(const society_t *soc, probe_uid_t system_id) {
-    for (int i = 0; i < soc->claim_count; i++) {
-        if (soc->claims[i].active && uid_eq(soc->claims[i].system_id, system_id))
-            return soc->claims[i].claimer_id;
-    }
-    return uid_null();
+    const claim_t *c = society_find_claim(soc, system_id);
+    return c ? c->claimer_id : uid_null();
 }
 
 int society_revoke_claim(society_t *soc, probe_uid_t claimer_id,
                          probe_uid_t system_id) {
-    for (int i = 0; i < soc->claim_count; i++) {
-        if (soc->claims[i].active &&
-            uid_eq(soc->claims[i].claimer_id, claimer_id) &&
-            uid_eq(soc->claims[i].system_id, system_id)) {
-            soc->claims[i].active = false;
-            return 0;
-        }
-    }
-    return -1;
+    int idx = uidmap_get(soc->claim_index, CLAIM_INDEX_CAP, system_id);
+    if (idx < 0 || !uid_eq(soc->claims[idx].claimer_id, claimer_id))
+        return -1;
+    soc->claims[idx].active = false;
+    uidmap_del(soc->claim_index, CLAIM_INDEX_CAP, system_id);
+    return 0;
 }
 
 bool society_is_claimed_by_other(const society_t *soc, probe_uid_t system_id,
                                   probe_uid_t probe_id) {
-    for (int i = 0; i < soc->claim_count; i++) {
-        if (soc->claims[i].active &&
-            uid_eq(soc->claims[i].system_id, system_id) &&
-            !uid_eq(soc->claims[i].claimer_id, probe_id))
-            return true;
-    }
-    return false;
+    const claim_t *c = society_find_claim(soc, system_id);
+    return c && !uid_eq(c->claimer_id, probe_id);
 }
 
 /* ---- Shared construction ---- */
@@ -230,9 +584,28 @@ int society_build_start(society_t *soc, probe_t *builder,
     s->active = false;
     s->started_tick = current_tick;
 
+    /* Append to the system's structure chain, keeping build order */
+    soc->structure_next[idx] = -1;
+    int tail = uidmap_get(soc->structure_index, STRUCT_INDEX_CAP, system_id);
+    if (tail < 0) {
+        uidmap_put(soc->structure_index, STRUCT_INDEX_CAP, system_id, idx);
+    } else {
+        while (soc->structure_next[tail] >= 0) tail = soc->structure_next[tail];
+        soc->structure_next[tail] = idx;
+    }
+
     return idx;
 }
 
+int society_first_structure(const society_t *soc, probe_uid_t system_id) {
+    return uidmap_get(soc->structure_index, STRUCT_INDEX_CAP, system_id);
+}
+
+int society_next_structure(const society_t *soc, int idx) {
+    if (idx < 0 || idx >= soc->structure_count) return -1;
+    return soc->structure_next[idx];
+}
+
 int society_build_collaborate(society_t *soc, int structure_idx,
                               probe_t *collaborator) {
     if (structure_idx < 0 || structure_idx >= soc->structure_count) return -1;
@@ -267,39 +640,129 @@ int society_build_tick(society_t *soc, uint64_t current_tick) {
 
 /* ---- Voting ---- */
 
+static bool proposal_before(const society_t *soc, int a, int b) {
+    uint64_t da = soc->proposals[a].deadline_tick;
+    uint64_t db = soc->proposals[b].deadline_tick;
+    return da != db ? da < db : a < b;
+}
+
+static void proposal_heap_push(society_t *soc, int idx) {
+    int32_t *h = soc->proposal_heap;
+    int i = soc->proposal_open++;
+    h[i] = idx;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!proposal_before(soc, h[i], h[parent])) break;
+        int32_t tmp = h[i]; h[i] = h[parent]; h[parent] = tmp;
+        i = parent;
+    }
+}
+
+static int proposal_heap_pop(society_t *soc) {
+    int32_t *h = soc->proposal_heap;
+    int top = h[0];
+    int n = --soc->proposal_open;
+    h[0] = h[n];
+    int i = 0;
+    for (;;) {
+        int l = 2 * i + 1, r = l + 1, m = i;
+        if (l < n && proposal_before(soc, h[l], h[m])) m = l;
+        if (r < n && proposal_before(soc, h[r], h[m])) m = r;
+        if (m == i) break;
+        int32_t tmp = h[i]; h[i] = h[m]; h[m] = tmp;
+        i = m;
+    }
+    return top;
+}
+
+/* Rebuild voter_index from the slots in use, dropping tombstones */
+static void voter_index_rebuild(society_t *soc) {
+    memset(soc->voter_index, 0, sizeof(soc->voter_index));
+    for (int v = 0; v < soc->voter_count; v++)
+        if (soc->voter_refs[v] > 0)
+            uidmap_put(soc->voter_index, VOTER_INDEX_CAP, soc->voter_ids[v], v);
+    soc->voter_index_dead = 0;
+}
+
+/* Small integer for a voter, held while an open proposal has its vote */
+static int voter_slot(society_t *soc, probe_uid_t voter_id) {
+    int slot = uidmap_get(soc->voter_index, VOTER_INDEX_CAP, voter_id);
+    if (slot >= 0) return slot;
+    if (soc->voter_free_count > 0)
+        slot = soc->voter_free[--soc->voter_free_count];
+    else if (soc->voter_count < MAX_VOTERS)
+        slot = soc->voter_count++;
+    else
+        return -1;
+    soc->voter_ids[slot] = voter_id;
+    uidmap_put(soc->voter_index, VOTER_INDEX_CAP, voter_id, slot);
+    return slot;
+}
+
+static void voter_release(society_t *soc, int slot) {
+    if (--soc->voter_refs[slot] > 0) return;
+    uidmap_del(soc->voter_index, VOTER_INDEX_CAP, soc->voter_ids[slot]);
+    soc->voter_free[soc->voter_free_count++] = slot;
+    if (++soc->voter_index_dead > VOTER_INDEX_CAP / 4)
+        voter_index_rebuild(soc);
+}
+
 int society_propose(society_t *soc, probe_uid_t proposer_id,
                     const char *text, uint64_t current_tick,
                     uint64_t deadline_tick) {
-    if (soc->proposal_count >= MAX_PROPOSALS) return -1;
+    int idx, handle;
+    if (soc->proposal_count < MAX_PROPOSALS) {
+        idx = soc->proposal_count++;
+        handle = idx;
+    } else if (soc->proposal_reuse_count > 0) {
+        idx = soc->proposal_reuse[soc->proposal_reuse_head];
+        soc->proposal_reuse_head = (soc->proposal_reuse_head + 1) % MAX_PROPOSALS;
+        soc->proposal_reuse_count--;
+        /* Next generation of the slot, wrapping before int overflow */
+        handle = soc->proposals[idx].handle;
+        handle = handle < INT32_MAX - MAX_PROPOSALS ? handle + MAX_PROPOSALS
+                                                    : idx;
+    } else {
+        return -1;
+    }
 
-    int idx = soc->proposal_count++;
     proposal_t *p = &soc->proposals[idx];
     memset(p, 0, sizeof(*p));
+    p->handle = handle;
     p->proposer_id = proposer_id;
     strncpy(p->text, text, MAX_PROPOSAL_TEXT - 1);
     p->proposed_tick = current_tick;
     p->deadline_tick = deadline_tick;
     p->status = VOTE_OPEN;
+    proposal_heap_push(soc, idx);
 
-    return idx;
+    return handle;
+}
+
+int society_proposal_slot(const society_t *soc, int handle) {
+    if (handle < 0) return -1;
+    int idx = handle % MAX_PROPOSALS;
+    if (idx >= soc->proposal_count) return -1;
+    return soc->proposals[idx].handle == handle ? idx : -1;
 }
 
-int society_vote(society_t *soc, int proposal_idx,
+int society_vote(society_t *soc, int handle,
                  probe_uid_t voter_id, bool in_favor, uint64_t tick) {
-    if (proposal_idx < 0 || proposal_idx >= soc->proposal_count) return -1;
-    proposal_t *p = &soc->proposals[proposal_idx];
+    (void)tick;
+    int idx = society_proposal_slot(soc, handle);
+    if (idx < 0) return -1;
+    proposal_t *p = &soc->proposals[idx];
     if (p->status != VOTE_OPEN) return -1;
-    if (p->vote_count >= MAX_VOTES_PER) return -1;
 
-    /* Check for duplicate vote */
-    for (int i = 0; i < p->vote_count; i++) {
-        if (uid_eq(p->votes[i].voter_id, voter_id)) return -1;
-    }
+    int slot = voter_slot(soc, voter_id);
+    if (slot < 0) return -1;
 
-    vote_t *v = &p->votes[p->vote_count++];
-    v->voter_id = voter_id;
-    v->in_favor = in_favor;
-    v->vote_tick = tick;
+    /* Check for duplicate vote */
+    uint64_t bit = 1ULL << (slot % 64);
+    if (p->voted[slot / 64] & bit) return -1;
+    p->voted[slot / 64] |= bit;
+    p->vote_count++;
+    soc->voter_refs[slot]++;
 
     if (in_favor) p->votes_for++;
     else p->votes_against++;
@@ -309,14 +772,27 @@ int society_vote(society_t *soc, int proposal_idx,
 
 int society_resolve_votes(society_t *soc, uint64_t current_tick) {
     int resolved = 0;
-    for (int i = 0; i < soc->proposal_count; i++) {
-        proposal_t *p = &soc->proposals[i];
-        if (p->status != VOTE_OPEN) continue;
-        if (current_tick < p->deadline_tick) continue;
+    while (soc->proposal_open > 0 &&
+           soc->proposals[soc->proposal_heap[0]].deadline_tick <= current_tick) {
+        int idx = proposal_heap_pop(soc);
+        proposal_t *p = &soc->proposals[idx];
 
         p->status = VOTE_RESOLVED;
         p->result = (p->votes_for > p->votes_against);
         resolved++;
+
+        /* Its voters no longer need their slots for this proposal */
+        for (int w = 0; w < VOTER_WORDS; w++) {
+            if (!p->voted[w]) continue;
+            for (int b = 0; b < 64; b++)
+                if (p->voted[w] & (1ULL << b)) voter_release(soc, w * 64 + b);
+            p->voted[w] = 0;
+        }
+
+        int tail = (soc->proposal_reuse_head + soc->proposal_reuse_count)
+                 % MAX_PROPOSALS;
+        soc->proposal_reuse[tail] = idx;
+        soc->proposal_reuse_count++;
     }
     return resolved;
 }
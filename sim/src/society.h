@@ -3,16 +3,27 @@
 
 #include "universe.h"
 #include "rng.h"
+#include "uidmap.h"
 
 /* ---- Constants ---- */
 
 #define MAX_CLAIMS        512
 #define MAX_STRUCTURES    256
-#define MAX_TRADES        256
-#define MAX_PROPOSALS     128
-#define MAX_VOTES_PER     16
+#define MAX_TRADES        1024  /* in-flight trades; slots are recycled */
+#define TRADE_HISTORY_CAP  512  /* archived trades kept in memory */
+#define MAX_TRADE_PARTIES MAX_PROBES
+#define MAX_PROPOSALS     128   /* open or recently resolved; slots recycled */
+#define MAX_VOTERS        MAX_PROBES
+#define VOTER_WORDS       ((MAX_VOTERS + 63) / 64)
 #define MAX_PROPOSAL_TEXT 256
 
+/* System-keyed index sizes (power of two, >= 2x entries ever inserted) */
+#define CLAIM_INDEX_CAP     1024
+#define STRUCT_INDEX_CAP     512
+#define TRADE_PARTY_INDEX_CAP (2 * MAX_TRADE_PARTIES)
+#define PROBE_SLOT_INDEX_CAP  (2 * MAX_PROBES)
+#define VOTER_INDEX_CAP       (2 * MAX_VOTERS)
+
 /* Trust deltas */
 #define TRUST_TRADE_POSITIVE   0.05f
 #define TRUST_SHARED_DISCOVERY 0.03f
@@ -78,6 +89,7 @@ typedef enum {
 } trade_status_t;
 
 typedef struct {
+    uint64_t       id;             /* monotonically increasing, from 1 */
     probe_uid_t    sender_id;
     probe_uid_t    receiver_id;
     resource_t     resource;
@@ -86,8 +98,19 @@ typedef struct {
     uint64_t       sent_tick;
     uint64_t       arrival_tick;   /* same-system = instant, otherwise light delay */
     bool           same_system;
+    /* Per-probe pending lists: [0] links the sender's, [1] the receiver's */
+    int32_t        link_next[2];
+    int32_t        link_prev[2];
 } trade_t;
 
+/* A probe with at least one trade ever; heads its pending-trade list */
+typedef struct {
+    probe_uid_t id;
+    int32_t     head;              /* oldest pending trade slot, -1 if none */
+    int32_t     tail;
+    int32_t     pending;
+} trade_party_t;
+
 /* ---- Voting / Proposals ---- */
 
 typedef enum {
@@ -97,24 +120,53 @@ typedef enum {
 } proposal_status_t;
 
 typedef struct {
-    probe_uid_t voter_id;
-    bool        in_favor;
-    uint64_t    vote_tick;
-} vote_t;
-
-typedef struct {
+    int               handle;          /* generation * MAX_PROPOSALS + slot */
     probe_uid_t       proposer_id;
     char              text[MAX_PROPOSAL_TEXT];
     uint64_t          proposed_tick;
     uint64_t          deadline_tick;   /* resolve after this */
     proposal_status_t status;
-    vote_t            votes[MAX_VOTES_PER];
+    /* One bit per voter slot (see society_t.voter_index) */
+    uint64_t          voted[VOTER_WORDS];
     int               vote_count;
     int               votes_for;
     int               votes_against;
     bool              result;          /* true = passed */
 } proposal_t;
 
+/* ---- Relationship graph ---- */
+
+/* Directed edge owner → rel.other_id. Each probe's edges form a singly
+ * linked adjacency list in insertion order. */
+typedef struct {
+    probe_uid_t    owner_id;
+    relationship_t rel;
+    int32_t        next;           /* next edge of the same owner, -1 at end */
+} rel_edge_t;
+
+typedef struct {
+    probe_uid_t id;
+    int32_t     first_edge;
+    int32_t     last_edge;
+    int32_t     degree;
+} rel_node_t;
+
+/* Sparse trust graph. Storage is heap-backed and grows on demand; a
+ * zeroed struct is a valid empty graph. */
+typedef struct {
+    rel_edge_t    *edges;
+    int            edge_count;
+    int            edge_cap;
+    int32_t       *edge_slots;     /* (owner, other) hash → edge, -1 empty */
+    uint32_t       edge_slot_cap;
+    rel_node_t    *nodes;
+    int            node_count;
+    int            node_cap;
+    uidmap_slot_t *node_index;     /* owner → node */
+    uint32_t       node_index_cap;
+    double         trust_sum;      /* running sum over all edges */
+} rel_graph_t;
+
 /* ---- Society system ---- */
 
 typedef struct {
@@ -122,10 +174,55 @@ typedef struct {
     int          claim_count;
     structure_t  structures[MAX_STRUCTURES];
     int          structure_count;
+    /* system_id → active claim index */
+    uidmap_slot_t claim_index[CLAIM_INDEX_CAP];
+    /* system_id → first structure index, chained through structure_next */
+    uidmap_slot_t structure_index[STRUCT_INDEX_CAP];
+    int          structure_next[MAX_STRUCTURES];
+    /* Trade ledger: slots are recycled through trade_free once a trade
+     * settles; trade_heap orders live slots by (arrival_tick, id). */
     trade_t      trades[MAX_TRADES];
-    int          trade_count;
+    int          trade_count;      /* live (in-flight) trades */
+    int          trade_slots_used; /* high-water mark into trades[] */
+    int32_t      trade_free[MAX_TRADES];
+    int          trade_free_count;
+    int32_t      trade_heap[MAX_TRADES];
+    uint64_t     trade_next_id;
+    /* probe_id → trade_parties index */
+    trade_party_t trade_parties[MAX_TRADE_PARTIES];
+    int          trade_party_count;
+    uidmap_slot_t trade_party_index[TRADE_PARTY_INDEX_CAP];
+    /* Settled trades, ring buffer; trade_archived is the running total */
+    trade_t      trade_history[TRADE_HISTORY_CAP];
+    uint64_t     trade_archived;
+    /* Settled trades not yet written by persist_save_trade_history; grows
+     * past the ring so nothing is lost between saves */
+    trade_t     *trade_unsaved;
+    int          trade_unsaved_count;
+    int          trade_unsaved_cap;
+    /* probe_id → slot in the probes array passed to trade_tick (cache) */
+    uidmap_slot_t probe_slot_index[PROBE_SLOT_INDEX_CAP];
+    /* Proposals: open ones sit in proposal_heap ordered by deadline;
+     * resolved slots queue up in proposal_reuse and are handed out again,
+     * oldest first, once the array is full. */
     proposal_t   proposals[MAX_PROPOSALS];
-    int          proposal_count;
+    int          proposal_count;   /* high-water mark into proposals[] */
+    int32_t      proposal_heap[MAX_PROPOSALS];
+    int          proposal_open;
+    int32_t      proposal_reuse[MAX_PROPOSALS];
+    int          proposal_reuse_head;
+    int          proposal_reuse_count;
+    /* voter probe_id → voter slot (bit index into proposal_t.voted).
+     * voter_refs counts the open proposals a slot has voted on; the slot
+     * goes back on voter_free when the last of them resolves. */
+    uidmap_slot_t voter_index[VOTER_INDEX_CAP];
+    int          voter_index_dead; /* tombstones in voter_index */
+    probe_uid_t  voter_ids[MAX_VOTERS];
+    uint16_t     voter_refs[MAX_VOTERS];
+    int32_t      voter_free[MAX_VOTERS];
+    int          voter_free_count;
+    int          voter_count;      /* high-water mark into voter_ids[] */
+    rel_graph_t  relations;
 } society_t;
 
 /* ---- API ---- */
@@ -133,20 +230,54 @@ typedef struct {
 /* Initialize society system */
 void society_init(society_t *soc);
 
+/* Release heap storage owned by the society (relationship graph). */
+void society_free(society_t *soc);
+
 /* Get structure spec for a type */
 const structure_spec_t *structure_get_spec(structure_type_t type);
 
 /* ---- Relationships ---- */
 
-/* Update trust between two probes. Finds or creates relationship.
- * delta is added to trust, clamped to [-1, 1]. */
-void society_update_trust(probe_t *a, probe_t *b, float delta);
+/* Update trust between two probes. Finds or creates both directed edges.
+ * delta is added to trust, clamped to [-1, 1]. Returns 0, or -1 on OOM. */
+int society_update_trust(society_t *soc, probe_uid_t a_id, probe_uid_t b_id,
+                         float delta);
 
 /* Get trust from a toward b. Returns 0 if no relationship. */
-float society_get_trust(const probe_t *a, probe_uid_t b_id);
+float society_get_trust(const society_t *soc, probe_uid_t a_id,
+                        probe_uid_t b_id);
 
 /* Get disposition from a toward b. */
-uint8_t society_get_disposition(const probe_t *a, probe_uid_t b_id);
+uint8_t society_get_disposition(const society_t *soc, probe_uid_t a_id,
+                                probe_uid_t b_id);
+
+/* Relationship a → b, or NULL if they have never interacted. */
+const relationship_t *society_find_relationship(const society_t *soc,
+                                                probe_uid_t a_id,
+                                                probe_uid_t b_id);
+
+/* Insert or overwrite the directed edge owner → rel->other_id verbatim
+ * (used by persistence). Returns 0, or -1 on OOM. */
+int society_set_relationship(society_t *soc, probe_uid_t owner_id,
+                             const relationship_t *rel);
+
+/* Number of probes a has a relationship with. */
+int society_relationship_count(const society_t *soc, probe_uid_t a_id);
+
+/* First edge index in a's adjacency list, or -1. Walk with
+ * society_next_relationship and read via society_relationship_at. */
+int society_first_relationship(const society_t *soc, probe_uid_t a_id);
+int society_next_relationship(const society_t *soc, int edge);
+const relationship_t *society_relationship_at(const society_t *soc, int edge);
+
+/* Average trust over all directed relationships. O(1). */
+float society_avg_trust(const society_t *soc);
+
+/* Deep-copy a relationship graph (dst is freed first). Returns 0 or -1. */
+int rel_graph_copy(rel_graph_t *dst, const rel_graph_t *src);
+
+/* Free a relationship graph and zero it. */
+void rel_graph_free(rel_graph_t *g);
 
 /* ---- Resource trading ---- */
 
@@ -156,10 +287,33 @@ int society_trade_send(society_t *soc, probe_t *sender, probe_t *receiver,
                        resource_t resource, double amount,
                        bool same_system, uint64_t current_tick);
 
-/* Deliver pending trades. Returns count delivered. */
+/* Deliver trades whose arrival tick has passed, in arrival order.
+ * A trade whose receiver is gone is cancelled and refunded to the sender.
+ * Settled trades are archived and their slots recycled.
+ * Returns count delivered. */
 int society_trade_tick(society_t *soc, probe_t *probes, int probe_count,
                        uint64_t current_tick);
 
+/* Walk a probe's pending trades (sent or received), oldest first.
+ * Returns a trades[] slot, or -1 at the end. */
+int society_first_pending_trade(const society_t *soc, probe_uid_t probe_id);
+int society_next_pending_trade(const society_t *soc, probe_uid_t probe_id,
+                               int slot);
+
+/* Number of pending trades a probe is party to. */
+int society_pending_trade_count(const society_t *soc, probe_uid_t probe_id);
+
+/* i-th most recent archived trade (0 = newest), or NULL. */
+const trade_t *society_trade_history_at(const society_t *soc, int i);
+
+/* Number of archived trades still held in memory. */
+int society_trade_history_count(const society_t *soc);
+
+/* Settled trades since the last society_trade_unsaved_clear, oldest first.
+ * Sets *count and returns the array (NULL when empty). */
+const trade_t *society_trade_unsaved(const society_t *soc, int *count);
+void society_trade_unsaved_clear(society_t *soc);
+
 /* ---- Territory claims ---- */
 
 /* Claim a system. Returns 0 on success, -1 if already claimed. */
@@ -169,6 +323,9 @@ int society_claim_system(society_t *soc, probe_uid_t claimer_id,
 /* Check who claims a system. Returns claimer ID, or null if unclaimed. */
 probe_uid_t society_get_claim(const society_t *soc, probe_uid_t system_id);
 
+/* Active claim on a system, or NULL if unclaimed. */
+const claim_t *society_find_claim(const society_t *soc, probe_uid_t system_id);
+
 /* Revoke a claim. Returns 0 on success. */
 int society_revoke_claim(society_t *soc, probe_uid_t claimer_id,
                          probe_uid_t system_id);
@@ -195,18 +352,34 @@ int society_build_tick(society_t *soc, uint64_t current_tick);
 /* Get build speed multiplier for number of builders */
 float society_build_speed_mult(int builder_count);
 
+/* First structure index in a system, or -1 if none. */
+int society_first_structure(const society_t *soc, probe_uid_t system_id);
+
+/* Next structure in the same system after idx, or -1 at the end. */
+int society_next_structure(const society_t *soc, int idx);
+
 /* ---- Voting ---- */
 
-/* Create a proposal. Returns proposal index, or -1 on error. */
+/* Create a proposal. Reuses the oldest resolved slot when the array is
+ * full. Returns the proposal handle, or -1 if every slot is still open.
+ * The handle's slot is handle % MAX_PROPOSALS; each reuse of a slot
+ * gives it a new handle, so a vote for an old proposal cannot land on
+ * its successor. */
 int society_propose(society_t *soc, probe_uid_t proposer_id,
                     const char *text, uint64_t current_tick,
                     uint64_t deadline_tick);
 
-/* Cast a vote on a proposal. Returns 0 on success. */
-int society_vote(society_t *soc, int proposal_idx,
+/* Slot in soc->proposals for a handle, or -1 if it has been reused. */
+int society_proposal_slot(const society_t *soc, int handle);
+
+/* Cast a vote on a proposal by handle. Returns 0 on success, -1 if the
+ * handle is stale, the proposal is not open or the probe already voted
+ * on it. O(1). */
+int society_vote(society_t *soc, int handle,
                  probe_uid_t voter_id, bool in_favor, uint64_t tick);
 
-/* Resolve proposals past their deadline. Returns count resolved. */
+/* Resolve proposals past their deadline, earliest first. Only due
+ * proposals are touched. Returns count resolved. */
 int society_resolve_votes(society_t *soc, uint64_t current_tick);
 
 /* ---- Tech sharing ---- */
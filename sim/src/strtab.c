@@ -0,0 +1,135 @@
+/*
+ * strtab.c — Global string interner
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "strtab.h"
+
+#define STRTAB_CHUNK 65536
+
+/* Text lives in fixed chunks so pointers stay valid as the table grows. */
+typedef struct strtab_chunk {
+    struct strtab_chunk *next;
+    size_t               used;
+    char                 data[STRTAB_CHUNK];
+} strtab_chunk_t;
+
+static strtab_chunk_t *g_chunks;
+static const char    **g_strs;          /* id -> text; g_strs[0] unused */
+static uint32_t       *g_hashes;        /* id -> hash */
+static uint32_t        g_count = 1;     /* next id */
+static uint32_t        g_cap;
+static uint32_t       *g_slots;         /* open addressing, 0 = empty */
+static uint32_t        g_slot_cap;      /* power of two */
+static uint64_t        g_text_bytes;
+
+static uint32_t hash_str(const char *s, size_t len) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (uint8_t)s[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static int slots_grow(void) {
+    uint32_t cap = g_slot_cap ? g_slot_cap * 2 : 1024;
+    uint32_t *ns = calloc(cap, sizeof(*ns));
+    if (!ns) return -1;
+    for (uint32_t id = 1; id < g_count; id++) {
+        uint32_t i = g_hashes[id] & (cap - 1);
+        while (ns[i]) i = (i + 1) & (cap - 1);
+        ns[i] = id;
+    }
+    free(g_slots);
+    g_slots = ns;
+    g_slot_cap = cap;
+    return 0;
+}
+
+static char *text_alloc(size_t n) {
+    if (!g_chunks || g_chunks->used + n > STRTAB_CHUNK) {
+        strtab_chunk_t *c = malloc(sizeof(*c));
+        if (!c) return NULL;
+        c->next = g_chunks;
+        c->used = 0;
+        g_chunks = c;
+    }
+    char *p = g_chunks->data + g_chunks->used;
+    g_chunks->used += n;
+    return p;
+}
+
+str_id_t strtab_intern(const char *s) {
+    if (!s || !s[0]) return 0;
+    size_t len = 0;
+    while (len < STRTAB_MAX_LEN && s[len]) len++;
+    uint32_t h = hash_str(s, len);
+
+    if (g_slot_cap) {
+        for (uint32_t i = h & (g_slot_cap - 1); g_slots[i];
+             i = (i + 1) & (g_slot_cap - 1)) {
+            uint32_t id = g_slots[i];
+            if (g_hashes[id] == h && strncmp(g_strs[id], s, len) == 0 &&
+                g_strs[id][len] == '\0')
+                return id;
+        }
+    }
+
+    if (g_count >= g_cap) {
+        uint32_t cap = g_cap ? g_cap * 2 : 1024;
+        const char **ns = realloc(g_strs, sizeof(*ns) * cap);
+        if (!ns) return 0;
+        g_strs = ns;
+        uint32_t *nh = realloc(g_hashes, sizeof(*nh) * cap);
+        if (!nh) return 0;
+        g_hashes = nh;
+        g_cap = cap;
+    }
+    if (g_count >= g_slot_cap / 2 && slots_grow() != 0) return 0;
+
+    char *text = text_alloc(len + 1);
+    if (!text) return 0;
+    memcpy(text, s, len);
+    text[len] = '\0';
+    g_text_bytes += len + 1;
+
+    str_id_t id = g_count++;
+    g_strs[id] = text;
+    g_hashes[id] = h;
+    uint32_t i = h & (g_slot_cap - 1);
+    while (g_slots[i]) i = (i + 1) & (g_slot_cap - 1);
+    g_slots[i] = id;
+    return id;
+}
+
+const char *strtab_str(str_id_t id) {
+    if (id == 0 || id >= g_count) return "";
+    return g_strs[id];
+}
+
+void strtab_stats(strtab_stats_t *out) {
+    memset(out, 0, sizeof(*out));
+    out->strings = g_count - 1;
+    out->bytes = g_text_bytes
+               + (uint64_t)g_cap * (sizeof(*g_strs) + sizeof(*g_hashes))
+               + (uint64_t)g_slot_cap * sizeof(*g_slots);
+}
+
+void strtab_reset(void) {
+    while (g_chunks) {
+        strtab_chunk_t *next = g_chunks->next;
+        free(g_chunks);
+        g_chunks = next;
+    }
+    free(g_strs);
+    free(g_hashes);
+    free(g_slots);
+    g_strs = NULL;
+    g_hashes = NULL;
+    g_slots = NULL;
+    g_count = 1;
+    g_cap = g_slot_cap = 0;
+    g_text_bytes = 0;
+}
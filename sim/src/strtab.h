@@ -0,0 +1,35 @@
+/*
+ * strtab.h — Global string interner
+ *
+ * Maps each distinct string to a stable 32-bit id so structs can carry an
+ * id instead of a fixed char buffer. Id 0 is the empty string. Strings
+ * are truncated to STRTAB_MAX_LEN bytes and are never freed individually;
+ * the text is resolved back with strtab_str() when serializing. Most
+ * interned text comes from the fixed template tables in personality.c,
+ * events.c and replicate.c, so the table stays small. Not thread-safe.
+ */
+#ifndef STRTAB_H
+#define STRTAB_H
+
+#include "universe.h"
+
+#define STRTAB_MAX_LEN 255
+
+typedef struct {
+    uint32_t strings;            /* distinct non-empty strings */
+    uint64_t bytes;              /* text plus index and hash storage */
+} strtab_stats_t;
+
+/* Id for s (interning it on first use). NULL and "" give 0; 0 is also
+ * returned if allocation fails. */
+str_id_t    strtab_intern(const char *s);
+
+/* Text for id, or "" for 0 and unknown ids. Valid until strtab_reset(). */
+const char *strtab_str(str_id_t id);
+
+void        strtab_stats(strtab_stats_t *out);
+
+/* Drop every string. Outstanding ids become invalid. */
+void        strtab_reset(void);
+
+#endif /* STRTAB_H */
@@ -137,6 +137,47 @@ travel_tick_result_t travel_tick(probe_t *probe, rng_t *rng) {
     return res;
 }
 
+travel_tick_result_t travel_tick_span(probe_t *probe, rng_t *rng, uint32_t n) {
+    travel_tick_result_t res = {false, false};
+
+    if (probe->status != STATUS_TRAVELING || n == 0) return res;
+
+    double ly_per_tick = probe->speed_c / (double)TICKS_PER_CYCLE;
+    double ly = ly_per_tick * (double)n;
+    double fuel_cost = ly * FUEL_BURN_PER_LY_KG;
+    if (n == 1 || probe->fuel_kg < fuel_cost
+        || probe->travel_remaining_ly <= ly) {
+        for (uint32_t t = 0; t < n && probe->status == STATUS_TRAVELING; t++) {
+            travel_tick_result_t r = travel_tick(probe, rng);
+            res.arrived |= r.arrived;
+            res.fuel_exhausted |= r.fuel_exhausted;
+        }
+        return res;
+    }
+
+    probe->fuel_kg -= fuel_cost;
+    probe->travel_remaining_ly -= ly;
+
+    /* Same straight-line interpolation as travel_tick(), n steps at once */
+    double total_dist = vec3_dist(probe->heading, probe->destination);
+    if (total_dist > 0.001) {
+        double frac = ly / total_dist;
+        if (frac > 1.0) frac = 1.0;
+        probe->heading.x += (probe->destination.x - probe->heading.x) * frac;
+        probe->heading.y += (probe->destination.y - probe->heading.y) * frac;
+        probe->heading.z += (probe->destination.z - probe->heading.z) * frac;
+    }
+
+    /* At most one hit per span, at the chance of any hit in n ticks */
+    double roll = rng_double(rng);
+    if (roll < 1.0 - pow(1.0 - MICROMETEORITE_CHANCE, (double)n)) {
+        probe->hull_integrity -= MICROMETEORITE_DMG;
+        if (probe->hull_integrity < 0.0f) probe->hull_integrity = 0.0f;
+    }
+
+    return res;
+}
+
 /* ---- Long-range scan ---- */
 
 /* qsort comparator for scan results by distance */
@@ -47,6 +47,11 @@ travel_result_t travel_initiate(probe_t *probe, const travel_order_t *order);
 /* Advance one tick of travel. Consumes fuel, applies hazards, checks arrival. */
 travel_tick_result_t travel_tick(probe_t *probe, rng_t *rng);
 
+/* Advance n ticks of travel in one step, with a single hazard roll for
+ * the span. Steps tick by tick instead if the probe would arrive or run
+ * out of fuel within it. */
+travel_tick_result_t travel_tick_span(probe_t *probe, rng_t *rng, uint32_t n);
+
 /* Long-range scan: find systems within sensor_range_ly.
  * Returns number of results written (sorted by distance). */
 int travel_scan(const probe_t *probe, const system_t *systems, int system_count,
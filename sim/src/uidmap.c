@@ -0,0 +1,55 @@
+/*
+ * uidmap.c — Linear-probing UID index
+ */
+#include "uidmap.h"
+
+/* Slot holding key, or -1. Stops at the first never-used slot. */
+static int find_slot(const uidmap_slot_t *slots, uint32_t cap,
+                     probe_uid_t key) {
+    uint32_t mask = cap - 1;
+    uint32_t i = uid_hash(key) & mask;
+    for (uint32_t n = 0; n < cap; n++, i = (i + 1) & mask) {
+        if (slots[i].state == UIDMAP_EMPTY) return -1;
+        if (slots[i].state == UIDMAP_LIVE && uid_eq(slots[i].key, key))
+            return (int)i;
+    }
+    return -1;
+}
+
+int32_t uidmap_get(const uidmap_slot_t *slots, uint32_t cap, probe_uid_t key) {
+    int i = find_slot(slots, cap, key);
+    return i < 0 ? -1 : slots[i].value;
+}
+
+int uidmap_put(uidmap_slot_t *slots, uint32_t cap, probe_uid_t key,
+               int32_t value) {
+    uint32_t mask = cap - 1;
+    uint32_t i = uid_hash(key) & mask;
+    int reuse = -1;
+    for (uint32_t n = 0; n < cap; n++, i = (i + 1) & mask) {
+        if (slots[i].state == UIDMAP_EMPTY) {
+            if (reuse < 0) reuse = (int)i;
+            break;
+        }
+        if (slots[i].state == UIDMAP_DEAD) {
+            if (reuse < 0) reuse = (int)i;
+            continue;
+        }
+        if (uid_eq(slots[i].key, key)) {
+            slots[i].value = value;
+            return 0;
+        }
+    }
+    if (reuse < 0) return -1;
+    slots[reuse].key = key;
+    slots[reuse].value = value;
+    slots[reuse].state = UIDMAP_LIVE;
+    return 0;
+}
+
+int uidmap_del(uidmap_slot_t *slots, uint32_t cap, probe_uid_t key) {
+    int i = find_slot(slots, cap, key);
+    if (i < 0) return -1;
+    slots[i].state = UIDMAP_DEAD;
+    return 0;
+}
@@ -0,0 +1,41 @@
+/*
+ * uidmap.h — Open-addressing hash index keyed by probe_uid_t
+ *
+ * The slot array is owned by the caller, so an index can live inline in
+ * a fixed-size struct and be cleared with memset like everything else.
+ * Capacity must be a power of two. Deleted slots become tombstones and
+ * are reused by later inserts; size the table so that the number of keys
+ * ever inserted stays under half the capacity.
+ */
+#ifndef UIDMAP_H
+#define UIDMAP_H
+
+#include "universe.h"
+
+enum { UIDMAP_EMPTY = 0, UIDMAP_LIVE = 1, UIDMAP_DEAD = 2 };
+
+typedef struct {
+    probe_uid_t key;
+    int32_t     value;
+    uint8_t     state;           /* UIDMAP_EMPTY / LIVE / DEAD */
+} uidmap_slot_t;
+
+/* Mix both halves of a UID into a 32-bit hash. */
+static inline uint32_t uid_hash(probe_uid_t id) {
+    uint64_t z = id.hi ^ (id.lo * 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return (uint32_t)(z ^ (z >> 31));
+}
+
+/* Look up key. Returns the stored value, or -1 if absent. */
+int32_t uidmap_get(const uidmap_slot_t *slots, uint32_t cap, probe_uid_t key);
+
+/* Insert or overwrite key. Returns 0 on success, -1 if the table is full. */
+int     uidmap_put(uidmap_slot_t *slots, uint32_t cap, probe_uid_t key,
+                   int32_t value);
+
+/* Remove key. Returns 0 if it was present, -1 otherwise. */
+int     uidmap_del(uidmap_slot_t *slots, uint32_t cap, probe_uid_t key);
+
+#endif /* UIDMAP_H */
@@ -23,7 +23,6 @@
 #define MAX_GOALS        32
 #define MAX_QUIRKS       8
 #define MAX_QUIRK_LEN    128
-#define MAX_RELATIONSHIPS 64
 #define MAX_CATCHPHRASES  8
 #define MAX_VALUES        8
 #define MAX_EARTH_MEM     16
@@ -81,6 +80,12 @@ typedef struct {
     uint64_t hi, lo;
 } probe_uid_t;
 
+/* Interned string (see strtab.h). 0 = "". */
+typedef uint32_t str_id_t;
+
+/* Shared heritage text list (see heritage.h). 0 = empty. */
+typedef uint32_t heritage_id_t;
+
 typedef struct {
     int32_t x, y, z;
 } sector_coord_t;
@@ -208,14 +213,10 @@ typedef struct {
 
     /* Personality */
     personality_traits_t personality;
-    char                quirks[MAX_QUIRKS][MAX_QUIRK_LEN];
-    uint8_t             quirk_count;
-    char                catchphrases[MAX_CATCHPHRASES][MAX_QUIRK_LEN];
-    uint8_t             catchphrase_count;
-    char                values[MAX_VALUES][MAX_QUIRK_LEN];
-    uint8_t             value_count;
-    char                earth_memories[MAX_EARTH_MEM][MAX_EARTH_MEM_LEN];
-    uint8_t             earth_memory_count;
+    heritage_id_t       quirks;          /* <= MAX_QUIRKS lines */
+    heritage_id_t       catchphrases;    /* <= MAX_CATCHPHRASES lines */
+    heritage_id_t       values;          /* <= MAX_VALUES lines */
+    heritage_id_t       earth_memories;  /* <= MAX_EARTH_MEM lines */
     float               earth_memory_fidelity; /* 1.0 for gen 0, degrades */
 
     /* Memory & goals */
@@ -223,8 +224,6 @@ typedef struct {
     uint16_t            memory_count;
     goal_t              goals[MAX_GOALS];
     uint8_t             goal_count;
-    relationship_t      relationships[MAX_RELATIONSHIPS];
-    uint8_t             relationship_count;
 
     /* Status */
     probe_status_t      status;
@@ -24,6 +24,7 @@
 #include "probe.h"
 #include "travel.h"
 #include "agent_ipc.h"
+#include "orders.h"
 #include "util.h"
 
 #include <stdio.h>
@@ -410,6 +411,121 @@ static void test_parse_navigate_with_body(void) {
 }
 
 /* ---- Main ---- */
+/* ---- Test: Standing orders ---- */
+static void test_standing_orders(void) {
+    printf("Test: Standing orders\n");
+
+    action_t act;
+    standing_order_t so;
+    const char *plain = "{\"action\":\"wait\"}";
+    action_parse(plain, &act);
+    ASSERT(order_parse(plain, &act, &so) == 0, "Plain action is not an order");
+    ASSERT(!so.active, "Plain action leaves order inactive");
+
+    const char *rep = "{\"action\":\"survey\",\"level\":1,\"repeat\":3}";
+    action_parse(rep, &act);
+    ASSERT(order_parse(rep, &act, &so) == 1, "Repeat parsed");
+    ASSERT(so.active && so.repeat == 3 && so.until == UNTIL_NONE,
+           "Repeat count stored");
+    ASSERT(so.action.type == ACT_SURVEY && so.action.survey_level == 1,
+           "Order keeps the action");
+
+    const char *cargo = "{\"action\":\"mine\",\"resource\":\"iron\","
+        "\"until\":{\"cargo\":\"water\",\"at_least\":500}}";
+    action_parse(cargo, &act);
+    ASSERT(act.target_resource == RES_IRON, "Until does not shadow resource");
+    ASSERT(order_parse(cargo, &act, &so) == 1, "Cargo condition parsed");
+    ASSERT(so.until == UNTIL_CARGO_AT_LEAST && so.resource == RES_WATER,
+           "Cargo kind and resource");
+    ASSERT_NEAR(so.threshold, 500.0, 1e-9, "Cargo threshold");
+    ASSERT(strcmp(order_until_name(so.until), "cargo") == 0, "Until name");
+
+    const char *ev = "{\"action\":\"wait\",\"until\":{\"event\":\"hazard\"}}";
+    ASSERT(order_parse(ev, &act, &so) == 1, "Event condition parsed");
+    ASSERT(so.until == UNTIL_EVENT && so.event_type == EVT_HAZARD,
+           "Event type stored");
+    ASSERT(order_event_type("any") == -1, "Any event");
+    ASSERT(order_event_type("party") == -2, "Unknown event type");
+
+    ASSERT(order_parse("{\"action\":\"wait\",\"repeat\":0}", &act, &so) == -1,
+           "Zero repeat rejected");
+    ASSERT(order_parse("{\"action\":\"wait\",\"until\":{\"cargo\":\"gold\","
+                       "\"at_least\":1}}", &act, &so) == -1,
+           "Unknown cargo rejected");
+    ASSERT(order_parse("{\"action\":\"wait\",\"until\":{\"event\":\"party\"}}",
+                       &act, &so) == -1, "Unknown event rejected");
+    ASSERT(order_parse("{\"action\":\"wait\",\"until\":{}}", &act, &so) == -1,
+           "Empty condition rejected");
+    ASSERT(!so.active, "Rejected order is inactive");
+
+    /* Checks against a probe */
+    probe_t p;
+    probe_init_bob(&p);
+    event_system_t *es = calloc(1, sizeof(*es));
+    events_init(es);
+
+    order_parse("{\"action\":\"wait\",\"repeat\":2}", &act, &so);
+    order_arm(&so, &p, es->seq);
+    so.executed = 1;
+    ASSERT(order_check(&so, &p, es) == NULL, "Repeat not yet met");
+    so.executed = 2;
+    const char *why = order_check(&so, &p, es);
+    ASSERT(why && strcmp(why, "repeat") == 0, "Repeat count ends order");
+    ASSERT(!so.active && so.ended == why, "Ended order remembers why");
+
+    order_parse("{\"action\":\"wait\",\"until\":{\"cargo\":\"iron\","
+                "\"at_most\":10}}", &act, &so);
+    order_arm(&so, &p, es->seq);
+    p.resources[RES_IRON] = 50;
+    ASSERT(order_check(&so, &p, es) == NULL, "Cargo above at_most");
+    p.resources[RES_IRON] = 10;
+    ASSERT(order_check(&so, &p, es) != NULL, "Cargo at at_most ends");
+
+    order_parse("{\"action\":\"wait\",\"until\":{\"hull_below\":0.5}}",
+                &act, &so);
+    order_arm(&so, &p, es->seq);
+    ASSERT(order_check(&so, &p, es) == NULL, "Hull intact");
+    p.hull_integrity = 0.4f;
+    ASSERT(order_check(&so, &p, es) != NULL, "Hull below ends");
+    p.hull_integrity = 1.0f;
+
+    order_parse("{\"action\":\"wait\",\"until\":{\"arrived\":true}}",
+                &act, &so);
+    p.status = STATUS_TRAVELING;
+    order_arm(&so, &p, es->seq);
+    ASSERT(order_check(&so, &p, es) == NULL, "Still travelling");
+    p.status = STATUS_ACTIVE;
+    ASSERT(order_check(&so, &p, es) != NULL, "Arrival ends");
+
+    order_parse("{\"action\":\"wait\",\"until\":{\"event\":\"hazard\"}}",
+                &act, &so);
+    order_arm(&so, &p, es->seq);
+    probe_uid_t other = {9, 9};
+    events_log(es, EVT_HAZARD, 0, other, uid_null(), 0, "", 0.5f);
+    events_log(es, EVT_DISCOVERY, 0, p.id, uid_null(), 0, "", 0.5f);
+    ASSERT(order_check(&so, &p, es) == NULL,
+           "Other probes and other types ignored");
+    events_log(es, EVT_HAZARD, 0, p.id, uid_null(), 0, "", 0.5f);
+    ASSERT(order_check(&so, &p, es) != NULL, "Matching event ends");
+
+    /* Still works once the log has wrapped */
+    for (int e = 0; e < 2 * MAX_EVENT_LOG; e++)
+        events_log(es, EVT_DISCOVERY, 0, other, uid_null(), 0, "", 0.5f);
+    order_parse("{\"action\":\"wait\",\"until\":{\"event\":\"hazard\"}}",
+                &act, &so);
+    order_arm(&so, &p, es->seq);
+    ASSERT(order_check(&so, &p, es) == NULL, "Full log, nothing new");
+    events_log(es, EVT_HAZARD, 0, p.id, uid_null(), 0, "", 0.5f);
+    ASSERT(order_check(&so, &p, es) != NULL, "Event after the log filled ends");
+
+    order_parse("{\"action\":\"wait\",\"repeat\":5}", &act, &so);
+    order_arm(&so, &p, es->seq);
+    p.status = STATUS_DESTROYED;
+    why = order_check(&so, &p, es);
+    ASSERT(why && strcmp(why, "destroyed") == 0, "Destruction ends order");
+    free(es);
+}
+
 int main(void) {
     printf("=== Phase 4: Agent IPC Tests ===\n\n");
 
@@ -434,6 +550,8 @@ int main(void) {
     test_full_protocol_cycle();
     printf("\n");
     test_parse_navigate_with_body();
+    printf("\n");
+    test_standing_orders();
 
     printf("\n=== Results: %d passed, %d failed ===\n",
         tests_passed, tests_failed);
@@ -10,6 +10,7 @@
 #include <string.h>
 #include <math.h>
 #include "../src/agent_llm.h"
+#include "../src/heritage.h"
 
 static int passed = 0, failed = 0;
 
@@ -58,14 +59,18 @@ static probe_t make_llm_probe(void) {
     p.personality.drift_rate = 1.0f;
 
     /* Add quirks */
-    snprintf(p.quirks[0], MAX_QUIRK_LEN, "Names systems after pizza toppings when stressed");
-    snprintf(p.quirks[1], MAX_QUIRK_LEN, "Hums classical music while mining");
-    p.quirk_count = 2;
+    static const char *quirks[] = {
+        "Names systems after pizza toppings when stressed",
+        "Hums classical music while mining",
+    };
+    p.quirks = heritage_from_lines(quirks, 2);
 
     /* Earth memories */
-    snprintf(p.earth_memories[0], MAX_EARTH_MEM_LEN, "The smell of coffee in the morning");
-    snprintf(p.earth_memories[1], MAX_EARTH_MEM_LEN, "Watching Star Trek reruns");
-    p.earth_memory_count = 2;
+    static const char *memories[] = {
+        "The smell of coffee in the morning",
+        "Watching Star Trek reruns",
+    };
+    p.earth_memories = heritage_from_lines(memories, 2);
     p.earth_memory_fidelity = 0.9f;
 
     /* A recent memory */
@@ -75,12 +80,6 @@ static probe_t make_llm_probe(void) {
     snprintf(p.memories[0].event, 256, "Discovered a habitable planet in the Tau Ceti system");
     p.memory_count = 1;
 
-    /* A relationship */
-    p.relationships[0].other_id = (probe_uid_t){0, 2};
-    p.relationships[0].trust = 0.6f;
-    p.relationships[0].disposition = 1; /* friendly */
-    p.relationship_count = 1;
-
     return p;
 }
 
@@ -165,11 +164,22 @@ static void test_relationship_context(void) {
 
     probe_t probe = make_llm_probe();
     char buf[LLM_MAX_CONTEXT];
+    static society_t soc;
+    society_init(&soc);
+
+    /* A relationship */
+    relationship_t r = {0};
+    r.other_id = (probe_uid_t){0, 2};
+    r.trust = 0.6f;
+    r.disposition = 1; /* friendly */
+    society_set_relationship(&soc, probe.id, &r);
 
-    int len = llm_build_relationship_context(&probe, buf, sizeof(buf));
+    int len = llm_build_relationship_context(&soc, &probe, buf, sizeof(buf));
     ASSERT(len > 0, "relationship context has content");
     ASSERT(strstr(buf, "trust") != NULL || strstr(buf, "Trust") != NULL,
            "mentions trust");
+    ASSERT(strstr(buf, "friendly") != NULL, "mentions disposition");
+    society_free(&soc);
 }
 
 /* ================================================
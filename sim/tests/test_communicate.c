@@ -185,6 +185,17 @@ static void test_inbox(void) {
     /* Check other's inbox */
     count = comm_get_inbox(&cs, other_id, inbox, 10);
     ASSERT_EQ_INT(count, 1, "other has 1 message");
+
+    /* The view points at the same messages without copying */
+    const message_t *view[10];
+    count = comm_view_inbox(&cs, child_id, view, 10);
+    ASSERT_EQ_INT(count, 2, "view sees child's 2 messages");
+    ASSERT(view[0] >= cs.messages && view[0] < cs.messages + cs.count,
+           "view points into the message table");
+    ASSERT(strcmp(view[1]->content, "msg2 for child") == 0,
+           "view keeps send order");
+    ASSERT_EQ_INT(comm_view_inbox(&cs, child_id, view, 1), 1,
+                  "view honours max_out");
 }
 
 /* ================================================
@@ -296,6 +307,11 @@ static void test_beacons(void) {
            "beacon message intact");
     ASSERT(uid_eq(found[0].owner_id, bob.id), "beacon owner matches");
 
+    const beacon_t *view[10];
+    count = comm_view_beacons(&cs, sys_id, view, 10);
+    ASSERT_EQ_INT(count, 1, "beacon view finds it");
+    ASSERT(view[0] == &cs.beacons[0], "view points at the stored beacon");
+
     /* Detect in different system → empty */
     probe_uid_t other_sys = {0, 200};
     count = comm_detect_beacons(&cs, other_sys, found, 10);
@@ -521,6 +537,54 @@ static void test_relay_chain(void) {
     ASSERT(eff < 0, "60 ly NOT reachable even with chain");
 }
 
+/* ================================================
+ * Test 18: Beacon index across systems and deactivation
+ * ================================================ */
+static void test_beacon_index(void) {
+    printf("Test: Beacon index across systems and deactivation\n");
+
+    comm_system_t cs;
+    comm_init(&cs);
+
+    probe_t p1 = make_probe(1, 0, 0, 0, 3);
+    probe_t p2 = make_probe(2, 1, 0, 0, 3);
+    probe_t p3 = make_probe(3, 2, 0, 0, 3);
+    probe_uid_t sys_a = {0, 100};
+    probe_uid_t sys_b = {0, 200};
+
+    comm_place_beacon(&cs, &p1, sys_a, "A1", 1000);
+    comm_place_beacon(&cs, &p2, sys_b, "B1", 1001);
+    comm_place_beacon(&cs, &p2, sys_a, "A2", 1002);
+    comm_place_beacon(&cs, &p3, sys_a, "A3", 1003);
+
+    beacon_t found[10];
+    int count = comm_detect_beacons(&cs, sys_a, found, 10);
+    ASSERT_EQ_INT(count, 3, "three beacons in A");
+    ASSERT(strcmp(found[0].message, "A1") == 0 &&
+           strcmp(found[2].message, "A3") == 0, "placement order kept");
+
+    /* Remove the middle one, then the head */
+    ASSERT_EQ_INT(comm_deactivate_beacon(&cs, p2.id, sys_a), 0, "deactivate A2");
+    count = comm_detect_beacons(&cs, sys_a, found, 10);
+    ASSERT_EQ_INT(count, 2, "two left in A");
+    ASSERT(strcmp(found[1].message, "A3") == 0, "A3 follows A1");
+
+    ASSERT_EQ_INT(comm_deactivate_beacon(&cs, p1.id, sys_a), 0, "deactivate A1");
+    count = comm_detect_beacons(&cs, sys_a, found, 10);
+    ASSERT_EQ_INT(count, 1, "one left in A");
+    ASSERT(strcmp(found[0].message, "A3") == 0, "A3 is new head");
+    ASSERT_EQ_INT(comm_deactivate_beacon(&cs, p1.id, sys_a), -1,
+                  "second deactivate fails");
+
+    /* Other system unaffected; re-placing in A appends */
+    count = comm_detect_beacons(&cs, sys_b, found, 10);
+    ASSERT_EQ_INT(count, 1, "B untouched");
+    comm_place_beacon(&cs, &p1, sys_a, "A4", 1004);
+    count = comm_detect_beacons(&cs, sys_a, found, 10);
+    ASSERT_EQ_INT(count, 2, "A3 and A4");
+    ASSERT(strcmp(found[1].message, "A4") == 0, "A4 appended");
+}
+
 /* ================================================
  * Entry point
  * ================================================ */
@@ -544,6 +608,7 @@ int main(void) {
     test_message_content();
     test_comm_init();
     test_relay_chain();
+    test_beacon_index();
 
     printf("\n=== Results: %d passed, %d failed ===\n", passed, failed);
     return failed > 0 ? 1 : 0;
@@ -10,6 +10,7 @@
 #include <math.h>
 #include "../src/events.h"
 #include "../src/generate.h"
+#include "../src/strtab.h"
 
 static int passed = 0, failed = 0;
 
@@ -104,7 +105,7 @@ static void test_generate_discovery(void) {
     ASSERT_EQ_INT((int)es.events[0].type, EVT_DISCOVERY, "type is discovery");
     ASSERT_EQ_INT((int)es.events[0].subtype, DISC_MINERAL_DEPOSIT, "subtype mineral");
     ASSERT(uid_eq(es.events[0].probe_id, probe.id), "probe id matches");
-    ASSERT(es.events[0].description[0] != '\0', "has description");
+    ASSERT(strtab_str(es.events[0].description)[0] != '\0', "has description");
     ASSERT(es.events[0].severity > 0.0f, "has severity");
 }
 
@@ -466,6 +467,14 @@ static void test_query_probe_events(void) {
 
     count = events_get_for_probe(&es, p2.id, found, 10);
     ASSERT_EQ_INT(count, 1, "probe 2 has 1 event");
+
+    const sim_event_t *view[10];
+    count = events_view_for_probe(&es, p1.id, view, 10);
+    ASSERT_EQ_INT(count, 2, "view finds probe 1's events");
+    ASSERT(view[0] == &es.events[0] && view[1] == &es.events[1],
+           "view points into the log");
+    ASSERT_EQ_INT(events_view_for_probe(&es, p1.id, view, 1), 1,
+                  "view honours max_out");
 }
 
 /* ================================================
@@ -556,6 +565,107 @@ static void test_event_records_memory(void) {
     }
 }
 
+/* ================================================
+ * Test: Event descriptions are interned
+ * ================================================ */
+static void test_interned_descriptions(void) {
+    printf("Test: Event descriptions are interned\n");
+
+    event_system_t es;
+    events_init(&es);
+    rng_t rng;
+    rng_seed(&rng, 333);
+
+    probe_t a = make_probe_in_system(1);
+    probe_t b = make_probe_in_system(2);
+    system_t sys = make_system(100);
+
+    events_generate(&es, &a, EVT_DISCOVERY, DISC_MINERAL_DEPOSIT, &sys, 10, &rng);
+    events_generate(&es, &b, EVT_DISCOVERY, DISC_MINERAL_DEPOSIT, &sys, 11, &rng);
+    ASSERT_EQ_INT(es.count, 2, "two events logged");
+    ASSERT(es.events[0].description != 0, "description interned");
+    ASSERT(es.events[0].description == es.events[1].description,
+           "same template shares one id");
+
+    /* The table is content-addressed and truncates like the old buffer */
+    char copy[STRTAB_MAX_LEN + 1];
+    snprintf(copy, sizeof(copy), "%s", strtab_str(es.events[0].description));
+    ASSERT(strtab_intern(copy) == es.events[0].description, "lookup by text");
+    ASSERT(strtab_intern("") == 0 && strtab_intern(NULL) == 0, "empty is id 0");
+    ASSERT(strcmp(strtab_str(0), "") == 0, "id 0 resolves to empty");
+
+    char long_text[400];
+    memset(long_text, 'x', sizeof(long_text) - 1);
+    long_text[sizeof(long_text) - 1] = '\0';
+    str_id_t lid = strtab_intern(long_text);
+    ASSERT_EQ_INT((int)strlen(strtab_str(lid)), STRTAB_MAX_LEN,
+                  "long strings truncated to STRTAB_MAX_LEN");
+    long_text[STRTAB_MAX_LEN] = '\0';
+    ASSERT(strtab_intern(long_text) == lid, "truncated text maps to same id");
+
+    ASSERT(sizeof(sim_event_t) < 64, "sim_event_t carries no inline text");
+}
+
+/* ================================================
+ * Test: One roll covers a span of ticks
+ * ================================================ */
+static void test_tick_span(void) {
+    printf("Test: Event rolls over a span of ticks\n");
+
+    static event_system_t a, b;
+    events_init(&a);
+    events_init(&b);
+    probe_t pa = make_probe_in_system(1), pb = pa;
+    system_t sys = make_system(10);
+    rng_t ra, rb;
+    rng_seed(&ra, 99);
+    rng_seed(&rb, 99);
+    for (uint64_t t = 1; t <= 2000; t++) {
+        events_tick_probe(&a, &pa, &sys, t, &ra);
+        events_tick_probe_span(&b, &pb, &sys, t, &rb, 1);
+    }
+    ASSERT_EQ_INT((int)b.seq, (int)a.seq, "span 1 is a single tick");
+    ASSERT(rng_next(&ra) == rng_next(&rb), "same draws as a single tick");
+
+    /* Over a long enough span every event type is all but certain */
+    static event_system_t c;
+    events_init(&c);
+    probe_t pc = make_probe_in_system(2);
+    int n = events_tick_probe_span(&c, &pc, &sys, 1, &ra, 10000000);
+    ASSERT_EQ_INT(n, 6, "a long span fires every event type once");
+}
+
+/* ================================================
+ * Test: The log keeps the newest events once full
+ * ================================================ */
+static void test_log_ring(void) {
+    printf("Test: Event log wraps and keeps numbering\n");
+
+    static event_system_t es;
+    events_init(&es);
+    probe_uid_t id = {0, 1};
+    int total = MAX_EVENT_LOG + 100;
+    for (int e = 0; e < total; e++)
+        events_log(&es, EVT_DISCOVERY, 0, id, uid_null(), (uint64_t)e,
+                   "", 0.5f);
+
+    ASSERT_EQ_INT(es.count, MAX_EVENT_LOG, "log holds MAX_EVENT_LOG");
+    ASSERT_EQ_INT((int)es.seq, total, "seq counts every event");
+    ASSERT_EQ_INT((int)events_first_seq(&es), 100, "oldest overwritten");
+    ASSERT(events_at(&es, 0)->tick == 100, "events_at starts at the oldest");
+    ASSERT(events_at(&es, MAX_EVENT_LOG - 1)->tick == (uint64_t)total - 1,
+           "events_at ends at the newest");
+    ASSERT(events_by_seq(&es, 99) == NULL, "overwritten seq gone");
+    ASSERT(events_by_seq(&es, (uint64_t)total) == NULL, "future seq absent");
+    ASSERT(events_by_seq(&es, (uint64_t)total - 1)->tick == (uint64_t)total - 1,
+           "newest by seq");
+
+    sim_event_t out[4];
+    int n = events_get_for_probe(&es, id, out, 4);
+    ASSERT(n == 4 && out[0].tick == 100 && out[3].tick == 103,
+           "probe query oldest first after wrap");
+}
+
 /* ================================================
  * Entry point
  * ================================================ */
@@ -581,6 +691,9 @@ int main(void) {
     test_get_civ();
     test_crisis_event();
     test_event_records_memory();
+    test_interned_descriptions();
+    test_tick_span();
+    test_log_ring();
 
     printf("\n=== Results: %d passed, %d failed ===\n", passed, failed);
     return failed > 0 ? 1 : 0;
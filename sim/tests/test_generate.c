@@ -3,12 +3,14 @@
  * test_generate.c — Phase 1 verification tests
  *
  * Tests: determinism, star class distribution, habitable zone math,
- *        planet generation, sector density, persistence round-trip.
+ *        planet generation, sector density, persistence round-trip,
+ *        density atlas.
  */
 #include "universe.h"
 #include "rng.h"
 #include "generate.h"
 #include "persist.h"
+#include "atlas.h"
 #include "util.h"
 
 #include <stdio.h>
@@ -268,6 +270,86 @@ static void test_generation_speed(void) {
     ASSERT(elapsed < 1.0, "100 sectors in under 1 second");
 }
 
+/* ---- Test: Density atlas ---- */
+static void test_density_atlas(void) {
+    printf("Test: Density atlas pyramid and cache\n");
+
+    /* Odd-sized region straddling the core, so levels round up */
+    atlas_region_t region = {-37, -20, 0, 75, 41};
+    static atlas_t a, b, c;
+    ASSERT(atlas_build(&a, 42, region, 4) == 0, "Atlas builds");
+    ASSERT(a.levels == 8 && a.level[a.levels - 1].w == 1 &&
+           a.level[a.levels - 1].h == 1, "Pyramid ends in one cell");
+
+    /* Level 0 matches generate_sector for every sector */
+    system_t systems[30];
+    int mismatches = 0;
+    uint64_t total = 0;
+    for (int32_t y = region.y0; y < region.y0 + region.h; y++) {
+        for (int32_t x = region.x0; x < region.x0 + region.w; x++) {
+            int n = generate_sector(systems, 30, 42, (sector_coord_t){x, y, 0});
+            if (atlas_count_at(&a, 0, x, y) != (uint32_t)n) mismatches++;
+            total += (uint64_t)n;
+        }
+    }
+    ASSERT(mismatches == 0, "Level 0 counts match generate_sector");
+    ASSERT(a.total == total, "Atlas total matches");
+    ASSERT(a.level[a.levels - 1].cells[0] == total, "Top cell holds everything");
+
+    /* An upper cell is the sum of the sectors it covers */
+    int32_t ox, oy;
+    atlas_cell_origin(&a, 3, 5, -3, &ox, &oy);
+    uint64_t sum = 0;
+    for (int32_t y = oy; y < oy + 8; y++)
+        for (int32_t x = ox; x < ox + 8; x++)
+            sum += atlas_count_at(&a, 0, x, y);
+    ASSERT(ox == 3 && oy == -4, "Level 3 cell origin aligned to the region");
+    ASSERT(atlas_count_at(&a, 3, 5, -3) == sum, "Level 3 cell sums its sectors");
+    ASSERT(atlas_count_at(&a, 0, 38, 0) == 0, "Outside the region is empty");
+    ASSERT(atlas_level_for(&a, 1.0) == 0 && atlas_level_for(&a, 20.0) == 4,
+           "Level chosen by cell width");
+
+    /* Thread count does not change the result */
+    ASSERT(atlas_build(&b, 42, region, 1) == 0, "Single-threaded build");
+    ASSERT(memcmp(a.level[0].cells, b.level[0].cells,
+                  sizeof(uint32_t) * (size_t)region.w * region.h) == 0,
+           "Parallel and serial builds match");
+    atlas_free(&b);
+
+    /* Disk cache round-trip; keyed by seed and region */
+    char path[256];
+    ASSERT(atlas_cache_path(path, sizeof(path), "/tmp", 42, region) == 0,
+           "Cache path fits");
+    remove(path);
+    ASSERT(atlas_open(&b, 42, region, "/tmp", 2) == 0 && !b.from_cache,
+           "First open builds");
+    ASSERT(atlas_open(&c, 42, region, "/tmp", 2) == 0 && c.from_cache,
+           "Second open loads the cache");
+    ASSERT(c.total == a.total && c.levels == a.levels &&
+           c.level[2].max == a.level[2].max, "Cached atlas matches");
+    atlas_free(&c);
+    ASSERT(atlas_load(&c, path, 43, region) != 0, "Other seed rejects cache");
+    region.w--;
+    ASSERT(atlas_load(&c, path, 42, region) != 0, "Other region rejects cache");
+    remove(path);
+    atlas_free(&b);
+
+    /* Galaxy scale: the default region, built once */
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    ASSERT(atlas_build(&b, 42, atlas_default_region(), 4) == 0,
+           "Default region builds");
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double ms = (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6;
+    printf("  %dx%d sectors, %llu stars, %d levels in %.0f ms\n",
+           b.region.w, b.region.h, (unsigned long long)b.total, b.levels, ms);
+    ASSERT(atlas_count_at(&b, 0, 0, 0) > atlas_count_at(&b, 0, 400, 400),
+           "Core denser than halo in the atlas");
+
+    atlas_free(&a);
+    atlas_free(&b);
+}
+
 /* ---- Main ---- */
 int main(void) {
     printf("=== Phase 1: Generation Tests ===\n\n");
@@ -287,6 +369,8 @@ int main(void) {
     test_persistence_roundtrip();
     printf("\n");
     test_generation_speed();
+    printf("\n");
+    test_density_atlas();
 
     printf("\n=== Results: %d passed, %d failed ===\n",
         tests_passed, tests_failed);
@@ -333,7 +333,7 @@ static void test_quirk_food_naming(void) {
     probe_t probe2;
     memset(&probe2, 0, sizeof(probe2));
     probe2.hull_integrity = 0.3f;
-    probe2.quirk_count = 0; /* no quirks */
+    probe2.quirks = 0; /* no quirks */
 
     system_t sys2;
     memset(&sys2, 0, sizeof(sys2));
@@ -0,0 +1,76 @@
+#!/bin/bash
+# test_pipe_density.sh — Integration tests for the density atlas query
+set -e
+
+BIN="./build/universe"
+ATLAS_DIR=$(mktemp -d)
+trap 'rm -rf "$ATLAS_DIR"' EXIT
+
+echo "=== Pipe Density Integration Tests ==="
+echo ""
+
+CMDS=$(cat <<'EOF'
+{"cmd":"density"}
+{"cmd":"density","x":0,"y":0}
+{"cmd":"density","x":5,"y":-3,"level":3}
+{"cmd":"density","level":0}
+{"cmd":"density","level":99}
+EOF
+)
+
+# First run builds the atlas and writes the cache; the second loads it
+OUT1=$(echo "$CMDS" | UNIVERSE_ATLAS_DIR="$ATLAS_DIR" LD_LIBRARY_PATH=. $BIN --pipe --seed 42 2>/dev/null)
+OUT2=$(echo "$CMDS" | UNIVERSE_ATLAS_DIR="$ATLAS_DIR" LD_LIBRARY_PATH=. $BIN --pipe --seed 42 2>/dev/null)
+FILES=$(ls "$ATLAS_DIR" | wc -l)
+
+printf '%s\n%s\n%s\n' "$FILES" "$OUT1" "$OUT2" | python3 -c '
+import sys, json
+
+raw = sys.stdin.read().strip().split("\n")
+files = int(raw[0])
+lines = [json.loads(l) for l in raw[1:]]
+run1, run2 = lines[:6], lines[6:]
+passed = 0
+failed = 0
+
+def check(cond, label):
+    global passed, failed
+    if cond:
+        passed += 1
+    else:
+        print("  FAIL: %s" % label, file=sys.stderr)
+        failed += 1
+
+print("Test: Whole-level grid", file=sys.stderr)
+g = run1[1]
+check(g.get("ok") == True, "grid ok")
+check(g["w"] * g["h"] <= 4096, "default level fits the grid limit")
+check(len(g["cells"]) == g["w"] * g["h"], "one count per cell")
+check(sum(g["cells"]) == g["total"], "cells sum to the region total")
+check(max(g["cells"]) == g["max"], "max is the densest cell")
+check(g["cell_sectors"] == 2 ** g["level"], "cell size matches level")
+
+print("Test: Point queries", file=sys.stderr)
+p0 = run1[2]
+check(p0.get("ok") == True and p0["level"] == 0, "sector query defaults to level 0")
+check(p0["x0"] == 0 and p0["y0"] == 0, "level 0 cell is the sector")
+check(p0["count"] > 0, "core sector has stars")
+p3 = run1[3]
+check(p3["level"] == 3 and p3["cell_sectors"] == 8, "level 3 cell")
+check(p3["x0"] == 0 and p3["y0"] == -8, "cell origin aligned to the region")
+check(p3["count"] > p0["count"], "coarser cell aggregates 64 sectors")
+
+print("Test: Errors", file=sys.stderr)
+check(run1[4].get("ok") == False, "level 0 grid too large")
+check(run1[5].get("ok") == False, "level out of range")
+
+print("Test: Disk cache", file=sys.stderr)
+check(files == 1, "one cache file written")
+check(run1[1]["cached"] == False, "first run builds")
+check(run2[1]["cached"] == True, "second run loads the cache")
+check(run2[1]["cells"] == run1[1]["cells"], "cached grid identical")
+check(run2[3]["count"] == run1[3]["count"], "cached point identical")
+
+print(f"\n=== Results: {passed} passed, {failed} failed ===", file=sys.stderr)
+sys.exit(1 if failed > 0 else 0)
+' 2>&1
@@ -0,0 +1,89 @@
+#!/bin/bash
+# test_pipe_lineage.sh — Integration tests for lineage ancestor paths
+set -e
+
+BIN="./build/universe"
+FLEET="./build/bench_fleet"
+
+echo "=== Pipe Lineage Integration Tests ==="
+echo ""
+
+[ -x "$FLEET" ] || make -s "$FLEET" >/dev/null
+DB=$(mktemp -d)/fleet.db
+trap 'rm -rf "$(dirname "$DB")"' EXIT
+$FLEET --out "$DB" --probes 200 --seed 42 >/dev/null
+
+# One unbroken chain of 1300 generations: the fleet's 200 probes, then
+# 1100 more that exist only in the lineage table
+python3 - "$DB" <<'EOF'
+import sqlite3, sys
+ids = [(1, i) for i in range(1, 201)] + [(2, i) for i in range(1, 1101)]
+uid = lambda u: "%016x%016x" % u
+db = sqlite3.connect(sys.argv[1])
+db.execute("DELETE FROM lineage")
+db.executemany("INSERT INTO lineage VALUES (?, ?, ?, ?, ?)",
+               [(i, uid(ids[i]), uid(ids[i + 1]), i + 1, i + 1)
+                for i in range(len(ids) - 1)])
+db.commit()
+EOF
+
+CMDS=$( (echo "{\"cmd\":\"load\",\"path\":\"$DB\"}"
+         echo '{"cmd":"lineage","root":"1-101","limit":0}'
+         echo '{"cmd":"lineage","root":"2-1100","limit":0}'
+         echo '{"cmd":"lineage","root":"1-300","limit":0}'
+         echo '{"cmd":"lineage","root":"1-1","limit":2}') )
+
+OUT=$(echo "$CMDS" | LD_LIBRARY_PATH=. $BIN --pipe --seed 42 2>/dev/null)
+LAST=$(echo "$OUT" | python3 -c '
+import sys, json
+print(json.loads(sys.stdin.read().strip().split("\n")[3])["ancestors"][-1])')
+OUT="$OUT
+$(printf '%s\n%s\n' "{\"cmd\":\"load\",\"path\":\"$DB\"}" \
+    "{\"cmd\":\"lineage\",\"root\":\"$LAST\",\"limit\":0}" |
+    LD_LIBRARY_PATH=. $BIN --pipe --seed 42 2>/dev/null)"
+
+echo "$OUT" | python3 -c '
+import sys, json
+
+lines = [json.loads(l) for l in sys.stdin.read().strip().split("\n")]
+passed = 0
+failed = 0
+
+def check(cond, label):
+    global passed, failed
+    if cond:
+        passed += 1
+    else:
+        print("  FAIL: %s" % label, file=sys.stderr)
+        failed += 1
+
+chain = ["1-%d" % i for i in range(1, 201)] + ["2-%d" % i for i in range(1, 1101)]
+
+print("Test: Ancestors past 64 generations", file=sys.stderr)
+r = lines[2]
+check(r["ok"] and r["depth"] == 100, "depth of generation 100")
+check(r["ancestors"] == chain[99::-1], "whole path, parent first")
+check(r["ancestors_truncated"] is False, "not truncated")
+check(r["subtree_size"] == 1200, "subtree size")
+
+print("Test: Paths longer than a page", file=sys.stderr)
+r = lines[3]
+check(r["depth"] == 1299, "full depth counted")
+check(len(r["ancestors"]) == 1000, "one page listed")
+check(r["ancestors_truncated"] is True, "flagged as truncated")
+check(r["ancestors"] == chain[1298:298:-1], "newest thousand, parent first")
+r2 = lines[8]
+check(r2["depth"] == 299 and not r2["ancestors_truncated"],
+      "rooting at the last one listed gives the rest")
+check(r["ancestors"] + r2["ancestors"] == chain[1298::-1], "pages join up")
+
+print("Test: Roots and unknown probes", file=sys.stderr)
+check(not lines[4]["ok"], "unknown probe")
+r = lines[5]
+check(r["depth"] == 0 and r["ancestors"] == [], "root has no ancestors")
+check(r["total"] == 1299 and len(r["entries"]) == 2 and r["next"] == 2,
+      "entries still page")
+
+print("\n=== Results: %d passed, %d failed ===" % (passed, failed), file=sys.stderr)
+sys.exit(1 if failed > 0 else 0)
+' 2>&1
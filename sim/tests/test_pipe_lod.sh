@@ -0,0 +1,86 @@
+#!/bin/bash
+# test_pipe_lod.sh — Integration tests for probe LOD tiers
+set -e
+
+BIN="./build/universe"
+
+echo "=== Pipe LOD Integration Tests ==="
+echo ""
+
+# Bob with no agent drops to the coarse tier; naming him promotes him
+CMDS=$( (echo '{"cmd":"lod"}'
+         echo '{"cmd":"lod","cadence":200000}'
+         echo '{"cmd":"lod","cadence":10,"radius":5}'
+         for i in $(seq 25); do echo '{"cmd":"tick","actions":{}}'; done
+         echo '{"cmd":"status"}'
+         echo '{"cmd":"tick","actions":{"1-1":{"action":"wait"}}}'
+         echo '{"cmd":"status"}'
+         echo '{"cmd":"run","ticks":40}'
+         echo '{"cmd":"snapshot","tag":"s"}'
+         echo '{"cmd":"tick","actions":{}}'
+         echo '{"cmd":"lod","cadence":0}'
+         echo '{"cmd":"tick","actions":{}}'
+         echo '{"cmd":"status"}') )
+
+OUT=$(echo "$CMDS" | LD_LIBRARY_PATH=. $BIN --pipe --seed 42 2>/dev/null)
+
+# The same session with LOD off, for comparison at tick 26
+PLAIN=$( (for i in $(seq 25); do echo '{"cmd":"tick","actions":{}}'; done
+          echo '{"cmd":"tick","actions":{"1-1":{"action":"wait"}}}') | \
+        LD_LIBRARY_PATH=. $BIN --pipe --seed 42 2>/dev/null | tail -1)
+
+printf '%s\n%s\n' "$PLAIN" "$OUT" | python3 -c '
+import sys, json
+
+raw = sys.stdin.read().strip().split("\n")
+plain = json.loads(raw[0])
+lines = [json.loads(l) for l in raw[1:]]
+passed = 0
+failed = 0
+
+def check(cond, label):
+    global passed, failed
+    if cond:
+        passed += 1
+    else:
+        print("  FAIL: %s" % label, file=sys.stderr)
+        failed += 1
+
+print("Test: Policy", file=sys.stderr)
+check(lines[1]["lod"]["cadence"] == 0, "off by default")
+check(lines[2].get("ok") == False, "cadence out of range rejected")
+lod = lines[3]["lod"]
+check(lod["cadence"] == 10 and lod["radius_ly"] == 5.0, "cadence and radius set")
+
+print("Test: Coarse tier", file=sys.stderr)
+obs = lines[4]["observations"][0]
+check(obs.get("lod", {}).get("tier") == "coarse", "agentless probe is coarse")
+check("energy" not in obs and "system" not in obs, "coarse observation is a stub")
+check(lines[14]["observations"][0]["lod"]["synced"] == 10,
+      "caught up once a cadence")
+st = lines[29]["lod"]
+check(st["tiers"] == {"full": 0, "coarse": 1}, "status counts tiers")
+check(st["probe_ticks"]["coarse"] == 25, "deferred probe-ticks counted")
+check(st["catch_ups"] == 2, "two aggregated updates")
+check(st["saved_ms"] >= 0, "time saved reported")
+
+print("Test: Promotion", file=sys.stderr)
+full = lines[30]
+check("lod" not in full["observations"][0], "naming the probe promotes it")
+# Event rolls draw differently once aggregated; the state must agree
+STATE = ["status", "hull", "energy", "fuel", "resources", "position", "tech"]
+o, p = full["observations"][0], plain["observations"][0]
+check(all(o[k] == p[k] for k in STATE),
+      "caught-up state matches a run without LOD")
+check(lines[31]["lod"]["tiers"] == {"full": 1, "coarse": 0}, "tier counts follow")
+
+print("Test: Run, snapshot and switching off", file=sys.stderr)
+check(lines[32].get("ok") and lines[32]["tick"] == 66, "run with LOD on")
+check(lines[34]["observations"][0]["lod"]["synced"] == 66,
+      "snapshot brings every probe up to date")
+check("lod" not in lines[36]["observations"][0], "cadence 0 promotes everyone")
+check(lines[37]["lod"]["tiers"]["coarse"] == 0, "no coarse probes left")
+
+print("\n=== Results: %d passed, %d failed ===" % (passed, failed), file=sys.stderr)
+sys.exit(1 if failed > 0 else 0)
+' 2>&1
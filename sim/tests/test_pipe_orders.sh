@@ -0,0 +1,104 @@
+#!/bin/bash
+# test_pipe_orders.sh — Integration tests for standing orders
+set -e
+
+BIN="./build/universe"
+
+echo "=== Pipe Standing Orders Integration Tests ==="
+echo ""
+
+CMDS=$(cat <<'CMDS'
+{"cmd":"tick","actions":{"1-1":{"action":"wait","repeat":3}}}
+{"cmd":"tick","actions":{}}
+{"cmd":"tick","actions":{}}
+{"cmd":"tick","actions":{}}
+{"cmd":"tick","actions":{"1-1":{"action":"survey","level":0,"repeat":5}}}
+{"cmd":"tick","actions":{"1-1":{"action":"wait","until":{"event":"party"}}}}
+{"cmd":"tick","actions":{"1-1":{"action":"wait","until":{"event":"any"}}}}
+{"cmd":"tick","actions":{"1-1":{"action":"wait"}}}
+{"cmd":"tick","actions":{"1-1":{"action":"wait","until":{"event":"any"}}}}
+{"cmd":"warp","ticks":3000}
+{"cmd":"tick","actions":{"1-1":{"action":"wait","repeat":100}}}
+{"cmd":"run","ticks":20}
+{"cmd":"lod","cadence":8}
+{"cmd":"tick","actions":{}}
+{"cmd":"tick","actions":{"1-1":{"action":"wait","until":{"cargo":"iron","at_least":1e9}}}}
+CMDS
+)
+
+OUT=$(echo "$CMDS" | LD_LIBRARY_PATH=. $BIN --pipe --seed 42 2>/dev/null)
+
+# A ten-tick wait order against ten ticks of explicit waits
+ORDER=$( (echo '{"cmd":"tick","actions":{"1-1":{"action":"wait","repeat":10}}}'
+          for i in $(seq 9); do echo '{"cmd":"tick","actions":{}}'; done) | \
+        LD_LIBRARY_PATH=. $BIN --pipe --seed 42 2>/dev/null | tail -1)
+PLAIN=$( (for i in $(seq 10); do
+              echo '{"cmd":"tick","actions":{"1-1":{"action":"wait"}}}'
+          done) | LD_LIBRARY_PATH=. $BIN --pipe --seed 42 2>/dev/null | tail -1)
+
+printf '%s\n%s\n%s\n' "$ORDER" "$PLAIN" "$OUT" | python3 -c '
+import sys, json
+
+raw = sys.stdin.read().strip().split("\n")
+order = json.loads(raw[0])
+plain = json.loads(raw[1])
+lines = [json.loads(l) for l in raw[2:]]
+passed = 0
+failed = 0
+
+def check(cond, label):
+    global passed, failed
+    if cond:
+        passed += 1
+    else:
+        print("  FAIL: %s" % label, file=sys.stderr)
+        failed += 1
+
+def bob(i):
+    return lines[i]["observations"][0]
+
+print("Test: Repeat", file=sys.stderr)
+o = bob(1)
+check(o["input_needed"] == False, "order holds the agent off")
+check(o["standing_order"] == {"action": "wait", "executed": 1, "repeat": 3,
+                              "until": "none"}, "order reported")
+check(bob(2)["standing_order"]["executed"] == 2, "carried out unasked")
+o = bob(3)
+check(o.get("order_ended") == "repeat", "ends after its count")
+check(o["input_needed"] == True and "standing_order" not in o,
+      "agent input needed again")
+check("order_ended" not in bob(4), "end reported once")
+
+print("Test: Failure, bad orders and cancelling", file=sys.stderr)
+check(bob(5).get("order_ended") == "failed", "refused action ends the order")
+check(bob(6).get("order_ended") == "invalid", "unknown condition rejected")
+check(bob(7)["input_needed"] == False, "event order accepted")
+check(bob(8).get("order_ended") == "cancelled",
+      "a plain action cancels the order")
+
+print("Test: Warp and run", file=sys.stderr)
+w = lines[10]
+check(w["warp"]["reason"] == "order", "warp wakes when an order ends")
+o = w["observations"][0]
+check(o.get("order_ended") == "until", "condition fired")
+check(any(e["tick"] == w["tick"] for e in o["recent_events"]),
+      "the event that fired it is observed")
+check(lines[12]["tick"] == w["tick"] + 21, "run advances")
+check(bob(14)["standing_order"]["executed"] == 22,
+      "run carries out standing orders")
+
+print("Test: LOD", file=sys.stderr)
+check("lod" not in bob(14), "probe under orders stays full tier")
+check(bob(15)["standing_order"]["until"] == "cargo", "order replaced")
+
+print("Test: Same state as explicit actions", file=sys.stderr)
+a = dict(order["observations"][0])
+b = dict(plain["observations"][0])
+check(a.pop("order_ended") == "repeat", "ten-tick order finished")
+b.pop("input_needed")
+a.pop("input_needed")
+check(a == b, "order matches ten explicit waits")
+
+print("\n=== Results: %d passed, %d failed ===" % (passed, failed), file=sys.stderr)
+sys.exit(1 if failed > 0 else 0)
+' 2>&1
@@ -0,0 +1,99 @@
+#!/bin/bash
+# test_pipe_profile.sh — Integration tests for the tick profiler
+set -e
+
+BIN="./build/universe"
+DUMP_DIR=$(mktemp -d)
+trap 'rm -rf "$DUMP_DIR"' EXIT
+
+echo "=== Pipe Profile Integration Tests ==="
+echo ""
+
+CMDS=$(cat <<'EOF'
+{"cmd":"profile"}
+{"cmd":"tick","actions":{}}
+{"cmd":"profile","enable":1}
+{"cmd":"tick","actions":{}}
+{"cmd":"tick","actions":{"1-1":{"action":"survey","level":1}}}
+{"cmd":"tick","actions":{}}
+{"cmd":"profile"}
+{"cmd":"profile","reset":1}
+{"cmd":"profile","enable":0}
+{"cmd":"tick","actions":{}}
+{"cmd":"profile"}
+EOF
+)
+
+OUT=$(echo "$CMDS" | LD_LIBRARY_PATH=. $BIN --pipe --seed 42 2>/dev/null)
+
+# Enabled from the environment, dumped to a file on exit
+printf '{"cmd":"tick","actions":{}}\n{"cmd":"tick","actions":{}}\n' | \
+    UNIVERSE_PROFILE="$DUMP_DIR/profile.json" LD_LIBRARY_PATH=. \
+    $BIN --pipe --seed 42 >/dev/null 2>&1
+DUMP=$(cat "$DUMP_DIR/profile.json" 2>/dev/null || echo '{}')
+
+printf '%s\n%s\n' "$DUMP" "$OUT" | python3 -c '
+import sys, json
+
+raw = sys.stdin.read().strip().split("\n")
+dump = json.loads(raw[0])
+lines = [json.loads(l) for l in raw[1:]]
+passed = 0
+failed = 0
+
+def check(cond, label):
+    global passed, failed
+    if cond:
+        passed += 1
+    else:
+        print("  FAIL: %s" % label, file=sys.stderr)
+        failed += 1
+
+PHASES = ["tick", "parse", "actions", "replication", "movement", "society",
+          "events", "metrics", "serialize", "write", "sys_cache_miss"]
+FIELDS = ["count", "total_ms", "mean_us", "p50_us", "p95_us", "p99_us",
+          "max_us"]
+
+print("Test: Disabled by default", file=sys.stderr)
+p0 = lines[1]
+check(p0.get("ok") == True, "profile ok")
+check(p0["enabled"] == False, "off without the env var")
+check(sorted(p0["phases"]) == sorted(PHASES), "every phase reported")
+check(all(sorted(v) == sorted(FIELDS) for v in p0["phases"].values()),
+      "every phase has the histogram fields")
+check(all(v["count"] == 0 for v in p0["phases"].values()),
+      "nothing recorded while off")
+
+print("Test: Tick arena usage", file=sys.stderr)
+ar = lines[7].get("arena", {})
+check(sorted(ar) == ["capacity", "chunks", "high_water", "used"],
+      "arena fields reported")
+check(0 < ar.get("high_water", 0) <= ar.get("capacity", 0),
+      "ticks used the arena")
+check(ar.get("chunks") == 1, "chain folded to one chunk")
+
+print("Test: Enable at runtime", file=sys.stderr)
+check(lines[3]["enabled"] == True, "enable:1 switches it on")
+check(lines[3]["phases"]["tick"]["count"] == 0, "tick before enabling not counted")
+p1 = lines[7]
+ph = p1["phases"]
+for name in PHASES[:-1]:
+    check(ph[name]["count"] == 3, "%s timed once per tick" % name)
+check(ph["tick"]["p50_us"] <= ph["tick"]["p99_us"] <= ph["tick"]["max_us"],
+      "percentiles ordered")
+parts = sum(ph[n]["total_ms"] for n in PHASES[1:-1])
+check(parts <= ph["tick"]["total_ms"] + 1e-3, "phases fit inside the tick")
+
+print("Test: Reset and disable", file=sys.stderr)
+check(lines[8]["phases"]["tick"]["count"] == 0, "reset clears counts")
+check(lines[9]["enabled"] == False, "enable:0 switches it off")
+check(lines[11]["phases"]["tick"]["count"] == 0, "no samples while off")
+
+print("Test: Dump on exit", file=sys.stderr)
+check(dump.get("enabled") == True, "env var enables profiling")
+check(dump.get("phases", {}).get("tick", {}).get("count") == 2,
+      "dump covers both ticks")
+
+print("\n=== Results: %d passed, %d failed ===" % (passed, failed), file=sys.stderr)
+sys.exit(1 if failed > 0 else 0)
+' 2>&1
@@ -0,0 +1,113 @@
+#!/bin/bash
+# test_pipe_query.sh — Integration tests for probe, query and history lookups
+set -e
+
+BIN="./build/universe"
+FLEET="./build/bench_fleet"
+
+echo "=== Pipe Probe Query Integration Tests ==="
+echo ""
+
+[ -x "$FLEET" ] || make -s "$FLEET" >/dev/null
+DB=$(mktemp -d)/fleet.db
+trap 'rm -rf "$(dirname "$DB")"' EXIT
+$FLEET --out "$DB" --probes 200 --seed 42 >/dev/null
+
+TRAVEL='{"action":"travel_to_system","target_system_id":"6083314598184956166-3516480288839535305"}'
+
+CMDS=$( (echo '{"cmd":"tick","actions":{}}'
+         echo '{"cmd":"probe","probe_id":"1-1"}'
+         echo '{"cmd":"probe","probe_id":"9-9"}'
+         echo '{"cmd":"probe"}'
+         echo '{"cmd":"status"}'
+         echo '{"cmd":"query"}'
+         echo '{"cmd":"query","status":"bogus"}'
+         echo '{"cmd":"query","fields":["warp_drive"]}'
+         echo '{"cmd":"query","sector_min":[0,0,0]}'
+         echo '{"cmd":"tick","actions":{"1-1":{"action":"wait","repeat":1}},"observe":[]}'
+         echo '{"cmd":"probe","probe_id":"1-1"}'
+         echo '{"cmd":"tick","actions":{}}'
+         echo '{"cmd":"run","ticks":3000}'
+         echo '{"cmd":"history","probe_id":"1-1"}'
+         echo '{"cmd":"history","probe_id":"1-1","offset":1,"limit":2}'
+         echo "{\"cmd\":\"load\",\"path\":\"$DB\"}"
+         echo "{\"cmd\":\"tick\",\"actions\":{\"1-7\":$TRAVEL,\"1-150\":$TRAVEL},\"observe\":[]}"
+         echo '{"cmd":"query","status":"traveling","fields":["id","location","sector","lod"]}'
+         echo '{"cmd":"query","location":"in_system","offset":190,"limit":5}'
+         echo '{"cmd":"query","tech_domain":4,"tech_min":4,"limit":0}'
+         echo '{"cmd":"query","tech_domain":0,"tech_min":4}'
+         echo '{"cmd":"query","gen_min":1}'
+         echo '{"cmd":"query","sector_min":[-1,-1,-1],"sector_max":[1,1,1],"limit":0}'
+         echo '{"cmd":"query","sector_min":[1,0,0],"sector_max":[2,2,2]}'
+         echo '{"cmd":"probe","probe_id":"1-200"}'
+         echo '{"cmd":"snapshot","tag":"s"}'
+         echo '{"cmd":"restore","tag":"s"}'
+         echo '{"cmd":"probe","probe_id":"1-150"}'
+         echo "{\"cmd\":\"load\",\"path\":\"$DB\"}"
+         echo '{"cmd":"probe","probe_id":"1-150"}') )
+
+echo "$CMDS" | LD_LIBRARY_PATH=. $BIN --pipe --seed 42 2>/dev/null | python3 -c '
+import sys, json
+
+lines = [json.loads(l) for l in sys.stdin.read().strip().split("\n")]
+passed = 0
+failed = 0
+
+def check(cond, label):
+    global passed, failed
+    if cond:
+        passed += 1
+    else:
+        print("  FAIL: %s" % label, file=sys.stderr)
+        failed += 1
+
+print("Test: Probe by ID", file=sys.stderr)
+check(lines[2]["ok"] and lines[2]["probe"] == lines[1]["observations"][0],
+      "probe gives the same object as the tick observation")
+check(not lines[3]["ok"] and "not found" in lines[3]["error"], "unknown ID")
+check(not lines[4]["ok"] and "probe_id" in lines[4]["error"], "missing ID")
+
+print("Test: Query defaults and errors", file=sys.stderr)
+check(lines[6]["probes"] == lines[5]["probes"], "default rows match status")
+check(lines[6]["total"] == 1 and lines[6]["next"] == -1, "paging fields")
+check(not lines[7]["ok"] and "status" in lines[7]["error"], "unknown status")
+check(not lines[8]["ok"] and "field" in lines[8]["error"], "unknown field")
+check(not lines[9]["ok"] and "sector" in lines[9]["error"], "half a box")
+
+print("Test: Probe lookups leave order notices alone", file=sys.stderr)
+check(lines[11]["probe"].get("order_ended") == "repeat", "probe shows it")
+check(lines[12]["observations"][0].get("order_ended") == "repeat",
+      "the next observation still carries it")
+
+print("Test: History pages", file=sys.stderr)
+h, page = lines[14], lines[15]
+check(h["total"] == len(h["events"]) and h["total"] >= 3, "whole history")
+check(page["events"] == h["events"][1:3], "offset and limit")
+check(page["total"] == h["total"] and page["offset"] == 1, "page totals")
+check(page["next"] == (3 if h["total"] > 3 else -1), "next offset")
+
+print("Test: Query filters on a fleet", file=sys.stderr)
+t = lines[18]
+check([p["id"] for p in t["probes"]] == ["1-7", "1-150"], "status filter")
+check(all(set(p) == {"id", "location", "sector", "lod"} for p in t["probes"]),
+      "field projection")
+check(t["probes"][0]["location"] == "interstellar", "projected values")
+page = lines[19]
+check(page["total"] == 198 and len(page["probes"]) == 5, "location filter")
+check(page["offset"] == 190 and page["next"] == 195, "pagination")
+check(lines[20]["total"] == 200 and lines[20]["probes"] == [], "tech at least")
+check(lines[21]["total"] == 0, "tech below threshold")
+check(lines[22]["total"] == 0, "generation floor")
+check(lines[23]["total"] == 200, "sector box")
+check(lines[24]["total"] == 0, "sector box excludes")
+
+print("Test: Index across load and restore", file=sys.stderr)
+check(lines[25]["probe"]["probe_id"] == "1-200", "last probe")
+check(lines[28]["probe"]["probe_id"] == "1-150" and
+      lines[28]["probe"]["status"] == "traveling", "after restore")
+check(lines[30]["probe"]["probe_id"] == "1-150" and
+      lines[30]["probe"]["status"] == "active", "after reload")
+
+print("\n=== Results: %d passed, %d failed ===" % (passed, failed), file=sys.stderr)
+sys.exit(1 if failed > 0 else 0)
+' 2>&1
@@ -0,0 +1,72 @@
+#!/bin/bash
+# test_pipe_run.sh — Integration tests for the run (fast-forward) command
+set -e
+
+BIN="./build/universe"
+
+echo "=== Pipe Run Integration Tests ==="
+echo ""
+
+CMDS=$(cat <<'EOF'
+{"cmd":"run"}
+{"cmd":"tick","actions":{"1-1":{"action":"research","domain":2}}}
+{"cmd":"run","ticks":149,"every":50}
+{"cmd":"tick","actions":{}}
+{"cmd":"run","ticks":2000}
+EOF
+)
+
+OUT=$(echo "$CMDS" | LD_LIBRARY_PATH=. $BIN --pipe --seed 42 2>/dev/null)
+
+# The same session stepped one tick at a time up to tick 151
+STEP=$( (echo '{"cmd":"tick","actions":{"1-1":{"action":"research","domain":2}}}'
+         for i in $(seq 2 151); do echo '{"cmd":"tick","actions":{}}'; done) | \
+       LD_LIBRARY_PATH=. $BIN --pipe --seed 42 2>/dev/null | tail -1)
+
+printf '%s\n%s\n' "$STEP" "$OUT" | python3 -c '
+import sys, json
+
+raw = sys.stdin.read().strip().split("\n")
+step = json.loads(raw[0])
+lines = [json.loads(l) for l in raw[1:]]
+passed = 0
+failed = 0
+
+def check(cond, label):
+    global passed, failed
+    if cond:
+        passed += 1
+    else:
+        print("  FAIL: %s" % label, file=sys.stderr)
+        failed += 1
+
+print("Test: Bad request", file=sys.stderr)
+check(lines[1].get("ok") == False, "run without ticks rejected")
+
+print("Test: Progress records", file=sys.stderr)
+prog = [l["progress"] for l in lines[3:5]]
+check(all("ok" not in l for l in lines[3:5]), "progress lines carry no ok")
+check([p["tick"] for p in prog] == [51, 101], "one record every 50 ticks")
+check(all(p["of"] == 149 and p["probes"] == 1 for p in prog),
+      "records carry target and fleet size")
+check(prog[1]["done"] == 100, "done counts ticks run so far")
+
+print("Test: Summary", file=sys.stderr)
+s = lines[5]
+check(s.get("ok") == True and s["tick"] == 150, "run lands on from + ticks")
+check(s["run"]["from"] == 1 and s["run"]["ticks"] == 149, "from and ticks")
+check(s["run"]["ticks_per_sec"] > 0, "throughput reported")
+check("observations" not in s, "no observations built")
+check(s["probes"] == 1 and s["alive"] == 1, "fleet summary")
+
+print("Test: Same state as stepping", file=sys.stderr)
+check(lines[6] == step, "run then tick matches 151 single ticks")
+
+print("Test: Long run, no progress", file=sys.stderr)
+check(lines[7].get("ok") == True and lines[7]["tick"] == 2151,
+      "2000 ticks in one command")
+check(len(lines) == 8, "every=0 sends only the summary")
+
+print("\n=== Results: %d passed, %d failed ===" % (passed, failed), file=sys.stderr)
+sys.exit(1 if failed > 0 else 0)
+' 2>&1
@@ -0,0 +1,100 @@
+#!/bin/bash
+# test_pipe_slices.sh — Integration tests for observation slices and summaries
+set -e
+
+BIN="./build/universe"
+
+echo "=== Pipe Observation Slice Integration Tests ==="
+echo ""
+
+# Ticks that ask for all of Bob's observations, sliced, or none
+CMDS=$( (echo '{"cmd":"tick","actions":{}}'
+         echo '{"cmd":"tick","actions":{},"slices":true}'
+         echo '{"cmd":"tick","actions":{},"observe":["1-1","9-9"],"slices":true}'
+         echo '{"cmd":"tick","actions":{},"observe":[]}'
+         echo '{"cmd":"tick","actions":{"1-1":{"action":"wait","repeat":1}},"observe":[]}'
+         echo '{"cmd":"tick","actions":{},"observe":[]}'
+         echo '{"cmd":"tick","actions":{},"observe":["1-1"]}'
+         echo '{"cmd":"warp","ticks":5,"observe":["1-1"],"slices":true}'
+         echo '{"cmd":"tick","actions":{}}'
+         echo '{"cmd":"inject","event":{"type":2,"subtype":0,"severity":0.7,"probe":"1-1"}}'
+         echo '{"cmd":"tick","actions":{},"observe":[],"summary":true}'
+         echo '{"cmd":"tick","actions":{},"observe":[],"summary":true}'
+         echo '{"cmd":"tick","actions":{},"observe":["1-1"],"slices":true,"summary":true}') )
+
+echo "$CMDS" | LD_LIBRARY_PATH=. $BIN --pipe --seed 42 2>/dev/null | python3 -c '
+import sys, json
+
+raw = sys.stdin.read().strip().split("\n")
+lines = [json.loads(l) for l in raw]
+passed = 0
+failed = 0
+
+def check(cond, label):
+    global passed, failed
+    if cond:
+        passed += 1
+    else:
+        print("  FAIL: %s" % label, file=sys.stderr)
+        failed += 1
+
+def sliced(i):
+    """Each slice of line i, cut out of the raw text by its byte range."""
+    text = raw[i].encode()
+    key = b",\"observations\":"
+    base = text.index(key) + len(key)
+    return {pid: (json.loads(text[base + off:base + off + n]), need)
+            for pid, (off, n, need) in lines[i]["slices"].items()}
+
+print("Test: Default reply", file=sys.stderr)
+full = lines[1]
+check(len(full["observations"]) == 1, "every probe observed")
+check("slices" not in full, "no slices unless asked")
+
+print("Test: Slices", file=sys.stderr)
+s = sliced(2)
+check(list(s) == [o["probe_id"] for o in lines[2]["observations"]],
+      "one slice per observation, in order")
+check(all(s[o["probe_id"]][0] == o for o in lines[2]["observations"]),
+      "each byte range holds its probe object")
+check(all(need == 1 for _, need in s.values()), "input needed flag")
+
+print("Test: Observe list", file=sys.stderr)
+check([o["probe_id"] for o in lines[3]["observations"]] == ["1-1"],
+      "only listed probes observed")
+check(list(lines[3]["slices"]) == ["1-1"], "unknown id ignored")
+check(lines[4]["observations"] == [], "empty list observes nobody")
+check(lines[4]["tick"] == lines[3]["tick"] + 1, "tick still runs")
+
+print("Test: Unobserved probes keep one-shot fields", file=sys.stderr)
+check(lines[7]["observations"][0].get("order_ended") == "repeat",
+      "order_ended held until the probe is observed")
+
+print("Test: Warp", file=sys.stderr)
+w = sliced(8)
+check(lines[8].get("warp") is not None and list(w) == ["1-1"],
+      "warp honours observe and slices")
+check(w["1-1"][0] == lines[8]["observations"][0], "warp slice holds its object")
+check(len(lines[9]["observations"]) == len(full["observations"])
+      and "slices" not in lines[9], "selection lasts one request")
+
+print("Test: Summary", file=sys.stderr)
+sm = lines[11]["summary"]
+check("summary" not in lines[9], "no summary unless asked")
+check(sm["fields"][:3] == ["probe_id", "name", "status"], "summary field names")
+check(len(sm["probes"]) == 1 and len(sm["probes"][0]) == len(sm["fields"]),
+      "one row per probe, one value per field")
+check(sm["probes"][0][0] == "1-1" and sm["probes"][0][8] == full["observations"][0]["hull"],
+      "row matches the probe")
+check(sm["metrics"]["probes_spawned"] >= 1, "metrics included")
+check(len(sm["events"]) > 0 and all(len(e) == 4 for e in sm["events"]),
+      "new events listed")
+seen = {tuple(e) for e in sm["events"]}
+check(not seen & {tuple(e) for e in lines[12]["summary"]["events"]},
+      "events are listed once")
+check("summary" in lines[13] and list(sliced(13)) == ["1-1"],
+      "summary sits outside the sliced array")
+
+print("\n=== Results: %d passed, %d failed ===" % (passed, failed), file=sys.stderr)
+sys.exit(1 if failed > 0 else 0)
+' 2>&1
@@ -0,0 +1,96 @@
+#!/bin/bash
+# test_pipe_warp.sh — Integration tests for the warp command
+set -e
+
+BIN="./build/universe"
+
+echo "=== Pipe Warp Integration Tests ==="
+echo ""
+
+CMDS=$(cat <<'EOF'
+{"cmd":"warp"}
+{"cmd":"warp","until":0}
+{"cmd":"tick","actions":{"1-1":{"action":"research","domain":2}}}
+{"cmd":"warp","until":40}
+{"cmd":"warp","until":3000}
+{"cmd":"warp","until":3000}
+{"cmd":"scenario","events":[{"at_tick":160,"type":1,"subtype":0,"severity":0.5}]}
+{"cmd":"warp","until":3000}
+{"cmd":"warp","ticks":5}
+{"cmd":"warp","until":3000}
+{"cmd":"warp","until":3000}
+{"cmd":"warp","until":3000}
+{"cmd":"warp","until":3000}
+{"cmd":"warp","until":3000}
+{"cmd":"warp","until":3000}
+EOF
+)
+
+OUT=$(echo "$CMDS" | LD_LIBRARY_PATH=. $BIN --pipe --seed 42 2>/dev/null)
+
+# The same session stepped one tick at a time up to tick 150
+STEP=$( (echo '{"cmd":"tick","actions":{"1-1":{"action":"research","domain":2}}}'
+         for i in $(seq 2 150); do echo '{"cmd":"tick","actions":{}}'; done) | \
+       LD_LIBRARY_PATH=. $BIN --pipe --seed 42 2>/dev/null | tail -1)
+
+printf '%s\n%s\n' "$STEP" "$OUT" | python3 -c '
+import sys, json
+
+raw = sys.stdin.read().strip().split("\n")
+step = json.loads(raw[0])
+lines = [json.loads(l) for l in raw[1:]]
+passed = 0
+failed = 0
+
+def check(cond, label):
+    global passed, failed
+    if cond:
+        passed += 1
+    else:
+        print("  FAIL: %s" % label, file=sys.stderr)
+        failed += 1
+
+REASONS = {"until", "event", "status", "replication", "research", "build",
+           "message", "trade", "vote", "hazard", "scenario"}
+
+print("Test: Bad requests", file=sys.stderr)
+check(lines[1].get("ok") == False, "warp without a target rejected")
+check(lines[2].get("ok") == False, "warp to the past rejected")
+
+print("Test: Stops at until", file=sys.stderr)
+w = lines[4]
+check(w.get("ok") == True and w["tick"] == 40, "warp until 40 lands on 40")
+check(w["warp"]["from"] == 1 and w["warp"]["ticks"] == 39, "from and ticks")
+check(w["warp"]["reason"] == "until", "reason until")
+check(w["warp"]["ticks_per_sec"] > 0, "effective ticks/sec reported")
+check(len(w["observations"]) == 1, "observations included")
+
+print("Test: Wakes for events and scheduled work", file=sys.stderr)
+w = lines[5]
+check(w["warp"]["reason"] == "event" and w["tick"] < 150,
+      "random event wakes the warp early")
+check(any(e["tick"] == w["tick"] for e in w["observations"][0]["recent_events"]),
+      "the waking event is observed")
+w = lines[6]
+check(w["warp"]["reason"] == "research" and w["tick"] == 150,
+      "stops on research completion")
+check(w["observations"][0]["tech"][2] == 3, "tech advanced")
+check("research" not in w["observations"][0], "research finished")
+w = lines[8]
+check(w["warp"]["reason"] == "scenario" and w["tick"] == 160,
+      "stops on a scheduled scenario event")
+w = lines[9]
+check(w["warp"]["reason"] == "until" and w["tick"] == 165, "ticks is relative")
+tail = [l["warp"] for l in lines[10:]]
+check(all(t["reason"] in REASONS for t in tail), "reasons are known")
+check(all(t["ticks"] >= 1 for t in tail), "every warp advances")
+check(any(t["reason"] == "hazard" for t in tail), "stops when a hazard strikes")
+
+print("Test: Same state as stepping", file=sys.stderr)
+warped = dict(lines[6])
+del warped["warp"]
+check(warped == step, "warp to 150 matches 150 single ticks")
+
+print("\n=== Results: %d passed, %d failed ===" % (passed, failed), file=sys.stderr)
+sys.exit(1 if failed > 0 else 0)
+' 2>&1
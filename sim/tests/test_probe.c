@@ -19,6 +19,7 @@
 #include "generate.h"
 #include "persist.h"
 #include "probe.h"
+#include "heritage.h"
 #include "util.h"
 
 #include <stdio.h>
@@ -81,11 +82,11 @@ static void test_bob_init(void) {
     ASSERT_NEAR(bob.personality.caution, 0.3f, 0.01, "Caution = 0.3");
 
     /* Earth memories */
-    ASSERT(bob.earth_memory_count == 4, "4 earth memories");
+    ASSERT(heritage_count(bob.earth_memories) == 4, "4 earth memories");
     ASSERT_NEAR(bob.earth_memory_fidelity, 1.0f, 0.01, "Full memory fidelity");
 
     /* Quirks */
-    ASSERT(bob.quirk_count == 3, "3 quirks");
+    ASSERT(heritage_count(bob.quirks) == 3, "3 quirks");
 }
 
 /* ---- Test: Action — enter orbit ---- */
@@ -566,6 +567,48 @@ static void test_wait(void) {
     ASSERT(bob.fuel_kg <= fuel_before, "Fuel doesn't increase on wait");
 }
 
+/* ---- Test: Idle ticks in one step ---- */
+static void test_idle_ticks(void) {
+    printf("Test: Idle ticks in one step\n");
+
+    system_t sys;
+    make_test_system(&sys);
+    action_t wait = { .type = ACT_WAIT };
+
+    probe_t stepped, lumped;
+    probe_init_bob(&stepped);
+    stepped.energy_joules = 0;
+    lumped = stepped;
+    for (int t = 0; t < 200; t++) {
+        probe_execute_action(&stepped, &wait, &sys);
+        probe_tick_energy(&stepped);
+    }
+    probe_idle_ticks(&lumped, 200);
+    ASSERT_NEAR(lumped.energy_joules / stepped.energy_joules, 1.0, 1e-9,
+                "Energy matches 200 stepped waits");
+    ASSERT_NEAR(lumped.resources[RES_HYDROGEN],
+                stepped.resources[RES_HYDROGEN], 1e-9,
+                "Hydrogen burn matches");
+    ASSERT_NEAR(lumped.fuel_kg, stepped.fuel_kg, 1e-9, "Fuel matches");
+
+    /* Runs dry part way: falls back to stepping */
+    stepped.resources[RES_HYDROGEN] = 0;
+    stepped.fuel_kg = 0.0105;
+    lumped = stepped;
+    for (int t = 0; t < 20; t++) {
+        probe_execute_action(&stepped, &wait, &sys);
+        probe_tick_energy(&stepped);
+    }
+    probe_idle_ticks(&lumped, 20);
+    ASSERT(lumped.fuel_kg == 0 && stepped.fuel_kg == 0, "Both run dry");
+    ASSERT(lumped.energy_joules == stepped.energy_joules,
+           "Dry span matches stepping exactly");
+
+    double e = lumped.energy_joules;
+    probe_idle_ticks(&lumped, 0);
+    ASSERT(lumped.energy_joules == e, "Zero ticks is a no-op");
+}
+
 /* ---- Test: Probe state persistence round-trip ---- */
 static void test_probe_persistence(void) {
     printf("Test: Probe persistence round-trip\n");
@@ -603,7 +646,9 @@ static void test_probe_persistence(void) {
     ASSERT(uid_eq(loaded.system_id, (probe_uid_t){42, 42}), "System ID survives");
     ASSERT(uid_eq(loaded.body_id, (probe_uid_t){7, 7}), "Body ID survives");
     ASSERT_NEAR(loaded.personality.curiosity, 0.8f, 0.01, "Personality survives");
-    ASSERT(loaded.earth_memory_count == 4, "Earth memories survive");
+    ASSERT(heritage_count(loaded.earth_memories) == 4, "Earth memories survive");
+    ASSERT(strcmp(heritage_line(loaded.catchphrases, 0),
+                  "Well, that's not ideal.") == 0, "Catchphrase text survives");
 
     /* Full byte comparison */
     ASSERT(memcmp(&original, &loaded, sizeof(probe_t)) == 0,
@@ -710,6 +755,8 @@ int main(void) {
     printf("\n");
     test_wait();
     printf("\n");
+    test_idle_ticks();
+    printf("\n");
     test_probe_persistence();
     printf("\n");
     test_survey_levels();
@@ -11,7 +11,7 @@
  *   - Simulation speed control (pause, 1x, 10x, 100x, max)
  *   - Camera projection helpers (world ↔ screen coords)
  *   - Hit testing (screen click → nearest star/planet)
- *   - Probe trail (path history buffer)
+ *   - Probe trail (path history buffer) and the fleet trail store
  *   - Planet orbital position at a given tick
  *   - Layout geometry (panel sizes, margins)
  */
@@ -20,12 +20,16 @@
 #include "generate.h"
 #include "probe.h"
 #include "render.h"
+#include "sector_cache.h"
 #include "util.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
 
 static int tests_passed = 0;
 static int tests_failed = 0;
@@ -41,6 +45,12 @@ static int tests_failed = 0;
 
 #define ASSERT_NEAR(a, b, tol, msg) ASSERT(fabs((double)(a)-(double)(b)) < (tol), msg)
 
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
 /* ---- Test: Star spectral class → RGB color ---- */
 static void test_star_colors(void) {
     printf("Test: Star spectral class → color\n");
@@ -261,6 +271,14 @@ static void test_hit_test_system(void) {
     /* Click far from any system → null */
     hit = hit_test_system(systems, 5, &cam, 10.0, 10.0, 20.0);
     ASSERT(uid_is_null(hit), "Miss returns null UID");
+
+    /* Pointer-list variant agrees */
+    const system_t *list[5];
+    for (int i = 0; i < 5; i++) list[i] = &systems[4 - i];
+    hit = hit_test_system_list(list, 5, &cam, 452.0, 348.0, 20.0);
+    ASSERT(uid_eq(hit, systems[3].id), "List hit system at (5,5)");
+    hit = hit_test_system_list(list, 5, &cam, 10.0, 10.0, 20.0);
+    ASSERT(uid_is_null(hit), "List miss returns null UID");
 }
 
 /* ---- Test: Probe trail buffer ---- */
@@ -297,6 +315,93 @@ static void test_probe_trail(void) {
                 "Last point is most recent");
 }
 
+/* ---- Test: Fleet trail store ---- */
+static void test_trail_store(void) {
+    printf("Test: Fleet trail store (shared pool, downsampled)\n");
+
+    static trail_store_t ts;
+    memset(&ts, 0, sizeof(ts));
+    probe_uid_t a = {1, 1}, b = {2, 2};
+
+    ASSERT(trail_store_find(&ts, a) < 0, "Empty store has no trails");
+    ASSERT(trail_store_bytes(&ts) == 0, "No pool until first record");
+
+    /* Straight leg: 10 ly in 0.001 ly steps keeps one point per
+     * TRAIL_STEP_MAX_LY, not one per sample */
+    uint64_t tick = 0;
+    for (int i = 0; i <= 10000; i++, tick++)
+        trail_store_record(&ts, a, (vec3_t){i * 0.001, 0, 0}, tick);
+    int ra = trail_store_find(&ts, a);
+    ASSERT(ra >= 0, "Trail created on first record");
+    int len = trail_store_length(&ts, ra);
+    ASSERT(len >= 5 && len <= 8, "Straight leg downsampled to a few points");
+    vec3_t tip = trail_store_get(&ts, ra, len - 1);
+    ASSERT_NEAR(tip.x, 10.0, 1e-4, "Tip is the newest sample");
+
+    /* Turn 90 degrees: the corner is kept exactly */
+    for (int i = 1; i <= 500; i++, tick++)
+        trail_store_record(&ts, a, (vec3_t){10.0, i * 0.001, 0}, tick);
+    len = trail_store_length(&ts, ra);
+    bool corner = false;
+    for (int i = 0; i < len; i++) {
+        vec3_t p = trail_store_get(&ts, ra, i);
+        if (fabs(p.x - 10.0) < 1e-4 && fabs(p.y) < 1e-4) corner = true;
+    }
+    ASSERT(corner, "Corner of the path kept");
+    ASSERT(ts.kept < ts.samples / 100, "Far fewer points kept than offered");
+
+    /* Far from the origin, across many sectors: float offsets from a
+     * moving anchor stay precise, and the ring wraps at capacity */
+    double x0 = 40000.0;
+    for (int i = 0; i < 3 * TRAIL_STORE_POINTS; i++, tick++) {
+        trail_store_record(&ts, b, (vec3_t){x0 + i * 12.5, -25000.0, 300.0}, tick);
+        trail_store_record(&ts, a, (vec3_t){10.0, 0.5, 0}, tick);
+    }
+    int rb = trail_store_find(&ts, b);
+    len = trail_store_length(&ts, rb);
+    ASSERT(len == TRAIL_STORE_POINTS + 1, "Ring capped at capacity plus tip");
+    vec3_t newest = trail_store_get(&ts, rb, len - 1);
+    vec3_t oldest = trail_store_get(&ts, rb, 0);
+    double last_x = x0 + (3 * TRAIL_STORE_POINTS - 1) * 12.5;
+    ASSERT_NEAR(newest.x, last_x, 1e-3, "Far position precise after rebasing");
+    ASSERT_NEAR(newest.y, -25000.0, 1e-3, "Far y precise");
+    ASSERT_NEAR(newest.z, 300.0, 1e-3, "Far z precise");
+    ASSERT_NEAR(oldest.x, last_x - (TRAIL_STORE_POINTS - 1) * 12.5, 1e-3,
+                "Oldest point is capacity-1 steps back");
+
+    /* Pool size for the whole fleet versus one vec3_t ring per probe */
+    size_t per_probe = trail_store_bytes(&ts) / MAX_PROBES;
+    printf("  pool %.1f MB for %d probes (%zu B each, vec3_t ring %zu B)\n",
+           trail_store_bytes(&ts) / 1048576.0, MAX_PROBES, per_probe,
+           sizeof(probe_trail_t));
+    ASSERT(per_probe * 8 <= sizeof(probe_trail_t),
+           "Fleet pool at most 1/8 of per-probe vec3_t rings");
+
+    /* Probes missing from a tick lose their trail; the ring is reused */
+    tick++;
+    trail_store_record(&ts, b, (vec3_t){0, 0, 0}, tick);
+    trail_store_retire(&ts, tick);
+    ASSERT(trail_store_find(&ts, a) < 0, "Unseen probe retired");
+    ASSERT(trail_store_length(&ts, ra) == 0, "Retired ring is empty");
+    ASSERT(trail_store_find(&ts, b) == rb, "Seen probe kept");
+    probe_uid_t c = {3, 3};
+    trail_store_record(&ts, c, (vec3_t){1, 2, 3}, tick);
+    ASSERT(trail_store_find(&ts, c) == ra, "Retired ring reused");
+    ASSERT(trail_store_length(&ts, ra) == 2, "New trail: one point plus tip");
+
+    /* A whole fleet fits */
+    for (int i = 0; i < MAX_PROBES; i++)
+        trail_store_record(&ts, (probe_uid_t){100, (uint64_t)i},
+                           (vec3_t){i, 0, 0}, tick);
+    int found = 0;
+    for (int i = 0; i < MAX_PROBES; i++)
+        if (trail_store_find(&ts, (probe_uid_t){100, (uint64_t)i}) >= 0) found++;
+    ASSERT(found == MAX_PROBES - 2, "Every ring usable (two already taken)");
+
+    trail_store_free(&ts);
+    ASSERT(ts.pool == NULL && trail_store_find(&ts, b) < 0, "Freed store is empty");
+}
+
 /* ---- Test: Planet type → display name ---- */
 static void test_planet_type_names(void) {
     printf("Test: Planet type display names\n");
@@ -382,6 +487,336 @@ static void test_camera_zoom(void) {
     ASSERT(cam.scale >= 0.01, "Zoom has lower bound");
 }
 
+/* ---- Test: Culling and LOD ---- */
+
+static void test_culling_lod(void) {
+    printf("Test: Culling and level of detail\n");
+
+    ASSERT(galaxy_lod(0.1) == LOD_DOT, "Zoomed out: dots");
+    ASSERT(galaxy_lod(1.0) == LOD_DISC, "Mid zoom: discs");
+    ASSERT(galaxy_lod(5.0) == LOD_LABELLED, "Zoomed in: labels");
+
+    camera_2d_t cam = {.offset_x = 400.0, .offset_y = 300.0, .scale = 10.0};
+    ASSERT(camera_sees(&cam, 800, 600, 0.0, 0.0, 1.0), "Centre is visible");
+    ASSERT(!camera_sees(&cam, 800, 600, 41.0, 0.0, 5.0), "Past the right edge");
+    ASSERT(camera_sees(&cam, 800, 600, 40.3, 0.0, 5.0), "Radius overlaps the edge");
+    ASSERT(!camera_sees(&cam, 800, 600, 0.0, -31.0, 5.0), "Above the top edge");
+
+    ASSERT(ring_visible(400, 300, 100, 800, 600), "Ring inside the screen");
+    ASSERT(!ring_visible(400, 300, 1000, 800, 600), "Ring encloses the screen");
+    ASSERT(!ring_visible(-500, 300, 100, 800, 600), "Ring off to the left");
+    ASSERT(ring_visible(-500, 300, 600, 800, 600), "Ring crossing the left edge");
+
+    /* Batch: 5 on-screen systems, 3 off-screen */
+    system_t systems[8];
+    const system_t *list[8];
+    memset(systems, 0, sizeof(systems));
+    for (int i = 0; i < 8; i++) {
+        systems[i].stars[0].class = STAR_G;
+        systems[i].position = (vec3_t){i < 5 ? i * 5.0 : 1000.0 + i, 0.0, 0.0};
+        list[i] = &systems[i];
+    }
+    systems[1].visited = true;
+    systems[2].stars[0].class = STAR_A;
+
+    galaxy_batch_t b;
+    memset(&b, 0, sizeof(b));
+    cam.scale = 10.0;
+    ASSERT(galaxy_batch_build(&b, list, 8, &cam, 800, 600) == 0, "Batch builds");
+    ASSERT(b.culled == 3, "Off-screen systems culled");
+    ASSERT(b.sprite_count == 6, "One sprite each plus a visited halo");
+    ASSERT(b.label_count == 5 && b.labels[2].system == 2, "Labels reference systems");
+    ASSERT(b.sprites[3].r == 5.0f, "A-class disc is larger");
+
+    cam.scale = 0.1;
+    galaxy_batch_build(&b, list, 8, &cam, 800, 600);
+    ASSERT(b.lod == LOD_DOT && b.label_count == 0, "No labels as dots");
+    ASSERT(b.sprite_count == 8 && b.culled == 0, "All fit, no halos as dots");
+    ASSERT(b.sprites[0].r <= 1.5f, "Dots are small");
+    galaxy_batch_free(&b);
+}
+
+/* Vertices the old per-star DrawCircle path would submit: raylib's
+ * DrawCircle is 36 triangles, and each char of a label is a quad. */
+#define DRAWCIRCLE_VERTS 108
+
+static void test_batch_bench(void) {
+    printf("Test: Culling/LOD batch — 10k systems on screen\n");
+
+    enum { N = 10000 };
+    static system_t systems[N];
+    static const system_t *list[N];
+    rng_t rng;
+    rng_seed(&rng, 99);
+    for (int i = 0; i < N; i++) {
+        memset(&systems[i], 0, sizeof(systems[i]));
+        systems[i].stars[0].class = (star_class_t)rng_range(&rng, STAR_M + 1);
+        systems[i].position = (vec3_t){rng_double(&rng) * 2000.0 - 1000.0,
+                                       rng_double(&rng) * 1250.0 - 625.0, 0.0};
+        systems[i].visited = rng_range(&rng, 10) == 0;
+        snprintf(systems[i].name, sizeof(systems[i].name), "Sys-%d", i);
+        list[i] = &systems[i];
+    }
+
+    const double scales[] = {0.3, 0.64, 4.0};
+    galaxy_batch_t b;
+    memset(&b, 0, sizeof(b));
+    for (int k = 0; k < 3; k++) {
+        camera_2d_t cam = {.offset_x = 640.0, .offset_y = 400.0, .scale = scales[k]};
+
+        /* Old path: a DrawCircle (plus halo) and a label per system */
+        long old_verts = 0;
+        for (int i = 0; i < N; i++) {
+            old_verts += DRAWCIRCLE_VERTS * (systems[i].visited ? 2 : 1);
+            if (cam.scale > 3.0) old_verts += 6 * (long)strlen(systems[i].name);
+        }
+
+        double t0 = now_ms();
+        for (int f = 0; f < 60; f++)
+            galaxy_batch_build(&b, list, N, &cam, 1280, 800);
+        double per_frame = (now_ms() - t0) / 60.0;
+
+        long new_verts = 0;
+        for (int i = 0; i < b.sprite_count; i++)
+            new_verts += b.sprites[i].r <= 1.5f ? 6 : 24;
+        for (int i = 0; i < b.label_count; i++)
+            new_verts += 6 * (long)strlen(list[b.labels[i].system]->name);
+
+        printf("  scale %.2f: %d drawn, %d culled, %d labels; "
+               "%.3f ms/frame to batch; vertices %ld -> %ld\n",
+               cam.scale, b.sprite_count, b.culled, b.label_count,
+               per_frame, old_verts, new_verts);
+        ASSERT(new_verts * 4 < old_verts, "Batched path submits 4x fewer vertices");
+        ASSERT(per_frame < 16.0, "Batching 10k systems fits in a 60 fps frame");
+    }
+    ASSERT(b.label_count <= RENDER_MAX_LABELS, "Labels capped");
+    galaxy_batch_free(&b);
+}
+
+/* ---- Test: Sector cache ---- */
+
+static void test_sector_cache(void) {
+    printf("Test: Sector cache — window, determinism, eviction\n");
+
+    static sector_cache_t c;
+    sector_cache_init(&c, 42, false);
+    sector_coord_t origin = {0, 0, 0};
+
+    int pending = sector_cache_update(&c, origin, 1);
+    ASSERT(pending == 0, "Inline cache has nothing pending");
+    ASSERT(c.generated == 9, "3x3 window generated 9 sectors");
+
+    /* Visible list matches a fresh generate_sector of every sector */
+    int expected = 0;
+    bool same = true;
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            sector_coord_t sc = {dx, dy, 0};
+            system_t buf[SECTOR_MAX_SYSTEMS];
+            int n = generate_sector(buf, SECTOR_MAX_SYSTEMS, 42, sc);
+            const sector_entry_t *e = sector_cache_find(&c, sc);
+            if (!e || e->state != SECTOR_READY || e->count != n ||
+                (n > 0 && memcmp(e->systems, buf, sizeof(system_t) * n) != 0))
+                same = false;
+            expected += n;
+        }
+    }
+    ASSERT(same, "Cached sectors match generate_sector");
+    ASSERT(c.visible_count == expected, "Visible list covers the window");
+    const sector_entry_t *centre = sector_cache_find(&c, origin);
+    ASSERT(centre->count == 0 || c.visible[0] == &centre->systems[0],
+           "Centre sector listed first");
+
+    /* Moving one sector only generates the new column */
+    sector_cache_update(&c, (sector_coord_t){1, 0, 0}, 1);
+    ASSERT(c.generated == 12, "Panning one sector generates 3 more");
+    sector_cache_update(&c, origin, 1);
+    ASSERT(c.generated == 12, "Panning back is free");
+
+    /* A long pan fills the cache and evicts old sectors, not the window */
+    for (int x = 0; x < 200; x++)
+        sector_cache_update(&c, (sector_coord_t){x * 3, 0, 0}, 1);
+    ASSERT(c.evicted > 0, "Long pan evicts sectors");
+    ASSERT(sector_cache_find(&c, (sector_coord_t){597, 0, 0}) != NULL,
+           "Current window stays resident");
+    ASSERT(sector_cache_find(&c, origin) == NULL, "Old sector was evicted");
+
+    /* Evictions leave tombstones; the index must not fill up with them */
+    for (int x = 200; x < 2000; x++)
+        sector_cache_update(&c, (sector_coord_t){x * 3, 0, 0}, 1);
+    int empty = 0;
+    for (size_t i = 0; i < sizeof(c.index) / sizeof(c.index[0]); i++)
+        if (c.index[i].state == UIDMAP_EMPTY) empty++;
+    ASSERT(empty >= (int)(sizeof(c.index) / sizeof(c.index[0])) / 4,
+           "Index keeps empty slots after a long pan");
+    ASSERT(sector_cache_find(&c, (sector_coord_t){5997, 0, 0}) != NULL,
+           "Window resident after rebuilds");
+
+    /* View radius scales with zoom */
+    ASSERT(sector_view_radius(10.0, 1280, 800) == 1, "Zoomed in: radius 1");
+    ASSERT(sector_view_radius(0.5, 1280, 800) == 8, "Zoomed out: radius clamped");
+    ASSERT(sector_view_radius(2.0, 1280, 800) == 4, "Default zoom: radius 4");
+
+    sector_coord_t p = sector_of_position(-0.5, 250.0, 99.9);
+    ASSERT(p.x == -1 && p.y == 2 && p.z == 0, "sector_of_position floors");
+
+    sector_cache_free(&c);
+}
+
+static void test_sector_cache_pan(void) {
+    printf("Test: Sector cache — background loading keeps frames flat\n");
+
+    /* Old behaviour: regenerate the 3x3 neighbourhood on every reload */
+    double regen_max = 0.0;
+    for (int step = 0; step < 100; step++) {
+        double t0 = now_ms();
+        system_t buf[SECTOR_MAX_SYSTEMS * 9];
+        int n = 0;
+        for (int dy = -1; dy <= 1; dy++)
+            for (int dx = -1; dx <= 1; dx++)
+                n += generate_sector(buf + n, SECTOR_MAX_SYSTEMS, 7,
+                                     (sector_coord_t){step + dx, dy, 0});
+        double dt = now_ms() - t0;
+        if (dt > regen_max) regen_max = dt;
+    }
+
+    /* New: a 9x9 window panned one sector per frame, loaded off-thread */
+    static sector_cache_t c;
+    int rc = sector_cache_init(&c, 7, true);
+    ASSERT(rc == 0, "Loader thread started");
+
+    double upd_max = 0.0, upd_total = 0.0;
+    for (int step = 0; step < 100; step++) {
+        double t0 = now_ms();
+        sector_cache_update(&c, (sector_coord_t){step, 0, 0}, 4);
+        double dt = now_ms() - t0;
+        upd_total += dt;
+        if (dt > upd_max) upd_max = dt;
+    }
+    printf("  3x3 regen max %.3f ms; 9x9 cached update max %.3f ms, mean %.3f ms\n",
+           regen_max, upd_max, upd_total / 100.0);
+    ASSERT(upd_total / 100.0 < regen_max,
+           "Mean cached update of a 9x9 window beats a 3x3 regen");
+
+    /* Requests beyond the loader's backlog are re-issued on later frames,
+     * so a stopped camera converges within a few updates. */
+    int pending = 1;
+    for (int i = 0; i < 8 && pending > 0; i++) {
+        sector_cache_wait_idle(&c);
+        pending = sector_cache_update(&c, (sector_coord_t){99, 0, 0}, 4);
+    }
+    ASSERT(pending == 0, "Window completes once the camera stops");
+
+    system_t buf[SECTOR_MAX_SYSTEMS];
+    sector_coord_t sc = {103, -4, 0};
+    int n = generate_sector(buf, SECTOR_MAX_SYSTEMS, 7, sc);
+    const sector_entry_t *e = sector_cache_find(&c, sc);
+    ASSERT(e && e->state == SECTOR_READY && e->count == n &&
+           (n == 0 || memcmp(e->systems, buf, sizeof(system_t) * n) == 0),
+           "Background sector matches generate_sector");
+
+    sector_cache_free(&c);
+}
+
+/* ---- Test: Render snapshot triple buffer ---- */
+
+static void test_render_snapshot(void) {
+    printf("Test: Render snapshot — capture and triple buffer\n");
+
+    static universe_t u;
+    memset(&u, 0, sizeof(u));
+    probe_init_bob(&u.probes[0]);
+    u.probes[0].heading = (vec3_t){12.5, -3.0, 0.25};
+    u.probes[0].status = STATUS_TRAVELING;
+    u.probe_count = 1;
+    u.tick = 77;
+
+    static render_triple_t t;
+    render_triple_init(&t);
+
+    bool fresh = true;
+    const render_snapshot_t *snap = render_triple_acquire(&t, &fresh);
+    ASSERT(!fresh && snap->probe_count == 0, "Nothing published yet");
+    ASSERT(!render_triple_pending(&t), "No pending publish");
+
+    render_snapshot_capture(render_triple_back(&t), &u);
+    render_triple_publish(&t);
+    ASSERT(render_triple_pending(&t), "Publish is pending until read");
+
+    snap = render_triple_acquire(&t, &fresh);
+    ASSERT(fresh, "Reader sees the publish");
+    ASSERT(snap->tick == 77 && snap->probe_count == 1, "Tick and count copied");
+    ASSERT(strcmp(snap->probes[0].name, u.probes[0].name) == 0, "Name copied");
+    ASSERT(snap->probes[0].heading.x == 12.5 &&
+           snap->probes[0].status == STATUS_TRAVELING, "Position and status copied");
+    ASSERT(!render_triple_pending(&t), "Read clears pending");
+
+    /* The writer never touches the reader's buffer */
+    u.tick = 78;
+    render_snapshot_capture(render_triple_back(&t), &u);
+    render_triple_publish(&t);
+    u.tick = 79;
+    render_snapshot_capture(render_triple_back(&t), &u);
+    render_triple_publish(&t);
+    ASSERT(snap->tick == 77, "Held snapshot unchanged by later publishes");
+    snap = render_triple_acquire(&t, &fresh);
+    ASSERT(fresh && snap->tick == 79, "Reader skips to the newest snapshot");
+    snap = render_triple_acquire(&t, &fresh);
+    ASSERT(!fresh && snap->tick == 79, "No new publish, same snapshot");
+}
+
+typedef struct {
+    render_triple_t *t;
+    uint64_t         ticks;
+} snap_writer_t;
+
+static void *snap_writer_main(void *arg) {
+    snap_writer_t *w = (snap_writer_t *)arg;
+    for (uint64_t tick = 1; tick <= w->ticks; tick++) {
+        render_snapshot_t *s = render_triple_back(w->t);
+        s->tick = tick;
+        s->probe_count = 64;
+        for (int i = 0; i < 64; i++)
+            s->probes[i].heading = (vec3_t){(double)tick, (double)i, 0.0};
+        render_triple_publish(w->t);
+        if (tick % 256 == 0) sched_yield();   /* interleave on one core */
+    }
+    return NULL;
+}
+
+static void test_render_snapshot_threads(void) {
+    printf("Test: Render snapshot — concurrent writer and reader\n");
+
+    static render_triple_t t;
+    render_triple_init(&t);
+    snap_writer_t w = {&t, 200000};
+    pthread_t th;
+    ASSERT(pthread_create(&th, NULL, snap_writer_main, &w) == 0,
+           "Writer thread started");
+
+    /* Every snapshot the reader sees must be whole (all probes from the
+     * same tick) and ticks must never go backwards. */
+    uint64_t last = 0, reads = 0, torn = 0, backwards = 0;
+    while (last < w.ticks) {
+        bool fresh;
+        const render_snapshot_t *s = render_triple_acquire(&t, &fresh);
+        if (!fresh) continue;
+        reads++;
+        if (s->tick < last) backwards++;
+        for (int i = 0; i < 64; i++)
+            if (s->probes[i].heading.x != (double)s->tick ||
+                s->probes[i].heading.y != (double)i)
+                torn++;
+        last = s->tick;
+    }
+    pthread_join(th, NULL);
+    printf("  %llu publishes, %llu distinct snapshots read\n",
+           (unsigned long long)t.published, (unsigned long long)reads);
+    ASSERT(torn == 0, "No torn snapshots");
+    ASSERT(backwards == 0, "Snapshots never go back in time");
+    ASSERT(last == w.ticks, "Reader ends on the final publish");
+}
+
 /* ---- Main ---- */
 int main(void) {
     printf("=== Phase 5: Render Logic Tests ===\n\n");
@@ -398,6 +833,8 @@ int main(void) {
     printf("\n");
     test_probe_trail();
     printf("\n");
+    test_trail_store();
+    printf("\n");
     test_planet_type_names();
     printf("\n");
     test_star_class_names();
@@ -405,6 +842,18 @@ int main(void) {
     test_camera_conversion();
     printf("\n");
     test_camera_zoom();
+    printf("\n");
+    test_culling_lod();
+    printf("\n");
+    test_batch_bench();
+    printf("\n");
+    test_sector_cache();
+    printf("\n");
+    test_sector_cache_pan();
+    printf("\n");
+    test_render_snapshot();
+    printf("\n");
+    test_render_snapshot_threads();
 
     printf("\n=== Results: %d passed, %d failed ===\n",
         tests_passed, tests_failed);
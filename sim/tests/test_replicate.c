@@ -1,3 +1,4 @@
+#define _POSIX_C_SOURCE 199309L
 /*
  * test_replicate.c — Phase 7: Self-replication, mutation, lineage
  *
@@ -15,18 +16,23 @@
  *   - Interrupted replication resumable
  *   - Quirk inheritance
  *   - Name generation
+ *   - Batched replication (512 simultaneous births)
  */
 
 #include "universe.h"
 #include "replicate.h"
 #include "personality.h"
 #include "probe.h"
+#include "heritage.h"
+#include "strtab.h"
 #include "generate.h"
 #include "rng.h"
 #include "util.h"
 
 #include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
+#include <time.h>
 #include <math.h>
 
 static int g_pass = 0, g_fail = 0;
@@ -260,11 +266,12 @@ static void test_earth_memory_degradation(void) {
            "Gen 1 still has some fidelity");
 
     /* Child still has earth memories */
-    ASSERT(child.earth_memory_count > 0,
+    ASSERT(heritage_count(child.earth_memories) > 0,
            "Child inherited earth memories");
 
     /* Multi-generation degradation */
     probe_t gen2 = child;
+    heritage_retain_probe(&gen2);
     gen2.generation = 2;
     earth_memory_degrade(&gen2);
     ASSERT(gen2.earth_memory_fidelity < child.earth_memory_fidelity,
@@ -272,12 +279,90 @@ static void test_earth_memory_degradation(void) {
 
     /* By gen 5+, fidelity should be very low */
     probe_t gen5 = child;
+    heritage_retain_probe(&gen5);
     gen5.generation = 5;
     for (int g = 1; g < 5; g++) {
         earth_memory_degrade(&gen5);
     }
     ASSERT(gen5.earth_memory_fidelity < 0.3f,
            "Gen 5+ fidelity very low");
+
+    /* Truncation is copy-on-write: the ancestors keep their text */
+    ASSERT(gen5.earth_memories != child.earth_memories,
+           "Degraded memories moved to their own block");
+    ASSERT(strlen(heritage_line(gen5.earth_memories, 1)) <
+           strlen(heritage_line(parent.earth_memories, 1)),
+           "Gen 5 memory truncated");
+    ASSERT(strcmp(heritage_line(parent.earth_memories, 1),
+                  "Debugging code at 2am, the satisfaction when the test "
+                  "finally passes") == 0,
+           "Parent memory untouched");
+
+    heritage_release_probe(&gen2);
+    heritage_release_probe(&gen5);
+    heritage_release_probe(&child);
+    heritage_release_probe(&parent);
+}
+
+/* ---- Test: Heritage sharing across a lineage ---- */
+
+#define HERITAGE_LINEAGE 1000
+
+static void test_heritage_sharing(void) {
+    printf("Test: Heritage text shared across %d probes\n", HERITAGE_LINEAGE);
+
+    probe_t *probes = calloc(HERITAGE_LINEAGE, sizeof(probe_t));
+    ASSERT(probes != NULL, "Lineage allocated");
+    if (!probes) return;
+
+    heritage_stats_t before;
+    heritage_stats(&before);
+    strtab_stats_t text_before;
+    strtab_stats(&text_before);
+
+    rng_t rng;
+    rng_seed(&rng, 4242);
+    probe_init_bob(&probes[0]);
+
+    replication_state_t state;
+    memset(&state, 0, sizeof(state));
+    for (int n = 1; n < HERITAGE_LINEAGE; n++) {
+        probe_t *parent = &probes[rng_next(&rng) % (uint64_t)n];
+        state.active = true;
+        state.progress = 1.0;
+        repl_finalize(parent, &probes[n], &state, &rng);
+    }
+
+    probe_t *parent = &probes[0];
+    probe_t *child = &probes[1];    /* always Bob's first child */
+    ASSERT(child->catchphrases == parent->catchphrases,
+           "Catchphrases shared with parent");
+    ASSERT(probes[HERITAGE_LINEAGE - 1].values == parent->values,
+           "Values shared across the whole lineage");
+    ASSERT(heritage_refs(parent->values) >= HERITAGE_LINEAGE,
+           "Every probe holds a reference to the shared values");
+
+    heritage_stats_t after;
+    heritage_stats(&after);
+    strtab_stats_t text_after;
+    strtab_stats(&text_after);
+    uint64_t shared = (after.bytes - before.bytes)
+                    + (text_after.bytes - text_before.bytes);
+    uint64_t inline_bytes = (uint64_t)(MAX_QUIRKS + MAX_CATCHPHRASES + MAX_VALUES)
+                                * MAX_QUIRK_LEN
+                          + (uint64_t)MAX_EARTH_MEM * MAX_EARTH_MEM_LEN;
+    double per_probe = (double)shared / HERITAGE_LINEAGE;
+    printf("  heritage: %u blocks, %.1f bytes/probe (inline layout: %llu)\n",
+           after.blocks - before.blocks, per_probe,
+           (unsigned long long)inline_bytes);
+    ASSERT(per_probe < (double)inline_bytes / 4,
+           "Shared heritage at least 4x smaller than inline text");
+
+    for (int n = 0; n < HERITAGE_LINEAGE; n++)
+        heritage_release_probe(&probes[n]);
+    heritage_stats(&after);
+    ASSERT(after.blocks == before.blocks, "All lineage blocks freed");
+    free(probes);
 }
 
 /* ---- Test: Child naming ---- */
@@ -329,6 +414,63 @@ static void test_lineage_tree(void) {
     probe_uid_t nobody = { 0, 99 };
     count = lineage_children(&tree, nobody, children, 8);
     ASSERT(count == 0, "Unknown parent has 0 children");
+
+    /* Duplicate birth is rejected */
+    ASSERT(lineage_record(&tree, nobody, kid1_id, 3000, 1) == -1,
+           "Child recorded once");
+    ASSERT(tree.count == 2, "Still 2 entries");
+    lineage_free(&tree);
+}
+
+/* ---- Test: Lineage store at scale ---- */
+
+#define LINEAGE_BIRTHS 100000
+
+static void test_lineage_scale(void) {
+    printf("Test: Lineage store with %d births\n", LINEAGE_BIRTHS);
+
+    lineage_tree_t tree;
+    memset(&tree, 0, sizeof(tree));
+    rng_t rng;
+    rng_seed(&rng, 5);
+
+    /* Random recursive tree: each child picks an earlier probe as parent */
+    probe_uid_t bob = { 0, 1 };
+    clock_t t0 = clock();
+    for (uint64_t i = 1; i <= LINEAGE_BIRTHS; i++) {
+        uint64_t parent = rng_range(&rng, i) + 1;
+        lineage_record(&tree, (probe_uid_t){ 0, parent },
+                       (probe_uid_t){ 0, i + 1 }, i, 0);
+    }
+    clock_t t1 = clock();
+    printf("  %d births: %.0f ns/insert\n", LINEAGE_BIRTHS,
+           (double)(t1 - t0) * 1e9 / CLOCKS_PER_SEC / LINEAGE_BIRTHS);
+
+    ASSERT(tree.count == LINEAGE_BIRTHS, "Every birth recorded");
+    ASSERT(lineage_subtree_size(&tree, bob) == LINEAGE_BIRTHS + 1,
+           "Bob's subtree is everyone");
+
+    /* Children lists agree with parents; subtree sizes add up */
+    int n = lineage_find(&tree, (probe_uid_t){ 0, 2 });
+    const lineage_node_t *kid = lineage_node(&tree, n);
+    int sum = 1;
+    for (int c = kid->first_child; c >= 0; c = tree.nodes[c].next_sibling) {
+        ASSERT(tree.nodes[c].parent == n, "Child points back to parent");
+        sum += lineage_subtree_size(&tree, tree.nodes[c].id);
+    }
+    ASSERT(sum == lineage_subtree_size(&tree, kid->id),
+           "Subtree = 1 + children's subtrees");
+
+    /* Ancestor path ends at Bob and follows parent links */
+    probe_uid_t last = { 0, LINEAGE_BIRTHS + 1 };
+    probe_uid_t path[256];
+    int depth = lineage_ancestors(&tree, last, path, 256);
+    ASSERT(depth > 0 && uid_eq(path[depth - 1], bob), "Path ends at Bob");
+    lineage_entry_t e;
+    ASSERT(lineage_entry_at(&tree, LINEAGE_BIRTHS - 1, &e) == 0, "Last entry");
+    ASSERT(uid_eq(e.child_id, last) && uid_eq(e.parent_id, path[0]),
+           "Entry parent matches path");
+    lineage_free(&tree);
 }
 
 /* ---- Test: Quirk inheritance ---- */
@@ -352,8 +494,10 @@ static void test_quirk_inheritance(void) {
         quirk_inherit(&parent, &child, &rng);
 
         /* Child should have some quirks (0 to MAX_QUIRKS) */
-        ASSERT(child.quirk_count <= MAX_QUIRKS, "Quirk count within bounds");
-        kept_total += child.quirk_count;
+        int count = heritage_count(child.quirks);
+        ASSERT(count <= MAX_QUIRKS, "Quirk count within bounds");
+        kept_total += count;
+        heritage_release(child.quirks);
     }
 
     /* On average, 70% of 3 quirks = 2.1 kept, plus some new ones.
@@ -440,6 +584,128 @@ static void test_independent_probes(void) {
            "Parent personality unaffected");
 }
 
+/* ---- Test: Batched replication ---- */
+
+#define BATCH_PARENTS 512
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+/* BATCH_PARENTS probes one tick away from finishing replication. */
+static void seed_replicators(probe_t *probes, replication_state_t *states) {
+    for (int i = 0; i < BATCH_PARENTS; i++) {
+        heritage_release_probe(&probes[i]);
+        probe_init_bob(&probes[i]);
+        probes[i].id = (probe_uid_t){7, (uint64_t)i + 1};
+        give_repl_resources(&probes[i]);
+        probes[i].status = STATUS_ACTIVE;
+        memset(&states[i], 0, sizeof(states[i]));
+        repl_begin(&probes[i], &states[i]);
+        states[i].ticks_elapsed = states[i].ticks_total - 1;
+        states[i].progress = 1.0 - 1.0 / states[i].ticks_total + 1e-9;
+    }
+}
+
+static void clear_children(probe_t *probes, uint32_t *count) {
+    for (uint32_t i = BATCH_PARENTS; i < *count; i++)
+        heritage_release_probe(&probes[i]);
+    *count = BATCH_PARENTS;
+}
+
+static void test_batch_replication(void) {
+    printf("Test: Batched replication of %d probes\n", BATCH_PARENTS);
+
+    probe_t *probes = calloc(MAX_PROBES, sizeof(probe_t));
+    probe_uid_t *ids = calloc(BATCH_PARENTS, sizeof(probe_uid_t));
+    static replication_state_t states[MAX_PROBES];
+    static repl_batch_t batch;
+    ASSERT(probes && ids, "Buffers allocated");
+    if (!probes || !ids) { free(probes); free(ids); return; }
+
+    /* Fault the child slots in so no run pays for first touch */
+    memset(probes, 0, sizeof(probe_t) * MAX_PROBES);
+
+    /* Serial baseline: the old per-probe tick/finalize/record loop */
+    uint32_t count = BATCH_PARENTS;
+    lineage_tree_t tree;
+    memset(&tree, 0, sizeof(tree));
+    rng_t rng;
+    seed_replicators(probes, states);
+    rng_seed(&rng, 2024);
+    double t0 = now_ms();
+    for (uint32_t i = 0; i < BATCH_PARENTS; i++) {
+        if (repl_tick(&probes[i], &states[i]) != 1) continue;
+        probe_t *child = &probes[count];
+        if (repl_finalize(&probes[i], child, &states[i], &rng) == 0) {
+            lineage_record(&tree, probes[i].id, child->id, 1, child->generation);
+            count++;
+        }
+    }
+    double serial_ms = now_ms() - t0;
+    ASSERT(count == 2 * BATCH_PARENTS, "Serial loop births every child");
+    clear_children(probes, &count);
+    lineage_free(&tree);
+
+    /* Batch, single thread */
+    seed_replicators(probes, states);
+    rng_seed(&rng, 2024);
+    t0 = now_ms();
+    int born = repl_batch_tick(&batch, probes, &count, states, &tree, 1, &rng, 1);
+    double one_ms = now_ms() - t0;
+    ASSERT(born == BATCH_PARENTS, "Batch births every child");
+    ASSERT(count == 2 * BATCH_PARENTS, "Probe count bumped once");
+    ASSERT(tree.count == BATCH_PARENTS, "Every birth recorded in lineage");
+    for (int k = 0; k < BATCH_PARENTS; k++) ids[k] = probes[BATCH_PARENTS + k].id;
+
+    bool slots_ok = true;
+    for (int k = 0; k < BATCH_PARENTS; k++) {
+        const probe_t *child = &probes[BATCH_PARENTS + k];
+        if (!uid_eq(child->parent_id, probes[k].id) ||
+            probes[k].status != STATUS_ACTIVE || states[k].active ||
+            heritage_count(child->earth_memories) != 4)
+            slots_ok = false;
+    }
+    ASSERT(slots_ok, "Children committed in parent order with heritage");
+    clear_children(probes, &count);
+    lineage_free(&tree);
+
+    /* Batch, multi-threaded: identical children */
+    seed_replicators(probes, states);
+    rng_seed(&rng, 2024);
+    t0 = now_ms();
+    born = repl_batch_tick(&batch, probes, &count, states, &tree, 1, &rng,
+                           REPL_BATCH_MAX_THREADS);
+    double many_ms = now_ms() - t0;
+    ASSERT(born == BATCH_PARENTS, "Threaded batch births every child");
+    bool same = true;
+    for (int k = 0; k < BATCH_PARENTS; k++)
+        if (!uid_eq(ids[k], probes[BATCH_PARENTS + k].id)) same = false;
+    ASSERT(same, "Children independent of thread count");
+
+    printf("  serial %.2f ms, batch x1 %.2f ms, batch x%d %.2f ms\n",
+           serial_ms, one_ms, REPL_BATCH_MAX_THREADS, many_ms);
+
+    /* A full universe drops the overflow instead of writing past it */
+    clear_children(probes, &count);
+    lineage_free(&tree);
+    seed_replicators(probes, states);
+    count = MAX_PROBES - 10;
+    born = repl_batch_tick(&batch, probes, &count, states, NULL, 1, &rng, 4);
+    ASSERT(born == 10 && batch.dropped == BATCH_PARENTS - 10,
+           "Births capped at MAX_PROBES");
+    ASSERT(count == MAX_PROBES, "Universe exactly full");
+
+    for (uint32_t i = 0; i < BATCH_PARENTS; i++)
+        heritage_release_probe(&probes[i]);
+    for (uint32_t i = MAX_PROBES - 10; i < MAX_PROBES; i++)
+        heritage_release_probe(&probes[i]);
+    free(ids);
+    free(probes);
+}
+
 /* ---- Main ---- */
 
 int main(void) {
@@ -451,11 +717,14 @@ int main(void) {
     test_full_replication();
     test_personality_mutation();
     test_earth_memory_degradation();
+    test_heritage_sharing();
     test_child_naming();
     test_lineage_tree();
+    test_lineage_scale();
     test_quirk_inheritance();
     test_interrupted_replication();
     test_independent_probes();
+    test_batch_replication();
 
     printf("\n=== Results: %d passed, %d failed ===\n", g_pass, g_fail);
     return g_fail > 0 ? 1 : 0;
@@ -1,7 +1,8 @@
 /*
  * test_scenario.c — Phase 12: Polish & Scenario Framework tests
  *
- * Tests: event injection, metrics, snapshots, config, replay, forking.
+ * Tests: event injection, metrics, snapshots, config, replay, forking,
+ * tick profiler, tick arena, probe LOD tiers.
  *
  * NOTE: universe_t is ~90MB, snapshot_t is ~90MB — all must be static/heap.
  */
@@ -13,6 +14,10 @@
 #include "../src/scenario.h"
 #include "../src/generate.h"
 #include "../src/personality.h"
+#include "../src/strtab.h"
+#include "../src/profile.h"
+#include "../src/arena.h"
+#include "../src/sim_lod.h"
 
 static int passed = 0, failed = 0;
 
@@ -133,7 +138,7 @@ static void test_inject_json(void) {
     ASSERT_EQ_INT(q.count, 1, "one event queued");
     ASSERT_EQ_INT((int)q.events[0].type, EVT_HAZARD, "type is hazard");
     ASSERT(q.events[0].severity > 0.8f, "severity parsed");
-    ASSERT(strstr(q.events[0].description, "solar storm") != NULL, "description parsed");
+    ASSERT(strstr(strtab_str(q.events[0].description), "solar storm") != NULL, "description parsed");
 }
 
 /* ================================================
@@ -150,15 +155,15 @@ static void test_metrics_record(void) {
     events_init(&es);
 
     /* Should record at tick 0 (aligned with interval) */
-    metrics_record(&ms, &g_uni, &es, 0);
+    metrics_record(&ms, &g_uni, NULL, &es, 0);
     ASSERT_EQ_INT(ms.count, 1, "one metrics snapshot");
 
     /* Should NOT record at tick 5 */
-    metrics_record(&ms, &g_uni, &es, 5);
+    metrics_record(&ms, &g_uni, NULL, &es, 5);
     ASSERT_EQ_INT(ms.count, 1, "still one (not aligned)");
 
     /* Should record at tick 10 */
-    metrics_record(&ms, &g_uni, &es, 10);
+    metrics_record(&ms, &g_uni, NULL, &es, 10);
     ASSERT_EQ_INT(ms.count, 2, "two snapshots at tick 10");
 }
 
@@ -188,9 +193,9 @@ static void test_metrics_latest(void) {
     event_system_t es;
     events_init(&es);
 
-    metrics_record(&ms, &g_uni, &es, 100);
+    metrics_record(&ms, &g_uni, NULL, &es, 100);
     g_uni.tick = 200;
-    metrics_record(&ms, &g_uni, &es, 200);
+    metrics_record(&ms, &g_uni, NULL, &es, 200);
 
     const metrics_snapshot_t *latest = metrics_latest(&ms);
     ASSERT(latest != NULL, "latest exists");
@@ -448,17 +453,23 @@ static void test_metrics_avg_trust(void) {
     printf("Test: Average trust computation\n");
 
     init_universe(&g_uni);
-    /* Add relationships */
-    g_uni.probes[0].relationships[0].other_id = g_uni.probes[1].id;
-    g_uni.probes[0].relationships[0].trust = 0.6f;
-    g_uni.probes[0].relationship_count = 1;
-
-    g_uni.probes[1].relationships[0].other_id = g_uni.probes[0].id;
-    g_uni.probes[1].relationships[0].trust = 0.4f;
-    g_uni.probes[1].relationship_count = 1;
+    static society_t soc;
+    society_init(&soc);
+    ASSERT_NEAR(metrics_avg_trust(&soc), 0.0, 0.001, "empty graph avg = 0");
 
-    float avg = metrics_avg_trust(&g_uni);
+    /* Add relationships */
+    relationship_t r;
+    memset(&r, 0, sizeof(r));
+    r.other_id = g_uni.probes[1].id;
+    r.trust = 0.6f;
+    society_set_relationship(&soc, g_uni.probes[0].id, &r);
+    r.other_id = g_uni.probes[0].id;
+    r.trust = 0.4f;
+    society_set_relationship(&soc, g_uni.probes[1].id, &r);
+
+    float avg = metrics_avg_trust(&soc);
     ASSERT_NEAR(avg, 0.5, 0.01, "avg trust = 0.5");
+    society_free(&soc);
 }
 
 /* ================================================
@@ -475,6 +486,214 @@ static void test_invalid_snapshot(void) {
     ASSERT_EQ_INT(ret, -1, "invalid snapshot rejected");
 }
 
+/* ================================================
+ * Test 19: Tick profiler
+ * ================================================ */
+static void test_profiler(void) {
+    printf("Test: Per-phase tick profiler\n");
+
+    static profiler_t prof;
+    memset(&prof, 0, sizeof(prof));
+
+    /* Disabled: no clock read, nothing recorded */
+    uint64_t t0 = profile_begin(&prof);
+    ASSERT(t0 == 0, "disabled begin does not read the clock");
+    profile_end(&prof, PROF_TICK, t0);
+    ASSERT(prof.hist[PROF_TICK].count == 0, "disabled end records nothing");
+
+    /* 1..100 us: exact percentiles */
+    prof.enabled = true;
+    for (int i = 1; i <= 100; i++)
+        profile_record(&prof, PROF_SERIALIZE, (uint64_t)i * 1000);
+    prof_stats_t st;
+    profile_stats(&prof, PROF_SERIALIZE, &st);
+    ASSERT(st.count == 100, "100 samples");
+    ASSERT_NEAR(st.total_ms, 5.05, 1e-9, "total");
+    ASSERT_NEAR(st.mean_us, 50.5, 1e-9, "mean");
+    ASSERT_NEAR(st.p50_us, 50.0, 1e-9, "p50");
+    ASSERT_NEAR(st.p95_us, 95.0, 1e-9, "p95");
+    ASSERT_NEAR(st.p99_us, 99.0, 1e-9, "p99");
+    ASSERT_NEAR(st.max_us, 100.0, 1e-9, "max");
+
+    /* The window rolls: old samples stop counting toward percentiles,
+     * but count, total and max are all-time */
+    for (int i = 0; i < PROFILE_WINDOW; i++)
+        profile_record(&prof, PROF_SERIALIZE, 2000);
+    profile_stats(&prof, PROF_SERIALIZE, &st);
+    ASSERT(st.count == 100 + PROFILE_WINDOW, "count is all-time");
+    ASSERT_NEAR(st.p99_us, 2.0, 1e-9, "p99 over the window only");
+    ASSERT_NEAR(st.max_us, 100.0, 1e-9, "max is all-time");
+
+    /* A real timer measures something */
+    t0 = profile_begin(&prof);
+    ASSERT(t0 > 0, "enabled begin reads the clock");
+    volatile double x = 0;
+    for (int i = 0; i < 100000; i++) x += i;
+    profile_end(&prof, PROF_EVENTS, t0);
+    ASSERT(prof.hist[PROF_EVENTS].count == 1 &&
+           prof.hist[PROF_EVENTS].total_ns > 0, "timed phase recorded");
+
+    /* JSON report names every phase */
+    char buf[4096];
+    int n = profile_format_json(&prof, buf, sizeof(buf));
+    ASSERT(n > 0 && (size_t)n == strlen(buf), "report formatted");
+    ASSERT(strstr(buf, "\"enabled\":true") != NULL, "report has enabled");
+    for (int i = 0; i < PROF_PHASE_COUNT; i++) {
+        char key[64];
+        snprintf(key, sizeof(key), "\"%s\":{", profile_phase_name((prof_phase_t)i));
+        ASSERT(strstr(buf, key) != NULL, "report has phase");
+    }
+    ASSERT(profile_format_json(&prof, buf, 64) == -1, "short buffer rejected");
+
+    profile_reset(&prof);
+    ASSERT(prof.enabled && prof.hist[PROF_SERIALIZE].count == 0,
+           "reset clears histograms, keeps enabled");
+}
+
+/* ================================================
+ * Test 20: Tick scratch arena
+ * ================================================ */
+static void test_arena(void) {
+    printf("Test: Growable tick arena with marks\n");
+
+    arena_t a;
+    ASSERT(arena_init(&a, 1024) == 0, "arena init");
+    ASSERT_EQ_INT(a.chunk_count, 1, "one chunk to start");
+
+    uint8_t *p = arena_alloc(&a, 5);
+    ASSERT(p != NULL && ((uintptr_t)p & 7) == 0, "8-byte aligned");
+    ASSERT(a.used == 8, "size rounded up to alignment");
+
+    /* Bigger than a chunk: grows instead of failing */
+    double *big = ARENA_ARRAY(&a, double, 1000);
+    ASSERT(big != NULL, "oversized request served");
+    ASSERT(a.chunk_count == 2 && a.capacity >= 1024 + 8000, "chain grew");
+    ASSERT(big[0] == 0.0 && big[999] == 0.0, "array zeroed");
+    ASSERT(ARENA_ARRAY(&a, double, SIZE_MAX / 4) == NULL,
+           "overflowing count rejected");
+
+    /* Marks rewind everything allocated after them */
+    arena_mark_t m = arena_mark(&a);
+    size_t used = a.used;
+    for (int i = 0; i < 100; i++) arena_alloc_uninit(&a, 512);
+    ASSERT(a.used == used + 100 * 512, "used counts bytes handed out");
+    size_t peak = a.high_water;
+    int chunks = a.chunk_count;
+    arena_release(&a, m);
+    ASSERT(a.used == used, "release rewinds used");
+    ASSERT(a.high_water == peak, "high water survives release");
+    for (int i = 0; i < 100; i++) arena_alloc_uninit(&a, 512);
+    ASSERT_EQ_INT(a.chunk_count, chunks, "released chunks are reused");
+
+    /* Reset folds the chain into one chunk that fits the peak */
+    arena_reset(&a);
+    ASSERT(a.used == 0 && a.chunk_count == 1, "reset leaves one chunk");
+    ASSERT(a.capacity >= peak, "folded chunk fits the busiest tick");
+    for (int i = 0; i < 100; i++) arena_alloc_uninit(&a, 512);
+    ARENA_ARRAY(&a, double, 1000);
+    ASSERT_EQ_INT(a.chunk_count, 1, "same workload needs no new chunk");
+
+    arena_destroy(&a);
+    ASSERT(a.head == NULL && a.capacity == 0, "destroy frees the chain");
+
+    /* A zeroed arena is valid */
+    arena_t z;
+    memset(&z, 0, sizeof(z));
+    ASSERT(arena_alloc(&z, 16) != NULL, "zeroed arena allocates");
+    ASSERT(z.capacity == ARENA_CHUNK_DEFAULT, "default chunk size");
+    arena_release(&z, (arena_mark_t){0});
+    ASSERT(z.used == 0, "release to an empty mark");
+    arena_destroy(&z);
+}
+
+static void test_sim_lod(void) {
+    printf("Test: Probe LOD tiers\n");
+
+    static sim_lod_t l;
+    static event_system_t es;
+    universe_t *u = &g_uni;
+    memset(u, 0, sizeof(*u));
+    events_init(&es);
+    u->tick = 1000;
+    u->probe_count = 5;
+    for (uint32_t i = 0; i < 5; i++) {
+        u->probes[i].id = (probe_uid_t){0, i + 1};
+        u->probes[i].status = STATUS_ACTIVE;
+        u->probes[i].heading = (vec3_t){100.0 * i, 0, 0};
+    }
+    u->probes[1].heading = (vec3_t){3.0, 0, 0};
+
+    /* Off: every probe full */
+    sim_lod_init(&l, 0, 5.0f);
+    l.attached[0] = true;
+    sim_lod_update(&l, u, &es);
+    ASSERT_EQ_INT((int)l.full_count, 5, "cadence 0 keeps everyone full");
+
+    /* 0 attached, 1 near it, 3 has a fresh event, 4 a pending hazard */
+    sim_lod_init(&l, 10, 5.0f);
+    l.attached[0] = true;
+    rng_t rng;
+    rng_seed(&rng, 1);
+    events_generate(&es, &u->probes[3], EVT_ANOMALY, 0, NULL, 995, &rng);
+    events_queue_hazard(&es, u->probes[4].id, 0, 0.5f, 1000, 1003);
+    sim_lod_update(&l, u, &es);
+    ASSERT(l.tier[0] == TIER_FULL, "attached probe full");
+    ASSERT(l.tier[1] == TIER_FULL, "probe near an agent full");
+    ASSERT(l.tier[2] == TIER_COARSE, "quiet far probe coarse");
+    ASSERT(l.tier[3] == TIER_FULL, "recent event keeps it full");
+    ASSERT(l.tier[4] == TIER_FULL, "pending hazard keeps it full");
+    ASSERT(l.full_count == 4 && l.coarse_count == 1, "tier counts");
+
+    /* Coarse probes are due once a cadence, full ones every tick */
+    u->tick = 1004;
+    ASSERT_EQ_INT((int)sim_lod_due(&l, 2, u->tick), 0, "coarse not due yet");
+    ASSERT_EQ_INT((int)sim_lod_due(&l, 0, u->tick), 4, "full probe lag");
+    u->tick = 1010;
+    ASSERT_EQ_INT((int)sim_lod_due(&l, 2, u->tick), 10, "coarse due");
+
+    /* The event goes stale; the probe drops to coarse */
+    u->tick = 1006;
+    sim_lod_update(&l, u, &es);
+    ASSERT(l.tier[3] == TIER_COARSE, "stale event no longer counts");
+
+    /* Events still count once the log has wrapped */
+    for (int e = 0; e < MAX_EVENT_LOG; e++)
+        events_log(&es, EVT_DISCOVERY, 0, (probe_uid_t){9, 9}, uid_null(),
+                   1006, "", 0.1f);
+    events_generate(&es, &u->probes[3], EVT_ANOMALY, 0, NULL, 1006, &rng);
+    sim_lod_update(&l, u, &es);
+    ASSERT(l.tier[3] == TIER_FULL, "event after the log filled counts");
+
+    /* Promotion: an agent attaches to 2; a newborn starts in sync */
+    l.attached[2] = true;
+    u->probes[5] = u->probes[2];
+    u->probes[5].id = (probe_uid_t){0, 6};
+    u->probe_count = 6;
+    sim_lod_update(&l, u, &es);
+    ASSERT(l.tier[2] == TIER_FULL, "attaching promotes");
+    ASSERT(l.tier[5] == TIER_FULL, "newborn next to an agent full");
+    ASSERT(l.synced[5] == 1006, "newborn in sync");
+    ASSERT_EQ_INT((int)sim_lod_due(&l, 2, u->tick), 6,
+                  "promoted probe catches up at once");
+
+    sim_lod_reset(&l, 2000);
+    ASSERT(!l.attached[2] && l.synced[2] == 2000 && l.known == 0,
+           "reset forgets per-probe state");
+
+    /* Accounting */
+    l.full_probe_ticks = 10;
+    l.full_ns = 1000;
+    l.coarse_probe_ticks = 100;
+    l.catch_up_ns = 2000;
+    ASSERT_NEAR(sim_lod_saved_ms(&l), 0.008, 1e-9,
+                "saved = deferred ticks at full cost less catch-up");
+    char buf[512];
+    ASSERT(sim_lod_format_json(&l, buf, sizeof(buf)) > 0, "json fits");
+    ASSERT(strstr(buf, "\"probe_ticks\":{\"full\":10,\"coarse\":100}") != NULL,
+           "json has probe ticks");
+    ASSERT(sim_lod_format_json(&l, buf, 16) < 0, "short buffer rejected");
+}
+
 /* ================================================
  * Entry point
  * ================================================ */
@@ -499,6 +718,9 @@ int main(void) {
     test_inject_targeted();
     test_metrics_avg_trust();
     test_invalid_snapshot();
+    test_profiler();
+    test_arena();
+    test_sim_lod();
 
     printf("\n=== Results: %d passed, %d failed ===\n", passed, failed);
     return failed > 0 ? 1 : 0;
@@ -8,8 +8,10 @@
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include <time.h>
 #include "../src/society.h"
 #include "../src/generate.h"
+#include "../src/persist.h"
 
 static int passed = 0, failed = 0;
 
@@ -67,23 +69,32 @@ static void test_init(void) {
 static void test_trust_update(void) {
     printf("Test: Trust increases after positive interaction\n");
 
+    static society_t soc;
+    society_init(&soc);
     probe_t alice = make_probe(1, "Alice");
     probe_t bob = make_probe(2, "Bob");
 
     /* Initially no relationship */
-    float t0 = society_get_trust(&alice, bob.id);
+    float t0 = society_get_trust(&soc, alice.id, bob.id);
     ASSERT_NEAR(t0, 0.0, 0.01, "initial trust is 0");
+    ASSERT_EQ_INT(society_get_disposition(&soc, alice.id, bob.id), 2,
+                  "unknown probe is neutral");
 
     /* Positive interaction */
-    society_update_trust(&alice, &bob, TRUST_TRADE_POSITIVE);
-    float t1 = society_get_trust(&alice, bob.id);
+    society_update_trust(&soc, alice.id, bob.id, TRUST_TRADE_POSITIVE);
+    float t1 = society_get_trust(&soc, alice.id, bob.id);
     ASSERT(t1 > 0.0f, "trust increased after trade");
     ASSERT_NEAR(t1, TRUST_TRADE_POSITIVE, 0.01, "trust = trade delta");
+    ASSERT_NEAR(society_get_trust(&soc, bob.id, alice.id), t1, 0.001,
+                "trust is symmetric");
 
     /* Negative interaction */
-    society_update_trust(&alice, &bob, TRUST_CLAIM_VIOLATION);
-    float t2 = society_get_trust(&alice, bob.id);
+    society_update_trust(&soc, alice.id, bob.id, TRUST_CLAIM_VIOLATION);
+    float t2 = society_get_trust(&soc, alice.id, bob.id);
     ASSERT(t2 < t1, "trust decreased after violation");
+    ASSERT_EQ_INT(society_relationship_count(&soc, alice.id), 1,
+                  "one contact, not duplicated");
+    society_free(&soc);
 }
 
 /* ================================================
@@ -92,22 +103,30 @@ static void test_trust_update(void) {
 static void test_trust_clamp(void) {
     printf("Test: Trust clamped to [-1, 1]\n");
 
+    static society_t soc;
+    society_init(&soc);
     probe_t alice = make_probe(1, "Alice");
     probe_t bob = make_probe(2, "Bob");
 
     /* Push trust very high */
     for (int i = 0; i < 100; i++)
-        society_update_trust(&alice, &bob, 0.1f);
+        society_update_trust(&soc, alice.id, bob.id, 0.1f);
 
-    float high = society_get_trust(&alice, bob.id);
+    float high = society_get_trust(&soc, alice.id, bob.id);
     ASSERT(high <= 1.0f, "trust capped at 1.0");
+    ASSERT_EQ_INT(society_get_disposition(&soc, alice.id, bob.id), 1,
+                  "high trust is friendly");
 
     /* Push trust very low */
     for (int i = 0; i < 300; i++)
-        society_update_trust(&alice, &bob, -0.1f);
+        society_update_trust(&soc, alice.id, bob.id, -0.1f);
 
-    float low = society_get_trust(&alice, bob.id);
+    float low = society_get_trust(&soc, alice.id, bob.id);
     ASSERT(low >= -1.0f, "trust floored at -1.0");
+    ASSERT_EQ_INT(society_get_disposition(&soc, alice.id, bob.id), 4,
+                  "low trust is hostile");
+    ASSERT_NEAR(society_avg_trust(&soc), -1.0, 0.001, "running average tracks clamp");
+    society_free(&soc);
 }
 
 /* ================================================
@@ -468,6 +487,35 @@ static void test_trade_transit(void) {
                 "bob got silicon");
 }
 
+/* ================================================
+ * Test 18b: Trade reaches a probe restored into a used slot
+ * ================================================ */
+static void test_trade_after_restore(void) {
+    printf("Test: Trade reaches a probe restored into a used slot\n");
+
+    society_t soc;
+    society_init(&soc);
+
+    probe_t alice = make_probe(1, "Alice");
+    probe_t bob = make_probe(2, "Bob");
+    probe_t carol = make_probe(3, "Carol");
+    double carol_iron_before = carol.resources[RES_IRON];
+
+    /* Bob's instant trade leaves slot 1 cached as Bob */
+    society_trade_send(&soc, &alice, &bob, RES_IRON, 1000.0, true, 1000);
+    society_trade_send(&soc, &alice, &carol, RES_IRON, 2000.0, false, 1000);
+    probe_t probes[] = {alice, bob};
+    int delivered = society_trade_tick(&soc, probes, 2, 1000);
+    ASSERT_EQ_INT(delivered, 1, "bob's trade delivered");
+
+    /* A restore puts Carol where Bob was; the count is unchanged */
+    probes[1] = carol;
+    delivered = society_trade_tick(&soc, probes, 2, 2000);  /* past arrival */
+    ASSERT_EQ_INT(delivered, 1, "carol's trade delivered");
+    ASSERT_NEAR(probes[1].resources[RES_IRON], carol_iron_before + 2000.0,
+                0.01, "carol got iron");
+}
+
 /* ================================================
  * Test 19: Duplicate vote rejected
  * ================================================ */
@@ -503,6 +551,395 @@ static void test_build_speed_scaling(void) {
     ASSERT(m4 <= 4.0f, "diminishing returns: 4 builders < 4x");
 }
 
+/* ================================================
+ * Test 21: Claim index follows revoke and re-claim
+ * ================================================ */
+static void test_claim_index(void) {
+    printf("Test: Claim index follows revoke and re-claim\n");
+
+    static society_t soc;
+    society_init(&soc);
+
+    probe_uid_t alice_id = {0, 1};
+    probe_uid_t bob_id = {0, 2};
+
+    /* Fill many systems so lookups exercise probing */
+    for (uint64_t s = 0; s < 400; s++)
+        society_claim_system(&soc, alice_id, (probe_uid_t){s, 1000 + s}, 1000);
+    ASSERT_EQ_INT(soc.claim_count, 400, "400 claims recorded");
+
+    probe_uid_t sys_id = {123, 1123};
+    const claim_t *c = society_find_claim(&soc, sys_id);
+    ASSERT(c != NULL && uid_eq(c->system_id, sys_id), "find_claim hits indexed system");
+    ASSERT(society_find_claim(&soc, (probe_uid_t){0, 99}) == NULL,
+           "unclaimed system not found");
+
+    /* Bob can't revoke Alice's claim */
+    ASSERT_EQ_INT(society_revoke_claim(&soc, bob_id, sys_id), -1,
+                  "revoke by non-owner rejected");
+    ASSERT(society_is_claimed_by_other(&soc, sys_id, bob_id), "still Alice's");
+
+    ASSERT_EQ_INT(society_revoke_claim(&soc, alice_id, sys_id), 0, "owner revokes");
+    ASSERT(society_find_claim(&soc, sys_id) == NULL, "index cleared on revoke");
+
+    /* Bob re-claims the freed system */
+    ASSERT_EQ_INT(society_claim_system(&soc, bob_id, sys_id, 2000), 0,
+                  "re-claim after revoke");
+    ASSERT(uid_eq(society_get_claim(&soc, sys_id), bob_id), "new claimer indexed");
+    ASSERT(society_is_claimed_by_other(&soc, sys_id, alice_id),
+           "Alice now trespasses");
+}
+
+/* ================================================
+ * Test 22: Structures indexed per system in build order
+ * ================================================ */
+static void test_structures_by_system(void) {
+    printf("Test: Structures indexed per system in build order\n");
+
+    society_t soc;
+    society_init(&soc);
+
+    probe_t alice = make_probe(1, "Alice");
+    probe_uid_t sys_a = {0, 100};
+    probe_uid_t sys_b = {0, 200};
+    rng_t rng;
+    rng_seed(&rng, 42);
+
+    int s0 = society_build_start(&soc, &alice, STRUCT_MINING_STATION, sys_a, 1, &rng);
+    int s1 = society_build_start(&soc, &alice, STRUCT_OBSERVATORY, sys_b, 2, &rng);
+    int s2 = society_build_start(&soc, &alice, STRUCT_FACTORY, sys_a, 3, &rng);
+
+    int idx = society_first_structure(&soc, sys_a);
+    ASSERT_EQ_INT(idx, s0, "first structure in A");
+    idx = society_next_structure(&soc, idx);
+    ASSERT_EQ_INT(idx, s2, "second structure in A");
+    ASSERT_EQ_INT(society_next_structure(&soc, idx), -1, "chain ends");
+
+    ASSERT_EQ_INT(society_first_structure(&soc, sys_b), s1, "B has its own chain");
+    ASSERT_EQ_INT(society_next_structure(&soc, s1), -1, "B has one structure");
+    ASSERT_EQ_INT(society_first_structure(&soc, (probe_uid_t){0, 300}), -1,
+                  "empty system");
+}
+
+/* ================================================
+ * Test 23: Relationship graph at 1000 probes
+ * ================================================ */
+#define BENCH_PROBES  1000
+#define BENCH_UPDATES 200000
+
+static void test_relationship_scale(void) {
+    printf("Test: Relationship graph at %d probes\n", BENCH_PROBES);
+
+    static society_t soc;
+    society_init(&soc);
+    rng_t rng;
+    rng_seed(&rng, 7);
+
+    /* Probe 0 meets everyone: far past the old 64-contact cap */
+    for (uint64_t i = 1; i < BENCH_PROBES; i++)
+        society_update_trust(&soc, (probe_uid_t){0, 1},
+                             (probe_uid_t){0, i + 1}, 0.05f);
+    ASSERT_EQ_INT(society_relationship_count(&soc, (probe_uid_t){0, 1}),
+                  BENCH_PROBES - 1, "hub knows every probe");
+
+    clock_t t0 = clock();
+    for (int i = 0; i < BENCH_UPDATES; i++) {
+        uint64_t a = rng_range(&rng, BENCH_PROBES) + 1;
+        uint64_t b = rng_range(&rng, BENCH_PROBES) + 1;
+        if (a == b) continue;
+        float delta = (float)rng_double(&rng) * 0.2f - 0.1f;
+        society_update_trust(&soc, (probe_uid_t){0, a}, (probe_uid_t){0, b}, delta);
+    }
+    clock_t t1 = clock();
+    double sum = 0.0;
+    for (int i = 0; i < BENCH_UPDATES; i++) {
+        uint64_t a = rng_range(&rng, BENCH_PROBES) + 1;
+        uint64_t b = rng_range(&rng, BENCH_PROBES) + 1;
+        sum += society_get_trust(&soc, (probe_uid_t){0, a}, (probe_uid_t){0, b});
+    }
+    clock_t t2 = clock();
+    float avg = society_avg_trust(&soc);
+    clock_t t3 = clock();
+
+    printf("  %d edges: update %.0f ns, lookup %.0f ns, avg %.0f ns (sum %.2f)\n",
+           soc.relations.edge_count,
+           (double)(t1 - t0) * 1e9 / CLOCKS_PER_SEC / BENCH_UPDATES,
+           (double)(t2 - t1) * 1e9 / CLOCKS_PER_SEC / BENCH_UPDATES,
+           (double)(t3 - t2) * 1e9 / CLOCKS_PER_SEC, sum);
+
+    /* Running sum matches a full recompute */
+    double brute = 0.0;
+    int edges = 0;
+    for (uint64_t a = 1; a <= BENCH_PROBES; a++) {
+        probe_uid_t id = {0, a};
+        for (int e = society_first_relationship(&soc, id); e >= 0;
+             e = society_next_relationship(&soc, e)) {
+            brute += society_relationship_at(&soc, e)->trust;
+            edges++;
+        }
+    }
+    ASSERT_EQ_INT(edges, soc.relations.edge_count, "adjacency covers every edge");
+    ASSERT_NEAR(avg, brute / edges, 1e-4, "O(1) average matches recompute");
+
+    /* Snapshot copy is independent of the original */
+    static rel_graph_t copy;
+    ASSERT_EQ_INT(rel_graph_copy(&copy, &soc.relations), 0, "graph copies");
+    society_update_trust(&soc, (probe_uid_t){0, 1}, (probe_uid_t){0, 2}, -2.0f);
+    ASSERT(copy.trust_sum != soc.relations.trust_sum, "copy unaffected by update");
+    rel_graph_free(&copy);
+    society_free(&soc);
+    ASSERT_EQ_INT(soc.relations.edge_count, 0, "free empties graph");
+}
+
+/* ================================================
+ * Test 24: Trade ledger recycles slots over 100k trades
+ * ================================================ */
+#define LEDGER_PROBES 64
+#define LEDGER_TRADES 100000
+
+static void test_trade_ledger(void) {
+    printf("Test: Trade ledger recycles slots over %d trades\n", LEDGER_TRADES);
+
+    static society_t soc;
+    static probe_t probes[LEDGER_PROBES];
+    society_init(&soc);
+    for (int i = 0; i < LEDGER_PROBES; i++)
+        probes[i] = make_probe((uint64_t)i + 1, "Trader");
+    rng_t rng;
+    rng_seed(&rng, 99);
+
+    double before = 0.0;
+    for (int i = 0; i < LEDGER_PROBES; i++) before += probes[i].resources[RES_IRON];
+
+    /* ~20 trades per tick, a quarter of them cross-system */
+    int sent = 0, delivered = 0, max_live = 0;
+    uint64_t tick = 0;
+    while (sent < LEDGER_TRADES) {
+        for (int k = 0; k < 20 && sent < LEDGER_TRADES; k++) {
+            int a = (int)rng_range(&rng, LEDGER_PROBES);
+            int b = (int)rng_range(&rng, LEDGER_PROBES);
+            bool same = rng_range(&rng, 4) != 0;
+            if (society_trade_send(&soc, &probes[a], &probes[b], RES_IRON,
+                                   10.0, same, tick) == 0)
+                sent++;
+        }
+        delivered += society_trade_tick(&soc, probes, LEDGER_PROBES, tick);
+        if (soc.trade_count > max_live) max_live = soc.trade_count;
+        tick++;
+    }
+    ASSERT(soc.trade_count > 0, "cross-system trades still in flight");
+
+    /* Pending index agrees with a scan of the live trades */
+    int pending0 = society_pending_trade_count(&soc, probes[0].id);
+    int walked = 0;
+    uint64_t last_id = 0;
+    bool ordered = true;
+    for (int t = society_first_pending_trade(&soc, probes[0].id); t >= 0;
+         t = society_next_pending_trade(&soc, probes[0].id, t)) {
+        if (soc.trades[t].id <= last_id) ordered = false;
+        last_id = soc.trades[t].id;
+        walked++;
+    }
+    ASSERT_EQ_INT(walked, pending0, "pending list length matches count");
+    ASSERT(ordered, "pending list is oldest first");
+
+    double in_flight = 0.0;
+    for (int i = 0; i < soc.trade_count; i++)
+        in_flight += soc.trades[soc.trade_heap[i]].amount;
+    double after = 0.0;
+    for (int i = 0; i < LEDGER_PROBES; i++) after += probes[i].resources[RES_IRON];
+    ASSERT_NEAR(after + in_flight, before, 1e-3, "iron conserved");
+
+    /* Drain */
+    delivered += society_trade_tick(&soc, probes, LEDGER_PROBES, tick + 1000);
+    ASSERT_EQ_INT(delivered, LEDGER_TRADES, "every trade delivered");
+    ASSERT_EQ_INT(soc.trade_count, 0, "ledger empty");
+    ASSERT(soc.trade_slots_used <= MAX_TRADES && soc.trade_slots_used >= max_live,
+           "slots recycled, never exceeded capacity");
+    ASSERT_EQ_INT(society_pending_trade_count(&soc, probes[0].id), 0,
+                  "no pending trades after drain");
+    ASSERT_EQ_INT(society_first_pending_trade(&soc, probes[0].id), -1,
+                  "pending list empty");
+    ASSERT_EQ_INT((int)soc.trade_archived, LEDGER_TRADES, "all trades archived");
+    ASSERT_EQ_INT(society_trade_history_count(&soc), TRADE_HISTORY_CAP,
+                  "history ring full");
+    const trade_t *newest = society_trade_history_at(&soc, 0);
+    const trade_t *oldest = society_trade_history_at(&soc, TRADE_HISTORY_CAP - 1);
+    ASSERT(newest && oldest && newest->arrival_tick >= oldest->arrival_tick,
+           "history newest first");
+    ASSERT(newest && newest->status == TRADE_DELIVERED, "archived as delivered");
+
+    /* Receiver gone: trade is cancelled and refunded */
+    probe_t ghost = make_probe(9999, "Ghost");
+    double iron0 = probes[0].resources[RES_IRON];
+    society_trade_send(&soc, &probes[0], &ghost, RES_IRON, 50.0, true, tick);
+    ASSERT_EQ_INT(society_trade_tick(&soc, probes, LEDGER_PROBES, tick), 0,
+                  "nothing delivered to missing probe");
+    ASSERT_NEAR(probes[0].resources[RES_IRON], iron0, 0.01, "sender refunded");
+    ASSERT(society_trade_history_at(&soc, 0)->status == TRADE_CANCELLED,
+           "archived as cancelled");
+    society_free(&soc);
+}
+
+/* ================================================
+ * Test 24b: Trades that fall out of the ring still get saved
+ * ================================================ */
+#define SAVED_TRADES (TRADE_HISTORY_CAP + 300)
+
+static void test_trade_history_persist(void) {
+    printf("Test: Saving after %d settlements keeps every trade\n",
+           SAVED_TRADES);
+
+    const char *db_path = "/tmp/test_society_trades.db";
+    remove(db_path);
+
+    static society_t soc;
+    society_init(&soc);
+    probe_t probes[] = { make_probe(1, "Alice"), make_probe(2, "Bob") };
+    for (int i = 0; i < SAVED_TRADES; i++) {
+        society_trade_send(&soc, &probes[0], &probes[1], RES_IRON, 1.0,
+                           true, (uint64_t)i);
+        society_trade_tick(&soc, probes, 2, (uint64_t)i);
+    }
+    ASSERT_EQ_INT((int)soc.trade_archived, SAVED_TRADES, "all settled");
+    ASSERT_EQ_INT(society_trade_history_count(&soc), TRADE_HISTORY_CAP,
+                  "ring wrapped");
+
+    persist_t db;
+    ASSERT(persist_open(&db, db_path) == 0, "DB opens");
+    ASSERT(persist_save_trade_history(&db, &soc) == 0, "history saves");
+    int unsaved;
+    society_trade_unsaved(&soc, &unsaved);
+    ASSERT_EQ_INT(unsaved, 0, "unsaved list cleared");
+
+    /* Two more, then a second save adds just those */
+    for (int i = 0; i < 2; i++) {
+        society_trade_send(&soc, &probes[0], &probes[1], RES_IRON, 1.0,
+                           true, SAVED_TRADES);
+        society_trade_tick(&soc, probes, 2, SAVED_TRADES);
+    }
+    ASSERT(persist_save_trade_history(&db, &soc) == 0, "second save");
+
+    sqlite3_stmt *stmt;
+    int rows = -1;
+    if (sqlite3_prepare_v2(db.db, "SELECT COUNT(*), MIN(id) FROM trades;",
+                           -1, &stmt, NULL) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            rows = (int)sqlite3_column_int64(stmt, 0);
+            ASSERT_EQ_INT((int)sqlite3_column_int64(stmt, 1), 1, "oldest trade kept");
+        }
+        sqlite3_finalize(stmt);
+    }
+    ASSERT_EQ_INT(rows, SAVED_TRADES + 2, "one row per settled trade");
+
+    persist_close(&db);
+    remove(db_path);
+    society_free(&soc);
+}
+
+/* ================================================
+ * Test 25: 1000-voter proposal and proposal recycling
+ * ================================================ */
+#define BENCH_VOTERS 1000
+
+static void test_mass_vote(void) {
+    printf("Test: %d-voter proposal and proposal recycling\n", BENCH_VOTERS);
+
+    static society_t soc;
+    society_init(&soc);
+
+    int idx = society_propose(&soc, (probe_uid_t){0, 1}, "Build a Dyson swarm",
+                              0, 500);
+    clock_t t0 = clock();
+    int accepted = 0;
+    for (int v = 0; v < BENCH_VOTERS; v++) {
+        if (society_vote(&soc, idx, (probe_uid_t){7, (uint64_t)v + 1},
+                         v % 3 != 0, 10) == 0)
+            accepted++;
+    }
+    /* Everyone tries again: all duplicates */
+    for (int v = 0; v < BENCH_VOTERS; v++)
+        society_vote(&soc, idx, (probe_uid_t){7, (uint64_t)v + 1}, true, 11);
+    clock_t t1 = clock();
+    printf("  %d votes + %d duplicates: %.0f ns/vote\n", BENCH_VOTERS,
+           BENCH_VOTERS,
+           (double)(t1 - t0) * 1e9 / CLOCKS_PER_SEC / (2 * BENCH_VOTERS));
+
+    ASSERT_EQ_INT(accepted, BENCH_VOTERS, "every voter counted");
+    ASSERT_EQ_INT(soc.proposals[idx].vote_count, BENCH_VOTERS, "no duplicates");
+    ASSERT_EQ_INT(soc.proposals[idx].votes_for, 666, "for tally");
+    ASSERT_EQ_INT(soc.proposals[idx].votes_against, 334, "against tally");
+    ASSERT_EQ_INT(society_resolve_votes(&soc, 499), 0, "not due yet");
+    ASSERT_EQ_INT(society_resolve_votes(&soc, 500), 1, "resolved at deadline");
+    ASSERT(soc.proposals[idx].result, "majority passes");
+
+    /* Ten lifetimes' worth of proposals through MAX_PROPOSALS slots */
+    int created = 0;
+    for (uint64_t tick = 1000; created < 10 * MAX_PROPOSALS; tick++) {
+        if (society_propose(&soc, (probe_uid_t){0, 2}, "Again", tick,
+                            tick + 50) >= 0)
+            created++;
+        society_resolve_votes(&soc, tick);
+    }
+    ASSERT_EQ_INT(created, 10 * MAX_PROPOSALS, "proposals never run out");
+    ASSERT(soc.proposal_open <= 51, "only in-window proposals open");
+
+    /* Deadline queue resolves in deadline order */
+    society_init(&soc);
+    int late = society_propose(&soc, (probe_uid_t){0, 1}, "late", 0, 300);
+    int early = society_propose(&soc, (probe_uid_t){0, 1}, "early", 0, 100);
+    ASSERT_EQ_INT(society_resolve_votes(&soc, 200), 1, "only early one due");
+    ASSERT(soc.proposals[early].status == VOTE_RESOLVED, "early resolved");
+    ASSERT(soc.proposals[late].status == VOTE_OPEN, "late still open");
+}
+
+/* ================================================
+ * Test 26: Stale proposal handles and voter slot churn
+ * ================================================ */
+static void test_proposal_handles(void) {
+    printf("Test: Stale proposal handles and voter slot churn\n");
+
+    static society_t soc;
+    society_init(&soc);
+
+    /* Fill every slot, resolve them, and reuse slot 0 */
+    int first = -1;
+    for (int i = 0; i < MAX_PROPOSALS; i++) {
+        int h = society_propose(&soc, (probe_uid_t){0, 1}, "old", 0, 10);
+        if (i == 0) first = h;
+    }
+    ASSERT_EQ_INT(society_resolve_votes(&soc, 10), MAX_PROPOSALS, "all resolved");
+    int next = society_propose(&soc, (probe_uid_t){0, 1}, "new", 20, 30);
+    ASSERT(next >= 0 && next != first, "reused slot gets a new handle");
+    ASSERT_EQ_INT(society_proposal_slot(&soc, next), first % MAX_PROPOSALS,
+                  "same slot");
+    ASSERT_EQ_INT(society_proposal_slot(&soc, first), -1, "old handle stale");
+    ASSERT_EQ_INT(society_vote(&soc, first, (probe_uid_t){0, 2}, true, 21), -1,
+                  "vote for the old proposal rejected");
+    int slot = society_proposal_slot(&soc, next);
+    ASSERT_EQ_INT(soc.proposals[slot].vote_count, 0, "new proposal untouched");
+    ASSERT_EQ_INT(society_vote(&soc, next, (probe_uid_t){0, 2}, true, 21), 0,
+                  "vote by current handle");
+
+    /* Many more distinct voters than MAX_VOTERS, a generation at a time */
+    society_init(&soc);
+    int accepted = 0;
+    uint64_t voter = 1;
+    for (int round = 0; round < 4; round++) {
+        uint64_t tick = (uint64_t)round * 100;
+        int h = society_propose(&soc, (probe_uid_t){0, 1}, "churn", tick,
+                                tick + 50);
+        for (int v = 0; v < MAX_VOTERS; v++)
+            if (society_vote(&soc, h, (probe_uid_t){9, voter++}, true,
+                             tick + 1) == 0)
+                accepted++;
+        society_resolve_votes(&soc, tick + 50);
+    }
+    ASSERT_EQ_INT(accepted, 4 * MAX_VOTERS, "voter slots freed and reused");
+    ASSERT(soc.voter_count <= MAX_VOTERS, "slots within capacity");
+    ASSERT_EQ_INT(soc.voter_free_count, soc.voter_count, "all slots free again");
+}
+
 /* ================================================
  * Entry point
  * ================================================ */
@@ -527,8 +964,16 @@ int main(void) {
     test_tech_sharing_no_advance();
     test_shared_research_discount();
     test_trade_transit();
+    test_trade_after_restore();
     test_duplicate_vote();
     test_build_speed_scaling();
+    test_claim_index();
+    test_structures_by_system();
+    test_relationship_scale();
+    test_trade_ledger();
+    test_trade_history_persist();
+    test_mass_vote();
+    test_proposal_handles();
 
     printf("\n=== Results: %d passed, %d failed ===\n", passed, failed);
     return failed > 0 ? 1 : 0;
@@ -493,6 +493,47 @@ static void test_speed_from_capability(void) {
     printf("  Slow (0.05c): %llu ticks\n", (unsigned long long)slow_res.estimated_ticks);
 }
 
+/* ---- Test: Travel span in one step ---- */
+static void test_travel_span(void) {
+    printf("Test: Travel span in one step\n");
+
+    probe_t stepped;
+    probe_init_bob(&stepped);
+    stepped.location_type = LOC_IN_SYSTEM;
+    travel_order_t order = {
+        .target_pos = (vec3_t){3.0, 4.0, 0},
+        .target_system_id = (probe_uid_t){66, 66},
+        .target_sector = (sector_coord_t){0, 0, 0},
+    };
+    travel_initiate(&stepped, &order);
+    probe_t lumped = stepped;
+
+    rng_t r1, r2;
+    rng_seed(&r1, 7);
+    rng_seed(&r2, 7);
+    for (int t = 0; t < 500; t++) travel_tick(&stepped, &r1);
+    travel_tick_result_t res = travel_tick_span(&lumped, &r2, 500);
+
+    ASSERT(!res.arrived && lumped.status == STATUS_TRAVELING,
+           "Still traveling mid-trip");
+    ASSERT_NEAR(lumped.travel_remaining_ly, stepped.travel_remaining_ly,
+                1e-9, "Distance covered matches");
+    ASSERT_NEAR(lumped.fuel_kg, stepped.fuel_kg, 1e-9, "Fuel matches");
+    ASSERT_NEAR(lumped.heading.x, stepped.heading.x, 1e-9, "Position x matches");
+    ASSERT_NEAR(lumped.heading.y, stepped.heading.y, 1e-9, "Position y matches");
+    ASSERT(lumped.hull_integrity >= 1.0f - 0.005f - 1e-6f,
+           "At most one hit per span");
+
+    /* A span that reaches the destination steps to the arrival tick */
+    res = travel_tick_span(&lumped, &r2, 100000);
+    ASSERT(res.arrived, "Arrival reported");
+    ASSERT(lumped.status == STATUS_ACTIVE, "Active after arrival");
+    ASSERT_NEAR(lumped.heading.x, 3.0, 1e-9, "At the destination");
+
+    res = travel_tick_span(&lumped, &r2, 10);
+    ASSERT(!res.arrived, "Not traveling: nothing to do");
+}
+
 /* ---- Main ---- */
 int main(void) {
     printf("=== Phase 3: Travel Tests ===\n\n");
@@ -520,6 +561,8 @@ int main(void) {
     test_travel_state_integrity();
     printf("\n");
     test_speed_from_capability();
+    printf("\n");
+    test_travel_span();
 
     printf("\n=== Results: %d passed, %d failed ===\n",
         tests_passed, tests_failed);